@@ -111,37 +111,22 @@ namespace monitor
          */
         void UpdateMonitorInfo(const monitor::proto::MonitorInfo& monitor_info)
         {
-            // 通知视图开始模型重置
-            beginResetModel();
-
-            // 清空现有数据
-            monitor_data_.clear();
+            std::vector<std::vector<QVariant>> rows;
+            rows.reserve(monitor_info.cpu_stat_size());
 
             // 遍历所有CPU核心的状态数据
             for (int i = 0; i < monitor_info.cpu_stat_size(); i++)
             {
                 // 转换并添加每个CPU核心的状态数据
-                monitor_data_.push_back(insert_one_cpu_stat(monitor_info.cpu_stat(i)));
+                rows.push_back(insert_one_cpu_stat(monitor_info.cpu_stat(i)));
             }
 
-            // 通知视图重置完成
-            endResetModel();
+            // 按CPU名增量更新，只通知变化的单元格
+            UpdateRows(std::move(rows), CpuStat::CPU_NAME);
 
             return;
         }
 
-    signals:
-        /**
-         * @brief 数据变化信号
-         * @param topLeft 变化区域左上角索引
-         * @param bottomRight 变化区域右下角索引
-         * @param roles 变化的角色列表
-         *
-         * 当模型数据发生变化时发射，通知连接的视图更新显示
-         */
-        void dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
-            const QVector<int>& roles);
-
     private:
         /**
          * @brief 转换单个CPU核心的状态数据
@@ -184,9 +169,6 @@ namespace monitor
             return cpu_stat_list;
         }
 
-        /// @brief 数据存储容器：二维向量，外层为行（每个CPU核心），内层为列（4个字段）
-        std::vector<std::vector<QVariant>> monitor_data_;
-
         /// @brief 表头字符串列表，支持国际化，包含4个列标题
         QStringList header_;
 
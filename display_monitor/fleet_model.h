@@ -0,0 +1,380 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <QColor>                 // 告警背景色
+#include <QHash>                  // 主机名到行号的映射
+#include <QMetaObject>            // 把RPC结果投递回GUI线程
+#include <QStringList>            // 表头
+#include <algorithm>              // std::min, std::max
+#include <cstdint>                // uint32_t
+#include <string>                 // 主机名
+#include <vector>                 // 表格数据
+#include "client/rpc_client.h"    // RPC客户端
+#include "monitor_inter.h"        // 监控基础模型接口
+#include "request_worker.h"       // 后台请求线程
+#include "monitor_info.pb.h"      // Protobuf生成代码
+
+namespace monitor
+{
+    /**
+     * @brief 集群总览数据模型类
+     *
+     * 每台主机一行，显示负载、CPU使用率、内存使用率、流量最大的网卡和采集端自身的开销；
+     * 采集端CPU使用率或最慢监控器的采样耗时超过阈值的单元格用醒目的背景色标出。
+     * 主机很多时不一次取完，也不为看不到的行请求数据：
+     * - 行：通过canFetchMore/fetchMore按主机名分页加载（ListHosts），视图滚动到底部时才取下一页
+     * - 数据：RequestSummaries只为可见范围内的行请求概要（GetHostSummaries），
+     *   未请求过的行只显示主机名
+     * RPC在模型自己的请求线程上执行，结果投递回GUI线程后再修改模型，界面不会被慢速服务器阻塞；
+     * 同一类请求同一时刻只有一个在进行。
+     */
+    class FleetModel : public MonitorInterModel
+    {
+    private:
+        Q_OBJECT  // Qt元对象系统宏，启用信号槽和反射机制
+
+    public:
+        /// @brief 每次fetchMore加载的主机数
+        static constexpr uint32_t kPageSize = 100;
+
+        /// @brief 单次概要请求的最大主机数
+        static constexpr int kMaxSummaryRows = 200;
+
+        /// @brief 采集端CPU使用率的告警阈值（%）
+        static constexpr float kHeavyAgentCpuPercent = 5.0f;
+
+        /// @brief 最慢监控器采样耗时p99的告警阈值（微秒）
+        static constexpr uint64_t kSlowCollectorP99Us = 100000;
+
+        /**
+         * @brief 构造函数
+         * @param rpc_client RPC客户端（生命周期长于模型），可以与其他线程共用
+         * @param parent 父对象指针，用于Qt对象树管理
+         */
+        explicit FleetModel(RpcClient* rpc_client, QObject* parent = nullptr)
+            : MonitorInterModel(parent), rpc_client_(rpc_client)
+        {
+            // 初始化表格列标题（9列）
+            header_ << tr("host");               // 主机名
+            header_ << tr("load_avg_1");         // 1分钟平均负载
+            header_ << tr("cpu_percent");        // 总CPU使用率（%）
+            header_ << tr("mem_used_percent");   // 内存使用率（%）
+            header_ << tr("top_nic");            // 流量最大的网卡
+            header_ << tr("top_nic_rate");       // 该网卡的收发速率之和（KB/s）
+            header_ << tr("agent_cpu_percent");  // 采集端进程CPU使用率（%）
+            header_ << tr("agent_rss_kb");       // 采集端进程常驻内存（KB）
+            header_ << tr("collector_p99_us");   // 最慢监控器的采样耗时p99（微秒）
+        }
+
+        /// @brief 虚析构函数，等待进行中的请求结束（未投递的结果随模型一起丢弃）
+        virtual ~FleetModel() {}
+
+        /**
+         * @brief 获取模型行数
+         * @param parent 父模型索引，表格模型中通常忽略
+         * @return 已加载的主机数
+         */
+        int rowCount(const QModelIndex& parent = QModelIndex()) const override
+        {
+            return parent.isValid() ? 0 : static_cast<int>(monitor_data_.size());
+        }
+
+        /**
+         * @brief 获取模型列数
+         * @param parent 父模型索引
+         * @return 固定列数（由COLUMN_MAX枚举定义）
+         */
+        int columnCount(const QModelIndex& parent = QModelIndex()) const override
+        {
+            return COLUMN_MAX;
+        }
+
+        /**
+         * @brief 获取表头数据
+         * @param section 列索引
+         * @param orientation 表头方向
+         * @param role 数据角色
+         * @return 表头显示内容
+         */
+        QVariant headerData(int section, Qt::Orientation orientation, int role) const override
+        {
+            // 只处理水平表头的显示角色
+            if (role == Qt::DisplayRole && orientation == Qt::Horizontal)
+            {
+                return header_[section];
+            }
+
+            // 其他情况委托给父类处理（如字体、颜色等样式）
+            return MonitorInterModel::headerData(section, orientation, role);
+        }
+
+        /**
+         * @brief 获取单元格数据
+         * @param index 单元格索引
+         * @param role 数据角色
+         * @return 单元格显示数据
+         */
+        QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override
+        {
+            // 边界检查：确保列索引有效
+            if (index.column() < 0 || index.column() >= COLUMN_MAX)
+            {
+                return QVariant();
+            }
+
+            if (role == Qt::DisplayRole)
+            {
+                if (index.row() < static_cast<int>(monitor_data_.size()))
+                {
+                    return monitor_data_[index.row()][index.column()];
+                }
+                return QVariant();
+            }
+
+            // 开销过大的采集端：告警单元格使用醒目的背景色
+            if (role == Qt::BackgroundRole && IsHeavyAgentCell(index))
+            {
+                return QVariant::fromValue(QColor(255, 200, 200));
+            }
+
+            // 样式角色交给父类
+            return MonitorInterModel::data(index, role);
+        }
+
+        /**
+         * @brief 是否还有未加载的主机
+         * @param parent 父模型索引
+         * @return bool 还有下一页，或服务器上的主机数多于已加载的行时返回true
+         */
+        bool canFetchMore(const QModelIndex& parent) const override
+        {
+            if (parent.isValid() || rpc_client_ == nullptr || fetching_hosts_)
+            {
+                return false;
+            }
+            return !exhausted_ || total_hosts_ > monitor_data_.size();
+        }
+
+        /**
+         * @brief 异步加载下一页主机
+         * @param parent 父模型索引
+         *
+         * 返回时行还没有插入，结果到达后在GUI线程上追加。
+         * 已经加载到末尾、服务器上又出现了新主机时从头重新翻页，已有的主机跳过。
+         */
+        void fetchMore(const QModelIndex& parent) override
+        {
+            if (!canFetchMore(parent))
+            {
+                return;
+            }
+            if (exhausted_)
+            {
+                cursor_.clear();
+                exhausted_ = false;
+            }
+
+            fetching_hosts_ = true;
+            const std::string start_after = cursor_;
+            worker_.Post([this, start_after]() {
+                monitor::proto::HostListResponse response;
+                const bool ok = rpc_client_->ListHosts(start_after, kPageSize, &response);
+                QMetaObject::invokeMethod(this, [this, ok, response = std::move(response)]() {
+                    AppendHosts(ok, response);
+                }, Qt::QueuedConnection);
+            });
+        }
+
+        /**
+         * @brief 刷新一段行的概要
+         * @param first 第一行（含）
+         * @param last 最后一行（含）
+         *
+         * 由视图在定时器和滚动时以可见范围调用；上一次请求还没有返回时忽略本次调用。
+         */
+        void RequestSummaries(int first, int last)
+        {
+            const int rows = static_cast<int>(monitor_data_.size());
+            first = std::max(first, 0);
+            last = std::min({last, rows - 1, first + kMaxSummaryRows - 1});
+            if (rpc_client_ == nullptr || fetching_summaries_ || first > last)
+            {
+                return;
+            }
+
+            std::vector<std::string> hosts;
+            hosts.reserve(last - first + 1);
+            for (int row = first; row <= last; ++row)
+            {
+                hosts.push_back(monitor_data_[row][HOST].toString().toStdString());
+            }
+
+            fetching_summaries_ = true;
+            worker_.Post([this, hosts = std::move(hosts)]() {
+                monitor::proto::HostSummaryResponse response;
+                const bool ok = rpc_client_->GetHostSummaries(hosts, &response);
+                QMetaObject::invokeMethod(this, [this, ok, response = std::move(response)]() {
+                    ApplySummaries(ok, response);
+                }, Qt::QueuedConnection);
+            });
+        }
+
+        /**
+         * @brief 获取某一行的主机名
+         * @param row 行号
+         * @return QString 主机名，行号无效时为空
+         */
+        QString HostAt(int row) const
+        {
+            if (row < 0 || row >= static_cast<int>(monitor_data_.size()))
+            {
+                return QString();
+            }
+            return monitor_data_[row][HOST].toString();
+        }
+
+    private:
+        /**
+         * @brief 单元格是否为超过阈值的采集端开销
+         * @param index 单元格索引
+         * @return bool 采集端CPU使用率或最慢监控器的p99超过阈值时返回true
+         */
+        bool IsHeavyAgentCell(const QModelIndex& index) const
+        {
+            if (index.row() >= static_cast<int>(monitor_data_.size()))
+            {
+                return false;
+            }
+            const QVariant& value = monitor_data_[index.row()][index.column()];
+            switch (index.column())
+            {
+            case AGENT_CPU_PERCENT:
+                return value.isValid() && value.toFloat() > kHeavyAgentCpuPercent;
+            case COLLECTOR_P99_US:
+                return value.isValid() && value.toULongLong() > kSlowCollectorP99Us;
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * @brief 追加一页主机（GUI线程）
+         * @param ok 请求是否成功
+         * @param response 本页的主机名
+         */
+        void AppendHosts(bool ok, const monitor::proto::HostListResponse& response)
+        {
+            fetching_hosts_ = false;
+            if (!ok)
+            {
+                return;   // 下次滚动或定时刷新时重试
+            }
+            total_hosts_ = response.total();
+            if (response.host_size() > 0)
+            {
+                cursor_ = response.host(response.host_size() - 1);
+            }
+            exhausted_ = static_cast<uint32_t>(response.host_size()) < kPageSize;
+
+            std::vector<QString> added;
+            for (const std::string& host : response.host())
+            {
+                QString name = QString::fromStdString(host);
+                if (!rows_.contains(name))
+                {
+                    added.push_back(name);
+                    rows_.insert(name, static_cast<int>(monitor_data_.size() + added.size() - 1));
+                }
+            }
+            if (added.empty())
+            {
+                return;
+            }
+
+            const int first = static_cast<int>(monitor_data_.size());
+            beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+            for (QString& name : added)
+            {
+                std::vector<QVariant> row(COLUMN_MAX);
+                row[HOST] = std::move(name);
+                monitor_data_.push_back(std::move(row));
+            }
+            endInsertRows();
+        }
+
+        /**
+         * @brief 更新收到概要的行（GUI线程）
+         * @param ok 请求是否成功
+         * @param response 主机概要
+         */
+        void ApplySummaries(bool ok, const monitor::proto::HostSummaryResponse& response)
+        {
+            fetching_summaries_ = false;
+            if (!ok)
+            {
+                return;
+            }
+            total_hosts_ = response.total();   // 主机数增加时canFetchMore再次返回true
+
+            for (const auto& summary : response.summary())
+            {
+                auto iter = rows_.constFind(QString::fromStdString(summary.host()));
+                if (iter == rows_.constEnd())
+                {
+                    continue;
+                }
+                std::vector<QVariant> row(COLUMN_MAX);
+                row[HOST] = QString::fromStdString(summary.host());
+                row[LOAD_AVG_1] = QVariant(summary.load_avg_1());
+                row[CPU_PERCENT] = QVariant(summary.cpu_percent());
+                row[MEM_USED_PERCENT] = QVariant(summary.mem_used_percent());
+                row[TOP_NIC] = QString::fromStdString(summary.top_nic());
+                row[TOP_NIC_RATE] = QVariant(summary.top_nic_rate());
+                if (summary.agent_rss_kb() > 0)   // 旧采集端不上报自身开销，留空
+                {
+                    row[AGENT_CPU_PERCENT] = QVariant(summary.agent_cpu_percent());
+                    row[AGENT_RSS_KB] = QVariant(static_cast<qulonglong>(summary.agent_rss_kb()));
+                    row[COLLECTOR_P99_US] = QVariant(static_cast<qulonglong>(summary.slowest_collector_p99_us()));
+                }
+                UpdateRow(iter.value(), std::move(row));
+            }
+        }
+
+        /// @brief RPC客户端
+        RpcClient* rpc_client_;
+
+        /// @brief 表头字符串列表，支持国际化，包含9个列标题
+        QStringList header_;
+
+        // ==================== 分页状态（GUI线程） ====================
+        QHash<QString, int> rows_;           ///< 主机名到行号
+        std::string cursor_;                 ///< 已加载的最后一个主机名（下一页从其后开始）
+        bool exhausted_ = false;             ///< 是否已加载到最后一页
+        size_t total_hosts_ = 0;             ///< 服务器上次报告的主机总数
+        bool fetching_hosts_ = false;        ///< 是否有ListHosts在进行
+        bool fetching_summaries_ = false;    ///< 是否有GetHostSummaries在进行
+
+        /// @brief 执行ListHosts和GetHostSummaries的请求线程（最后声明，最先析构）
+        RequestWorker worker_;
+
+        /**
+         * @brief 集群总览列枚举
+         *
+         * 使用枚举代替硬编码数字，提高代码可读性和可维护性
+         * COLUMN_MAX作为哨兵值表示总列数
+         */
+        enum FleetModelInfo
+        {
+            HOST = 0,                 ///< 主机名列
+            LOAD_AVG_1,               ///< 1分钟平均负载列
+            CPU_PERCENT,              ///< 总CPU使用率列（%）
+            MEM_USED_PERCENT,         ///< 内存使用率列（%）
+            TOP_NIC,                  ///< 流量最大的网卡列
+            TOP_NIC_RATE,             ///< 网卡收发速率之和列（KB/s）
+            AGENT_CPU_PERCENT,        ///< 采集端CPU使用率列（%）
+            AGENT_RSS_KB,             ///< 采集端常驻内存列（KB）
+            COLLECTOR_P99_US,         ///< 最慢监控器采样耗时p99列（微秒）
+            COLUMN_MAX                ///< 列总数，用于循环终止条件
+        };
+    };
+}  // namespace monitor
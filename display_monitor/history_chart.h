@@ -0,0 +1,290 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <QColor>                 // 序列颜色
+#include <QHash>                  // 序列名到下标
+#include <QPainter>               // 绘制
+#include <QPolygonF>              // 降采样后的折线
+#include <QWidget>                // 窗口部件基类
+#include <algorithm>              // std::max
+#include <cstdint>                // int64_t
+#include <vector>                 // 序列列表
+#include "monitor_info.pb.h"      // RangeResponse
+#include "series_ring.h"          // 环形缓冲区和MinMaxLttb
+
+namespace monitor
+{
+    /**
+     * @brief 滚动历史曲线图
+     *
+     * 显示最近一小时的多条序列（每个CPU、每块网卡一条），每条序列保存在客户端的SeriesRing中。
+     * 绘制时不画原始点：每条序列先用MinMaxLttb降采样到绘图区宽度（像素数）个点，
+     * 尖峰和低谷保留在折线里，256条一小时的序列重绘也只画几十万个点；
+     * 降采样结果缓存为折线，只在数据变化或宽度变化后的下一次重绘时重新计算。
+     */
+    class HistoryChart : public QWidget
+    {
+    private:
+        Q_OBJECT  // Qt元对象系统宏，启用信号槽机制
+
+    public:
+        /// @brief 显示的时间窗口（毫秒）
+        static constexpr int64_t kWindowMs = 3600 * 1000;
+
+        /// @brief 同一序列相邻两点的最小间隔（毫秒），保证SeriesRing的容量覆盖整个窗口
+        static constexpr int64_t kMinSpacingMs = 1000;
+
+        /// @brief 图例最多显示的序列数
+        static constexpr int kMaxLegend = 8;
+
+        /**
+         * @brief 构造函数
+         * @param title 图表标题
+         * @param unit 数值单位（显示在纵轴标签上）
+         * @param fixed_max 纵轴固定上限（如百分比为100），0表示按可见数据自动缩放
+         * @param parent 父窗口部件指针
+         */
+        HistoryChart(const QString& title, const QString& unit, float fixed_max = 0, QWidget* parent = nullptr)
+            : QWidget(parent), title_(title), unit_(unit), fixed_max_(fixed_max)
+        {
+            setMinimumHeight(200);
+        }
+
+        /**
+         * @brief 追加一个实时采样点
+         * @param series 序列名（如"cpu0"、"eth0 tx"）
+         * @param timestamp_ms 采样时间（Unix毫秒）
+         * @param value 值
+         */
+        void Append(const QString& series, int64_t timestamp_ms, float value)
+        {
+            Series& target = SeriesFor(series);
+            if (target.ring.Size() > 0 && timestamp_ms < target.ring.TimeAt(target.ring.Size() - 1) + kMinSpacingMs)
+            {
+                return;
+            }
+            if (target.ring.Append(timestamp_ms, value))
+            {
+                latest_ms_ = std::max(latest_ms_, timestamp_ms);
+                Invalidate();
+            }
+        }
+
+        /**
+         * @brief 用服务器历史回填一条序列
+         * @param series 序列名
+         * @param history QueryRange的结果（时间升序）
+         *
+         * 历史放在前面，回填之前已经收到的实时点接在后面（与历史重叠的部分去掉）。
+         */
+        void Backfill(const QString& series, const monitor::proto::RangeResponse& history)
+        {
+            Series& target = SeriesFor(series);
+            SeriesRing merged;
+            int64_t last = INT64_MIN;
+            auto append = [&](int64_t timestamp_ms, float value) {
+                if (last == INT64_MIN || timestamp_ms >= last + kMinSpacingMs)
+                {
+                    merged.Append(timestamp_ms, value);
+                    last = timestamp_ms;
+                }
+            };
+            const int points = std::min(history.timestamp_ms_size(), history.value_size());
+            for (int i = 0; i < points; ++i)
+            {
+                append(history.timestamp_ms(i), history.value(i));
+            }
+            for (size_t i = 0; i < target.ring.Size(); ++i)
+            {
+                append(target.ring.TimeAt(i), target.ring.ValueAt(i));
+            }
+            target.ring = std::move(merged);
+            if (target.ring.Size() > 0)
+            {
+                latest_ms_ = std::max(latest_ms_, target.ring.TimeAt(target.ring.Size() - 1));
+            }
+            Invalidate();
+        }
+
+        /// @brief 删除所有序列（切换主机时调用）
+        void Clear()
+        {
+            series_.clear();
+            index_.clear();
+            latest_ms_ = 0;
+            Invalidate();
+        }
+
+    protected:
+        /**
+         * @brief 绘制坐标轴、折线和图例
+         */
+        void paintEvent(QPaintEvent*) override
+        {
+            QPainter painter(this);
+            painter.fillRect(rect(), Qt::white);
+            const QRectF plot = PlotArea();
+            if (plot.width() < 2 || plot.height() < 2)
+            {
+                return;
+            }
+            if (dirty_ || cached_width_ != static_cast<int>(plot.width()) || cached_height_ != static_cast<int>(plot.height()))
+            {
+                Rebuild(plot);
+            }
+
+            // 标题、网格和坐标轴标签
+            painter.setPen(Qt::black);
+            painter.setFont(QFont("Microsoft YaHei", 10, QFont::Bold));
+            painter.drawText(QRectF(0, 0, width(), kTopMargin), Qt::AlignCenter, title_);
+            painter.setFont(QFont("Microsoft YaHei", 8));
+            for (int i = 0; i <= 2; ++i)
+            {
+                const double y = plot.bottom() - plot.height() * i / 2;
+                painter.setPen(QColor(Qt::lightGray));
+                painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+                painter.setPen(Qt::black);
+                painter.drawText(QRectF(0, y - 8, kLeftMargin - 4, 16), Qt::AlignRight | Qt::AlignVCenter,
+                                 QString::number(y_max_ * i / 2, 'g', 3) + unit_);
+            }
+            painter.drawText(QRectF(plot.left(), plot.bottom(), 80, kBottomMargin), Qt::AlignLeft | Qt::AlignVCenter,
+                             tr("-60 min"));
+            painter.drawText(QRectF(plot.center().x() - 40, plot.bottom(), 80, kBottomMargin), Qt::AlignCenter,
+                             tr("-30 min"));
+            painter.drawText(QRectF(plot.right() - 80, plot.bottom(), 80, kBottomMargin), Qt::AlignRight | Qt::AlignVCenter,
+                             tr("now"));
+
+            // 折线：不开抗锯齿，每条序列一次drawPolyline
+            painter.setClipRect(plot);
+            for (const Series& series : series_)
+            {
+                painter.setPen(QPen(series.color, 1));
+                painter.drawPolyline(series.polyline);
+            }
+            painter.setClipping(false);
+
+            // 图例：前kMaxLegend条序列的名称和最新值
+            double x = plot.left();
+            for (int i = 0; i < static_cast<int>(series_.size()) && i < kMaxLegend; ++i)
+            {
+                const Series& series = series_[i];
+                const QString latest = series.ring.Size() > 0
+                    ? QString::number(series.ring.ValueAt(series.ring.Size() - 1), 'f', 1) : QString("-");
+                const QString text = series.name + " " + latest;
+                painter.setPen(series.color);
+                painter.drawText(QPointF(x, kTopMargin - 4), text);
+                x += painter.fontMetrics().horizontalAdvance(text) + 12;
+            }
+            if (static_cast<int>(series_.size()) > kMaxLegend)
+            {
+                painter.setPen(Qt::black);
+                painter.drawText(QPointF(x, kTopMargin - 4), tr("+%1 more").arg(series_.size() - kMaxLegend));
+            }
+        }
+
+    private:
+        /// @brief 绘图区边距（像素）
+        static constexpr int kLeftMargin = 60;
+        static constexpr int kRightMargin = 10;
+        static constexpr int kTopMargin = 36;
+        static constexpr int kBottomMargin = 20;
+
+        /**
+         * @brief 一条序列
+         */
+        struct Series
+        {
+            QString name;         ///< 序列名
+            QColor color;         ///< 线条颜色
+            SeriesRing ring;      ///< 最近一小时的点
+            QPolygonF polyline;   ///< 降采样后的折线（像素坐标）
+        };
+
+        /**
+         * @brief 查找序列，不存在时创建
+         * @param name 序列名
+         * @return Series& 序列
+         */
+        Series& SeriesFor(const QString& name)
+        {
+            auto iter = index_.constFind(name);
+            if (iter != index_.constEnd())
+            {
+                return series_[iter.value()];
+            }
+            const int position = static_cast<int>(series_.size());
+            index_.insert(name, position);
+            Series series;
+            series.name = name;
+            series.color = QColor::fromHsv((position * 47) % 360, 200, 200);   // 相邻序列颜色相差较大
+            series_.push_back(std::move(series));
+            return series_.back();
+        }
+
+        /// @brief 绘图区（去掉标题、图例和坐标轴标签）
+        QRectF PlotArea() const
+        {
+            return QRectF(kLeftMargin, kTopMargin, width() - kLeftMargin - kRightMargin,
+                          height() - kTopMargin - kBottomMargin);
+        }
+
+        /// @brief 标记折线需要重新计算并请求重绘（多次调用在一帧内合并）
+        void Invalidate()
+        {
+            dirty_ = true;
+            update();
+        }
+
+        /**
+         * @brief 重新降采样所有序列并换算为像素坐标
+         * @param plot 绘图区
+         */
+        void Rebuild(const QRectF& plot)
+        {
+            dirty_ = false;
+            cached_width_ = static_cast<int>(plot.width());
+            cached_height_ = static_cast<int>(plot.height());
+
+            const int64_t t1 = latest_ms_;
+            const int64_t t0 = t1 - kWindowMs;
+            const size_t threshold = static_cast<size_t>(cached_width_);
+
+            float max_value = 0;
+            for (Series& series : series_)
+            {
+                series.ring.Downsample(t0, t1, threshold, &times_, &values_);
+                series.polyline.resize(static_cast<int>(times_.size()));
+                for (size_t i = 0; i < times_.size(); ++i)
+                {
+                    series.polyline[static_cast<int>(i)] = QPointF(static_cast<double>(times_[i] - t0), values_[i]);
+                    max_value = std::max(max_value, values_[i]);
+                }
+            }
+            y_max_ = fixed_max_ > 0 ? fixed_max_ : std::max(max_value * 1.1f, 1.0f);
+
+            // 时间和数值换算为像素坐标
+            const double x_scale = plot.width() / static_cast<double>(kWindowMs);
+            const double y_scale = plot.height() / y_max_;
+            for (Series& series : series_)
+            {
+                for (QPointF& point : series.polyline)
+                {
+                    point = QPointF(plot.left() + point.x() * x_scale, plot.bottom() - point.y() * y_scale);
+                }
+            }
+        }
+
+        QString title_;                       ///< 图表标题
+        QString unit_;                        ///< 数值单位
+        float fixed_max_;                     ///< 纵轴固定上限，0表示自动
+        float y_max_ = 1;                     ///< 当前纵轴上限
+        std::vector<Series> series_;          ///< 所有序列（按首次出现的顺序）
+        QHash<QString, int> index_;           ///< 序列名到下标
+        int64_t latest_ms_ = 0;               ///< 所有序列中最新的点的时间（窗口右端）
+        bool dirty_ = true;                   ///< 折线是否需要重新计算
+        int cached_width_ = 0;                ///< 折线对应的绘图区宽度
+        int cached_height_ = 0;               ///< 折线对应的绘图区高度
+        std::vector<int64_t> times_;          ///< 降采样时间缓冲区（复用）
+        std::vector<float> values_;           ///< 降采样数值缓冲区（复用）
+    };
+}  // namespace monitor
@@ -1,7 +1,16 @@
 #include <QApplication>        // Qt应用程序类
+#include <QMetaObject>         // 向GUI线程投递操作
+#include <algorithm>           // std::min
+#include <chrono>              // 重新订阅的退避时间
+#include <condition_variable>  // 切换主机时唤醒退避中的订阅线程
+#include <cstdint>             // 切换主机的代数
+#include <memory>              // 邮箱中的消息
+#include <mutex>               // 保护当前主机
 #include <thread>              // C++11线程支持
+#include <utility>             // std::pair
 #include "client/rpc_client.h" // RPC客户端
 #include "monitor_widget.h"    // 监控主窗口
+#include "sample_mailbox.h"    // RPC线程到GUI线程的单槽邮箱
 
 /**
  * @brief 监控显示程序主函数
@@ -13,7 +22,12 @@
  * 1. 初始化Qt应用程序
  * 2. 连接RPC服务器
  * 3. 创建并显示监控界面
- * 4. 启动数据更新线程
+ * 4. 启动数据更新线程（订阅服务器推送）
+ *
+ * 线程模型：数据更新线程只负责接收采样并放入单槽邮箱，
+ * 界面模型只在GUI线程上更新（邮箱由投递到GUI线程的取出操作清空，只应用最新的采样）。
+ * 在集群总览中选中其他主机时，取消当前订阅，数据更新线程随即订阅新主机。
+ * 退出时置停止标志并取消订阅，事件循环返回后等待数据更新线程结束，再析构它引用的局部对象。
  */
 int main(int argc, char* argv[])
 {
@@ -23,54 +37,166 @@ int main(int argc, char* argv[])
     // 设置默认的gRPC服务器地址
     std::string server_address = "localhost:50051";
 
-    // 支持命令行参数指定服务器地址
-    // 用法: ./display server_address:50051
+    // 支持命令行参数指定服务器地址和主机名
+    // 用法: ./display server_address:50051 [host]
+    // 不指定主机时显示最近一次上报的主机
     if (argc > 1)
     {
         server_address = argv[1];
     }
+    std::string host;
+    if (argc > 2)
+    {
+        host = argv[2];
+    }
+
+    // 创建RPC客户端，连接到指定服务器（先于窗口创建、后于窗口析构，集群总览模型会使用它）
+    monitor::RpcClient rpc_client(server_address);
 
     // 创建监控窗口部件
     monitor::MonitorWidget moitor_widget;
 
-    // 创建RPC客户端，连接到指定服务器
-    monitor::RpcClient rpc_client(server_address);
-
-    // 创建Protobuf消息对象，用于存储监控数据
-    monitor::proto::MonitorInfo monitor_info;
+    // 当前显示的主机（GUI线程切换，数据更新线程读取），代数每次切换加一
+    std::mutex host_mutex;
+    std::condition_variable host_cv;
+    uint64_t host_generation = 0;
+    bool stopping = false;   // 程序退出，数据更新线程应尽快返回（受host_mutex保护）
+    auto current_host = [&]() {
+        std::lock_guard<std::mutex> lock(host_mutex);
+        return std::make_pair(host, host_generation);
+    };
+    auto stopped = [&]() {
+        std::lock_guard<std::mutex> lock(host_mutex);
+        return stopping;
+    };
 
-    // 首次获取监控信息，主要用于获取主机名
-    // 注意：这里存在潜在问题，如果服务器未运行会阻塞
-    rpc_client.GetMonitorInfo(&monitor_info);
-    std::string name = monitor_info.name();  // 获取主机名用于界面显示
+    // 按是否指定主机选择查询方式
+    auto fetch = [&](monitor::proto::MonitorInfo* info) {
+        const std::string target = current_host().first;
+        if (target.empty())
+        {
+            rpc_client.GetMonitorInfo(info);
+        }
+        else
+        {
+            rpc_client.GetMonitorInfo(target, info);
+        }
+    };
 
-    // 创建并显示完整的监控界面
-    QWidget* widget = moitor_widget.ShowAllMonitorWidget(name);
+    // 创建并显示完整的监控界面（带集群总览页面）
+    // 不等服务器：未指定主机时按钮上的主机名由第一份收到的采样填上
+    QWidget* widget = moitor_widget.ShowAllMonitorWidget(host, &rpc_client);
     widget->show();  // 显示窗口
 
+    // 在集群总览中选中主机：切换当前主机并取消旧订阅
+    QObject::connect(&moitor_widget, &monitor::MonitorWidget::HostSelected, [&](const QString& selected) {
+        {
+            std::lock_guard<std::mutex> lock(host_mutex);
+            host = selected.toStdString();
+            ++host_generation;
+        }
+        host_cv.notify_all();
+        rpc_client.CancelSubscribe();
+    });
+
+    // 退出事件循环前：通知数据更新线程停止，并取消阻塞中的订阅
+    QObject::connect(&app, &QApplication::aboutToQuit, [&]() {
+        {
+            std::lock_guard<std::mutex> lock(host_mutex);
+            stopping = true;
+        }
+        host_cv.notify_all();
+        rpc_client.CancelSubscribe();
+    });
+
+    // RPC线程到GUI线程的交接：邮箱从空变为非空时向GUI线程投递一次取出
+    monitor::SampleMailbox mailbox;
+    auto drain = [&]() {
+        std::unique_ptr<monitor::proto::MonitorInfo> sample = mailbox.Take();
+        if (!sample)
+        {
+            return;
+        }
+        // 未指定主机：固定为第一份采样的主机，之后重新订阅和轮询都查询它
+        std::string target = current_host().first;
+        if (target.empty() && !sample->name().empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(host_mutex);
+                host = sample->name();
+            }
+            target = sample->name();
+            moitor_widget.SetHostName(target);
+        }
+        // 丢弃切换主机前收到的旧主机采样
+        if (target.empty() || sample->name() == target)
+        {
+            moitor_widget.UpdateData(*sample);   // GUI线程上更新模型
+        }
+        mailbox.Recycle(std::move(sample));
+    };
+    auto publish = [&](std::unique_ptr<monitor::proto::MonitorInfo> sample) {
+        if (mailbox.Publish(std::move(sample)))
+        {
+            QMetaObject::invokeMethod(&app, drain, Qt::QueuedConnection);
+        }
+    };
+
     // 创建数据更新线程（使用智能指针管理）
+    // 订阅服务器推送：只在主机上报新采样时刷新界面；服务器不支持订阅时回退到每2秒轮询
     std::unique_ptr<std::thread> thread_;
     thread_ = std::make_unique<std::thread>([&]() {
-        // 线程主循环
-        while (true)
+        std::chrono::seconds backoff(1);
+        while (!stopped())
         {
-            // 清空上一次的监控数据
-            monitor_info.Clear();
+            // 界面显示所有分组，订阅全部字段（掩码为0）
+            const std::pair<std::string, uint64_t> target = current_host();
+            const uint64_t generation = target.second;
+            grpc::Status status = rpc_client.Subscribe(target.first, 0, [&](const monitor::proto::MonitorInfo& info) {
+                if (stopped() || current_host().second != generation)
+                {
+                    rpc_client.CancelSubscribe();   // 订阅建立前已切换主机或开始退出
+                    return;
+                }
+                std::unique_ptr<monitor::proto::MonitorInfo> sample = mailbox.Acquire();
+                sample->CopyFrom(info);
+                publish(std::move(sample));
+                backoff = std::chrono::seconds(1);
+            });
+            if (status.error_code() == grpc::StatusCode::UNIMPLEMENTED)
+            {
+                break;
+            }
+
+            // 连接断开：退避后重新订阅；期间切换了主机则立即订阅新主机，开始退出则立即返回
+            std::unique_lock<std::mutex> lock(host_mutex);
+            if (!host_cv.wait_for(lock, backoff, [&]() { return stopping || host_generation != generation; }))
+            {
+                backoff = std::min(backoff * 2, std::chrono::seconds(30));
+            }
+        }
 
+        // 旧服务器不支持订阅，回退到轮询
+        while (!stopped())
+        {
             // 从服务器获取最新的监控数据
-            rpc_client.GetMonitorInfo(&monitor_info);
+            std::unique_ptr<monitor::proto::MonitorInfo> sample = mailbox.Acquire();
+            sample->Clear();
+            fetch(sample.get());
 
-            // 更新监控界面显示
-            moitor_widget.UpdateData(monitor_info);
+            // 交给GUI线程更新监控界面显示
+            publish(std::move(sample));
 
-            // 休眠2秒，控制更新频率
-            std::this_thread::sleep_for(std::chrono::seconds(2));
+            // 等待2秒控制更新频率，开始退出时立即醒来
+            std::unique_lock<std::mutex> lock(host_mutex);
+            host_cv.wait_for(lock, std::chrono::seconds(2), [&]() { return stopping; });
         }
     });
 
-    // 分离线程，让它在后台运行
-    thread_->detach();
-
     // 启动Qt事件循环，等待用户交互
-    return app.exec();
+    const int code = app.exec();
+
+    // aboutToQuit已通知线程停止：等它结束后再析构邮箱、RPC客户端和窗口
+    thread_->join();
+    return code;
 }
@@ -127,33 +127,14 @@ namespace monitor
          */
         void UpdateMonitorInfo(const monitor::proto::MonitorInfo& monitor_info)
         {
-            // 通知视图开始模型重置
-            beginResetModel();
-
-            // 清空现有数据
-            monitor_data_.clear();
-
-            // 转换并添加内存数据（只有一行）
-            monitor_data_.push_back(insert_one_mem_info(monitor_info.mem_info()));
-
-            // 通知视图重置完成
-            endResetModel();
+            // 转换内存数据（只有一行），按行号增量更新，只通知变化的单元格
+            std::vector<std::vector<QVariant>> rows;
+            rows.push_back(insert_one_mem_info(monitor_info.mem_info()));
+            UpdateRows(std::move(rows), -1);
 
             return;
         }
 
-    signals:
-        /**
-         * @brief 数据变化信号
-         * @param topLeft 变化区域左上角索引
-         * @param bottomRight 变化区域右下角索引
-         * @param roles 变化的角色列表
-         *
-         * 当模型数据发生变化时发射，通知连接的视图更新显示
-         */
-        void dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
-            const QVector<int>& roles);
-
     private:
         /**
          * @brief 转换内存信息数据
@@ -233,9 +214,6 @@ namespace monitor
             return mem_info_list;
         }
 
-        /// @brief 数据存储容器：二维向量，外层为行（系统内存只有1行），内层为列（19个字段）
-        std::vector<std::vector<QVariant>> monitor_data_;
-
         /// @brief 表头字符串列表，支持国际化，包含19个列标题
         QStringList header_;
 
@@ -5,6 +5,12 @@
 #include <QObject>              // Qt对象基类
 #include <QColor>               // Qt颜色类
 #include <QFont>                // Qt字体类
+#include <QHash>                // 行标识到新数据位置的映射
+#include <QVariant>             // 单元格数据
+#include <QVector>              // dataChanged的角色列表
+#include <cstddef>              // size_t
+#include <utility>              // std::move
+#include <vector>               // 表格数据
 
 namespace monitor
 {
@@ -100,5 +106,116 @@ namespace monitor
             // 对于DisplayRole等数据角色，由派生类实现
             return QVariant();
         }
+
+    protected:
+        /**
+         * @brief 增量更新表格数据
+         * @param rows 新一轮的数据，外层为行，内层为列
+         * @param key_column 行标识所在的列（CPU名、网卡名），小于0时按行号标识（单行表格）
+         *
+         * 按行标识保持行的稳定，不重置模型，视图的选中、滚动位置和代理模型的排序都保持不变：
+         * 1. 新数据中不再出现的行用beginRemoveRows/endRemoveRows删除（连续的行合并为一次）
+         * 2. 仍然存在的行原地更新，只对值变化的单元格范围发射dataChanged
+         * 3. 新出现的行用beginInsertRows/endInsertRows追加到末尾
+         * 新数据中行标识重复的行只保留第一行。
+         */
+        void UpdateRows(std::vector<std::vector<QVariant>> rows, int key_column = 0)
+        {
+            auto key_of = [key_column](const std::vector<QVariant>& row, size_t position) {
+                return key_column >= 0 ? row[key_column].toString() : QString::number(position);
+            };
+
+            // 新数据中每个行标识第一次出现的位置
+            QHash<QString, size_t> incoming;
+            std::vector<bool> wanted(rows.size(), false);
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                QString key = key_of(rows[i], i);
+                if (!incoming.contains(key))
+                {
+                    incoming.insert(key, i);
+                    wanted[i] = true;
+                }
+            }
+
+            // 1. 从后往前删除消失的行
+            for (int row = static_cast<int>(monitor_data_.size()) - 1; row >= 0; --row)
+            {
+                if (incoming.contains(key_of(monitor_data_[row], row)))
+                {
+                    continue;
+                }
+                int first = row;
+                while (first > 0 && !incoming.contains(key_of(monitor_data_[first - 1], first - 1)))
+                {
+                    --first;
+                }
+                beginRemoveRows(QModelIndex(), first, row);
+                monitor_data_.erase(monitor_data_.begin() + first, monitor_data_.begin() + row + 1);
+                endRemoveRows();
+                row = first;
+            }
+
+            // 2. 原地更新仍然存在的行
+            for (size_t row = 0; row < monitor_data_.size(); ++row)
+            {
+                const size_t from = incoming.value(key_of(monitor_data_[row], row));
+                wanted[from] = false;
+                UpdateRow(static_cast<int>(row), std::move(rows[from]));
+            }
+
+            // 3. 追加新出现的行
+            std::vector<size_t> added;
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                if (wanted[i])
+                {
+                    added.push_back(i);
+                }
+            }
+            if (!added.empty())
+            {
+                const int first = static_cast<int>(monitor_data_.size());
+                beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+                for (size_t i : added)
+                {
+                    monitor_data_.push_back(std::move(rows[i]));
+                }
+                endInsertRows();
+            }
+        }
+
+        /**
+         * @brief 原地更新一行
+         * @param row 行号（必须是已有的行）
+         * @param next 该行的新数据
+         *
+         * 只对值变化的单元格范围发射一次dataChanged，值没有变化时不通知视图。
+         */
+        void UpdateRow(int row, std::vector<QVariant> next)
+        {
+            std::vector<QVariant>& current = monitor_data_[row];
+            int first_changed = -1;
+            int last_changed = -1;
+            for (size_t column = 0; column < next.size(); ++column)
+            {
+                if (column >= current.size() || current[column] != next[column])
+                {
+                    if (first_changed < 0)
+                    {
+                        first_changed = static_cast<int>(column);
+                    }
+                    last_changed = static_cast<int>(column);
+                }
+            }
+            current = std::move(next);
+            if (first_changed >= 0)
+            {
+                emit dataChanged(index(row, first_changed), index(row, last_changed), {Qt::DisplayRole});
+            }
+        }
+
+        /// @brief 数据存储容器：二维向量，外层为行，内层为列（由派生类定义列的含义）
+        std::vector<std::vector<QVariant>> monitor_data_;
     };
 }  // namespace monitor
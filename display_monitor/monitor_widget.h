@@ -3,14 +3,20 @@
 
 #include <QStandardItemModel>    // Qt标准项模型（未直接使用，可移除）
 #include <QtWidgets>             // Qt窗口部件模块（包含常用UI组件）
+#include <chrono>                // 历史查询的时间区间
 #include <thread>                // C++线程支持
 #include <string>                // C++字符串支持
+#include <utility>               // std::pair
+#include <vector>                // 历史查询列表
 
 #include "cpu_load_model.h"      // CPU负载数据模型
 #include "cpu_softirq_model.h"   // CPU软中断数据模型（未直接使用）
 #include "cpu_stat_model.h"      // CPU状态数据模型
+#include "fleet_model.h"         // 集群总览数据模型
+#include "history_chart.h"       // 滚动历史曲线图
 #include "mem_model.h"           // 内存数据模型
 #include "net_model.h"           // 网络数据模型
+#include "request_worker.h"      // 后台请求线程
 
 // 包含Protobuf和gRPC生成的头文件
 #include "monitor_info.grpc.pb.h"
@@ -23,6 +29,12 @@ namespace monitor
      *
      * 继承自QWidget，是监控系统的用户界面主控制器
      * 负责整合所有监控模型和视图，提供页面切换和数据显示功能
+     *
+     * 历史页面显示每个CPU的使用率和每块网卡的收发速率最近一小时的曲线：
+     * 收到一台主机的第一份采样时用QueryRange从服务器回填历史（在后台请求线程上），之后追加实时采样。
+     *
+     * 提供RPC客户端时额外有一个集群总览页面：每台主机一行，单击某一行切换到该主机的详细页面，
+     * 并发射HostSelected，由调用者把数据订阅切换到该主机。
      */
     class MonitorWidget : public QWidget
     {
@@ -39,12 +51,19 @@ namespace monitor
         /// @brief 析构函数，确保正确释放资源
         ~MonitorWidget() {}
 
+        /// @brief 历史页面在堆叠布局中的索引
+        static constexpr int kHistoryPage = 4;
+
+        /// @brief 集群总览页面在堆叠布局中的索引
+        static constexpr int kFleetPage = 5;
+
         /**
          * @brief 创建并显示完整的监控界面
          * @param name 主机名或用户标识，用于按钮标签
+         * @param rpc_client RPC客户端，为空时不创建集群总览页面
          * @return 返回包含完整界面的QWidget指针
          */
-        QWidget* ShowAllMonitorWidget(const std::string& name);
+        QWidget* ShowAllMonitorWidget(const std::string& name, RpcClient* rpc_client = nullptr);
 
         /**
          * @brief 初始化CPU监控页面
@@ -70,6 +89,19 @@ namespace monitor
          */
         QWidget* InitNetMonitorWidget();
 
+        /**
+         * @brief 初始化历史页面
+         * @return 包含CPU和网卡历史曲线的窗口部件
+         */
+        QWidget* InitHistoryMonitorWidget();
+
+        /**
+         * @brief 初始化集群总览页面
+         * @param rpc_client RPC客户端
+         * @return 包含所有主机概要的窗口部件
+         */
+        QWidget* InitFleetMonitorWidget(RpcClient* rpc_client);
+
         /**
          * @brief 初始化按钮菜单
          * @param name 主机名或用户标识
@@ -85,6 +117,19 @@ namespace monitor
          */
         void UpdateData(const monitor::proto::MonitorInfo& monitor_info);
 
+        /**
+         * @brief 更新详细页面按钮上显示的主机名
+         * @param name 主机名
+         */
+        void SetHostName(const std::string& name);
+
+    signals:
+        /**
+         * @brief 在集群总览中选中了一台主机
+         * @param host 主机名
+         */
+        void HostSelected(const QString& host);
+
     private slots:
         /// @brief CPU按钮点击槽函数，切换到CPU监控页面
         void ClickCpuButton();
@@ -98,13 +143,41 @@ namespace monitor
         /// @brief 网络按钮点击槽函数，切换到网络监控页面
         void ClickNetButton();
 
+        /// @brief 历史按钮点击槽函数，切换到历史页面
+        void ClickHistoryButton();
+
+        /// @brief 集群总览按钮点击槽函数，切换到集群总览页面
+        void ClickFleetButton();
+
+        /**
+         * @brief 集群总览行点击槽函数，切换到该主机的详细页面
+         * @param index 被点击的单元格
+         */
+        void ClickFleetRow(const QModelIndex& index);
+
+        /// @brief 刷新集群总览中可见行的概要（定时器和滚动时调用）
+        void RefreshFleet();
+
     private:
+        /**
+         * @brief 向服务器请求一台主机的历史并回填曲线
+         * @param monitor_info 该主机的第一份采样（用于确定CPU和网卡实例）
+         */
+        void LoadHistory(const monitor::proto::MonitorInfo& monitor_info);
+
+        /**
+         * @brief 把实时采样追加到历史曲线
+         * @param monitor_info 采样
+         */
+        void AppendHistory(const monitor::proto::MonitorInfo& monitor_info);
+
         // 表格视图指针
         QTableView* monitor_view_ = nullptr;        ///< 软中断监控表格视图
         QTableView* cpu_load_monitor_view_ = nullptr; ///< CPU负载监控表格视图
         QTableView* cpu_stat_monitor_view_ = nullptr; ///< CPU状态监控表格视图
         QTableView* mem_monitor_view_ = nullptr;    ///< 内存监控表格视图
         QTableView* net_monitor_view_ = nullptr;    ///< 网络监控表格视图
+        QTableView* fleet_monitor_view_ = nullptr;  ///< 集群总览表格视图
 
         // 数据模型指针
         MonitorBaseModel* monitor_model_ = nullptr; ///< 软中断数据模型
@@ -112,6 +185,26 @@ namespace monitor
         CpuStatModel* cpu_stat_model_ = nullptr;    ///< CPU状态数据模型
         MemModel* mem_model_ = nullptr;             ///< 内存数据模型
         NetModel* net_model_ = nullptr;             ///< 网络数据模型
+        FleetModel* fleet_model_ = nullptr;         ///< 集群总览数据模型
+
+        // 详细页面按钮（标签中带主机名）
+        QPushButton* cpu_button_ = nullptr;         ///< CPU页面按钮
+        QPushButton* soft_irq_button_ = nullptr;    ///< 软中断页面按钮
+        QPushButton* mem_button_ = nullptr;         ///< 内存页面按钮
+        QPushButton* net_button_ = nullptr;         ///< 网络页面按钮
+        QPushButton* history_button_ = nullptr;     ///< 历史页面按钮
+
+        // 历史曲线
+        HistoryChart* cpu_history_chart_ = nullptr; ///< 每个CPU的使用率曲线
+        HistoryChart* net_history_chart_ = nullptr; ///< 每块网卡的收发速率曲线
+        std::string history_host_;                  ///< 曲线当前对应的主机
+        RpcClient* rpc_client_ = nullptr;           ///< 回填历史使用的RPC客户端（可为空）
+
+        /// @brief 集群总览刷新定时器
+        QTimer* fleet_timer_ = nullptr;
+
+        /// @brief 执行历史查询的请求线程（最后声明，最先析构）
+        RequestWorker history_worker_;
 
         /// @brief 堆叠布局，用于页面切换
         QStackedLayout* stack_menu_ = nullptr;
@@ -131,12 +224,14 @@ namespace monitor
     /**
      * @brief 创建并显示完整的监控界面
      * @param name 主机名或用户标识
+     * @param rpc_client RPC客户端，为空时不创建集群总览页面
      * @return 包含完整界面的QWidget指针
      */
-    inline QWidget* MonitorWidget::ShowAllMonitorWidget(const std::string& name)
+    inline QWidget* MonitorWidget::ShowAllMonitorWidget(const std::string& name, RpcClient* rpc_client)
     {
         // 创建主窗口部件
         QWidget* widget = new QWidget();
+        rpc_client_ = rpc_client;
 
         // 创建堆叠布局，用于切换不同监控页面
         stack_menu_ = new QStackedLayout();
@@ -146,6 +241,11 @@ namespace monitor
         stack_menu_->addWidget(InitSoftIrqMonitorWidget());   // 索引1: 软中断监控
         stack_menu_->addWidget(InitMemMonitorWidget());       // 索引2: 内存监控
         stack_menu_->addWidget(InitNetMonitorWidget());       // 索引3: 网络监控
+        stack_menu_->addWidget(InitHistoryMonitorWidget());   // 索引4: 历史曲线
+        if (rpc_client != nullptr)
+        {
+            stack_menu_->addWidget(InitFleetMonitorWidget(rpc_client));   // 索引5: 集群总览
+        }
 
         // 创建网格布局作为主布局
         QGridLayout* layout = new QGridLayout(this);
@@ -168,39 +268,49 @@ namespace monitor
      */
     inline QWidget* MonitorWidget::InitButtonMenu(const std::string& name)
     {
-        // 创建四个导航按钮
-        QPushButton* cpu_button = new QPushButton(
-            tr("CPU (%1)").arg(QString::fromStdString(name)), this);
-        QPushButton* soft_irq_button = new QPushButton(
-            tr("SoftIRQ (%1)").arg(QString::fromStdString(name)), this);
-        QPushButton* mem_button = new QPushButton(
-            tr("Memory (%1)").arg(QString::fromStdString(name)), this);
-        QPushButton* net_button = new QPushButton(
-            tr("Network (%1)").arg(QString::fromStdString(name)), this);
+        // 创建五个导航按钮（标签由SetHostName设置）
+        cpu_button_ = new QPushButton(this);
+        soft_irq_button_ = new QPushButton(this);
+        mem_button_ = new QPushButton(this);
+        net_button_ = new QPushButton(this);
+        history_button_ = new QPushButton(this);
+        SetHostName(name);
 
         // 设置按钮字体
         QFont* font = new QFont("Microsoft YaHei", 15, 40);  // 微软雅黑，15号，正常粗细
-        cpu_button->setFont(*font);
-        soft_irq_button->setFont(*font);
-        mem_button->setFont(*font);
-        net_button->setFont(*font);
+        cpu_button_->setFont(*font);
+        soft_irq_button_->setFont(*font);
+        mem_button_->setFont(*font);
+        net_button_->setFont(*font);
+        history_button_->setFont(*font);
 
         // 创建水平布局放置按钮
         QHBoxLayout* layout = new QHBoxLayout();
-        layout->addWidget(cpu_button);
-        layout->addWidget(soft_irq_button);
-        layout->addWidget(mem_button);
-        layout->addWidget(net_button);
+        layout->addWidget(cpu_button_);
+        layout->addWidget(soft_irq_button_);
+        layout->addWidget(mem_button_);
+        layout->addWidget(net_button_);
+        layout->addWidget(history_button_);
+
+        // 有集群总览页面时增加总览按钮
+        if (fleet_model_ != nullptr)
+        {
+            QPushButton* fleet_button = new QPushButton(tr("Fleet"), this);
+            fleet_button->setFont(*font);
+            layout->addWidget(fleet_button);
+            connect(fleet_button, SIGNAL(clicked()), this, SLOT(ClickFleetButton()));
+        }
 
         // 创建容器部件并设置布局
         QWidget* widget = new QWidget();
         widget->setLayout(layout);
 
         // 连接按钮点击信号到槽函数
-        connect(cpu_button, SIGNAL(clicked()), this, SLOT(ClickCpuButton()));
-        connect(soft_irq_button, SIGNAL(clicked()), this, SLOT(ClickSoftIrqButton()));
-        connect(mem_button, SIGNAL(clicked()), this, SLOT(ClickMemButton()));
-        connect(net_button, SIGNAL(clicked()), this, SLOT(ClickNetButton()));
+        connect(cpu_button_, SIGNAL(clicked()), this, SLOT(ClickCpuButton()));
+        connect(soft_irq_button_, SIGNAL(clicked()), this, SLOT(ClickSoftIrqButton()));
+        connect(mem_button_, SIGNAL(clicked()), this, SLOT(ClickMemButton()));
+        connect(net_button_, SIGNAL(clicked()), this, SLOT(ClickNetButton()));
+        connect(history_button_, SIGNAL(clicked()), this, SLOT(ClickHistoryButton()));
 
         return widget;
     }
@@ -338,6 +448,69 @@ namespace monitor
         return widget;
     }
 
+    /**
+     * @brief 初始化历史页面
+     * @return 包含CPU和网卡历史曲线的窗口部件
+     */
+    inline QWidget* MonitorWidget::InitHistoryMonitorWidget()
+    {
+        QWidget* widget = new QWidget();
+
+        // CPU使用率固定0~100%，网卡速率按可见数据自动缩放
+        cpu_history_chart_ = new HistoryChart(tr("CPU utilization (last hour)"), "%", 100);
+        net_history_chart_ = new HistoryChart(tr("NIC throughput (last hour)"), " KB/s");
+
+        // 创建网格布局
+        QGridLayout* layout = new QGridLayout();
+        layout->addWidget(cpu_history_chart_, 1, 0);
+        layout->addWidget(net_history_chart_, 2, 0);
+
+        widget->setLayout(layout);
+        return widget;
+    }
+
+    /**
+     * @brief 初始化集群总览页面
+     * @param rpc_client RPC客户端
+     * @return 包含所有主机概要的窗口部件
+     *
+     * 表格按主机名排序、由模型按需分页加载，不使用排序代理（排序需要先加载全部行）。
+     * 每2秒以及滚动时只刷新可见行的概要。
+     */
+    inline QWidget* MonitorWidget::InitFleetMonitorWidget(RpcClient* rpc_client)
+    {
+        QWidget* widget = new QWidget();
+
+        // 集群总览标签
+        QLabel* fleet_label = new QLabel(this);
+        fleet_label->setText(tr("Monitor fleet (click a host for details):"));
+        fleet_label->setFont(QFont("Microsoft YaHei", 10, 40));
+
+        // 集群总览表格（整行选择，单击打开主机详情）
+        fleet_monitor_view_ = new QTableView;
+        fleet_model_ = new FleetModel(rpc_client, this);
+        fleet_monitor_view_->setModel(fleet_model_);
+        fleet_monitor_view_->setSelectionBehavior(QAbstractItemView::SelectRows);
+        fleet_monitor_view_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        fleet_monitor_view_->show();
+
+        connect(fleet_monitor_view_, SIGNAL(clicked(QModelIndex)), this, SLOT(ClickFleetRow(QModelIndex)));
+        connect(fleet_monitor_view_->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(RefreshFleet()));
+
+        // 定时刷新可见行（不在总览页面时不请求）
+        fleet_timer_ = new QTimer(this);
+        connect(fleet_timer_, SIGNAL(timeout()), this, SLOT(RefreshFleet()));
+        fleet_timer_->start(2000);
+
+        // 创建网格布局
+        QGridLayout* layout = new QGridLayout();
+        layout->addWidget(fleet_label, 1, 0);
+        layout->addWidget(fleet_monitor_view_, 2, 0, 1, 1);
+
+        widget->setLayout(layout);
+        return widget;
+    }
+
     /**
      * @brief 更新所有监控数据
      * @param monitor_info Protobuf格式的监控数据
@@ -351,6 +524,120 @@ namespace monitor
         cpu_stat_model_->UpdateMonitorInfo(monitor_info);     // CPU状态
         mem_model_->UpdateMonitorInfo(monitor_info);          // 内存
         net_model_->UpdateMonitorInfo(monitor_info);          // 网络
+
+        // 换了主机：清空曲线并回填新主机的历史
+        if (monitor_info.name() != history_host_)
+        {
+            history_host_ = monitor_info.name();
+            cpu_history_chart_->Clear();
+            net_history_chart_->Clear();
+            LoadHistory(monitor_info);
+        }
+        AppendHistory(monitor_info);
+    }
+
+    /**
+     * @brief 向服务器请求一台主机的历史并回填曲线
+     * @param monitor_info 该主机的第一份采样
+     *
+     * 每个CPU的cpu_percent、每块网卡的send_rate和rcv_rate各一次QueryRange，
+     * 在请求线程上依次执行，全部完成后一次性投递回GUI线程；
+     * 结果到达前又换了主机时丢弃。
+     */
+    inline void MonitorWidget::LoadHistory(const monitor::proto::MonitorInfo& monitor_info)
+    {
+        if (rpc_client_ == nullptr || monitor_info.name().empty())
+        {
+            return;
+        }
+
+        // 一条待回填的序列：是否为CPU曲线、序列名、指标名、实例名
+        struct Query
+        {
+            bool cpu;
+            QString series;
+            std::string metric;
+            std::string instance;
+        };
+        std::vector<Query> queries;
+        for (const auto& cpu : monitor_info.cpu_stat())
+        {
+            queries.push_back({true, QString::fromStdString(cpu.cpu_name()), "cpu_stat.cpu_percent", cpu.cpu_name()});
+        }
+        for (const auto& net : monitor_info.net_info())
+        {
+            queries.push_back({false, QString::fromStdString(net.name() + " tx"), "net_info.send_rate", net.name()});
+            queries.push_back({false, QString::fromStdString(net.name() + " rx"), "net_info.rcv_rate", net.name()});
+        }
+
+        const std::string host = monitor_info.name();
+        const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        history_worker_.Post([this, host, now_ms, queries = std::move(queries)]() {
+            std::vector<std::pair<size_t, monitor::proto::RangeResponse>> results;
+            monitor::proto::RangeRequest request;
+            request.set_host(host);
+            request.set_t0_ms(now_ms - HistoryChart::kWindowMs);
+            request.set_t1_ms(now_ms);
+            for (size_t i = 0; i < queries.size(); ++i)
+            {
+                request.set_metric(queries[i].metric);
+                request.set_instance(queries[i].instance);
+                monitor::proto::RangeResponse response;
+                if (rpc_client_->QueryRange(request, &response))
+                {
+                    results.emplace_back(i, std::move(response));
+                }
+            }
+            QMetaObject::invokeMethod(this, [this, host, queries, results = std::move(results)]() {
+                if (host != history_host_)
+                {
+                    return;   // 已切换到其他主机
+                }
+                for (const auto& result : results)
+                {
+                    const Query& query = queries[result.first];
+                    (query.cpu ? cpu_history_chart_ : net_history_chart_)->Backfill(query.series, result.second);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    /**
+     * @brief 把实时采样追加到历史曲线
+     * @param monitor_info 采样（没有时间戳时使用本地时间）
+     */
+    inline void MonitorWidget::AppendHistory(const monitor::proto::MonitorInfo& monitor_info)
+    {
+        int64_t timestamp_ms = monitor_info.timestamp_ms();
+        if (timestamp_ms == 0)
+        {
+            timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+        for (const auto& cpu : monitor_info.cpu_stat())
+        {
+            cpu_history_chart_->Append(QString::fromStdString(cpu.cpu_name()), timestamp_ms, cpu.cpu_percent());
+        }
+        for (const auto& net : monitor_info.net_info())
+        {
+            net_history_chart_->Append(QString::fromStdString(net.name() + " tx"), timestamp_ms, net.send_rate());
+            net_history_chart_->Append(QString::fromStdString(net.name() + " rx"), timestamp_ms, net.rcv_rate());
+        }
+    }
+
+    /**
+     * @brief 更新详细页面按钮上显示的主机名
+     * @param name 主机名
+     */
+    inline void MonitorWidget::SetHostName(const std::string& name)
+    {
+        const QString host = QString::fromStdString(name);
+        cpu_button_->setText(tr("CPU (%1)").arg(host));
+        soft_irq_button_->setText(tr("SoftIRQ (%1)").arg(host));
+        mem_button_->setText(tr("Memory (%1)").arg(host));
+        net_button_->setText(tr("Network (%1)").arg(host));
+        history_button_->setText(tr("History (%1)").arg(host));
     }
 
     /**
@@ -388,4 +675,69 @@ namespace monitor
     {
         stack_menu_->setCurrentIndex(3);
     }
+
+    /**
+     * @brief 历史按钮点击槽函数
+     * 切换到历史页面（堆叠布局索引4）
+     */
+    inline void MonitorWidget::ClickHistoryButton()
+    {
+        stack_menu_->setCurrentIndex(kHistoryPage);
+    }
+
+    /**
+     * @brief 集群总览按钮点击槽函数
+     * 切换到集群总览页面（堆叠布局索引5）并立即刷新可见行
+     */
+    inline void MonitorWidget::ClickFleetButton()
+    {
+        stack_menu_->setCurrentIndex(kFleetPage);
+        RefreshFleet();
+    }
+
+    /**
+     * @brief 集群总览行点击槽函数
+     * @param index 被点击的单元格
+     */
+    inline void MonitorWidget::ClickFleetRow(const QModelIndex& index)
+    {
+        const QString host = fleet_model_->HostAt(index.row());
+        if (host.isEmpty())
+        {
+            return;
+        }
+        SetHostName(host.toStdString());
+        stack_menu_->setCurrentIndex(0);   // 打开该主机的CPU页面
+        emit HostSelected(host);
+    }
+
+    /**
+     * @brief 刷新集群总览中可见行的概要
+     *
+     * 视口下方还有空白（最后一行可见）时加载下一页主机，然后只为可见范围请求概要。
+     */
+    inline void MonitorWidget::RefreshFleet()
+    {
+        if (fleet_model_ == nullptr || stack_menu_->currentIndex() != kFleetPage)
+        {
+            return;
+        }
+
+        const int rows = fleet_model_->rowCount();
+        int first = fleet_monitor_view_->rowAt(0);
+        int last = fleet_monitor_view_->rowAt(fleet_monitor_view_->viewport()->height() - 1);
+        if (last < 0 || last == rows - 1)
+        {
+            last = rows - 1;
+            if (fleet_model_->canFetchMore(QModelIndex()))
+            {
+                fleet_model_->fetchMore(QModelIndex());
+            }
+        }
+        if (first < 0)
+        {
+            first = 0;
+        }
+        fleet_model_->RequestSummaries(first, last);
+    }
 }  // namespace monitor
@@ -27,12 +27,16 @@ namespace monitor
          */
         explicit NetModel(QObject* parent = nullptr) : MonitorInterModel(parent)
         {
-            // 初始化表格列标题（5列）
+            // 初始化表格列标题（9列）
             header_ << tr("name");               // 网络接口名称
             header_ << tr("send_rate");          // 发送速率（KB/s）
             header_ << tr("rcv_rate");           // 接收速率（KB/s）
             header_ << tr("send_packets_rate");  // 发送数据包速率（包/秒）
             header_ << tr("rcv_packets_rate");   // 接收数据包速率（包/秒）
+            header_ << tr("rcv_errors_rate");    // 接收错误速率（个/秒）
+            header_ << tr("send_errors_rate");   // 发送错误速率（个/秒）
+            header_ << tr("rcv_drop_rate");      // 接收丢包速率（个/秒）
+            header_ << tr("send_drop_rate");     // 发送丢包速率（个/秒）
         }
 
         /// @brief 虚析构函数，确保正确释放资源
@@ -112,42 +116,27 @@ namespace monitor
          */
         void UpdateMonitorInfo(const monitor::proto::MonitorInfo& monitor_info)
         {
-            // 通知视图开始模型重置
-            beginResetModel();
-
-            // 清空现有数据
-            monitor_data_.clear();
+            std::vector<std::vector<QVariant>> rows;
+            rows.reserve(monitor_info.net_info_size());
 
             // 遍历所有网络接口数据
             for (int i = 0; i < monitor_info.net_info_size(); i++)
             {
                 // 转换并添加每个网络接口的数据
-                monitor_data_.push_back(insert_one_net_info(monitor_info.net_info(i)));
+                rows.push_back(insert_one_net_info(monitor_info.net_info(i)));
             }
 
-            // 通知视图重置完成
-            endResetModel();
+            // 按网卡名增量更新，只通知变化的单元格
+            UpdateRows(std::move(rows), NetModelInfo::NAME);
 
             return;
         }
 
-    signals:
-        /**
-         * @brief 数据变化信号
-         * @param topLeft 变化区域左上角索引
-         * @param bottomRight 变化区域右下角索引
-         * @param roles 变化的角色列表
-         *
-         * 当模型数据发生变化时发射，通知连接的视图更新显示
-         */
-        void dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
-            const QVector<int>& roles);
-
     private:
         /**
          * @brief 转换单个网络接口的数据
          * @param net_info Protobuf的NetInfo消息
-         * @return 包含5个字段的QVariant向量
+         * @return 包含9个字段的QVariant向量
          *
          * 辅助方法，将Protobuf消息转换为模型内部数据结构
          * 处理网络接口名称和流量统计信息
@@ -182,6 +171,22 @@ namespace monitor
                         // 接收数据包速率（包/秒）
                         net_info_list.push_back(QVariant(net_info.rcv_packets_rate()));
                         break;
+                    case NetModelInfo::RCV_ERRORS_RATE:
+                        // 接收错误速率（个/秒）
+                        net_info_list.push_back(QVariant(net_info.rcv_errors_rate()));
+                        break;
+                    case NetModelInfo::SEND_ERRORS_RATE:
+                        // 发送错误速率（个/秒）
+                        net_info_list.push_back(QVariant(net_info.send_errors_rate()));
+                        break;
+                    case NetModelInfo::RCV_DROP_RATE:
+                        // 接收丢包速率（个/秒）
+                        net_info_list.push_back(QVariant(net_info.rcv_drop_rate()));
+                        break;
+                    case NetModelInfo::SEND_DROP_RATE:
+                        // 发送丢包速率（个/秒）
+                        net_info_list.push_back(QVariant(net_info.send_drop_rate()));
+                        break;
                     default:
                         break;  // 枚举完整性保证不会执行到此处
                 }
@@ -189,10 +194,7 @@ namespace monitor
             return net_info_list;
         }
 
-        /// @brief 数据存储容器：二维向量，外层为行（每个网络接口），内层为列（5个字段）
-        std::vector<std::vector<QVariant>> monitor_data_;
-
-        /// @brief 表头字符串列表，支持国际化，包含5个列标题
+        /// @brief 表头字符串列表，支持国际化，包含9个列标题
         QStringList header_;
 
         /**
@@ -208,6 +210,10 @@ namespace monitor
             RCV_RATE,                 ///< 接收速率列（KB/s）
             SEND_PACKETS_RATE,        ///< 发送数据包速率列（包/秒）
             RCV_PACKETS_RATE,         ///< 接收数据包速率列（包/秒）
+            RCV_ERRORS_RATE,          ///< 接收错误速率列（个/秒）
+            SEND_ERRORS_RATE,         ///< 发送错误速率列（个/秒）
+            RCV_DROP_RATE,            ///< 接收丢包速率列（个/秒）
+            SEND_DROP_RATE,           ///< 发送丢包速率列（个/秒）
             COLUMN_MAX                ///< 列总数，用于循环终止条件
         };
     };
@@ -0,0 +1,82 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <condition_variable>   // 新任务通知
+#include <deque>                // 任务队列
+#include <functional>           // 任务
+#include <mutex>                // 保护任务队列
+#include <thread>               // 请求线程
+
+namespace monitor
+{
+    /**
+     * @brief 界面的后台请求线程
+     *
+     * 按提交顺序在一个线程上执行阻塞的RPC，界面不会被慢速服务器阻塞。
+     * 任务把结果用QMetaObject::invokeMethod(context, ..., Qt::QueuedConnection)投递回GUI线程，
+     * context对象析构后尚未执行的投递由Qt丢弃。
+     * 析构时等待正在执行的任务结束，尚未开始的任务直接丢弃。
+     */
+    class RequestWorker
+    {
+    public:
+        /// @brief 构造函数，启动请求线程
+        RequestWorker() : thread_([this]() { Run(); }) {}
+
+        RequestWorker(const RequestWorker&) = delete;
+        RequestWorker& operator=(const RequestWorker&) = delete;
+
+        /// @brief 析构函数，停止并等待请求线程
+        ~RequestWorker()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            cv_.notify_one();
+            thread_.join();
+        }
+
+        /**
+         * @brief 提交任务
+         * @param task 在请求线程上执行的任务
+         */
+        void Post(std::function<void()> task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.push_back(std::move(task));
+            }
+            cv_.notify_one();
+        }
+
+    private:
+        /**
+         * @brief 请求线程主循环：依次执行任务，直到析构
+         */
+        void Run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                if (stopping_)
+                {
+                    return;
+                }
+                std::function<void()> task = std::move(tasks_.front());
+                tasks_.pop_front();
+
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex_;                          ///< 保护以下成员
+        std::condition_variable cv_;                ///< 新任务或停止通知
+        std::deque<std::function<void()>> tasks_;   ///< 待执行的任务
+        bool stopping_ = false;                     ///< 停止标志
+        std::thread thread_;                        ///< 请求线程（最后初始化）
+    };
+}  // namespace monitor
@@ -0,0 +1,83 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <atomic>                 // 无锁的单槽交换
+#include <memory>                 // std::unique_ptr
+#include "monitor_info.pb.h"      // Protobuf生成代码
+
+namespace monitor
+{
+    /**
+     * @brief RPC线程到GUI线程的单槽邮箱
+     *
+     * RPC线程把收到的采样放入邮箱，GUI线程取出后更新界面，两个线程不共享同一条消息：
+     * - 单槽：邮箱里最多一条采样，GUI来不及处理时新采样直接替换旧采样，只应用最新的一条
+     * - 无锁：放入和取出都是一次原子交换，RPC线程不会被GUI线程阻塞
+     * - 复用：GUI线程用完的消息放回备用槽，RPC线程下次从备用槽取，稳态下不分配消息
+     *
+     * 通知：Publish在邮箱原本为空时返回true，调用者此时向GUI线程投递一次取出操作；
+     * 邮箱非空说明已有一次取出在排队，它会取到最新的采样，不需要重复投递。
+     */
+    class SampleMailbox
+    {
+    public:
+        SampleMailbox() = default;
+        SampleMailbox(const SampleMailbox&) = delete;
+        SampleMailbox& operator=(const SampleMailbox&) = delete;
+
+        /// @brief 析构函数，释放槽中的消息
+        ~SampleMailbox()
+        {
+            delete slot_.exchange(nullptr);
+            delete spare_.exchange(nullptr);
+        }
+
+        /**
+         * @brief 获取一条可写的消息（RPC线程）
+         * @return std::unique_ptr<monitor::proto::MonitorInfo> 备用槽中的消息，备用槽为空时新建
+         */
+        std::unique_ptr<monitor::proto::MonitorInfo> Acquire()
+        {
+            monitor::proto::MonitorInfo* spare = spare_.exchange(nullptr, std::memory_order_acquire);
+            return std::unique_ptr<monitor::proto::MonitorInfo>(spare ? spare : new monitor::proto::MonitorInfo());
+        }
+
+        /**
+         * @brief 放入一条采样（RPC线程）
+         * @param sample 采样消息
+         * @return bool 邮箱原本为空返回true，调用者需要通知GUI线程取出
+         */
+        bool Publish(std::unique_ptr<monitor::proto::MonitorInfo> sample)
+        {
+            monitor::proto::MonitorInfo* replaced = slot_.exchange(sample.release(), std::memory_order_acq_rel);
+            if (replaced == nullptr)
+            {
+                return true;
+            }
+            Recycle(std::unique_ptr<monitor::proto::MonitorInfo>(replaced));   // 被替换的旧采样不再应用
+            return false;
+        }
+
+        /**
+         * @brief 取出最新的采样（GUI线程）
+         * @return std::unique_ptr<monitor::proto::MonitorInfo> 最新采样，邮箱为空时返回空指针
+         */
+        std::unique_ptr<monitor::proto::MonitorInfo> Take()
+        {
+            return std::unique_ptr<monitor::proto::MonitorInfo>(slot_.exchange(nullptr, std::memory_order_acq_rel));
+        }
+
+        /**
+         * @brief 归还用完的消息，供下一次Acquire复用（任意线程）
+         * @param sample 不再使用的消息
+         */
+        void Recycle(std::unique_ptr<monitor::proto::MonitorInfo> sample)
+        {
+            delete spare_.exchange(sample.release(), std::memory_order_acq_rel);   // 备用槽已满时释放旧的
+        }
+
+    private:
+        std::atomic<monitor::proto::MonitorInfo*> slot_{nullptr};   ///< 等待GUI线程应用的最新采样
+        std::atomic<monitor::proto::MonitorInfo*> spare_{nullptr};  ///< 可复用的空闲消息
+    };
+}  // namespace monitor
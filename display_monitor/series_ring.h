@@ -0,0 +1,302 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <algorithm>   // std::lower_bound, std::copy_n
+#include <cmath>       // std::fabs
+#include <cstddef>     // size_t
+#include <cstdint>     // int64_t
+#include <vector>      // 列存储
+
+namespace monitor
+{
+    /**
+     * @brief 查找区间内最小值和最大值的下标
+     * @param values 值数组
+     * @param begin 区间起点（包含）
+     * @param end 区间终点（不包含，必须大于begin）
+     * @param low 输出参数，最小值的下标（相同值取最早的）
+     * @param high 输出参数，最大值的下标（相同值取最早的）
+     *
+     * 比较写成条件赋值，并把当前极值保存在寄存器里：
+     * 随机数据上没有分支预测失败，循环依赖链上也没有按下标的回读。
+     */
+    inline void MinMaxIndex(const float* values, size_t begin, size_t end, size_t* low, size_t* high)
+    {
+        float min_value = values[begin];
+        float max_value = values[begin];
+        size_t min_index = begin;
+        size_t max_index = begin;
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            const float value = values[i];
+            const bool lower = value < min_value;
+            const bool higher = value > max_value;
+            min_value = lower ? value : min_value;
+            min_index = lower ? i : min_index;
+            max_value = higher ? value : max_value;
+            max_index = higher ? i : max_index;
+        }
+        *low = min_index;
+        *high = max_index;
+    }
+
+    /**
+     * @brief 用MinMaxLTTB把一条序列降采样到指定点数
+     * @param times 原始点的时间（升序）
+     * @param values 原始点的值
+     * @param n 原始点数
+     * @param threshold 目标点数（通常为图表宽度的像素数）
+     * @param selected 输出参数，选中的点的下标（升序）
+     *
+     * 两步完成，总代价O(n)：
+     * 1. 预选：把内部的点均分为threshold * kMinMaxRatio / 2个桶，每个桶保留最小值和最大值
+     * 2. LTTB：在预选出的点上按"最大三角形面积"为每个输出桶选一个点
+     * 首尾两点和全局的最大值、最小值总是保留（最多超出threshold两个点），
+     * 尖峰不会因为降采样而被抹平。n不超过threshold时原样返回所有下标。
+     */
+    inline void MinMaxLttb(const int64_t* times, const float* values, size_t n, size_t threshold,
+                           std::vector<size_t>* selected)
+    {
+        /// @brief 预选点数与目标点数之比
+        constexpr size_t kMinMaxRatio = 4;
+
+        selected->clear();
+        if (threshold < 3 || n <= threshold)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                selected->push_back(i);
+            }
+            return;
+        }
+
+        // 全局极值
+        size_t global_min = 0;
+        size_t global_max = 0;
+        MinMaxIndex(values, 0, n, &global_min, &global_max);
+
+        // 1. 预选：每个桶的最小值和最大值（按时间顺序）；点数不多时跳过，直接在原始点上做LTTB
+        std::vector<size_t> candidates;
+
+        const size_t interior = n - 2;
+        const size_t minmax_buckets = threshold * kMinMaxRatio / 2;
+        if (interior > minmax_buckets * 2)
+        {
+            candidates.reserve(minmax_buckets * 2 + 2);
+            candidates.push_back(0);
+            for (size_t bucket = 0; bucket < minmax_buckets; ++bucket)
+            {
+                const size_t begin = 1 + interior * bucket / minmax_buckets;
+                const size_t end = 1 + interior * (bucket + 1) / minmax_buckets;
+                if (begin >= end)
+                {
+                    continue;
+                }
+                size_t low = begin;
+                size_t high = begin;
+                MinMaxIndex(values, begin, end, &low, &high);
+                candidates.push_back(std::min(low, high));
+                if (low != high)
+                {
+                    candidates.push_back(std::max(low, high));
+                }
+            }
+            candidates.push_back(n - 1);
+        }
+        const bool preselected = !candidates.empty();
+        auto point = [&](size_t i) { return preselected ? candidates[i] : i; };
+
+        // 2. LTTB：每个桶选与上一个选中点、下一个桶平均点构成的三角形面积最大的点
+        const size_t m = preselected ? candidates.size() : n;
+        const double every = static_cast<double>(m - 2) / static_cast<double>(threshold - 2);
+        selected->reserve(threshold + 2);
+        selected->push_back(0);
+        size_t previous = 0;
+        for (size_t bucket = 0; bucket + 2 < threshold; ++bucket)
+        {
+            const size_t begin = static_cast<size_t>(bucket * every) + 1;
+            const size_t end = std::min(static_cast<size_t>((bucket + 1) * every) + 1, m - 1);
+
+            // 下一个桶的平均点（最后一个桶的下一个点是终点）
+            const size_t next_begin = end;
+            const size_t next_end = std::min(static_cast<size_t>((bucket + 2) * every) + 1, m);
+            double avg_t = 0;
+            double avg_v = 0;
+            for (size_t i = next_begin; i < next_end; ++i)
+            {
+                avg_t += static_cast<double>(times[point(i)]);
+                avg_v += values[point(i)];
+            }
+            const double count = static_cast<double>(std::max<size_t>(next_end - next_begin, 1));
+            avg_t /= count;
+            avg_v /= count;
+
+            const double prev_t = static_cast<double>(times[previous]);
+            const double prev_v = values[previous];
+            double best_area = -1;
+            size_t best = point(std::min(begin, m - 2));
+            for (size_t i = begin; i < end; ++i)
+            {
+                const size_t index = point(i);
+                const double area = std::fabs((prev_t - avg_t) * (values[index] - prev_v) -
+                                              (prev_t - static_cast<double>(times[index])) * (avg_v - prev_v));
+                best = area > best_area ? index : best;
+                best_area = std::max(area, best_area);
+            }
+            selected->push_back(best);
+            previous = best;
+        }
+        selected->push_back(n - 1);
+
+        // 全局极值总是保留
+        for (size_t extreme : {global_min, global_max})
+        {
+            auto iter = std::lower_bound(selected->begin(), selected->end(), extreme);
+            if (iter == selected->end() || *iter != extreme)
+            {
+                selected->insert(iter, extreme);
+            }
+        }
+    }
+
+    /**
+     * @brief 固定容量的时间序列环形缓冲区
+     *
+     * 时间戳和值按列分开存放，容量在构造时一次性分配，写满后覆盖最旧的点，稳态追加不分配内存。
+     * 点按时间严格递增，时间不晚于最新点的追加被忽略（历史回填与实时采样重叠时去重）。
+     */
+    class SeriesRing
+    {
+    public:
+        /// @brief 默认容量：1秒采样保存1小时
+        static constexpr size_t kDefaultCapacity = 3600;
+
+        /**
+         * @brief 构造函数
+         * @param capacity 最多保存的点数
+         */
+        explicit SeriesRing(size_t capacity = kDefaultCapacity)
+            : times_(capacity), values_(capacity) {}
+
+        /**
+         * @brief 追加一个点
+         * @param timestamp_ms 时间（Unix毫秒）
+         * @param value 值
+         * @return bool 时间晚于最新点、已追加时返回true
+         */
+        bool Append(int64_t timestamp_ms, float value)
+        {
+            if (times_.empty() || (size_ > 0 && timestamp_ms <= TimeAt(size_ - 1)))
+            {
+                return false;
+            }
+            const size_t slot = (head_ + size_) % times_.size();
+            times_[slot] = timestamp_ms;
+            values_[slot] = value;
+            if (size_ < times_.size())
+            {
+                ++size_;
+            }
+            else
+            {
+                head_ = (head_ + 1) % times_.size();   // 覆盖最旧的点
+            }
+            return true;
+        }
+
+        /// @brief 清空所有点（不释放容量）
+        void Clear()
+        {
+            head_ = 0;
+            size_ = 0;
+        }
+
+        /// @brief 当前点数
+        size_t Size() const { return size_; }
+
+        /// @brief 第i个点的时间（0为最旧的点）
+        int64_t TimeAt(size_t i) const { return times_[(head_ + i) % times_.size()]; }
+
+        /// @brief 第i个点的值（0为最旧的点）
+        float ValueAt(size_t i) const { return values_[(head_ + i) % times_.size()]; }
+
+        /**
+         * @brief 查找第一个时间不早于指定时间的点
+         * @param timestamp_ms 时间（Unix毫秒）
+         * @return size_t 点的下标，所有点都更早时返回Size()
+         */
+        size_t LowerBound(int64_t timestamp_ms) const
+        {
+            size_t low = 0;
+            size_t high = size_;
+            while (low < high)
+            {
+                const size_t mid = low + (high - low) / 2;
+                if (TimeAt(mid) < timestamp_ms)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            return low;
+        }
+
+        /**
+         * @brief 把时间区间内的点降采样到指定点数（MinMaxLttb）
+         * @param t0_ms 起始时间（包含）
+         * @param t1_ms 结束时间（包含）
+         * @param threshold 目标点数
+         * @param times 输出参数，选中的点的时间
+         * @param values 输出参数，选中的点的值
+         */
+        void Downsample(int64_t t0_ms, int64_t t1_ms, size_t threshold,
+                        std::vector<int64_t>* times, std::vector<float>* values) const
+        {
+            const size_t first = LowerBound(t0_ms);
+            size_t last = LowerBound(t1_ms);
+            if (last < size_ && TimeAt(last) == t1_ms)
+            {
+                ++last;
+            }
+
+            times->clear();
+            values->clear();
+            if (first >= last)
+            {
+                return;
+            }
+
+            // 区间内的点拷贝为连续数组（环形缓冲区最多分两段），降采样不再逐点取模
+            const size_t count = last - first;
+            window_times_.resize(count);
+            window_values_.resize(count);
+            const size_t begin = (head_ + first) % times_.size();
+            const size_t head_part = std::min(count, times_.size() - begin);
+            std::copy_n(times_.begin() + begin, head_part, window_times_.begin());
+            std::copy_n(values_.begin() + begin, head_part, window_values_.begin());
+            std::copy_n(times_.begin(), count - head_part, window_times_.begin() + head_part);
+            std::copy_n(values_.begin(), count - head_part, window_values_.begin() + head_part);
+
+            MinMaxLttb(window_times_.data(), window_values_.data(), count, threshold, &selected_);
+            times->reserve(selected_.size());
+            values->reserve(selected_.size());
+            for (size_t i : selected_)
+            {
+                times->push_back(window_times_[i]);
+                values->push_back(window_values_[i]);
+            }
+        }
+
+    private:
+        std::vector<int64_t> times_;           ///< 时间列（环形）
+        std::vector<float> values_;            ///< 值列（环形）
+        size_t head_ = 0;                      ///< 最旧的点所在的槽位
+        size_t size_ = 0;                      ///< 当前点数
+        mutable std::vector<int64_t> window_times_;  ///< 降采样区间的时间（连续，复用）
+        mutable std::vector<float> window_values_;   ///< 降采样区间的值（连续，复用）
+        mutable std::vector<size_t> selected_;       ///< 降采样的下标缓冲区（复用）
+    };
+}  // namespace monitor
@@ -0,0 +1,92 @@
+// 包含对应的头文件
+#include "alloc_counter.h"
+
+// C++标准库头文件
+#include <atomic>       // 计数器
+#include <cstdlib>      // std::malloc、std::aligned_alloc、std::free
+#include <new>          // std::bad_alloc、std::align_val_t、std::nothrow_t
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};   ///< 进程内operator new调用次数
+
+    /**
+     * @brief 计数并分配内存
+     * @param size 字节数
+     * @param alignment 对齐（0为默认对齐）
+     * @return void* 分配的内存，失败时为nullptr
+     */
+    void* CountedAlloc(std::size_t size, std::size_t alignment)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (size == 0)
+        {
+            size = 1;
+        }
+        if (alignment == 0)
+        {
+            return std::malloc(size);
+        }
+        // aligned_alloc要求大小是对齐的整数倍
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    /**
+     * @brief 计数并分配内存，失败时抛出std::bad_alloc
+     */
+    void* CountedAllocOrThrow(std::size_t size, std::size_t alignment)
+    {
+        if (void* p = CountedAlloc(size, alignment))
+        {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+}  // namespace
+
+namespace monitor
+{
+    uint64_t AllocationCount()
+    {
+        return g_allocations.load(std::memory_order_relaxed);
+    }
+}  // namespace monitor
+
+// ==================== 全局分配函数的替换 ====================
+// 所有版本都经malloc/aligned_alloc分配、free释放，任意new与delete的组合都匹配
+
+void* operator new(std::size_t size) { return CountedAllocOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return CountedAllocOrThrow(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size, 0); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
@@ -0,0 +1,25 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <cstdint>      // uint64_t
+
+namespace monitor
+{
+    /**
+     * @brief 获取进程启动以来operator new的调用次数（所有线程，基准测试用）
+     * @return uint64_t 调用次数
+     *
+     * alloc_counter.cpp替换全局的operator new/delete（普通、数组、nothrow、按对齐版本，
+     * 以及对应的sized delete），每次operator new计数一次后转交malloc/aligned_alloc，
+     * delete一律free，任意new与delete的组合都匹配。替换函数不能声明为inline，
+     * 需要统计分配次数的基准测试把alloc_counter.cpp加入源文件。
+     *
+     * 用法：
+     * @code
+     * const uint64_t before = AllocationCount();
+     * body();
+     * const uint64_t allocations = AllocationCount() - before;
+     * @endcode
+     */
+    uint64_t AllocationCount();
+}  // namespace monitor
@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "client/rpc_client.h"              // 复用槽位的发送队列
+#include "monitor/collector_scheduler.h"    // 批次Arena
+#include "monitor/cpu_load_monitor.h"
+#include "monitor/cpu_softirq_monitor.h"
+#include "monitor/cpu_stat_monitor.h"
+#include "monitor/mem_monitor.h"
+#include "monitor/net_monitor.h"
+#include "utils/arena_block_pool.h"         // Arena内存块池
+#include "alloc_counter.h"                  // 堆分配计数
+
+#include "monitor_info.pb.h"
+
+/**
+ * @brief 堆分配次数基准测试
+ *
+ * 用alloc_counter替换的全局operator new统计每个采样批次的堆分配次数（allocs_per_batch），
+ * 用来证明稳态采样路径不调用malloc：
+ * - Heap：原有做法，每个批次在栈上构造MonitorInfo，每个add_xxx()都是一次堆分配
+ * - Arena：每个批次在ArenaBlockPool支持的Arena上构造，结束时Reset
+ * - Scheduler：真实的监控器经CollectorScheduler::CollectAll采集并拷贝进RpcClient发送队列，
+ *   即采集端每个批次的完整路径（range为工作线程数）。剩余约2次分配来自发送队列槽位的CopyFrom：
+ *   proto3的Clear()会释放堆上消息的单值子消息（cpu_load、mem_info），随后重新创建
+ *
+ * 用法：./bin/arena_alloc_benchmark --benchmark_counters_tabular=true
+ */
+namespace
+{
+    constexpr int kCpus = 64;      ///< 模拟的CPU核心数
+    constexpr int kNics = 4;       ///< 模拟的网卡数
+
+    /**
+     * @brief 按采集器的方式填充一个完整的批次消息
+     */
+    void FillSample(monitor::proto::MonitorInfo* info, int tick)
+    {
+        // 名称只构造一次（预热阶段），与采集器复用名称字符串的做法一致
+        static const std::vector<std::string> kCpuNames = []() {
+            std::vector<std::string> names{"cpu"};
+            for (int c = 0; c < kCpus; ++c)
+            {
+                names.push_back("cpu" + std::to_string(c));
+            }
+            return names;
+        }();
+
+        info->set_name("benchmark_host");
+        for (int c = 0; c < kCpus; ++c)
+        {
+            auto* irq = info->add_soft_irq();
+            irq->set_cpu(kCpuNames[c + 1]);
+            irq->set_timer(1000.0f + tick);
+            irq->set_sched(500.0f + c);
+            irq->set_rcu(300.0f);
+        }
+        for (int c = 0; c <= kCpus; ++c)
+        {
+            auto* stat = info->add_cpu_stat();
+            stat->set_cpu_name(kCpuNames[c]);
+            stat->set_cpu_percent(12.5f);
+            stat->set_usr_percent(8.0f);
+            stat->set_system_percent(4.5f);
+            stat->set_idle_percent(87.5f);
+        }
+        for (int n = 0; n < kNics; ++n)
+        {
+            auto* net = info->add_net_info();
+            net->set_name(n == 0 ? "lo" : "eth");
+            net->set_send_rate(100.0f * n);
+            net->set_rcv_rate(200.0f * n);
+        }
+        info->mutable_mem_info()->set_total(64.0f);
+        info->mutable_mem_info()->set_used_percent(42.0f);
+        info->mutable_cpu_load()->set_load_avg_1(1.5f);
+    }
+
+    /**
+     * @brief 预热后统计循环内的分配次数
+     */
+    template <typename Body>
+    void CountAllocations(benchmark::State& state, Body&& body)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            body();   // 预热：内存块池、发送队列槽位、监控器缓冲区达到稳态
+        }
+
+        const uint64_t before = monitor::AllocationCount();
+        for (auto _ : state)
+        {
+            body();
+        }
+        const uint64_t allocations = monitor::AllocationCount() - before;
+        state.counters["allocs_per_batch"] =
+            benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(state.iterations()));
+    }
+
+    void BM_BuildHeap(benchmark::State& state)
+    {
+        int tick = 0;
+        CountAllocations(state, [&]() {
+            monitor::proto::MonitorInfo info;
+            FillSample(&info, ++tick);
+            benchmark::DoNotOptimize(info.soft_irq_size());
+        });
+    }
+
+    void BM_BuildArena(benchmark::State& state)
+    {
+        google::protobuf::Arena arena(monitor::ArenaBlockPool::Options());
+        int tick = 0;
+        CountAllocations(state, [&]() {
+            auto* info = google::protobuf::Arena::CreateMessage<monitor::proto::MonitorInfo>(&arena);
+            FillSample(info, ++tick);
+            benchmark::DoNotOptimize(info->soft_irq_size());
+            arena.Reset();
+        });
+    }
+
+    void BM_Scheduler(benchmark::State& state)
+    {
+        monitor::CollectorScheduler scheduler(static_cast<size_t>(state.range(0)));
+        const auto period = std::chrono::seconds(1);
+        scheduler.Register("softirq", std::make_shared<monitor::CpuSoftIrqMonitor>(), period);
+        scheduler.Register("cpu_load", std::make_shared<monitor::CpuLoadMonitor>(), period);
+        scheduler.Register("cpu_stat", std::make_shared<monitor::CpuStatMonitor>(), period);
+        scheduler.Register("mem", std::make_shared<monitor::MemMonitor>(), period);
+        scheduler.Register("net", std::make_shared<monitor::NetMonitor>(), period);
+
+        // 不启动发送线程：队列写满后循环覆盖最旧的槽位，正好覆盖稳态入队路径
+        monitor::RpcClient client;
+        CountAllocations(state, [&]() {
+            scheduler.CollectAll([&](monitor::proto::MonitorInfo* info) {
+                info->set_name("benchmark_host");
+                client.PushMonitorInfo(*info);
+            });
+        });
+    }
+}  // namespace
+
+BENCHMARK(BM_BuildHeap);
+BENCHMARK(BM_BuildArena);
+BENCHMARK(BM_Scheduler)->Arg(0)->Arg(4)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "monitor/cpu_load_monitor.h"
+#include "monitor/cpu_softirq_monitor.h"
+#include "monitor/cpu_stat_monitor.h"
+#include "monitor/mem_monitor.h"
+#include "monitor/net_monitor.h"
+#include "utils/arena_block_pool.h"   // 与调度器相同的批次Arena
+#include "alloc_counter.h"            // 堆分配计数
+#include "proc_fixture.h"             // 合成的/proc文件
+
+#include "monitor_info.pb.h"
+
+/**
+ * @brief 监控器基准测试
+ *
+ * 每个监控器读取ProcFixture生成的/proc文件（4~1024个CPU、1~512块网卡），
+ * 在与调度器相同的批次Arena上执行UpdateOnce，一次迭代即一次采样（tick）。
+ * 每次采样之前fixture推进一个tick（计数器增长），差分和填充消息的路径与真实采样相同；
+ * 改写fixture不计入结果（手动计时，只计UpdateOnce）：
+ * - Time列为每次采样的耗时（ns/tick）
+ * - allocs_per_tick为预热后每次采样的堆分配次数（alloc_counter统计），稳态应为0
+ * 解析器或差分路径的性能回退会直接体现在这两列上。
+ *
+ * 用法：./bin/collector_benchmark --benchmark_counters_tabular=true --benchmark_filter=CpuStat
+ */
+namespace
+{
+    /**
+     * @brief 让监控器读取合成文件并统计每次采样的耗时和分配次数
+     * @tparam Monitor 监控器类型（构造函数接受数据源路径）
+     * @param state 基准测试状态
+     * @param file fixture中的文件名
+     * @param cpus CPU核心数
+     * @param nics 网卡数
+     */
+    template <typename Monitor>
+    void RunCollector(benchmark::State& state, const char* file, size_t cpus, size_t nics)
+    {
+        monitor::ProcFixture fixture(cpus, nics);
+        Monitor collector(fixture.Path(file));
+        google::protobuf::Arena arena(monitor::ArenaBlockPool::Options());
+        uint64_t allocations = 0;
+        size_t filled = 0;   // 最近一次采样的消息字节数，只在预热阶段计算
+        auto tick = [&](bool warmup) {
+            fixture.Advance(file);
+            const uint64_t before = monitor::AllocationCount();
+            const auto start = std::chrono::steady_clock::now();
+
+            auto* info = google::protobuf::Arena::CreateMessage<monitor::proto::MonitorInfo>(&arena);
+            collector.UpdateOnce(info);
+            benchmark::DoNotOptimize(info);
+            if (warmup)
+            {
+                filled = info->ByteSizeLong();
+            }
+            arena.Reset();
+
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            allocations += monitor::AllocationCount() - before;
+            return std::chrono::duration<double>(elapsed).count();
+        };
+
+        for (int i = 0; i < 8; ++i)
+        {
+            tick(true);   // 预热：建立上一次采样、名称缓存、内存块池达到稳态
+        }
+        if (filled == 0)
+        {
+            state.SkipWithError("监控器没有从fixture解析出任何数据（fixture格式与解析器不一致）");
+            return;
+        }
+
+        allocations = 0;
+        for (auto _ : state)
+        {
+            state.SetIterationTime(tick(false));
+        }
+        state.counters["allocs_per_tick"] =
+            benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(state.iterations()));
+    }
+
+    void BM_CpuStat(benchmark::State& state)
+    {
+        RunCollector<monitor::CpuStatMonitor>(state, "stat", static_cast<size_t>(state.range(0)), 1);
+    }
+
+    void BM_SoftIrq(benchmark::State& state)
+    {
+        RunCollector<monitor::CpuSoftIrqMonitor>(state, "softirqs", static_cast<size_t>(state.range(0)), 1);
+    }
+
+    void BM_Net(benchmark::State& state)
+    {
+        RunCollector<monitor::NetMonitor>(state, "net_dev", 4, static_cast<size_t>(state.range(0)));
+    }
+
+    void BM_Mem(benchmark::State& state)
+    {
+        RunCollector<monitor::MemMonitor>(state, "meminfo", 4, 1);
+    }
+
+    void BM_CpuLoad(benchmark::State& state)
+    {
+        RunCollector<monitor::CpuLoadMonitor>(state, "loadavg", 4, 1);
+    }
+}  // namespace
+
+// 注册基准测试：CPU数4~1024，网卡数1~512
+BENCHMARK(BM_CpuStat)->RangeMultiplier(4)->Range(4, 1024)->UseManualTime();
+BENCHMARK(BM_SoftIrq)->RangeMultiplier(4)->Range(4, 1024)->UseManualTime();
+BENCHMARK(BM_Net)->RangeMultiplier(8)->Range(1, 512)->UseManualTime();
+BENCHMARK(BM_Mem)->UseManualTime();
+BENCHMARK(BM_CpuLoad)->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utils/counter_delta.h"    // 计数器差分速率内核
+#include "utils/per_cpu_matrix.h"   // 按CPU索引寻址的稠密矩阵
+
+/**
+ * @brief 计数器差分内核基准测试
+ *
+ * 模拟软中断监控器的一次速率计算：10种软中断类型 × N个CPU核心，
+ * 对比标量实现和各SIMD实现（当前CPU不支持的实现会被跳过）。
+ *
+ * 用法：./bin/counter_delta_benchmark --benchmark_filter=256
+ */
+namespace
+{
+    constexpr size_t kSoftIrqFields = 10;   ///< /proc/softirqs中的软中断类型数
+
+    /**
+     * @brief 生成两次采样的计数矩阵，增量随机，少量计数器回退
+     */
+    void FillCounters(size_t cpus, monitor::PerCpuMatrix<uint64_t>* prev,
+        monitor::PerCpuMatrix<uint64_t>* cur)
+    {
+        std::mt19937_64 rng(42);
+        prev->Resize(kSoftIrqFields, cpus);
+        cur->Resize(kSoftIrqFields, cpus);
+        for (size_t i = 0; i < cur->Size(); ++i)
+        {
+            prev->Data()[i] = rng() >> 16;
+            cur->Data()[i] = (i % 97 == 0) ? 0 : prev->Data()[i] + rng() % 100000;
+        }
+    }
+
+    void BM_CounterDelta(benchmark::State& state, monitor::CounterDelta::Isa isa)
+    {
+        if (!monitor::CounterDelta::ForceIsa(isa))
+        {
+            state.SkipWithError("ISA not supported on this CPU");
+            return;
+        }
+
+        monitor::PerCpuMatrix<uint64_t> prev;
+        monitor::PerCpuMatrix<uint64_t> cur;
+        monitor::PerCpuMatrix<float> rate;
+        FillCounters(static_cast<size_t>(state.range(0)), &prev, &cur);
+
+        for (auto _ : state)
+        {
+            monitor::CounterDelta::Rates(cur, prev, 10.0, &rate);
+            benchmark::DoNotOptimize(rate.Data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * cur.Size());
+        state.SetLabel(monitor::CounterDelta::IsaName(isa));
+    }
+}  // namespace
+
+// 注册基准测试：8、64、256个CPU核心
+BENCHMARK_CAPTURE(BM_CounterDelta, Scalar, monitor::CounterDelta::Isa::SCALAR)->Arg(8)->Arg(64)->Arg(256);
+BENCHMARK_CAPTURE(BM_CounterDelta, Sse4, monitor::CounterDelta::Isa::SSE4)->Arg(8)->Arg(64)->Arg(256);
+BENCHMARK_CAPTURE(BM_CounterDelta, Avx2, monitor::CounterDelta::Isa::AVX2)->Arg(8)->Arg(64)->Arg(256);
+BENCHMARK_CAPTURE(BM_CounterDelta, Neon, monitor::CounterDelta::Isa::NEON)->Arg(8)->Arg(64)->Arg(256);
+
+BENCHMARK_MAIN();
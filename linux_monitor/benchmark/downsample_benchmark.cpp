@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "series_ring.h"   // 界面历史曲线的环形缓冲区和MinMaxLttb
+
+/**
+ * @brief 历史曲线降采样基准测试
+ *
+ * 模拟历史页面的一次完整重绘：N条序列 × 一小时（3600点），每条降采样到1000像素宽。
+ * 帧预算为16ms，256条序列的结果应远低于预算（QPainter只需画约25万个点）。
+ *
+ * 用法：./bin/downsample_benchmark --benchmark_filter=256
+ */
+namespace
+{
+    constexpr size_t kPoints = 3600;    ///< 每条序列的点数（1秒采样1小时）
+    constexpr size_t kWidth = 1000;     ///< 绘图区宽度（像素）
+
+    /**
+     * @brief 生成带随机尖峰的序列
+     */
+    std::vector<monitor::SeriesRing> MakeSeries(size_t count)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> noise(0.0f, 10.0f);
+        std::vector<monitor::SeriesRing> series(count);
+        for (auto& ring : series)
+        {
+            for (size_t i = 0; i < kPoints + 100; ++i)   // 写满后继续写，环形缓冲区已回绕
+            {
+                const float spike = (rng() % 500 == 0) ? 90.0f : 0.0f;
+                ring.Append(static_cast<int64_t>(i) * 1000, 20.0f + noise(rng) + spike);
+            }
+        }
+        return series;
+    }
+
+    void BM_DownsampleAllSeries(benchmark::State& state)
+    {
+        std::vector<monitor::SeriesRing> series = MakeSeries(static_cast<size_t>(state.range(0)));
+        const int64_t t1 = static_cast<int64_t>(kPoints + 99) * 1000;
+        std::vector<int64_t> times;
+        std::vector<float> values;
+        size_t drawn = 0;
+
+        for (auto _ : state)
+        {
+            drawn = 0;
+            for (const auto& ring : series)
+            {
+                ring.Downsample(t1 - 3600 * 1000, t1, kWidth, &times, &values);
+                drawn += values.size();
+                benchmark::DoNotOptimize(values.data());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * series.size() * kPoints);
+        state.counters["points_drawn"] = static_cast<double>(drawn);
+    }
+
+    void BM_CopyAllSeries(benchmark::State& state)
+    {
+        // 对照：不降采样，把窗口内所有点取出来交给绘制
+        std::vector<monitor::SeriesRing> series = MakeSeries(static_cast<size_t>(state.range(0)));
+        std::vector<float> values;
+
+        for (auto _ : state)
+        {
+            for (const auto& ring : series)
+            {
+                values.resize(ring.Size());
+                for (size_t i = 0; i < ring.Size(); ++i)
+                {
+                    values[i] = ring.ValueAt(i);
+                }
+                benchmark::DoNotOptimize(values.data());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * series.size() * kPoints);
+        state.counters["points_drawn"] = static_cast<double>(series.size() * kPoints);
+    }
+}  // namespace
+
+// 注册基准测试：16、64、256条序列
+BENCHMARK(BM_DownsampleAllSeries)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CopyAllSeries)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,227 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <stdlib.h>     // mkdtemp
+#include <unistd.h>     // unlink、rmdir
+
+#include <cstdint>      // uint64_t
+#include <cstdio>       // std::FILE
+#include <string>       // 路径
+#include <vector>       // 生成的文件列表
+
+namespace monitor
+{
+    /**
+     * @brief 合成的/proc文件
+     *
+     * 在临时目录中按指定的CPU数和网卡数生成与内核格式一致的
+     * stat、softirqs、net_dev、meminfo和loadavg文件，供基准测试把监控器指向这些文件，
+     * 不依赖运行机器的CPU数和网卡数。计数器取值由CPU/网卡编号和当前tick确定：
+     * Advance让累计计数器按各自的步长增长（原地改写同一个文件，监控器常驻的fd读到新内容），
+     * 差分路径每次都有非零的增量，与真实系统一样输出完整的消息。
+     * 析构时删除所有文件和临时目录。
+     *
+     * 用法：
+     * @code
+     * ProcFixture fixture(256, 16);
+     * CpuStatMonitor monitor(fixture.Path("stat"));
+     * fixture.Advance("stat");   // 每次采样之前
+     * @endcode
+     */
+    class ProcFixture
+    {
+    public:
+        /**
+         * @brief 构造函数，生成所有文件
+         * @param cpus CPU核心数
+         * @param nics 网卡数（第一块为lo，其余为eth0、eth1……）
+         */
+        ProcFixture(size_t cpus, size_t nics) : cpus_(cpus), nics_(nics)
+        {
+            char pattern[] = "/tmp/proc_fixture_XXXXXX";
+            if (::mkdtemp(pattern) != nullptr)
+            {
+                dir_ = pattern;
+            }
+            WriteStat();
+            WriteSoftIrqs();
+            WriteNetDev();
+            WriteMemInfo();
+            Write("loadavg", "0.52 0.58 0.59 2/1024 12345\n");
+        }
+
+        ProcFixture(const ProcFixture&) = delete;
+        ProcFixture& operator=(const ProcFixture&) = delete;
+
+        /// @brief 析构函数，删除生成的文件和临时目录
+        ~ProcFixture()
+        {
+            for (const std::string& file : files_)
+            {
+                ::unlink(file.c_str());
+            }
+            if (!dir_.empty())
+            {
+                ::rmdir(dir_.c_str());
+            }
+        }
+
+        /**
+         * @brief 获取生成的文件路径
+         * @param name 文件名（"stat"、"softirqs"、"net_dev"、"meminfo"、"loadavg"）
+         * @return std::string 文件的完整路径
+         */
+        std::string Path(const std::string& name) const { return dir_ + "/" + name; }
+
+        /**
+         * @brief 推进一个tick：改写文件中的累计计数器
+         * @param name 文件名（"stat"、"softirqs"、"net_dev"；meminfo和loadavg是瞬时值，不变）
+         */
+        void Advance(const std::string& name)
+        {
+            ++tick_;
+            if (name == "stat")
+            {
+                WriteStat();
+            }
+            else if (name == "softirqs")
+            {
+                WriteSoftIrqs();
+            }
+            else if (name == "net_dev")
+            {
+                WriteNetDev();
+            }
+        }
+
+    private:
+        /**
+         * @brief 写入一个文件
+         * @param name 文件名
+         * @param content 文件内容
+         */
+        void Write(const std::string& name, const std::string& content)
+        {
+            const std::string path = Path(name);
+            if (std::FILE* file = std::fopen(path.c_str(), "w"))   // 截断后改写同一个inode
+            {
+                std::fwrite(content.data(), 1, content.size(), file);
+                std::fclose(file);
+                if (tick_ == 0)
+                {
+                    files_.push_back(path);
+                }
+            }
+        }
+
+        /// @brief 生成/proc/stat：汇总行、每个CPU一行，以及intr、ctxt等尾部行
+        void WriteStat()
+        {
+            std::string content;
+            auto cpu_line = [&](const std::string& name, uint64_t base, uint64_t scale) {
+                content += name;
+                for (uint64_t field = 0; field < 10; ++field)
+                {
+                    // 前8列（user~steal）累计增长，idle增长最快；guest两列为0
+                    const uint64_t step = field == 3 ? 60 : field + (base % 5) + 1;
+                    content += ' ' + std::to_string(field < 8 ? base * (field + 1) + tick_ * step * scale : 0);
+                }
+                content += '\n';
+            };
+            cpu_line("cpu ", 1000 * cpus_, cpus_);
+            for (size_t cpu = 0; cpu < cpus_; ++cpu)
+            {
+                cpu_line("cpu" + std::to_string(cpu), 1000 + cpu, 1);
+            }
+            content += "intr 123456789";
+            for (int irq = 0; irq < 256; ++irq)
+            {
+                content += irq % 16 == 0 ? " 1234" : " 0";
+            }
+            content += "\nctxt 987654321\nbtime 1700000000\nprocesses 123456\n"
+                       "procs_running 2\nprocs_blocked 0\nsoftirq 1000 10 200 30 40 50 60 70 80 90 100\n";
+            Write("stat", content);
+        }
+
+        /// @brief 生成/proc/softirqs：CPU名称表头和10种软中断各一行
+        void WriteSoftIrqs()
+        {
+            const size_t cpus = cpus_;
+            static const char* const kNames[] = {
+                "HI", "TIMER", "NET_TX", "NET_RX", "BLOCK", "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU"};
+            std::string content = "         ";
+            for (size_t cpu = 0; cpu < cpus; ++cpu)
+            {
+                content += "       CPU" + std::to_string(cpu);
+            }
+            content += '\n';
+            uint64_t row = 1;
+            for (const char* name : kNames)
+            {
+                content += std::string(10 - std::string(name).size(), ' ') + name + ':';
+                for (size_t cpu = 0; cpu < cpus; ++cpu)
+                {
+                    content += "   " + std::to_string(row * 100003 + cpu * 17 + tick_ * (row + cpu % 5));
+                }
+                content += '\n';
+                ++row;
+            }
+            Write("softirqs", content);
+        }
+
+        /// @brief 生成/proc/net/dev：两行表头，每块网卡一行（接收8列、发送8列）
+        void WriteNetDev()
+        {
+            const size_t nics = nics_;
+            std::string content =
+                "Inter-|   Receive                                                |  Transmit\n"
+                " face |bytes    packets errs drop fifo frame compressed multicast|"
+                "bytes    packets errs drop fifo colls carrier compressed\n";
+            for (size_t nic = 0; nic < nics; ++nic)
+            {
+                const std::string name = nic == 0 ? "lo" : "eth" + std::to_string(nic - 1);
+                const uint64_t base = 1000000 * (nic + 1);
+                content += std::string(name.size() < 6 ? 6 - name.size() : 0, ' ') + name + ':';
+                for (uint64_t field = 0; field < 16; ++field)
+                {
+                    // 每个方向的bytes、packets列累计增长，其余列（errs、drop等）保持不变
+                    const uint64_t step = field % 8 == 0 ? 1500 * (nic + 1) : nic + 1;
+                    content += ' ' + std::to_string(field % 8 < 2 ? base * (field + 1) + tick_ * step : field);
+                }
+                content += '\n';
+            }
+            Write("net_dev", content);
+        }
+
+        /// @brief 生成/proc/meminfo：与6.x内核相同的字段顺序
+        void WriteMemInfo()
+        {
+            static const char* const kFields[] = {
+                "MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "SwapCached", "Active", "Inactive",
+                "Active(anon)", "Inactive(anon)", "Active(file)", "Inactive(file)", "Unevictable", "Mlocked",
+                "SwapTotal", "SwapFree", "Zswap", "Zswapped", "Dirty", "Writeback", "AnonPages", "Mapped",
+                "Shmem", "KReclaimable", "Slab", "SReclaimable", "SUnreclaim", "KernelStack", "PageTables",
+                "SecPageTables", "NFS_Unstable", "Bounce", "WritebackTmp", "CommitLimit", "Committed_AS",
+                "VmallocTotal", "VmallocUsed", "VmallocChunk", "Percpu", "HardwareCorrupted", "AnonHugePages",
+                "ShmemHugePages", "ShmemPmdMapped", "FileHugePages", "FilePmdMapped", "Unaccepted",
+                "HugePages_Total", "HugePages_Free", "HugePages_Rsvd", "HugePages_Surp", "Hugepagesize",
+                "Hugetlb", "DirectMap4k", "DirectMap2M", "DirectMap1G"};
+            std::string content;
+            uint64_t value = 65536000;
+            for (const char* field : kFields)
+            {
+                const std::string label = std::string(field) + ':';
+                content += label + std::string(label.size() < 16 ? 16 - label.size() : 1, ' ') +
+                           std::to_string(value) + " kB\n";
+                value = value / 2 + 123;
+            }
+            Write("meminfo", content);
+        }
+
+        size_t cpus_;                      ///< CPU核心数
+        size_t nics_;                      ///< 网卡数
+        uint64_t tick_ = 0;                ///< 已推进的tick数
+        std::string dir_;                  ///< 临时目录
+        std::vector<std::string> files_;   ///< 已生成的文件
+    };
+}  // namespace monitor
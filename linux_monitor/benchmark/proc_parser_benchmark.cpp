@@ -0,0 +1,104 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utils/proc_parser.h"   // 零拷贝解析器
+#include "utils/read_file.h"     // 原有的逐行分词实现
+
+/**
+ * @brief /proc解析基准测试
+ *
+ * 对比两种解析路径读取同一个/proc文件并解析所有数值字段的开销：
+ * - ReadFile：每次构造ifstream，每行一个std::string、一个istringstream，
+ *   每个字段一个std::string，再经std::stoll转换
+ * - ProcParser：复用缓冲区一次pread读入，字段为string_view，std::from_chars转换
+ *
+ * 用法：./bin/proc_parser_benchmark --benchmark_filter=Stat
+ */
+namespace
+{
+    /**
+     * @brief 使用ReadFile解析整个文件，累加所有数值字段
+     * @param path 文件路径
+     * @return int64_t 数值字段之和（防止编译器优化掉解析过程）
+     */
+    int64_t ParseWithReadFile(const std::string& path)
+    {
+        monitor::ReadFile file(path);
+        std::vector<std::string> fields;
+        int64_t sum = 0;
+        while (file.ReadLine(&fields))
+        {
+            for (const auto& field : fields)
+            {
+                if (!field.empty() && field[0] >= '0' && field[0] <= '9')
+                {
+                    sum += std::stoll(field);
+                }
+            }
+            fields.clear();
+        }
+        return sum;
+    }
+
+    /**
+     * @brief 使用ProcParser解析整个文件，累加所有数值字段
+     * @param parser 复用的解析器
+     * @param fields 复用的字段容器
+     * @return int64_t 数值字段之和
+     */
+    int64_t ParseWithProcParser(monitor::ProcParser* parser,
+        std::vector<std::string_view>* fields)
+    {
+        int64_t sum = 0;
+        if (!parser->Load())
+        {
+            return sum;
+        }
+        std::string_view line;
+        while (parser->NextLine(&line))
+        {
+            monitor::ProcParser::SplitFields(line, fields);
+            for (auto field : *fields)
+            {
+                sum += monitor::ProcParser::ToNumber<int64_t>(field);
+            }
+        }
+        return sum;
+    }
+
+    void BM_ReadFile(benchmark::State& state, const char* path)
+    {
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(ParseWithReadFile(path));
+        }
+    }
+
+    void BM_ProcParser(benchmark::State& state, const char* path)
+    {
+        monitor::ProcParser parser(path);
+        std::vector<std::string_view> fields;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(ParseWithProcParser(&parser, &fields));
+        }
+        state.SetBytesProcessed(state.iterations() * parser.Content().size());
+    }
+}  // namespace
+
+// 注册基准测试：覆盖五个监控器读取的全部/proc文件
+BENCHMARK_CAPTURE(BM_ReadFile, Stat, "/proc/stat");
+BENCHMARK_CAPTURE(BM_ProcParser, Stat, "/proc/stat");
+BENCHMARK_CAPTURE(BM_ReadFile, SoftIrqs, "/proc/softirqs");
+BENCHMARK_CAPTURE(BM_ProcParser, SoftIrqs, "/proc/softirqs");
+BENCHMARK_CAPTURE(BM_ReadFile, MemInfo, "/proc/meminfo");
+BENCHMARK_CAPTURE(BM_ProcParser, MemInfo, "/proc/meminfo");
+BENCHMARK_CAPTURE(BM_ReadFile, NetDev, "/proc/net/dev");
+BENCHMARK_CAPTURE(BM_ProcParser, NetDev, "/proc/net/dev");
+BENCHMARK_CAPTURE(BM_ReadFile, LoadAvg, "/proc/loadavg");
+BENCHMARK_CAPTURE(BM_ProcParser, LoadAvg, "/proc/loadavg");
+
+BENCHMARK_MAIN();
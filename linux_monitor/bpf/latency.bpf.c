@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: (BSD-2-Clause OR GPL-2.0-only)
+/*
+ * 软中断耗时和运行队列延迟的内核聚合
+ *
+ * 每个事件只在本CPU的per-CPU map中累加一个log2桶，不向用户态传递事件：
+ * 用户态每个采样周期批量读取一次map，开销与事件频率无关。
+ *
+ * - 软中断耗时：softirq_entry记录开始时间，softirq_exit按软中断类型累加到softirq_hist。
+ *   同一CPU上的软中断不会互相嵌套，每个CPU一个开始时间即可
+ * - 运行队列延迟：任务被唤醒（sched_wakeup、sched_wakeup_new）或被抢占时仍处于运行态
+ *   （sched_switch的prev）时记录入队时间，任务被切换上CPU时按该CPU累加到runq_hist
+ *
+ * 以CO-RE方式编译（vmlinux.h由bpftool从/sys/kernel/btf/vmlinux生成），同一个目标文件可在
+ * 不同版本的内核上加载。
+ */
+#include "vmlinux.h"
+#include <bpf/bpf_core_read.h>
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+#include "latency.h"
+
+#define TASK_RUNNING 0
+#define MAX_TRACKED_TASKS 10240
+
+/* 各CPU上正在执行的软中断的开始时间 */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, __u32);
+    __type(value, __u64);
+} softirq_start SEC(".maps");
+
+/* 按软中断类型索引的耗时直方图（每个CPU一份） */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __uint(max_entries, LATENCY_SOFTIRQ_VECS);
+    __type(key, __u32);
+    __type(value, struct latency_hist);
+} softirq_hist SEC(".maps");
+
+/* 可运行任务的入队时间（按pid索引） */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_HASH);
+    __uint(max_entries, MAX_TRACKED_TASKS);
+    __type(key, __u32);
+    __type(value, __u64);
+} runq_start SEC(".maps");
+
+/* 运行队列延迟直方图（每个CPU一份，记在任务被切换上去的CPU） */
+struct
+{
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, __u32);
+    __type(value, struct latency_hist);
+} runq_hist SEC(".maps");
+
+/* task_struct的状态字段在5.14改名为__state；用两种flavor声明，生成vmlinux.h的内核是哪个版本都能编译 */
+struct task_struct___new
+{
+    unsigned int __state;
+} __attribute__((preserve_access_index));
+
+struct task_struct___old
+{
+    long state;
+} __attribute__((preserve_access_index));
+
+static __always_inline long task_state(struct task_struct* task)
+{
+    struct task_struct___new* t = (void*)task;
+    if (bpf_core_field_exists(t->__state))
+    {
+        return BPF_CORE_READ(t, __state);
+    }
+    return BPF_CORE_READ((struct task_struct___old*)task, state);
+}
+
+/* 向下取整的log2，delta为0时返回0 */
+static __always_inline __u32 log2_slot(__u64 delta)
+{
+    __u32 slot = 0;
+    __u32 shift;
+
+    shift = (delta > 0xFFFFFFFFULL) << 5; delta >>= shift; slot |= shift;
+    shift = (delta > 0xFFFF) << 4; delta >>= shift; slot |= shift;
+    shift = (delta > 0xFF) << 3; delta >>= shift; slot |= shift;
+    shift = (delta > 0xF) << 2; delta >>= shift; slot |= shift;
+    shift = (delta > 0x3) << 1; delta >>= shift; slot |= shift;
+    slot |= (delta >> 1);
+    return slot < LATENCY_SLOTS ? slot : LATENCY_SLOTS - 1;
+}
+
+static __always_inline void record(struct latency_hist* hist, __u64 delta)
+{
+    /* per-CPU值只被本CPU上的程序修改，tracepoint程序执行期间不会迁移，无需原子操作 */
+    hist->slots[log2_slot(delta)]++;
+    hist->total_ns += delta;
+}
+
+// ==================== 软中断耗时 ====================
+
+SEC("tp_btf/softirq_entry")
+int BPF_PROG(handle_softirq_entry, unsigned int vec_nr)
+{
+    __u32 key = 0;
+    __u64* start = bpf_map_lookup_elem(&softirq_start, &key);
+    if (start)
+    {
+        *start = bpf_ktime_get_ns();
+    }
+    return 0;
+}
+
+SEC("tp_btf/softirq_exit")
+int BPF_PROG(handle_softirq_exit, unsigned int vec_nr)
+{
+    __u32 key = 0;
+    __u64* start = bpf_map_lookup_elem(&softirq_start, &key);
+    if (!start || *start == 0)
+    {
+        return 0;   /* 加载时已在执行的软中断没有开始时间 */
+    }
+    __u64 delta = bpf_ktime_get_ns() - *start;
+    *start = 0;
+
+    __u32 vec = vec_nr;
+    struct latency_hist* hist = bpf_map_lookup_elem(&softirq_hist, &vec);
+    if (hist)
+    {
+        record(hist, delta);
+    }
+    return 0;
+}
+
+// ==================== 运行队列延迟 ====================
+
+static __always_inline int enqueue(__u32 pid)
+{
+    if (pid == 0)
+    {
+        return 0;   /* idle任务 */
+    }
+    __u64 now = bpf_ktime_get_ns();
+    bpf_map_update_elem(&runq_start, &pid, &now, BPF_ANY);
+    return 0;
+}
+
+SEC("tp_btf/sched_wakeup")
+int BPF_PROG(handle_sched_wakeup, struct task_struct* task)
+{
+    return enqueue(task->pid);
+}
+
+SEC("tp_btf/sched_wakeup_new")
+int BPF_PROG(handle_sched_wakeup_new, struct task_struct* task)
+{
+    return enqueue(task->pid);
+}
+
+SEC("tp_btf/sched_switch")
+int BPF_PROG(handle_sched_switch, bool preempt, struct task_struct* prev, struct task_struct* next)
+{
+    /* 被抢占的任务仍然可运行，重新进入运行队列 */
+    if (task_state(prev) == TASK_RUNNING)
+    {
+        enqueue(prev->pid);
+    }
+
+    __u32 pid = next->pid;
+    __u64* start = bpf_map_lookup_elem(&runq_start, &pid);
+    if (!start)
+    {
+        return 0;
+    }
+    __u64 delta = bpf_ktime_get_ns() - *start;
+    bpf_map_delete_elem(&runq_start, &pid);
+
+    __u32 key = 0;
+    struct latency_hist* hist = bpf_map_lookup_elem(&runq_hist, &key);
+    if (hist)
+    {
+        record(hist, delta);
+    }
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "Dual BSD/GPL";
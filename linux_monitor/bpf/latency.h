@@ -0,0 +1,24 @@
+/* 头文件保护宏，防止重复包含 */
+#pragma once
+
+/*
+ * eBPF延迟监控的内核/用户态共享定义
+ *
+ * latency.bpf.c（以vmlinux.h提供__u64等类型）和BpfLatencyMonitor（先包含<linux/types.h>）
+ * 共同包含本文件，保证两侧的map值布局一致。本文件不包含其他头文件。
+ */
+
+/* log2桶数：桶i统计[2^i, 2^(i+1)) ns内的事件，最后一个桶兼收更长的事件（约2秒以上） */
+#define LATENCY_SLOTS 32
+
+/* 软中断类型数（NR_SOFTIRQS），顺序与/proc/softirqs相同：HI、TIMER、NET_TX、NET_RX、BLOCK、
+ * IRQ_POLL、TASKLET、SCHED、HRTIMER、RCU */
+#define LATENCY_SOFTIRQ_VECS 10
+
+/* 一个延迟直方图（per-CPU map的值，每个CPU一份，只累加不清零）。
+ * 不单独记录事件数：用户态读取时内核可能正在更新，事件数取各桶之和，与桶保持自洽 */
+struct latency_hist
+{
+    __u64 slots[LATENCY_SLOTS];   /* 各log2桶的累计事件数 */
+    __u64 total_ns;               /* 累计耗时（纳秒） */
+};
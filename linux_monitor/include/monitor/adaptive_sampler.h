@@ -0,0 +1,120 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <chrono>       // 周期上下限
+#include <cstdint>      // int64_t
+#include <functional>   // 信号提取函数
+#include <memory>       // std::shared_ptr
+#include <vector>       // 各实例的信号
+
+// 项目自定义头文件
+#include "monitor_info.pb.h"          // Protobuf消息定义
+
+namespace monitor
+{
+    /**
+     * @brief 自适应采样周期控制
+     *
+     * 固定周期在故障期间太粗（短暂的突发落在两次采样之间），在空闲时又浪费上报量。
+     * 每个监控器一个AdaptiveSampler：从每次采样中提取关键信号（每个实例一个值，
+     * 如每个CPU的cpu_percent），维护每个值的指数加权均值和方差，据此调整下一个周期：
+     * - 波动分数：max(|x - 均值|, 标准差) / (absolute + relative × |均值|)，取所有实例的最大值
+     * - 分数不低于enter_score时，周期立即降到下限（突发开始时不错过后续的点）
+     * - 分数低于exit_score的采样连续出现calm_samples次后，周期加倍，直到上限
+     * - 分数在两者之间时保持当前周期（滞回，避免在阈值附近来回切换）
+     *
+     * 加权系数按实际间隔计算（alpha = 1 - exp(-dt / tau)），均值和方差的时间常数与周期无关。
+     * 实例数变化（网卡增减）时重新开始统计。
+     *
+     * 线程模型：只在调度线程上调用。
+     */
+    class AdaptiveSampler
+    {
+    public:
+        /**
+         * @brief 信号提取函数：从批次消息中取出监控器的关键信号，追加到values
+         *
+         * 各次采样中同一实例的值必须在相同的位置。
+         */
+        using Extractor = std::function<void(const monitor::proto::MonitorInfo&, std::vector<double>*)>;
+
+        /**
+         * @brief 波动尺度：偏差超过absolute + relative × |均值|时分数为1
+         */
+        struct Threshold
+        {
+            double absolute = 0;   ///< 绝对尺度（信号的单位）
+            double relative = 0;   ///< 相对均值的尺度
+        };
+
+        /**
+         * @brief 控制参数
+         */
+        struct Options
+        {
+            std::chrono::nanoseconds floor = std::chrono::milliseconds(100);     ///< 周期下限
+            std::chrono::nanoseconds ceiling = std::chrono::milliseconds(5000);  ///< 周期上限
+            double tau_seconds = 5;    ///< 均值和方差的时间常数（秒）
+            double enter_score = 1.0;  ///< 进入快速采样的分数
+            double exit_score = 0.5;   ///< 视为平稳的分数
+            int calm_samples = 3;      ///< 周期加倍前需要的连续平稳采样数
+        };
+
+        /**
+         * @brief 构造函数
+         * @param extractor 信号提取函数
+         * @param threshold 波动尺度
+         * @param options 控制参数
+         */
+        AdaptiveSampler(Extractor extractor, Threshold threshold, const Options& options);
+
+        /**
+         * @brief 用一次采样更新统计并计算下一个周期
+         * @param monitor_info 本批次的消息（包含该监控器填充的字段）
+         * @param now_ns 采样完成的时间（CLOCK_MONOTONIC，纳秒）
+         * @param period_ns 当前周期（纳秒）
+         * @return int64_t 下一个周期（纳秒），在[floor, ceiling]内
+         */
+        int64_t Observe(const monitor::proto::MonitorInfo& monitor_info, int64_t now_ns, int64_t period_ns);
+
+        /**
+         * @brief 获取最近一次采样的波动分数
+         * @return double 分数（还没有统计时为0）
+         */
+        double LastScore() const { return last_score_; }
+
+        // ==================== 各监控器的关键信号 ====================
+
+        /// @brief 每个CPU的cpu_percent（CpuStatMonitor），偏差10个百分点为1分
+        static std::shared_ptr<AdaptiveSampler> ForCpuStat(const Options& options);
+
+        /// @brief 每个CPU的net_rx软中断速率（CpuSoftIrqMonitor）
+        static std::shared_ptr<AdaptiveSampler> ForSoftIrq(const Options& options);
+
+        /// @brief 每块网卡的接收、发送速率（NetMonitor，不含lo）
+        static std::shared_ptr<AdaptiveSampler> ForNet(const Options& options);
+
+        /// @brief 内存使用率（MemMonitor），偏差2个百分点为1分
+        static std::shared_ptr<AdaptiveSampler> ForMem(const Options& options);
+
+    private:
+        /**
+         * @brief 一个值的加权统计
+         */
+        struct Signal
+        {
+            double mean = 0;       ///< 指数加权均值
+            double variance = 0;   ///< 指数加权方差
+        };
+
+        Extractor extractor_;             ///< 信号提取函数
+        Threshold threshold_;             ///< 波动尺度
+        Options options_;                 ///< 控制参数
+        std::vector<Signal> signals_;     ///< 各实例的统计
+        std::vector<double> values_;      ///< 复用的本次采样值
+        int64_t last_ns_ = 0;             ///< 上一次采样的时间
+        int calm_ = 0;                    ///< 连续平稳的采样数
+        double last_score_ = 0;           ///< 最近一次的波动分数
+    };
+}  // namespace monitor
@@ -0,0 +1,91 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <chrono>       // 统计窗口
+#include <cstddef>      // size_t
+#include <cstdint>      // int64_t、uint64_t
+#include <mutex>        // 保护上报统计
+#include <vector>       // 绑定的CPU和NUMA节点
+
+// 项目自定义头文件
+#include "utils/latency_histogram.h"  // 上报耗时直方图
+#include "monitor_info.pb.h"          // Protobuf消息定义
+
+namespace monitor
+{
+    /**
+     * @brief 采集端自身开销统计
+     *
+     * 按固定的统计窗口汇总采集端进程自身的开销，导出为AgentStats：
+     * - 进程CPU使用率：窗口内getrusage(RUSAGE_SELF)的用户态+内核态时间增量 / 窗口长度
+     * - 常驻内存：/proc/self/statm的resident页数
+     * - 上报耗时和字节数：RpcClient的上报观察者每次上报成功后调用RecordSend
+     * - 放置校验：设置了CPU/NUMA绑定时，统计运行在绑定CPU之外的线程数和远端节点上的内存，
+     *   作为采集端不占用独占核心、不产生跨节点访问的运行时证据
+     *
+     * 服务器和界面据此找出开销过大的采集端（例如某台主机的网卡数多到让采样变慢）。
+     *
+     * 线程模型：RecordSend可以在任意线程调用（流式上报时在发送线程）；
+     * Due和Export只能在同一个线程（调度器的批次回调）调用。
+     */
+    class AgentStatsRecorder
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param window 统计窗口长度，第一个窗口从构造时开始
+         */
+        explicit AgentStatsRecorder(std::chrono::milliseconds window);
+
+        /**
+         * @brief 记录一次上报
+         * @param latency_ns 上报耗时（纳秒）
+         * @param bytes 序列化字节数
+         */
+        void RecordSend(int64_t latency_ns, size_t bytes);
+
+        /**
+         * @brief 设置CPU/NUMA绑定结果，之后每个窗口导出放置校验
+         * @param cpus 绑定的CPU（CpuPlacement::Cpus），为空时不统计线程位置
+         * @param nodes 绑定的NUMA节点（CpuPlacement::Nodes），为空时不统计远端内存
+         */
+        void SetPlacement(std::vector<int> cpus, std::vector<int> nodes);
+
+        /**
+         * @brief 当前统计窗口是否已经结束
+         * @return bool 距上次导出已超过窗口长度时返回true
+         */
+        bool Due() const;
+
+        /**
+         * @brief 导出本窗口的统计并开始新窗口
+         * @param dropped 流式上报累计丢弃的采样数（RpcClient::DroppedCount）
+         * @param stats 输出参数，采集端统计
+         */
+        void Export(uint64_t dropped, monitor::proto::AgentStats* stats);
+
+    private:
+        /**
+         * @brief 获取进程累计的CPU时间
+         * @return int64_t 用户态+内核态时间（微秒）
+         */
+        static int64_t ProcessCpuMicros();
+
+        /**
+         * @brief 获取进程的常驻内存
+         * @return uint64_t 常驻内存（KB），读取失败时返回0
+         */
+        static uint64_t ResidentKb();
+
+        const std::chrono::steady_clock::duration window_;           ///< 统计窗口长度
+        std::chrono::steady_clock::time_point window_start_;         ///< 本窗口开始时间
+        int64_t cpu_start_us_;                                       ///< 本窗口开始时的进程CPU时间
+        std::vector<int> placement_cpus_;                            ///< 绑定的CPU
+        std::vector<int> placement_nodes_;                           ///< 绑定的NUMA节点
+
+        std::mutex mutex_;                    ///< 保护以下上报统计
+        LatencyHistogram send_latency_;       ///< 本窗口的上报耗时
+        uint64_t bytes_ = 0;                  ///< 本窗口的上报字节数
+    };
+}  // namespace monitor
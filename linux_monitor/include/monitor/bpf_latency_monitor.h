@@ -0,0 +1,122 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cstddef>           // size_t
+#include <cstdint>           // uint32_t、uint64_t
+#include <string>            // 直方图名称
+#include <vector>            // map值缓冲区
+
+// 项目自定义头文件
+#include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "monitor_info.grpc.pb.h"     // gRPC生成代码（间接需要）
+#include "monitor_info.pb.h"          // Protobuf消息定义
+
+// bpftool生成的skeleton（只在实现文件中包含）
+struct latency_bpf;
+
+namespace monitor
+{
+    /**
+     * @brief eBPF软中断耗时和运行队列延迟监控器
+     *
+     * CpuSoftIrqMonitor从/proc/softirqs只能得到每秒次数，看不出软中断执行了多久；
+     * 本监控器加载latency.bpf.c，在内核中按CPU聚合软中断耗时（按类型）和运行队列延迟的
+     * log2直方图，每个采样周期用bpf_map_lookup_batch批量读取一次，与上次的累计值做差后
+     * 上报softirq_latency和runq_latency。内核中只累加per-CPU的桶，不向用户态传递事件，
+     * 用户态开销只与CPU数有关，与事件频率无关。
+     *
+     * 只在构建时找到libbpf、clang和bpftool时编译（定义MONITOR_WITH_BPF）；
+     * 运行时需要加载BPF程序的权限（CAP_BPF + CAP_PERFMON或root）和内核BTF，
+     * 加载失败时Loaded()返回false，不注册到调度器。
+     */
+    class BpfLatencyMonitor : public MonitorInter
+    {
+    public:
+        /**
+         * @brief 构造函数，加载并附加BPF程序
+         */
+        BpfLatencyMonitor();
+
+        /**
+         * @brief 析构函数，卸载BPF程序
+         */
+        ~BpfLatencyMonitor() override;
+
+        // 持有BPF对象，禁止拷贝
+        BpfLatencyMonitor(const BpfLatencyMonitor&) = delete;
+        BpfLatencyMonitor& operator=(const BpfLatencyMonitor&) = delete;
+
+        /**
+         * @brief BPF程序是否已加载并附加
+         * @return bool 已加载返回true
+         */
+        bool Loaded() const { return skeleton_ != nullptr; }
+
+        /**
+         * @brief 获取加载失败的原因
+         * @return const std::string& 错误描述，加载成功时为空
+         */
+        const std::string& Error() const { return error_; }
+
+        /**
+         * @brief 更新延迟监控信息（实现抽象基类接口）
+         * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+         *
+         * 批量读取两个直方图map，填充本周期内有事件的softirq_latency和runq_latency。
+         * 第一次采样只记录累计值，不输出。
+         */
+        void UpdateOnce(monitor::proto::MonitorInfo* monitor_info) override;
+
+        /**
+         * @brief 停止监控（实现抽象基类接口）
+         */
+        void Stop() override {}
+
+    private:
+        /**
+         * @brief 一个per-CPU直方图map的读取状态
+         */
+        struct HistogramMap
+        {
+            int fd = -1;                     ///< map fd
+            uint32_t entries = 0;            ///< map的键数
+            std::vector<uint64_t> current;   ///< 本次读取的值（键 × CPU × 直方图）
+            std::vector<uint64_t> previous;  ///< 上次读取的值
+            std::vector<uint32_t> keys;      ///< 批量读取的键缓冲区
+            bool has_prev = false;           ///< 是否已有上次读取
+        };
+
+        /**
+         * @brief 读取一个map的全部键（所有CPU）到current
+         * @param map 读取状态
+         * @return bool 成功返回true
+         *
+         * 优先使用bpf_map_lookup_batch（一次系统调用）；内核不支持批量操作（5.6之前）时
+         * 逐键bpf_map_lookup_elem。
+         */
+        bool ReadMap(HistogramMap* map);
+
+        /**
+         * @brief 把一个直方图的本周期增量追加到输出列表
+         * @param map 读取状态
+         * @param key 键
+         * @param cpu CPU编号
+         * @param name 直方图名称
+         * @param output 输出列表（本周期内没有事件时不追加）
+         */
+        void EmitDelta(const HistogramMap& map, uint32_t key, size_t cpu, const std::string& name,
+                       google::protobuf::RepeatedPtrField<monitor::proto::LatencyInfo>* output);
+
+        struct latency_bpf* skeleton_ = nullptr;   ///< BPF对象
+        std::string error_;                         ///< 加载失败的原因
+        size_t cpus_ = 0;                           ///< 可能的CPU数（per-CPU map的值份数）
+        bool batch_supported_ = true;               ///< 内核是否支持批量查找
+
+        HistogramMap softirq_;                      ///< 软中断耗时（键为软中断类型）
+        HistogramMap runq_;                         ///< 运行队列延迟（单键）
+        std::vector<std::string> softirq_names_;    ///< "<cpu>/<类型>"，按键 × CPU预先生成
+        std::vector<std::string> runq_names_;       ///< "<cpu>"，按CPU预先生成
+        std::vector<uint64_t> delta_;               ///< 复用的桶增量缓冲区
+    };
+}  // namespace monitor
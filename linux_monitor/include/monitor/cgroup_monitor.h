@@ -0,0 +1,192 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <array>             // 每个cgroup的接口文件fd
+#include <chrono>            // 采样时间
+#include <cstddef>           // size_t
+#include <cstdint>           // uint64_t
+#include <string>            // cgroup路径
+#include <string_view>       // 零拷贝字段视图
+#include <unordered_map>     // 路径和watch索引
+#include <vector>            // 复用的缓冲区
+
+// 项目自定义头文件
+#include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "monitor_info.grpc.pb.h"     // gRPC生成代码（间接需要）
+#include "monitor_info.pb.h"          // Protobuf消息定义
+
+namespace monitor
+{
+    /**
+     * @brief cgroup v2容器级资源监控器
+     *
+     * MemMonitor和CpuStatMonitor只有整机的/proc/meminfo、/proc/stat；本监控器上报每个cgroup的
+     * cpu.stat、memory.current、memory.stat和io.stat（增量换算为速率），定位是哪个容器占用资源。
+     *
+     * 节点上有几百个Pod时每个周期遍历整棵cgroup树代价过高，采用以下方式：
+     * - inotify增量发现：只在构造时遍历一次目录树，并对每个cgroup目录添加inotify watch；
+     *   之后每次采样读空inotify队列，按IN_CREATE/IN_DELETE（目录）增删cgroup。
+     *   新目录先加watch再遍历其子目录，两者之间创建的子cgroup不会漏掉；
+     *   队列溢出（IN_Q_OVERFLOW）时才重新遍历一次
+     * - 常驻fd：每个cgroup的四个接口文件打开一次，每次采样只做pread；fd总数不超过
+     *   RLIMIT_NOFILE软限制的四分之一，超出的cgroup每次采样临时openat
+     * - 接口文件不存在（对应控制器未在父cgroup的subtree_control中启用）时不每次重试，
+     *   每kMissingRetryTicks个tick重试一次
+     *
+     * 根cgroup不上报（对应整机数据）；只有cgroup v1的主机上根目录下没有cgroup.controllers，
+     * 混合模式下自动改用<root>/unified。
+     */
+    class CgroupMonitor : public MonitorInter
+    {
+    public:
+        /// @brief 接口文件不存在时的重试间隔（tick）
+        static constexpr uint64_t kMissingRetryTicks = 30;
+
+        /**
+         * @brief 构造函数，遍历一次cgroup树并添加inotify watch
+         * @param root cgroup v2挂载点，默认为/sys/fs/cgroup
+         * @param max_depth 最多发现的层数（1表示只上报根目录的直接子cgroup），0表示不限
+         */
+        explicit CgroupMonitor(const std::string& root = "/sys/fs/cgroup", size_t max_depth = 0);
+
+        /**
+         * @brief 析构函数，关闭所有fd和inotify实例
+         */
+        ~CgroupMonitor() override;
+
+        // 持有fd，禁止拷贝
+        CgroupMonitor(const CgroupMonitor&) = delete;
+        CgroupMonitor& operator=(const CgroupMonitor&) = delete;
+
+        /**
+         * @brief 更新cgroup监控信息（实现抽象基类接口）
+         * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+         *
+         * 处理inotify事件后读取所有cgroup，填充已有上次采样的cgroup_info。
+         */
+        void UpdateOnce(monitor::proto::MonitorInfo* monitor_info) override;
+
+        /**
+         * @brief 停止监控（实现抽象基类接口）
+         */
+        void Stop() override {}
+
+        /**
+         * @brief 获取当前跟踪的cgroup数
+         * @return size_t cgroup数（不含根cgroup）
+         */
+        size_t TrackedCount() const { return cgroups_.size(); }
+
+    private:
+        /**
+         * @brief 每个cgroup读取的接口文件
+         */
+        enum CgroupFile
+        {
+            CPU_STAT = 0,      ///< cpu.stat
+            MEMORY_CURRENT,    ///< memory.current
+            MEMORY_STAT,       ///< memory.stat
+            IO_STAT,           ///< io.stat
+            FILE_MAX           ///< 文件总数
+        };
+
+        /**
+         * @brief 一次读取的累计计数（增量换算为速率）
+         */
+        struct Counters
+        {
+            uint64_t usage_usec = 0;      ///< cpu.stat usage_usec
+            uint64_t user_usec = 0;       ///< cpu.stat user_usec
+            uint64_t system_usec = 0;     ///< cpu.stat system_usec
+            uint64_t nr_throttled = 0;    ///< cpu.stat nr_throttled
+            uint64_t throttled_usec = 0;  ///< cpu.stat throttled_usec
+            uint64_t pgmajfault = 0;      ///< memory.stat pgmajfault
+            uint64_t rbytes = 0;          ///< io.stat rbytes（各设备之和）
+            uint64_t wbytes = 0;          ///< io.stat wbytes
+            uint64_t rios = 0;            ///< io.stat rios
+            uint64_t wios = 0;            ///< io.stat wios
+        };
+
+        /**
+         * @brief 一个被跟踪的cgroup
+         */
+        struct Cgroup
+        {
+            std::array<int, FILE_MAX> fds;        ///< 常驻fd，-1表示未缓存
+            std::array<bool, FILE_MAX> missing;   ///< 接口文件是否不存在
+            uint64_t retry_tick = 0;              ///< 重试不存在的接口文件的tick
+            int wd = -1;                          ///< inotify watch，-1表示未监视（达到最大层数）
+            Counters prev;                        ///< 上一次读取的累计计数
+            std::chrono::steady_clock::time_point prev_time;   ///< 上一次读取的时间
+            bool has_prev = false;                ///< 是否已有上一次读取
+
+            Cgroup() { fds.fill(-1); missing.fill(false); }
+        };
+
+        /**
+         * @brief 加入一个cgroup目录及其所有子目录
+         * @param path 相对根目录的路径（根目录为空串）
+         * @param depth 层数（根目录为0）
+         *
+         * 先添加inotify watch再列举子目录；已经跟踪的目录不重复加入，但仍会列举其子目录
+         * （队列溢出后重新遍历时用于找回漏掉的子cgroup）。
+         */
+        void AddTree(const std::string& path, size_t depth);
+
+        /**
+         * @brief 删除一个cgroup及其所有子cgroup
+         * @param path 相对根目录的路径
+         */
+        void RemoveTree(const std::string& path);
+
+        /**
+         * @brief 读空inotify队列并增删cgroup
+         *
+         * 队列溢出时删除目录已经不存在的cgroup，再从根目录重新遍历一次。
+         */
+        void DrainEvents();
+
+        /**
+         * @brief 读取一个接口文件到buffer_
+         * @param path cgroup路径
+         * @param cgroup cgroup缓存项（按需打开或记为不存在）
+         * @param file 接口文件
+         * @return size_t 读取到的字节数，失败返回0
+         */
+        size_t ReadFile(const std::string& path, Cgroup* cgroup, CgroupFile file);
+
+        /**
+         * @brief 读取一个cgroup并填充CgroupInfo
+         * @param path cgroup路径
+         * @param cgroup cgroup缓存项
+         * @param now 本次采样时间
+         * @param monitor_info 输出参数
+         */
+        void ReadCgroup(const std::string& path, Cgroup* cgroup, std::chrono::steady_clock::time_point now,
+                        monitor::proto::MonitorInfo* monitor_info);
+
+        /**
+         * @brief 关闭一个cgroup的所有fd
+         * @param cgroup cgroup缓存项
+         */
+        void CloseFds(Cgroup* cgroup);
+
+        std::string root_;                                  ///< cgroup v2挂载点
+        size_t max_depth_;                                  ///< 最多发现的层数，0表示不限
+        int root_fd_ = -1;                                  ///< 挂载点目录fd（openat的基准目录）
+        int inotify_fd_ = -1;                               ///< inotify实例（非阻塞）
+        size_t fd_budget_;                                  ///< 最多缓存的fd数
+        size_t open_fds_ = 0;                               ///< 当前缓存的fd数
+        uint64_t tick_ = 0;                                 ///< 采样次数
+
+        std::unordered_map<std::string, Cgroup> cgroups_;   ///< 路径索引的cgroup（不含根cgroup）
+        std::unordered_map<int, std::string> watches_;      ///< inotify watch到目录路径（含根目录）
+
+        // ==================== 复用缓冲区（稳态不分配） ====================
+        std::vector<char> buffer_;                          ///< 接口文件内容
+        std::vector<char> events_;                          ///< inotify事件
+        std::vector<std::string_view> fields_;              ///< 字段视图
+        std::string path_buffer_;                           ///< 临时openat的相对路径
+    };
+}  // namespace monitor
@@ -0,0 +1,205 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <atomic>       // 运行标志
+#include <chrono>       // 采样周期
+#include <cstdint>      // int64_t
+#include <functional>   // 批次回调
+#include <memory>       // std::shared_ptr
+#include <queue>        // std::priority_queue（最小堆）
+#include <string>       // 监控器名称
+#include <vector>       // 监控器列表
+
+// 项目自定义头文件
+#include "monitor/adaptive_sampler.h" // 自适应采样周期
+#include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "utils/arena_block_pool.h"   // 批次Arena的内存块池
+#include "utils/latency_histogram.h"  // 监控器采样耗时直方图
+#include "utils/worker_pool.h"        // 并行采集线程池
+#include "monitor_info.pb.h"          // Protobuf消息定义
+
+namespace monitor
+{
+    /**
+     * @brief 监控器调度器
+     *
+     * 每个监控器以自己的采样周期注册，调度器用截止时间最小堆决定下一个
+     * 应该运行的监控器，避免所有监控器都按最慢/最贵的那个节奏运行：
+     * 例如网络每250ms采样一次，内存每5s采样一次。
+     *
+     * 调度特点：
+     * - 绝对时间：截止时间按周期累加，用clock_nanosleep(TIMER_ABSTIME)睡到截止时间，
+     *   监控器本身的耗时和唤醒延迟不会累积成漂移
+     * - 批量上报：同一时刻到期（相差不超过kBatchSlack）的监控器填充同一个MonitorInfo，
+     *   只触发一次上报回调
+     * - 超时跳过：某次采样耗时超过周期时，跳过错过的周期而不是连续补采
+     * - 并行采集（可选）：配置工作线程后，同一批次的监控器分发到线程池并行执行，
+     *   每个监控器填充自己的子消息，完成后按字段移动（不拷贝）合并到批次消息中，
+     *   批次延迟从所有监控器耗时之和降为其中最慢的一个
+     * - 批次Arena：批次消息和子消息都在调度器持有的Protobuf Arena上构造，
+     *   add_soft_irq()等子消息分配只是Arena内的指针移动；回调返回后Reset而不是逐个释放，
+     *   内存块由ArenaBlockPool复用，稳态采样路径不调用malloc
+     * - 自身计时：每次UpdateOnce的耗时记入该监控器的LatencyHistogram，
+     *   由ExportCollectorStats按统计窗口导出分位数
+     * - 自适应周期（可选）：注册时带AdaptiveSampler的监控器每次采样后由它决定下一个周期，
+     *   批次消息中为这些监控器各附带一条sample_interval（本次采样所在的周期）
+     *
+     * 线程模型：Run在调用线程上执行调度循环，Stop可以在任意线程调用。
+     */
+    class CollectorScheduler
+    {
+    public:
+        /**
+         * @brief 批次回调类型
+         *
+         * 参数为本批次到期的所有监控器填充后的消息，回调可以修改消息内容。
+         * 消息在批次Arena上分配，回调返回后即被回收：需要保留数据时拷贝出去
+         * （如RpcClient::PushMonitorInfo(const MonitorInfo&)），不能保存指针，
+         * 也不要对其使用std::move（跨Arena移动会退化为深拷贝加堆分配）。
+         */
+        using BatchHandler = std::function<void(monitor::proto::MonitorInfo*)>;
+
+        /**
+         * @brief 同一批次的时间容差
+         *
+         * 截止时间落在当前时刻之后该容差内的监控器提前合并到当前批次，
+         * 周期成倍数关系的监控器（如250ms和500ms）因此总是一起上报。
+         */
+        static constexpr std::chrono::milliseconds kBatchSlack{1};
+
+        /**
+         * @brief 构造函数
+         * @param workers 并行采集的工作线程数，0表示在调度线程上串行执行所有监控器
+         */
+        explicit CollectorScheduler(size_t workers = 0);
+
+        /**
+         * @brief 注册监控器
+         * @param name 监控器名称（用于日志）
+         * @param collector 监控器实例
+         * @param period 采样周期（自适应时为初始周期），必须为正数
+         * @param adaptive 自适应周期控制，为空时使用固定周期
+         *
+         * 必须在Run之前调用。所有监控器的第一次采样都在Run开始时立即执行。
+         */
+        void Register(const std::string& name, std::shared_ptr<MonitorInter> collector,
+            std::chrono::nanoseconds period, std::shared_ptr<AdaptiveSampler> adaptive = nullptr);
+
+        /**
+         * @brief 运行调度循环，直到Stop被调用
+         * @param handler 批次回调，每个批次调用一次
+         */
+        void Run(const BatchHandler& handler);
+
+        /**
+         * @brief 立即把所有已注册的监控器作为一个批次运行一次
+         * @param handler 批次回调
+         *
+         * 与Run中的一个批次走完全相同的路径（批次Arena、并行采集、移动合并），
+         * 但不等待截止时间，也不修改调度状态；用于基准测试和一次性采集。
+         * 不能与Run同时调用。
+         */
+        void CollectAll(const BatchHandler& handler);
+
+        /**
+         * @brief 请求停止调度循环
+         *
+         * 调度线程在下一次唤醒时退出（最长等待一个最短采样周期），
+         * 退出前调用所有监控器的Stop。
+         */
+        void Stop() { running_.store(false); }
+
+        /**
+         * @brief 导出各监控器本窗口的采样耗时并开始新窗口
+         * @param monitor_info 输出参数，每个本窗口运行过的监控器追加一条collector_stats
+         *
+         * 只能在批次回调中调用（此时本批次的并行采集已经全部完成，直方图不会被并发写入）。
+         */
+        void ExportCollectorStats(monitor::proto::MonitorInfo* monitor_info);
+
+    private:
+        /**
+         * @brief 已注册的监控器
+         */
+        struct Collector
+        {
+            std::string name;                          ///< 监控器名称
+            std::shared_ptr<MonitorInter> collector;   ///< 监控器实例
+            int64_t period_ns;                         ///< 采样周期（纳秒）
+            LatencyHistogram latency;                  ///< 本窗口的UpdateOnce耗时
+            std::shared_ptr<AdaptiveSampler> adaptive; ///< 自适应周期控制（固定周期时为空）
+        };
+
+        /**
+         * @brief 最小堆中的截止时间条目
+         */
+        struct Deadline
+        {
+            int64_t deadline_ns;   ///< 下一次采样的绝对时间（CLOCK_MONOTONIC，纳秒）
+            size_t index;          ///< 在collectors_中的索引
+
+            /// @brief 截止时间早的排在堆顶
+            bool operator>(const Deadline& other) const { return deadline_ns > other.deadline_ns; }
+        };
+
+        /**
+         * @brief 获取当前CLOCK_MONOTONIC时间
+         * @return int64_t 纳秒
+         */
+        static int64_t NowNs();
+
+        /**
+         * @brief 睡眠到指定的绝对时间
+         * @param deadline_ns CLOCK_MONOTONIC绝对时间（纳秒）
+         */
+        static void SleepUntil(int64_t deadline_ns);
+
+        /**
+         * @brief 运行本批次到期的监控器，结果写入monitor_info
+         * @param monitor_info 输出参数，批次消息
+         */
+        void CollectDue(monitor::proto::MonitorInfo* monitor_info);
+
+        /**
+         * @brief 运行一个监控器并记录耗时
+         * @param entry 监控器
+         * @param monitor_info 输出参数，监控器填充的消息
+         */
+        static void RunTimed(Collector* entry, monitor::proto::MonitorInfo* monitor_info);
+
+        /**
+         * @brief 为本批次中自适应的监控器记录周期并计算下一个周期
+         * @param monitor_info 批次消息，追加sample_interval
+         */
+        void Adapt(monitor::proto::MonitorInfo* monitor_info);
+
+        /**
+         * @brief 在批次Arena上运行due_中的监控器并调用回调，完成后回收Arena
+         * @param handler 批次回调
+         * @param adapt 是否更新自适应周期（CollectAll不修改调度状态）
+         */
+        void RunBatch(const BatchHandler& handler, bool adapt);
+
+        /**
+         * @brief 把子消息中的字段移动合并到目标消息
+         * @param from 子消息，合并后内容不再可用
+         * @param to 目标消息
+         *
+         * 各监控器写入MonitorInfo的不同字段，通过反射交换字段指针完成合并
+         * （两个消息在同一个Arena上，交换不涉及拷贝）；
+         * 目标消息中已经存在的字段（两个监控器写了同一个字段）退回MergeFrom拷贝。
+         */
+        void MergeByMove(monitor::proto::MonitorInfo* from, monitor::proto::MonitorInfo* to);
+
+        std::vector<Collector> collectors_;   ///< 已注册的监控器
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;   ///< 截止时间最小堆
+        std::vector<Deadline> due_;           ///< 复用的本批次到期条目
+        std::unique_ptr<WorkerPool> pool_;    ///< 并行采集线程池（未配置时为空）
+        std::vector<monitor::proto::MonitorInfo*> sub_infos_;  ///< 本批次各监控器的子消息（在批次Arena上）
+        std::vector<const google::protobuf::FieldDescriptor*> merge_fields_;    ///< 移动合并复用的字段列表
+        std::vector<const google::protobuf::FieldDescriptor*> merge_movable_;   ///< 移动合并复用的可交换字段列表
+        google::protobuf::Arena arena_{ArenaBlockPool::Options()};             ///< 批次Arena
+        std::atomic<bool> running_{false};    ///< 调度循环运行标志
+    };
+}  // namespace monitor
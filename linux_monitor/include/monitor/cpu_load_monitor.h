@@ -2,7 +2,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "utils/proc_parser.h"        // /proc零拷贝解析器
 
 // Protobuf和gRPC生成的头文件
 #include "monitor_info.grpc.pb.h"     // gRPC服务相关定义（可能间接需要）
@@ -24,11 +27,10 @@ namespace monitor
     {
     public:
         /**
-         * @brief 默认构造函数
-         *
-         * 初始化CPU负载监控器，成员变量会在UpdateOnce方法中被赋值。
+         * @brief 构造函数
+         * @param path 数据源路径，默认为/proc/loadavg（基准测试传入合成的fixture文件）
          */
-        CpuLoadMonitor() {}
+        explicit CpuLoadMonitor(const std::string& path = "/proc/loadavg") : loadavg_parser_(path) {}
 
         /**
          * @brief 更新监控信息（实现抽象基类接口）
@@ -59,6 +61,9 @@ namespace monitor
         float load_avg_1_;    ///< 存储1分钟平均负载值
         float load_avg_3_;    ///< 存储3分钟平均负载值
         float load_avg_15_;   ///< 存储15分钟平均负载值
+
+        ProcParser loadavg_parser_;              ///< /proc/loadavg解析器（缓冲区跨采样复用）
+        std::vector<std::string_view> fields_;   ///< 复用的字段容器
     };
 
 }  // namespace monitor
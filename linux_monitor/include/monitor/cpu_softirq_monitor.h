@@ -3,11 +3,15 @@
 
 // C++标准库头文件
 #include <string>            // 字符串操作
-#include <unordered_map>     // 哈希映射容器，用于存储CPU软中断数据
-#include <chrono>            // 高精度时间库，用于计算网络速率
+#include <string_view>       // 零拷贝字段视图
+#include <vector>            // 复用的字段容器
+#include <chrono>            // 高精度时间库，用于计算中断速率
+#include <cstdint>           // uint64_t
 
 // 项目自定义头文件
 #include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "utils/per_cpu_matrix.h"     // 按CPU索引寻址的稠密矩阵
+#include "utils/proc_parser.h"        // /proc零拷贝解析器
 #include "monitor_info.grpc.pb.h"     // gRPC生成代码（间接需要）
 #include "monitor_info.pb.h"          // Protobuf消息定义
 
@@ -29,32 +33,32 @@ namespace monitor
     class CpuSoftIrqMonitor : public MonitorInter
     {
         /**
-         * @brief 软中断数据结构体
+         * @brief 软中断类型索引
          *
-         * 用于存储单个CPU核心的软中断统计信息。
-         * 包含10种软中断类型的计数和时间戳，用于速率计算。
+         * 顺序与/proc/softirqs中各行的顺序一致，
+         * 每个类型对应计数矩阵中的一行（所有CPU核心连续存放）。
          */
-        struct SoftIrq
+        enum SoftIrqField
         {
-            std::string cpu_name;                             ///< CPU核心标识，如"CPU0", "CPU1"
-            int64_t hi;                                       ///< 高优先级任务软中断计数
-            int64_t timer;                                    ///< 定时器软中断计数
-            int64_t net_tx;                                   ///< 网络发送软中断计数
-            int64_t net_rx;                                   ///< 网络接收软中断计数
-            int64_t block;                                    ///< 块设备软中断计数
-            int64_t irq_poll;                                 ///< IRQ轮询软中断计数
-            int64_t tasklet;                                  ///< 小任务软中断计数
-            int64_t sched;                                    ///< 调度器软中断计数
-            int64_t hrtimer;                                  ///< 高精度定时器软中断计数
-            int64_t rcu;                                      ///< RCU（读-拷贝-更新）软中断计数
-            std::chrono::steady_clock::time_point timepoint;  ///< 采样时间点
+            HI = 0,      ///< 高优先级任务软中断计数
+            TIMER,       ///< 定时器软中断计数
+            NET_TX,      ///< 网络发送软中断计数
+            NET_RX,      ///< 网络接收软中断计数
+            BLOCK,       ///< 块设备软中断计数
+            IRQ_POLL,    ///< IRQ轮询软中断计数
+            TASKLET,     ///< 小任务软中断计数
+            SCHED,       ///< 调度器软中断计数
+            HRTIMER,     ///< 高精度定时器软中断计数
+            RCU,         ///< RCU（读-拷贝-更新）软中断计数
+            FIELD_MAX    ///< 软中断类型总数
         };
 
     public:
         /**
-         * @brief 默认构造函数
+         * @brief 构造函数
+         * @param path 数据源路径，默认为/proc/softirqs（基准测试传入合成的fixture文件）
          */
-        CpuSoftIrqMonitor() {}
+        explicit CpuSoftIrqMonitor(const std::string& path = "/proc/softirqs") : softirqs_parser_(path) {}
 
         /**
          * @brief 更新监控信息（实现抽象基类接口）
@@ -75,12 +79,21 @@ namespace monitor
 
     private:
         /**
-         * @brief CPU软中断数据存储
+         * @brief CPU软中断计数存储
          *
-         * 哈希映射，键为CPU核心名称（如"CPU0"），
-         * 值为SoftIrq结构体，存储上一次采样的数据。
-         * 用于计算两次采样之间的中断速率。
+         * 按CPU列索引（/proc/softirqs表头中的列顺序）寻址的struct-of-arrays矩阵，
+         * 每种软中断类型一行，所有CPU核心的计数连续存放，
+         * 当前和上次采样交替使用，不做按名称的哈希查找和结构体拷贝。
          */
-        std::unordered_map<std::string, struct SoftIrq> cpu_softirqs_;
+        PerCpuMatrix<uint64_t> prev_irqs_;                      ///< 上一次采样的软中断计数
+        PerCpuMatrix<uint64_t> cur_irqs_;                       ///< 本次采样的软中断计数
+        PerCpuMatrix<float> rate_;                              ///< 本次计算出的软中断速率（次/秒）
+        std::vector<std::string> cpu_name_list_;                ///< 列对应的CPU名称（变化时才重建）
+        bool has_prev_ = false;                                 ///< 是否已有上一次采样
+        std::chrono::steady_clock::time_point prev_time_;       ///< 上一次采样时间点
+
+        ProcParser softirqs_parser_;                             ///< /proc/softirqs解析器
+        std::vector<std::string_view> cpu_names_;                ///< 复用的表头字段（CPU名称）
+        std::vector<std::string_view> irq_row_;                  ///< 复用的软中断类型行字段
     };
 }  // namespace monitor
@@ -1,11 +1,15 @@
 // 头文件保护宏，防止重复包含
 #pragma once
 
+#include <cstdint>
 #include <string>
-#include <unordered_map>              // 哈希映射容器，用于存储CPU状态历史数据
+#include <string_view>
+#include <vector>
 
 // 项目自定义头文件
 #include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "utils/per_cpu_matrix.h"     // 按CPU索引寻址的稠密矩阵
+#include "utils/proc_parser.h"        // /proc零拷贝解析器
 #include "monitor_info.grpc.pb.h"     // gRPC生成代码（间接需要）
 #include "monitor_info.pb.h"          // Protobuf消息定义
 
@@ -19,35 +23,41 @@ namespace monitor
      *
      * 该类监控CPU在各种状态下的时间分布，包括用户态、系统态、空闲、等待I/O等。
      * 使用差分计算方式，通过前后两次采样的差值计算CPU使用率百分比。
+     *
+     * 状态存储：
+     * 按CPU槽位索引（槽位0为汇总行"cpu"，槽位N+1为"cpuN"）寻址的
+     * struct-of-arrays矩阵，当前和上次采样的计数器都是连续的uint64_t数组，
+     * 差分和百分比计算对所有CPU一次完成。
      */
     class CpuStatMonitor : public MonitorInter
     {
         /**
-         * @brief CPU状态数据结构体
+         * @brief /proc/stat中CPU时间片字段索引
          *
-         * 用于存储单个CPU核心的时间片统计信息（单位：jiffies，通常为10ms）。
+         * 顺序与/proc/stat每行的列顺序一致（单位：jiffies，通常为10ms），
          * 这些值表示从系统启动开始，CPU在各种状态下消耗的时间计数。
          */
-        struct CpuStat
+        enum CpuStatField
         {
-            std::string cpu_name;    ///< CPU核心标识，"cpu"表示总体，"cpu0"表示第一个核心
-            float user;              ///< 用户态时间（普通优先级进程）
-            float system;            ///< 系统态时间（内核代码）
-            float idle;              ///< 空闲时间
-            float nice;              ///< 用户态时间（低优先级进程）
-            float io_wait;           ///< 等待I/O完成的时间
-            float irq;               ///< 处理硬件中断的时间
-            float soft_irq;          ///< 处理软中断的时间
-            float steal;             ///< 被虚拟化环境偷走的时间（虚拟化环境）
-            float guest;             ///< 运行虚拟CPU的时间（虚拟化环境）
-            float guest_nice;        ///< 运行低优先级虚拟CPU的时间（虚拟化环境）
+            USER = 0,      ///< 用户态时间（普通优先级进程）
+            NICE,          ///< 用户态时间（低优先级进程）
+            SYSTEM,        ///< 系统态时间（内核代码）
+            IDLE,          ///< 空闲时间
+            IO_WAIT,       ///< 等待I/O完成的时间
+            IRQ,           ///< 处理硬件中断的时间
+            SOFT_IRQ,      ///< 处理软中断的时间
+            STEAL,         ///< 被虚拟化环境偷走的时间（虚拟化环境）
+            GUEST,         ///< 运行虚拟CPU的时间（虚拟化环境，已包含在user中）
+            GUEST_NICE,    ///< 运行低优先级虚拟CPU的时间（虚拟化环境，已包含在nice中）
+            FIELD_MAX      ///< 字段总数
         };
 
     public:
         /**
-         * @brief 默认构造函数
+         * @brief 构造函数
+         * @param path 数据源路径，默认为/proc/stat（基准测试传入合成的fixture文件）
          */
-        CpuStatMonitor() {}
+        explicit CpuStatMonitor(const std::string& path = "/proc/stat") : stat_parser_(path) {}
 
         /**
          * @brief 更新监控信息（实现抽象基类接口）
@@ -69,12 +79,37 @@ namespace monitor
 
     private:
         /**
-         * @brief CPU状态历史数据存储
+         * @brief 根据CPU名称计算槽位索引
+         * @param name CPU名称（"cpu"或"cpuN"）
+         * @param slot 输出参数，槽位索引
+         * @return bool 名称合法返回true
+         */
+        static bool CpuSlot(std::string_view name, size_t* slot);
+
+        /**
+         * @brief 确保矩阵和辅助数组至少包含指定数量的CPU槽位
+         * @param slots 需要的槽位数
+         */
+        void EnsureSlots(size_t slots);
+
+        /**
+         * @brief 计算所有CPU的使用率百分比
          *
-         * 哈希映射，键为CPU核心名称（如"cpu"、"cpu0"、"cpu1"），
-         * 值为CpuStat结构体，存储上一次采样的数据。
-         * 用于计算两次采样之间的CPU使用率变化。
+         * 对连续数组做差分：先求每个CPU的总时间片变化量，
+         * 再把每个字段的变化量乘以该CPU的100/总变化量，结果写入percent_。
          */
-        std::unordered_map<std::string, struct CpuStat> cpu_stat_map_;
+        void ComputePercents();
+
+        PerCpuMatrix<uint64_t> prev_stat_;     ///< 上一次采样的时间片计数
+        PerCpuMatrix<uint64_t> cur_stat_;      ///< 本次采样的时间片计数
+        PerCpuMatrix<float> percent_;          ///< 本次计算出的各字段百分比
+        std::vector<double> total_diff_;       ///< 每个CPU的总时间片变化量
+        std::vector<double> busy_diff_;        ///< 每个CPU的繁忙时间片变化量
+        std::vector<uint8_t> prev_seen_;       ///< 上一次采样中出现过的槽位（CPU可能离线）
+        std::vector<uint8_t> cur_seen_;        ///< 本次采样中出现过的槽位
+        std::vector<std::string> cpu_names_;   ///< 槽位对应的CPU名称（首次出现时构造一次）
+
+        ProcParser stat_parser_;                 ///< /proc/stat解析器（缓冲区跨采样复用）
+        std::vector<std::string_view> fields_;   ///< 复用的字段容器
     };
 }  // namespace monitor
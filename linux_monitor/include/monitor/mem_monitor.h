@@ -2,10 +2,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <unordered_map>              // 哈希映射容器
+#include <vector>
 
 // 项目自定义头文件
 #include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "utils/proc_parser.h"        // /proc零拷贝解析器
 #include "monitor_info.grpc.pb.h"     // gRPC生成代码（间接需要）
 #include "monitor_info.pb.h"          // Protobuf消息定义
 
@@ -54,9 +57,10 @@ namespace monitor
 
     public:
         /**
-         * @brief 默认构造函数
+         * @brief 构造函数
+         * @param path 数据源路径，默认为/proc/meminfo（基准测试传入合成的fixture文件）
          */
-        MemMonitor() {}
+        explicit MemMonitor(const std::string& path = "/proc/meminfo") : meminfo_parser_(path) {}
 
         /**
          * @brief 更新内存监控信息（实现抽象基类接口）
@@ -75,5 +79,9 @@ namespace monitor
          * 因此实现为空。
          */
         void Stop() override {}
+
+    private:
+        ProcParser meminfo_parser_;              ///< /proc/meminfo解析器（缓冲区跨采样复用）
+        std::vector<std::string_view> fields_;   ///< 复用的字段容器
     };
 }  // namespace monitor
@@ -3,11 +3,17 @@
 
 // C++标准库头文件
 #include <string>            // 字符串操作
-#include <unordered_map>     // 哈希映射容器，用于存储网络接口历史数据
+#include <string_view>       // 零拷贝字段视图
+#include <vector>            // 复用的字段容器
 #include <chrono>            // 高精度时间库，用于计算网络速率
+#include <cstdint>           // uint64_t
+#include <unordered_map>     // 按ifindex对齐上次采样
 
 // 项目自定义头文件
 #include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "utils/netlink_link_reader.h"  // rtnetlink网络接口统计读取器
+#include "utils/per_cpu_matrix.h"     // 按列索引寻址的稠密矩阵
+#include "utils/proc_parser.h"        // /proc零拷贝解析器
 #include "monitor_info.grpc.pb.h"     // gRPC生成代码（间接需要）
 #include "monitor_info.pb.h"          // Protobuf消息定义
 
@@ -22,36 +28,60 @@ namespace monitor
      *
      * 该类采用差分计算方法，通过记录前后两次采样的数据和时间戳，
      * 计算出精确的网络速率（如：KB/s, packets/s）。
+     *
+     * 数据源可在运行时选择：
+     * - PROCFS：解析/proc/net/dev的文本，按接口名称对齐前后两次采样
+     * - NETLINK：通过NetlinkLinkReader一次批量转储所有接口的64位计数，按ifindex对齐；
+     *   容器主机上有几百个veth/macvlan接口时开销远小于解析文本
      */
     class NetMonitor : public MonitorInter
     {
         /**
-         * @brief 网络接口信息数据结构体
+         * @brief 网络接口计数器字段索引
          *
-         * 用于存储单个网络接口的统计信息，包括：
-         * - 接收和发送的字节数、数据包数
-         * - 接收和发送的错误数、丢包数
-         * - 采样时间点（用于计算速率）
+         * 每个字段对应计数矩阵中的一行，所有网络接口的累计值连续存放，
+         * 所有值都从系统启动或接口启动开始累加。
          */
-        struct NetInfo
+        enum NetField
         {
-            std::string name;                                  ///< 网络接口名称（如eth0、lo、wlan0）
-            int64_t rcv_bytes;                                 ///< 累计接收字节数（bytes）
-            int64_t rcv_packets;                               ///< 累计接收数据包数（packets）
-            int64_t err_in;                                    ///< 累计接收错误数
-            int64_t drop_in;                                   ///< 累计接收丢包数
-            int64_t snd_bytes;                                 ///< 累计发送字节数（bytes）
-            int64_t snd_packets;                               ///< 累计发送数据包数（packets）
-            int64_t err_out;                                   ///< 累计发送错误数
-            int64_t drop_out;                                  ///< 累计发送丢包数
-            std::chrono::steady_clock::time_point timepoint;   ///< 数据采样时间点
+            RCV_BYTES = 0,   ///< 累计接收字节数（bytes）
+            RCV_PACKETS,     ///< 累计接收数据包数（packets）
+            ERR_IN,          ///< 累计接收错误数
+            DROP_IN,         ///< 累计接收丢包数
+            SND_BYTES,       ///< 累计发送字节数（bytes）
+            SND_PACKETS,     ///< 累计发送数据包数（packets）
+            ERR_OUT,         ///< 累计发送错误数
+            DROP_OUT,        ///< 累计发送丢包数
+            FIELD_MAX        ///< 字段总数
         };
 
     public:
         /**
-         * @brief 默认构造函数
+         * @brief 数据源类型
          */
-        NetMonitor() {}
+        enum class Backend
+        {
+            PROCFS,     ///< 解析/proc/net/dev
+            NETLINK,    ///< rtnetlink批量转储
+        };
+
+        /**
+         * @brief 构造函数，使用/proc/net/dev数据源
+         * @param path 数据源路径，默认为/proc/net/dev（基准测试传入合成的fixture文件）
+         */
+        explicit NetMonitor(const std::string& path = "/proc/net/dev") : net_dev_parser_(path) {}
+
+        /**
+         * @brief 构造函数，按类型选择数据源
+         * @param backend 数据源类型；选择NETLINK但rtnetlink不可用时退回PROCFS
+         */
+        explicit NetMonitor(Backend backend);
+
+        /**
+         * @brief 获取实际使用的数据源
+         * @return Backend 数据源类型
+         */
+        Backend GetBackend() const { return backend_; }
 
         /**
          * @brief 更新网络监控信息（实现抽象基类接口）
@@ -73,12 +103,54 @@ namespace monitor
 
     private:
         /**
-         * @brief 网络接口历史数据存储
+         * @brief 从/proc/net/dev读取本次采样
+         * @return size_t 接口数；读取失败返回0
+         */
+        size_t LoadProcfs();
+
+        /**
+         * @brief 从rtnetlink读取本次采样
+         * @return size_t 接口数；读取失败返回0
+         */
+        size_t LoadNetlink();
+
+        /**
+         * @brief 准备第iface_num列（名称只在变化时重建，列数不够时按倍数扩容）
+         * @param iface_num 列索引
+         * @param name 接口名称
+         */
+        void PrepareColumn(size_t iface_num, std::string_view name);
+
+        /**
+         * @brief 接口列表变化时把上次采样对齐到本次的列顺序
+         *
+         * 只在接口增删或顺序变化时调用；PROCFS按接口名称、NETLINK按ifindex匹配。
+         * 本次新出现的接口在prev_valid_中标记为无效。
+         */
+        void AlignPrevious();
+
+        /**
+         * @brief 网络接口计数存储
          *
-         * 哈希映射，键为网络接口名称（如"eth0"、"lo"），
-         * 值为NetInfo结构体，存储上一次采样的数据和时间戳。
-         * 用于计算两次采样之间的网络速率变化。
+         * 按接口在/proc/net/dev中的行顺序（列索引）寻址的struct-of-arrays矩阵，
+         * 当前和上次采样交替使用，接口列表不变时不做按名称的哈希查找和结构体拷贝。
          */
-        std::unordered_map<std::string, struct NetInfo> net_info_;
+        PerCpuMatrix<uint64_t> prev_counters_;                  ///< 上一次采样的累计计数
+        PerCpuMatrix<uint64_t> cur_counters_;                   ///< 本次采样的累计计数
+        PerCpuMatrix<uint64_t> aligned_counters_;               ///< 接口列表变化时对齐后的上次采样
+        PerCpuMatrix<float> rate_;                              ///< 本次计算出的速率（单位/秒）
+        std::vector<std::string> prev_names_;                   ///< 上一次采样各列的接口名称
+        std::vector<std::string> cur_names_;                    ///< 本次采样各列的接口名称
+        std::vector<uint32_t> prev_ifindex_;                    ///< 上一次采样各列的ifindex（NETLINK）
+        std::vector<uint32_t> cur_ifindex_;                     ///< 本次采样各列的ifindex（NETLINK）
+        std::unordered_map<uint32_t, size_t> prev_columns_;     ///< 对齐时ifindex到上次列索引的映射
+        std::vector<uint8_t> prev_valid_;                       ///< 各列在上一次采样中是否存在
+        bool has_prev_ = false;                                 ///< 是否已有上一次采样
+        std::chrono::steady_clock::time_point prev_time_;       ///< 上一次采样时间点
+
+        Backend backend_ = Backend::PROCFS;      ///< 实际使用的数据源
+        ProcParser net_dev_parser_;              ///< /proc/net/dev解析器（缓冲区跨采样复用）
+        std::vector<std::string_view> fields_;   ///< 复用的字段容器
+        NetlinkLinkReader netlink_;              ///< rtnetlink读取器（NETLINK）
     };
 }  // namespace monitor
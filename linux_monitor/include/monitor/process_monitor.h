@@ -0,0 +1,175 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <chrono>            // 目录重扫周期、采样间隔
+#include <cstddef>           // size_t
+#include <cstdint>           // uint64_t
+#include <string>            // 进程名
+#include <string_view>       // 零拷贝字段视图
+#include <unordered_map>     // pid索引的缓存
+#include <vector>            // 复用的缓冲区
+
+// 项目自定义头文件
+#include "monitor/monitor_inter.h"    // 监控器接口基类
+#include "monitor_info.grpc.pb.h"     // gRPC生成代码（间接需要）
+#include "monitor_info.pb.h"          // Protobuf消息定义
+
+namespace monitor
+{
+    /**
+     * @brief 进程监控器类
+     *
+     * 上报CPU使用率最高的前N个进程和常驻内存最高的前N个进程（合并去重，CPU排名在前），
+     * 出现负载问题时不需要登录主机运行top。
+     *
+     * 进程很多（上万个进程、几万个线程）时逐个打开/proc/[pid]/stat代价过高，采用以下方式控制开销：
+     * - 常驻fd缓存：按pid索引缓存已打开的/proc/[pid]/stat，每次采样只做pread；
+     *   进程退出后pread失败（fd绑定的是原进程，pid被复用也不会读到新进程），缓存项随即删除。
+     *   缓存的fd数不超过RLIMIT_NOFILE软限制的一半，超出的进程每次采样临时openat
+     * - 周期性重扫：/proc目录只每隔rescan_period列举一次来发现新进程，两次重扫之间启动的进程
+     *   在下一次重扫后才会出现
+     * - 空闲退避：连续没有CPU增量的进程按2、4、8、16个tick的间隔读取，没读的tick沿用上次的值，
+     *   忙碌的进程每个tick都读；CPU使用率按两次读取之间的实际时间计算，间隔变长不影响结果。
+     *   达到最大间隔的进程按pid分散到各个tick，1万个空闲进程每个tick只读约1/16；
+     *   空闲进程开始占用CPU后最多kMaxIdleSkip个tick出现在排名中
+     * - 有界堆选择：只维护大小为N的最小堆，选择代价为O(进程数 × log N)
+     * - 零拷贝解析：stat内容读入复用的缓冲区，用ProcParser::SplitFields按视图分割，
+     *   稳态采样只为新进程的名称分配内存
+     */
+    class ProcessMonitor : public MonitorInter
+    {
+    public:
+        /// @brief 默认上报的进程数（按CPU、按内存各取前N个）
+        static constexpr size_t kDefaultTopN = 10;
+
+        /// @brief 默认的/proc目录重扫周期
+        static constexpr std::chrono::milliseconds kDefaultRescanPeriod{2000};
+
+        /// @brief 空闲进程的最大读取间隔（tick）
+        static constexpr uint32_t kMaxIdleSkip = 16;
+
+        /**
+         * @brief 构造函数
+         * @param top_n 按CPU、按内存各上报的进程数
+         * @param rescan_period /proc目录的重扫周期
+         * @param proc_root proc文件系统的根目录，默认为/proc（基准测试传入合成的fixture目录）
+         */
+        explicit ProcessMonitor(size_t top_n = kDefaultTopN,
+            std::chrono::milliseconds rescan_period = kDefaultRescanPeriod,
+            const std::string& proc_root = "/proc");
+
+        /**
+         * @brief 析构函数，关闭所有缓存的fd
+         */
+        ~ProcessMonitor() override;
+
+        // 持有fd，禁止拷贝
+        ProcessMonitor(const ProcessMonitor&) = delete;
+        ProcessMonitor& operator=(const ProcessMonitor&) = delete;
+
+        /**
+         * @brief 更新进程监控信息（实现抽象基类接口）
+         * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+         *
+         * 必要时重扫/proc目录，读取到期的进程，选出前N个进程填充process_info。
+         */
+        void UpdateOnce(monitor::proto::MonitorInfo* monitor_info) override;
+
+        /**
+         * @brief 停止监控（实现抽象基类接口）
+         */
+        void Stop() override {}
+
+        /**
+         * @brief 获取当前跟踪的进程数
+         * @return size_t 缓存中的进程数
+         */
+        size_t TrackedCount() const { return processes_.size(); }
+
+    private:
+        /**
+         * @brief 一个被跟踪的进程
+         */
+        struct Process
+        {
+            int fd = -1;                  ///< 常驻的/proc/[pid]/stat fd，-1表示未缓存（每次临时打开）
+            std::string name;             ///< 上报的进程标识"<comm>[<pid>]"
+            uint64_t cpu_ticks = 0;       ///< 上次读取时的utime + stime（时钟tick）
+            std::chrono::steady_clock::time_point read_time;   ///< 上次读取的时间
+            bool has_prev = false;        ///< 是否已有上次读取
+            float cpu_percent = 0;        ///< 最近一次计算的CPU使用率
+            uint64_t rss_kb = 0;          ///< 最近一次读取的常驻内存
+            uint32_t threads = 0;         ///< 最近一次读取的线程数
+            uint32_t idle_streak = 0;     ///< 连续没有CPU增量的读取次数
+            uint64_t next_read_tick = 0;  ///< 下一次读取的tick
+            uint64_t seen_scan = 0;       ///< 最近一次在目录列表中出现的重扫序号
+        };
+
+        /**
+         * @brief 参与排名的候选
+         */
+        struct Candidate
+        {
+            float key;                    ///< 排名依据（CPU使用率或常驻内存）
+            uint32_t pid;                 ///< 进程号
+        };
+
+        /**
+         * @brief 列举/proc目录，加入新进程，删除已经不在列表中的进程
+         */
+        void Rescan();
+
+        /**
+         * @brief 读取并解析一个进程的stat
+         * @param pid 进程号
+         * @param process 缓存项
+         * @param now 本次采样时间
+         * @return bool 读取成功返回true；进程已退出返回false
+         */
+        bool ReadProcess(uint32_t pid, Process* process, std::chrono::steady_clock::time_point now);
+
+        /**
+         * @brief 读取/proc/[pid]/stat到stat_buffer_
+         * @param pid 进程号
+         * @param process 缓存项（按需打开或关闭其fd）
+         * @return size_t 读取到的字节数，失败返回0
+         */
+        size_t ReadStat(uint32_t pid, Process* process);
+
+        /**
+         * @brief 用有界最小堆选出key最大的前top_n_个候选
+         * @param by_cpu true按CPU使用率，false按常驻内存
+         * @param selected 输出参数，选中的pid（按key降序追加）
+         */
+        void SelectTop(bool by_cpu, std::vector<uint32_t>* selected);
+
+        /**
+         * @brief 关闭一个缓存项的fd
+         * @param process 缓存项
+         */
+        void CloseFd(Process* process);
+
+        size_t top_n_;                                      ///< 按CPU、按内存各上报的进程数
+        std::chrono::steady_clock::duration rescan_period_; ///< 目录重扫周期
+        std::string proc_root_;                             ///< proc文件系统根目录
+        int proc_fd_ = -1;                                  ///< 根目录fd（openat的基准目录）
+        size_t fd_budget_;                                  ///< 最多缓存的fd数
+        size_t open_fds_ = 0;                               ///< 当前缓存的fd数
+        double ticks_per_second_;                           ///< 时钟tick频率（sysconf(_SC_CLK_TCK)）
+        uint64_t page_kb_;                                  ///< 每页的KB数
+
+        std::unordered_map<uint32_t, Process> processes_;   ///< pid索引的进程缓存
+        std::chrono::steady_clock::time_point last_rescan_; ///< 上次重扫时间
+        bool scanned_ = false;                              ///< 是否已经重扫过
+        uint64_t scan_serial_ = 0;                          ///< 重扫序号
+        uint64_t tick_ = 0;                                 ///< 采样次数
+
+        // ==================== 复用缓冲区（稳态不分配） ====================
+        std::vector<char> stat_buffer_;                     ///< stat内容
+        std::vector<std::string_view> fields_;              ///< stat字段视图
+        std::vector<uint32_t> exited_;                      ///< 本次采样中退出的进程
+        std::vector<Candidate> heap_;                       ///< 有界最小堆
+        std::vector<uint32_t> selected_;                    ///< 选中的pid
+    };
+}  // namespace monitor
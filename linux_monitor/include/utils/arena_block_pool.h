@@ -0,0 +1,60 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cstddef>      // size_t
+
+// Protobuf头文件
+#include <google/protobuf/arena.h>
+
+namespace monitor
+{
+    /**
+     * @brief Protobuf Arena的内存块池
+     *
+     * 调度器每次采样在同一个Arena上构造MonitorInfo，上报后Reset。
+     * Arena默认在Reset时把内存块还给malloc，下一次采样再重新申请；
+     * 并行采集时每个工作线程在Arena中还有自己的内存块链，同样每次重新申请。
+     *
+     * 通过ArenaOptions的block_alloc/block_dealloc接管内存块的申请和释放：
+     * - 所有内存块固定为kBlockSize（起始块和最大块大小相同）
+     * - 释放的块放入空闲链表，下一次申请直接复用
+     * - 单次申请超过kBlockSize的大块（罕见）直接使用operator new/delete
+     *
+     * 预热几次采样后，空闲链表中的块数等于单次采样的峰值块数，此后稳态采样路径不再调用malloc。
+     * 线程安全：空闲链表由互斥锁保护（每个内存块只在申请/释放时加锁一次）。
+     */
+    class ArenaBlockPool
+    {
+    public:
+        /// @brief 内存块大小
+        static constexpr size_t kBlockSize = 64 * 1024;
+
+        /**
+         * @brief 获取使用内存块池的Arena选项
+         * @return google::protobuf::ArenaOptions Arena构造参数
+         */
+        static google::protobuf::ArenaOptions Options();
+
+        /**
+         * @brief 获取空闲链表中的块数（用于基准测试和调试）
+         * @return size_t 空闲块数
+         */
+        static size_t CachedBlocks();
+
+    private:
+        /**
+         * @brief 申请内存块（ArenaOptions::block_alloc）
+         * @param size 块大小
+         * @return void* 内存块
+         */
+        static void* Allocate(size_t size);
+
+        /**
+         * @brief 释放内存块（ArenaOptions::block_dealloc）
+         * @param block 内存块
+         * @param size 块大小
+         */
+        static void Release(void* block, size_t size);
+    };
+}  // namespace monitor
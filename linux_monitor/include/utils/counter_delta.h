@@ -0,0 +1,106 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <type_traits>  // std::is_same_v
+
+// 项目自定义头文件
+#include "utils/per_cpu_matrix.h"     // 按CPU索引寻址的稠密矩阵
+
+namespace monitor
+{
+    /**
+     * @brief 计数器差分速率计算内核
+     *
+     * 所有基于差分计算速率的监控器（软中断、CPU状态、网络）共用的计算内核：
+     *
+     *   out[i] = max(cur[i] - prev[i], 0) × scale
+     *
+     * 输入是两次采样的uint64_t累计计数器（连续数组），输出是连续的float速率数组，
+     * 监控器再从输出数组填充Protobuf消息。
+     *
+     * 运行时按CPU能力选择实现（进程内只检测一次）：
+     * - x86：AVX2（每次4个计数器）> SSE4.2（每次2个计数器）> 标量
+     * - ARM64：NEON（每次2个计数器，ARMv8必备，无需检测）
+     *
+     * 计数器回退（如CPU重新上线、网卡被重置）时差值按0处理，
+     * 避免无符号减法回绕成巨大的速率。
+     */
+    class CounterDelta
+    {
+    public:
+        /**
+         * @brief 内核实现类型
+         */
+        enum class Isa
+        {
+            SCALAR = 0,    ///< 标量实现（所有平台可用）
+            SSE4,          ///< x86 SSE4.2
+            AVX2,          ///< x86 AVX2
+            NEON           ///< ARM64 NEON
+        };
+
+        /**
+         * @brief 计算一段连续计数器的速率（统一缩放系数）
+         * @param cur 本次采样的计数器数组
+         * @param prev 上一次采样的计数器数组
+         * @param n 计数器个数
+         * @param scale 缩放系数（如1/时间间隔）
+         * @param out 输出参数，速率数组，长度至少为n
+         */
+        static void Rates(const uint64_t* cur, const uint64_t* prev, size_t n,
+            double scale, float* out);
+
+        /**
+         * @brief 计算一段连续计数器的速率（逐元素缩放系数）
+         * @param cur 本次采样的计数器数组
+         * @param prev 上一次采样的计数器数组
+         * @param n 计数器个数
+         * @param scale 缩放系数数组，长度至少为n（如每个CPU的100/总时间片）
+         * @param out 输出参数，速率数组，长度至少为n
+         */
+        static void Rates(const uint64_t* cur, const uint64_t* prev, size_t n,
+            const double* scale, float* out);
+
+        /**
+         * @brief 计算整个计数矩阵的速率
+         * @tparam T 输出矩阵元素类型（目前只支持float）
+         * @param cur 本次采样的计数矩阵
+         * @param prev 上一次采样的计数矩阵（维度必须与cur一致）
+         * @param scale 缩放系数（如1/时间间隔）
+         * @param out 输出参数，速率矩阵，维度会调整为与cur一致
+         *
+         * 矩阵是字段优先的连续存储，所有字段、所有CPU一次调用即可算完。
+         */
+        template <typename T>
+        static void Rates(const PerCpuMatrix<uint64_t>& cur, const PerCpuMatrix<uint64_t>& prev,
+            double scale, PerCpuMatrix<T>* out)
+        {
+            static_assert(std::is_same_v<T, float>, "CounterDelta only produces float rates");
+            out->Resize(cur.Fields(), cur.Cpus());
+            Rates(cur.Data(), prev.Data(), cur.Size(), scale, out->Data());
+        }
+
+        /**
+         * @brief 获取当前使用的内核实现
+         * @return Isa 内核实现类型
+         */
+        static Isa ActiveIsa();
+
+        /**
+         * @brief 获取内核实现的名称（用于日志和基准测试）
+         * @param isa 内核实现类型
+         * @return const char* 名称，如"avx2"
+         */
+        static const char* IsaName(Isa isa);
+
+        /**
+         * @brief 强制使用指定的内核实现（用于基准测试对比）
+         * @param isa 内核实现类型
+         * @return bool 当前CPU支持该实现并切换成功返回true
+         */
+        static bool ForceIsa(Isa isa);
+    };
+}  // namespace monitor
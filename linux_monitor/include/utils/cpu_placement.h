@@ -0,0 +1,121 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cstdint>      // uint64_t
+#include <string>       // CPU列表文本、错误描述
+#include <string_view>  // 解析CPU列表
+#include <vector>       // CPU和NUMA节点列表
+
+namespace monitor
+{
+    /**
+     * @brief 采集端进程的CPU亲和性、调度策略和NUMA内存布局
+     *
+     * 在延迟敏感的主机上，采集线程、工作线程、RPC发送线程和gRPC内部线程不能与业务独占的
+     * 核心（isolcpus/nohz_full）争抢CPU，也不能跨NUMA节点访问内存。Apply必须在main的最开始、
+     * 创建任何线程和监控器之前调用：
+     * - 亲和性、SCHED_IDLE和nice都是线程属性，之后创建的线程继承；已存在的线程逐个设置
+     * - 内存策略绑定到所选CPU所在的节点（MPOL_BIND），之后分配的缓冲区（包括各监控器的
+     *   PerCpuMatrix）首次写入时都落在本地节点；已经分配的页面用migrate_pages迁移过去
+     *
+     * auto模式下从当前亲和性中去掉/sys/devices/system/cpu/isolated和nohz_full中的CPU，
+     * 并只保留其中CPU最多的一个NUMA节点；显式指定的CPU列表也会去掉独占核心。
+     * 不依赖libnuma，直接使用set_mempolicy、migrate_pages系统调用。
+     */
+    class CpuPlacement
+    {
+    public:
+        /**
+         * @brief 放置配置（对应命令行选项）
+         */
+        struct Config
+        {
+            std::string cpuset;        ///< 空串不绑定，"auto"使用非独占核心，或CPU列表（如"0-3,8"）
+            bool sched_idle = false;   ///< 是否使用SCHED_IDLE调度策略
+            int nice = 0;              ///< nice值，0表示不修改
+        };
+
+        /**
+         * @brief 应用放置配置
+         * @param config 放置配置
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true（配置为空时直接成功）
+         */
+        bool Apply(const Config& config, std::string* error);
+
+        /**
+         * @brief 获取绑定后的CPU列表
+         * @return const std::vector<int>& 升序的CPU编号，未绑定时为空
+         */
+        const std::vector<int>& Cpus() const { return cpus_; }
+
+        /**
+         * @brief 获取内存绑定的NUMA节点
+         * @return const std::vector<int>& 升序的节点编号，未绑定或只有一个节点的主机上为空
+         */
+        const std::vector<int>& Nodes() const { return nodes_; }
+
+        /**
+         * @brief 获取应用配置时遇到的非致命问题
+         * @return const std::string& 如已有页面迁移失败，没有问题时为空
+         */
+        const std::string& Warning() const { return warning_; }
+
+        /**
+         * @brief 解析内核CPU列表格式（如"0-3,8,10-11"）
+         * @param text CPU列表文本（可带结尾换行）
+         * @param cpus 输出参数，升序去重的编号
+         * @return bool 格式正确返回true（空串得到空列表）
+         */
+        static bool ParseCpuList(std::string_view text, std::vector<int>* cpus);
+
+        /**
+         * @brief 把CPU列表格式化为内核CPU列表格式
+         * @param cpus 升序的编号
+         * @return std::string 如"0-3,8"
+         */
+        static std::string FormatCpuList(const std::vector<int>& cpus);
+
+        /**
+         * @brief 统计运行在列表之外的CPU上的线程数
+         * @param cpus 允许的CPU列表
+         * @return uint64_t /proc/self/task/<tid>/stat中最近一次运行的CPU不在列表中的线程数
+         */
+        static uint64_t ThreadsOutside(const std::vector<int>& cpus);
+
+        /**
+         * @brief 统计位于其他NUMA节点上的常驻内存
+         * @param nodes 本地节点列表
+         * @return uint64_t /proc/self/numa_maps中不在列表中的节点上的页面（KB）
+         */
+        static uint64_t RemoteNodeKb(const std::vector<int>& nodes);
+
+    private:
+        /**
+         * @brief 读取一个CPU列表文件
+         * @param path 文件路径
+         * @return std::vector<int> CPU列表，文件不存在或格式错误时为空
+         */
+        static std::vector<int> ReadCpuList(const std::string& path);
+
+        /**
+         * @brief 把亲和性和调度策略设置到本进程的所有线程
+         * @param config 放置配置
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true
+         */
+        bool ApplyThreads(const Config& config, std::string* error) const;
+
+        /**
+         * @brief 把内存策略绑定到nodes_并迁移已有页面
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true（页面迁移失败只记录到warning_）
+         */
+        bool BindMemory(std::string* error);
+
+        std::vector<int> cpus_;    ///< 绑定后的CPU
+        std::vector<int> nodes_;   ///< 内存绑定的NUMA节点
+        std::string warning_;      ///< 非致命问题
+    };
+}  // namespace monitor
@@ -0,0 +1,98 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <algorithm>    // std::max
+#include <array>        // 桶计数
+#include <bit>          // std::bit_width
+#include <cstddef>      // size_t
+#include <cstdint>      // int64_t、uint64_t
+
+namespace monitor
+{
+    /**
+     * @brief HDR风格的对数-线性耗时直方图
+     *
+     * 每个2的幂区间再均分为kSubBuckets个子桶，任意取值的相对误差不超过1/kSubBuckets（6.25%），
+     * 小于kSubBuckets的值精确记录；超过2^(kMaxExponent+1)-1纳秒（约36分钟）的值计入最后一个桶。
+     * 桶数组在对象内固定分配，Record只是一次位运算和一次计数递增，可以放在采样热路径上。
+     *
+     * 线程模型：不加锁，同一时刻只能由一个线程记录或读取。
+     */
+    class LatencyHistogram
+    {
+    public:
+        /// @brief 每个2的幂区间的子桶数（2^kSubBucketBits）
+        static constexpr int kSubBucketBits = 4;
+        static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+
+        /// @brief 记录的最大指数（最高桶覆盖[2^40, 2^41)纳秒）
+        static constexpr int kMaxExponent = 40;
+
+        /// @brief 桶总数：精确桶 + 每个指数kSubBuckets个子桶
+        static constexpr size_t kBuckets = kSubBuckets + (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+        /**
+         * @brief 记录一次耗时
+         * @param value_ns 耗时（纳秒），负数按0记录
+         */
+        void Record(int64_t value_ns)
+        {
+            const uint64_t value = value_ns > 0 ? static_cast<uint64_t>(value_ns) : 0;
+            ++counts_[BucketOf(value)];
+            ++count_;
+            max_ = std::max(max_, value);
+        }
+
+        /// @brief 记录的次数
+        uint64_t Count() const { return count_; }
+
+        /// @brief 记录的最大值（纳秒，精确值）
+        uint64_t Max() const { return max_; }
+
+        /**
+         * @brief 计算分位数
+         * @param quantile 分位（0到1，如0.99）
+         * @return uint64_t 分位数所在桶的上界（纳秒，不超过最大值），没有记录时返回0
+         */
+        uint64_t Percentile(double quantile) const;
+
+        /// @brief 清空所有记录（开始新的统计窗口）
+        void Reset();
+
+        /**
+         * @brief 合并另一个直方图的记录（如各线程各自记录，结束时汇总）
+         * @param other 另一个直方图
+         */
+        void Merge(const LatencyHistogram& other);
+
+    private:
+        /**
+         * @brief 计算取值所在的桶
+         * @param value 取值（纳秒）
+         * @return size_t 桶下标
+         */
+        static size_t BucketOf(uint64_t value)
+        {
+            if (value < kSubBuckets)
+            {
+                return static_cast<size_t>(value);
+            }
+            const int exponent = std::min(static_cast<int>(std::bit_width(value)) - 1, kMaxExponent);
+            const int shift = exponent - kSubBucketBits;
+            const uint64_t sub = std::min((value >> shift) - kSubBuckets, kSubBuckets - 1);
+            return static_cast<size_t>(kSubBuckets + static_cast<uint64_t>(shift) * kSubBuckets + sub);
+        }
+
+        /**
+         * @brief 计算桶的上界
+         * @param bucket 桶下标
+         * @return uint64_t 桶内的最大取值（纳秒）
+         */
+        static uint64_t UpperBound(size_t bucket);
+
+        std::array<uint64_t, kBuckets> counts_{};   ///< 各桶的计数
+        uint64_t count_ = 0;                        ///< 总次数
+        uint64_t max_ = 0;                          ///< 最大值
+    };
+}  // namespace monitor
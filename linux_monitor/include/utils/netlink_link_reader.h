@@ -0,0 +1,141 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cstddef>         // size_t
+#include <cstdint>         // uint16_t、uint32_t、uint64_t
+#include <string>          // 缓存的接口名称
+#include <string_view>     // 零拷贝接口名视图
+#include <unordered_map>   // ifindex索引的名称缓存
+#include <vector>          // 可复用的接收缓冲区
+
+namespace monitor
+{
+    /**
+     * @brief rtnetlink网络接口统计读取器
+     *
+     * 通过常驻的NETLINK_ROUTE套接字做一次批量转储，取回所有网络接口的64位累计计数，
+     * 代替逐行解析/proc/net/dev的文本。
+     *
+     * 数据来源：
+     * - 每次Load()发送一个RTM_GETSTATS转储请求，过滤器只选IFLA_STATS_LINK_64，
+     *   每个接口的回复只有ifindex和一个rtnl_link_stats64
+     * - 接口名称按ifindex缓存，只在收到RTMGRP_LINK组播通知（接口增删、改名）时
+     *   做一次RTM_GETLINK转储刷新；RTM_GETLINK回复携带接口的全部属性，
+     *   每次采样都用它比读取/proc/net/dev还慢
+     * - 内核不支持RTM_GETSTATS（4.7之前）时退回每次采样做RTM_GETLINK转储，读取IFLA_STATS64
+     *
+     * 设计特点：
+     * - 缓冲区复用：内核分批返回的所有消息追加到同一个缓冲区，只在接口变多时扩容
+     * - 零拷贝：接口名是指向名称缓存的视图，直到下一次调用Load()之前有效
+     * - 以ifindex标识接口：接口删除后重建的同名接口拥有新的ifindex，不会与旧接口的计数做差分
+     *
+     * 计数与/proc/net/dev保持一致：接收丢包数为rx_dropped + rx_missed_errors（与内核
+     * dev_seq_printf_stats相同），两种数据源计算出的速率可以直接比较。
+     *
+     * 典型用法：
+     * @code
+     * NetlinkLinkReader reader;
+     * NetlinkLinkReader::Link link;
+     * if (reader.Load())
+     * {
+     *     while (reader.NextLink(&link))
+     *     {
+     *         uint64_t rx = link.rx_bytes;
+     *     }
+     * }
+     * @endcode
+     */
+    class NetlinkLinkReader
+    {
+    public:
+        /**
+         * @brief 一个网络接口的累计计数
+         */
+        struct Link
+        {
+            uint32_t ifindex = 0;         ///< 接口索引
+            std::string_view name;        ///< 接口名称（指向名称缓存）
+            uint64_t rx_bytes = 0;        ///< 累计接收字节数
+            uint64_t rx_packets = 0;      ///< 累计接收数据包数
+            uint64_t rx_errors = 0;       ///< 累计接收错误数
+            uint64_t rx_dropped = 0;      ///< 累计接收丢包数（含rx_missed_errors）
+            uint64_t tx_bytes = 0;        ///< 累计发送字节数
+            uint64_t tx_packets = 0;      ///< 累计发送数据包数
+            uint64_t tx_errors = 0;       ///< 累计发送错误数
+            uint64_t tx_dropped = 0;      ///< 累计发送丢包数
+        };
+
+        NetlinkLinkReader() = default;
+
+        /**
+         * @brief 析构函数，关闭套接字
+         */
+        ~NetlinkLinkReader();
+
+        // 持有套接字，禁止拷贝
+        NetlinkLinkReader(const NetlinkLinkReader&) = delete;
+        NetlinkLinkReader& operator=(const NetlinkLinkReader&) = delete;
+
+        /**
+         * @brief 打开请求套接字和RTMGRP_LINK通知套接字
+         * @return bool 成功返回true（已打开时直接返回true）
+         *
+         * Load()会按需调用；单独调用用于在启动时判断rtnetlink是否可用。
+         */
+        bool Open();
+
+        /**
+         * @brief 转储所有网络接口的累计计数
+         * @return bool 收到完整的转储（NLMSG_DONE）返回true，失败返回false
+         *
+         * 收到过接口变化通知时先刷新名称缓存。失败时关闭套接字，下一次调用重新打开。
+         * 读取完成后重置游标，之前返回的视图失效。
+         */
+        bool Load();
+
+        /**
+         * @brief 获取下一个网络接口
+         * @param link 输出参数
+         * @return bool 还有接口返回true，到达末尾返回false
+         *
+         * 名称缓存中还没有的接口（两次转储之间刚创建）跳过，并在下一次Load()时刷新名称。
+         */
+        bool NextLink(Link* link);
+
+    private:
+        /**
+         * @brief 发送转储请求并把全部回复接收到buffer_
+         * @param type 请求类型（RTM_GETLINK或RTM_GETSTATS）
+         * @return int 成功返回0，内核拒绝请求时返回其错误码（正数），收发失败返回-1
+         */
+        int Dump(uint16_t type);
+
+        /**
+         * @brief 用一次RTM_GETLINK转储重建名称缓存
+         * @return bool 成功返回true
+         */
+        bool RefreshNames();
+
+        /**
+         * @brief 读空通知套接字，有任何接口变化通知时标记名称缓存需要刷新
+         */
+        void DrainEvents();
+
+        /**
+         * @brief 关闭所有套接字
+         */
+        void Close();
+
+        int fd_ = -1;                      ///< 请求套接字
+        int events_fd_ = -1;               ///< RTMGRP_LINK通知套接字（非阻塞）
+        uint32_t seq_ = 0;                 ///< 请求序号，用于丢弃过期的回复
+        bool use_getstats_ = true;         ///< 内核是否支持RTM_GETSTATS
+        bool names_dirty_ = true;          ///< 名称缓存是否需要刷新
+        std::unordered_map<uint32_t, std::string> names_;   ///< ifindex到接口名称的缓存
+
+        std::vector<char> buffer_;         ///< 一次转储的所有回复消息（按接收顺序拼接）
+        size_t size_ = 0;                  ///< buffer_中的有效字节数
+        size_t offset_ = 0;                ///< NextLink的游标
+    };
+}  // namespace monitor
@@ -0,0 +1,65 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cstdint>        // int64_t
+#include <string>         // 选项名和值
+#include <unordered_map>  // 选项表
+
+namespace monitor
+{
+    /**
+     * @brief 命令行选项解析器
+     *
+     * 解析形如"--key=value"的命令行参数，"--flag"等价于"--flag=true"。
+     * 不认识的参数原样保留，由调用者决定是否报错。
+     *
+     * 示例：
+     *   ./monitor --net_interval_ms=250 --mem_interval_ms=5000
+     */
+    class Options
+    {
+    public:
+        /**
+         * @brief 解析命令行参数
+         * @param argc 参数个数
+         * @param argv 参数数组（argv[0]为程序名，跳过）
+         * @return bool 所有参数格式合法返回true，遇到不以"--"开头的参数返回false
+         */
+        bool Parse(int argc, char** argv);
+
+        /**
+         * @brief 是否指定了某个选项
+         * @param key 选项名（不含"--"）
+         * @return bool 命令行中出现过该选项返回true
+         */
+        bool Has(const std::string& key) const { return values_.count(key) > 0; }
+
+        /**
+         * @brief 获取字符串选项
+         * @param key 选项名（不含"--"）
+         * @param default_value 未指定时的默认值
+         * @return std::string 选项值
+         */
+        std::string GetString(const std::string& key, const std::string& default_value) const;
+
+        /**
+         * @brief 获取整数选项
+         * @param key 选项名（不含"--"）
+         * @param default_value 未指定或格式非法时的默认值
+         * @return int64_t 选项值
+         */
+        int64_t GetInt(const std::string& key, int64_t default_value) const;
+
+        /**
+         * @brief 获取布尔选项
+         * @param key 选项名（不含"--"）
+         * @param default_value 未指定时的默认值
+         * @return bool 值为"true"、"1"、"yes"或"on"时返回true
+         */
+        bool GetBool(const std::string& key, bool default_value) const;
+
+    private:
+        std::unordered_map<std::string, std::string> values_;   ///< 选项名到值的映射
+    };
+}  // namespace monitor
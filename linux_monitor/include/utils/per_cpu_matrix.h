@@ -0,0 +1,105 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <algorithm>    // std::copy_n、std::min
+#include <cstddef>      // size_t
+#include <utility>      // std::swap
+#include <vector>       // 连续存储
+
+namespace monitor
+{
+    /**
+     * @brief 按CPU索引寻址的稠密矩阵（struct-of-arrays布局）
+     * @tparam T 元素类型（计数器使用uint64_t，计算结果使用float/double）
+     *
+     * 行为计数器字段（如user、system或HI、TIMER），列为CPU槽位索引
+     * （网络监控中列为网络接口索引），同一字段所有CPU的值在内存中连续存放：
+     *
+     *   field 0: [cpu0][cpu1][cpu2]...[cpuN]
+     *   field 1: [cpu0][cpu1][cpu2]...[cpuN]
+     *   ...
+     *
+     * 这种布局让"对所有CPU计算某个字段的差值"成为一个连续内存上的简单循环，
+     * 便于编译器自动向量化，也避免了按CPU名称做哈希查找和结构体拷贝。
+     *
+     * 设计特点：
+     * - 容量只增不减：CPU数量不变时Resize不产生任何分配
+     * - 扩容保序：CPU数量增加（如CPU热插拔）时原有数据按新布局保留
+     */
+    template <typename T>
+    class PerCpuMatrix
+    {
+    public:
+        /**
+         * @brief 调整矩阵维度
+         * @param fields 字段数（行数）
+         * @param cpus CPU槽位数（列数）
+         *
+         * 维度不变时不做任何操作；维度变化时按新布局搬移已有数据，
+         * 新增的位置填0。
+         */
+        void Resize(size_t fields, size_t cpus)
+        {
+            if (fields == fields_ && cpus == cpus_)
+            {
+                return;
+            }
+
+            std::vector<T> data(fields * cpus, T());
+            const size_t keep_fields = std::min(fields, fields_);
+            const size_t keep_cpus = std::min(cpus, cpus_);
+            for (size_t f = 0; f < keep_fields; ++f)
+            {
+                std::copy_n(data_.data() + f * cpus_, keep_cpus, data.data() + f * cpus);
+            }
+
+            data_.swap(data);
+            fields_ = fields;
+            cpus_ = cpus;
+        }
+
+        /**
+         * @brief 获取某个字段所有CPU的连续数组
+         * @param field 字段索引
+         * @return T* 指向该字段第一个CPU槽位的指针，长度为Cpus()
+         */
+        T* Field(size_t field) { return data_.data() + field * cpus_; }
+        const T* Field(size_t field) const { return data_.data() + field * cpus_; }
+
+        /**
+         * @brief 访问单个元素
+         * @param field 字段索引
+         * @param cpu CPU槽位索引
+         * @return T& 元素引用
+         */
+        T& At(size_t field, size_t cpu) { return data_[field * cpus_ + cpu]; }
+        const T& At(size_t field, size_t cpu) const { return data_[field * cpus_ + cpu]; }
+
+        /// @brief 所有元素的连续存储（字段优先）
+        T* Data() { return data_.data(); }
+        const T* Data() const { return data_.data(); }
+
+        /// @brief 字段数
+        size_t Fields() const { return fields_; }
+
+        /// @brief CPU槽位数
+        size_t Cpus() const { return cpus_; }
+
+        /// @brief 元素总数
+        size_t Size() const { return data_.size(); }
+
+        /// @brief 与另一个矩阵交换内容（用于"当前采样"和"上次采样"之间切换）
+        void Swap(PerCpuMatrix& other)
+        {
+            data_.swap(other.data_);
+            std::swap(fields_, other.fields_);
+            std::swap(cpus_, other.cpus_);
+        }
+
+    private:
+        std::vector<T> data_;   ///< 字段优先的连续存储
+        size_t fields_ = 0;     ///< 字段数
+        size_t cpus_ = 0;       ///< CPU槽位数
+    };
+}  // namespace monitor
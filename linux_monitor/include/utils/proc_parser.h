@@ -0,0 +1,124 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <charconv>      // std::from_chars，无分配的数值转换
+#include <cstddef>       // size_t
+#include <memory>        // std::shared_ptr
+#include <string>        // 文件路径
+#include <string_view>   // 零拷贝字段视图
+#include <vector>        // 可复用的缓冲区和字段容器
+
+// 项目自定义头文件
+#include "utils/procfs_source.h"   // 常驻fd的procfs数据源
+
+namespace monitor
+{
+    /**
+     * @brief /proc文件零拷贝解析器
+     *
+     * 替代ReadFile::ReadLine的逐行istringstream分词方式：
+     * 一次性将整个文件读入可复用的缓冲区，按行、按字段返回std::string_view，
+     * 数值转换使用std::from_chars，整个解析过程不产生任何临时std::string。
+     *
+     * 设计特点：
+     * - 缓冲区复用：缓冲区只在文件变大时扩容，稳态下每次采样零分配
+     * - 零拷贝：所有行和字段都是指向内部缓冲区的视图
+     * - 常驻fd：文件通过ProcfsRegistry只打开一次，每次Load()只做pread
+     * - 视图有效期：下一次调用Load()之前有效
+     *
+     * 典型用法：
+     * @code
+     * ProcParser parser("/proc/stat");
+     * std::vector<std::string_view> fields;
+     * std::string_view line;
+     * if (parser.Load())
+     * {
+     *     while (parser.NextLine(&line))
+     *     {
+     *         ProcParser::SplitFields(line, &fields);
+     *         int64_t user = ProcParser::ToNumber<int64_t>(fields[1]);
+     *     }
+     * }
+     * @endcode
+     */
+    class ProcParser
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param path 要解析的文件路径（如"/proc/stat"）
+         *
+         * 从ProcfsRegistry获取该路径的数据源，第一次调用Load()时才真正打开文件。
+         */
+        explicit ProcParser(const std::string& path)
+            : source_(ProcfsRegistry::Instance().Get(path)) {}
+
+        /**
+         * @brief 读取整个文件到内部缓冲区
+         * @return bool 读取成功返回true，文件打开或读取失败返回false
+         *
+         * 通过常驻fd使用pread从偏移0开始读取，缓冲区不足时按倍数扩容，
+         * 读取失败时数据源会透明地重新打开文件。
+         * 读取完成后重置行游标，之前返回的所有视图失效。
+         */
+        bool Load();
+
+        /**
+         * @brief 获取下一行
+         * @param line 输出参数，指向缓冲区内一行内容的视图（不含换行符）
+         * @return bool 还有行返回true，到达末尾返回false
+         */
+        bool NextLine(std::string_view* line);
+
+        /**
+         * @brief 获取整个文件内容的视图
+         * @return std::string_view 最近一次Load()读取到的内容
+         */
+        std::string_view Content() const { return std::string_view(buffer_.data(), size_); }
+
+        /**
+         * @brief 获取解析的文件路径
+         * @return const std::string& 文件路径
+         */
+        const std::string& Path() const { return source_->Path(); }
+
+        /**
+         * @brief 按空白字符分割一行
+         * @param line 要分割的行
+         * @param fields 输出参数，存储分割后的字段视图（调用前会被清空）
+         * @return size_t 字段个数
+         *
+         * 连续的空白字符视为一个分隔符，行首行尾的空白会被忽略。
+         * fields只在容量不足时扩容，调用者复用同一个vector即可避免分配。
+         */
+        static size_t SplitFields(std::string_view line, std::vector<std::string_view>* fields);
+
+        /**
+         * @brief 将字段转换为数值
+         * @tparam T 目标数值类型（整数或浮点数）
+         * @param field 要转换的字段
+         * @param default_value 转换失败时的返回值
+         * @return T 转换结果
+         *
+         * 基于std::from_chars实现，不依赖locale，也不会抛出异常。
+         */
+        template <typename T>
+        static T ToNumber(std::string_view field, T default_value = T())
+        {
+            T value = default_value;
+            auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+            if (result.ec != std::errc())
+            {
+                return default_value;
+            }
+            return value;
+        }
+
+    private:
+        std::shared_ptr<ProcfsSource> source_;   ///< 常驻fd的数据源（可与其他解析器共享）
+        std::vector<char> buffer_;               ///< 可复用的文件内容缓冲区（每个解析器独享）
+        size_t size_ = 0;                        ///< 缓冲区中有效数据的长度
+        size_t cursor_ = 0;                      ///< NextLine的行游标
+    };
+}  // namespace monitor
@@ -0,0 +1,107 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <atomic>         // 原子fd，pread路径无锁
+#include <cstddef>        // size_t
+#include <memory>         // std::shared_ptr、std::weak_ptr
+#include <mutex>          // 保护打开/重新打开过程
+#include <string>         // 文件路径
+#include <unordered_map>  // 路径到数据源的映射
+#include <utility>        // std::move
+#include <vector>         // 读取缓冲区
+
+namespace monitor
+{
+    /**
+     * @brief 常驻fd的procfs数据源
+     *
+     * 在监控器的整个生命周期内只打开一次文件，之后每次采样通过
+     * pread(fd, buf, n, 0)从偏移0重新读取，省去每次采样的open/close
+     * 系统调用和路径查找开销。
+     *
+     * 设计特点：
+     * - 延迟打开：第一次读取时才打开文件
+     * - 透明重开：pread失败时自动重新打开并重试一次
+     * - 线程安全：pread不依赖文件偏移，多个读者可以共用同一个fd；
+     *   重新打开使用dup2原子替换fd号，正在使用旧fd号的读者直接读到新文件
+     * - 缓冲区由调用者提供：数据源只共享fd，不共享缓冲区，读者之间互不影响
+     */
+    class ProcfsSource
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param path 文件路径（如"/proc/stat"）
+         */
+        explicit ProcfsSource(std::string path) : path_(std::move(path)) {}
+
+        /**
+         * @brief 析构函数，关闭常驻fd
+         */
+        ~ProcfsSource();
+
+        // 持有fd，禁止拷贝
+        ProcfsSource(const ProcfsSource&) = delete;
+        ProcfsSource& operator=(const ProcfsSource&) = delete;
+
+        /**
+         * @brief 从偏移0读取整个文件
+         * @param buffer 输入输出参数，读取缓冲区，容量不足时按倍数扩容
+         * @param size 输出参数，读取到的有效字节数
+         * @return bool 读取成功返回true，打开或读取失败返回false
+         *
+         * 缓冲区只增不减，稳态下每次读取不产生内存分配。
+         */
+        bool ReadAll(std::vector<char>* buffer, size_t* size);
+
+        /**
+         * @brief 获取文件路径
+         * @return const std::string& 文件路径
+         */
+        const std::string& Path() const { return path_; }
+
+    private:
+        /**
+         * @brief 打开文件或替换已有的fd
+         * @param stale_fd 调用者读取失败时使用的fd，-1表示尚未打开
+         * @return int 当前可用的fd，失败返回-1
+         *
+         * 如果其他线程已经完成了重新打开（fd_不再等于stale_fd），直接返回新fd。
+         */
+        int Reopen(int stale_fd);
+
+        std::string path_;          ///< 文件路径
+        std::atomic<int> fd_{-1};   ///< 常驻fd，-1表示尚未打开
+        std::mutex mutex_;          ///< 串行化打开/重新打开
+    };
+
+    /**
+     * @brief procfs数据源注册表
+     *
+     * 进程级单例，按路径缓存ProcfsSource，保证同一个/proc文件只打开一次。
+     * 注册表只持有弱引用，最后一个使用者释放后fd随之关闭。
+     */
+    class ProcfsRegistry
+    {
+    public:
+        /**
+         * @brief 获取单例
+         * @return ProcfsRegistry& 进程级注册表
+         */
+        static ProcfsRegistry& Instance();
+
+        /**
+         * @brief 获取指定路径的数据源
+         * @param path 文件路径
+         * @return std::shared_ptr<ProcfsSource> 共享的数据源（文件延迟到第一次读取时打开）
+         */
+        std::shared_ptr<ProcfsSource> Get(const std::string& path);
+
+    private:
+        ProcfsRegistry() = default;
+
+        std::mutex mutex_;   ///< 保护sources_
+        std::unordered_map<std::string, std::weak_ptr<ProcfsSource>> sources_;   ///< 路径到数据源
+    };
+}  // namespace monitor
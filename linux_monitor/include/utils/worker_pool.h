@@ -0,0 +1,75 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <condition_variable>   // 任务通知
+#include <cstddef>              // size_t
+#include <functional>           // 任务函数
+#include <mutex>                // 保护批次状态
+#include <thread>               // 工作线程
+#include <vector>               // 线程列表
+
+namespace monitor
+{
+    /**
+     * @brief 固定大小的工作线程池
+     *
+     * 面向"一批彼此独立的短任务、调用者等待全部完成"的场景（如一次调度中
+     * 到期的多个监控器），不是通用的任务队列：
+     * - 线程在构造时创建、析构时回收，运行期间不再创建线程
+     * - 每次ParallelFor提交一个批次，工作线程通过共享计数器领取任务下标
+     * - 调用者阻塞到批次内所有任务完成，任务函数的副作用对调用者可见
+     *
+     * 同一时刻只允许一个线程调用ParallelFor。
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * @brief 构造函数，创建工作线程
+         * @param workers 工作线程数，0表示不创建线程，ParallelFor在调用线程上串行执行
+         */
+        explicit WorkerPool(size_t workers);
+
+        /**
+         * @brief 析构函数，通知并等待所有工作线程退出
+         */
+        ~WorkerPool();
+
+        // 持有线程，禁止拷贝
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        /**
+         * @brief 并行执行一批任务
+         * @param count 任务数
+         * @param task 任务函数，参数为任务下标[0, count)
+         *
+         * 阻塞直到所有任务完成。
+         */
+        void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+        /**
+         * @brief 获取工作线程数
+         * @return size_t 工作线程数
+         */
+        size_t Size() const { return threads_.size(); }
+
+    private:
+        /**
+         * @brief 工作线程主循环：等待批次，领取并执行任务
+         */
+        void WorkerLoop();
+
+        std::vector<std::thread> threads_;                 ///< 工作线程
+        std::mutex mutex_;                                 ///< 保护以下批次状态
+        std::condition_variable work_cv_;                  ///< 新批次或退出通知
+        std::condition_variable done_cv_;                  ///< 批次完成通知
+        const std::function<void(size_t)>* task_ = nullptr; ///< 当前批次的任务函数
+        size_t count_ = 0;                                 ///< 当前批次的任务数
+        size_t next_ = 0;                                  ///< 下一个待领取的任务下标
+        size_t pending_ = 0;                               ///< 尚未完成的任务数
+        size_t generation_ = 0;                            ///< 批次编号，用于唤醒判断
+        bool stopping_ = false;                            ///< 退出标志
+    };
+}  // namespace monitor
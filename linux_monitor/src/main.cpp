@@ -1,30 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include <sys/resource.h>   // getrlimit、setrlimit
+
 // 客户端RPC相关头文件
 #include "client/rpc_client.h"            // RPC客户端实现
 
 // 监控器头文件
+#include "monitor/adaptive_sampler.h"     // 自适应采样周期
+#include "monitor/agent_stats_recorder.h" // 采集端自身开销统计
+#if defined(MONITOR_WITH_BPF)
+#include "monitor/bpf_latency_monitor.h"  // eBPF软中断耗时和运行队列延迟（可选）
+#endif
+#include "monitor/cgroup_monitor.h"       // cgroup v2容器级监控
+#include "monitor/collector_scheduler.h"  // 按采样周期调度监控器
 #include "monitor/cpu_load_monitor.h"     // CPU负载监控
 #include "monitor/cpu_softirq_monitor.h"  // CPU软中断监控
 #include "monitor/cpu_stat_monitor.h"     // CPU状态监控
 #include "monitor/mem_monitor.h"          // 内存监控
 #include "monitor/monitor_inter.h"        // 监控器接口基类
 #include "monitor/net_monitor.h"          // 网络监控
+#include "monitor/process_monitor.h"      // 进程Top-N监控
+
+// 工具类头文件
+#include "utils/cpu_placement.h"          // CPU亲和性、调度策略和NUMA布局
+#include "utils/options.h"                // 命令行选项解析
 
 // Protobuf生成的头文件
 #include "monitor_info.grpc.pb.h"         // gRPC服务定义
 #include "monitor_info.pb.h"              // Protobuf消息定义
 
+/**
+ * @brief 监控器注册信息
+ *
+ * 每个监控器有独立的采样周期，可通过命令行"--<option>=<毫秒>"覆盖。
+ * 各监控器通过ProcfsRegistry常驻/proc文件fd，每次采样只需pread，
+ * 因此变化快、开销小的指标（负载、网络）可以使用较短的周期。
+ */
+struct CollectorConfig
+{
+    const char* name;                                 ///< 监控器名称
+    const char* option;                               ///< 采样周期的命令行选项名
+    int64_t default_interval_ms;                      ///< 默认采样周期（毫秒）
+    std::shared_ptr<monitor::MonitorInter> runner;    ///< 监控器实例
+};
+
 /**
  * @brief 监控系统主程序入口
  *
  * 主程序功能概述：
  * 1. 创建并管理所有监控器实例
- * 2. 启动监控数据采集线程
- * 3. 定期（每3秒）采集系统各项指标
- * 4. 通过RPC客户端将数据发送到服务器
+ * 2. 按各自的采样周期把监控器注册到调度器
+ * 3. 启动监控数据采集线程，运行调度循环
+ * 4. 同一时刻到期的监控器合并为一个MonitorInfo，通过RPC客户端发送到服务器
+ *
+ * 命令行选项（单位：毫秒）：
+ *   --softirq_interval_ms  软中断采样周期（默认1000）
+ *   --cpu_load_interval_ms CPU负载采样周期（默认250）
+ *   --cpu_stat_interval_ms CPU状态采样周期（默认500）
+ *   --mem_interval_ms      内存采样周期（默认5000）
+ *   --net_interval_ms      网络采样周期（默认250）
+ *   --process_interval_ms  进程Top-N采样周期（默认1000）
+ *   --process_top_n        按CPU、按内存各上报的进程数（默认10）
+ *   --cgroup_interval_ms   cgroup v2容器级采样周期（默认1000）
+ *   --cgroup_root          cgroup v2挂载点（默认/sys/fs/cgroup，混合模式下自动使用其中的unified）
+ *   --cgroup_max_depth     最多发现的cgroup层数（默认0即不限）
+ *   --bpf_latency_interval_ms eBPF软中断耗时和运行队列延迟的采样周期（默认0即关闭；
+ *                          仅在构建时找到libbpf时可用，需要CAP_BPF + CAP_PERFMON或root）
+ *   --net_backend          网络监控数据源：procfs（默认，解析/proc/net/dev）或netlink（rtnetlink批量转储）
+ *   --workers              并行采集的工作线程数（默认0，即在采集线程上串行执行）
+ *
+ * 自适应采样选项：
+ *   --adaptive             按关键信号的波动调整周期（默认关闭）：cpu_stat（每个CPU的cpu_percent）、
+ *                          softirq（net_rx速率）、net（网卡收发速率）、mem（used_percent）
+ *                          波动时降到下限，平稳后逐步加倍到上限，其余监控器保持固定周期；
+ *                          每个批次附带这些监控器的sample_interval
+ *   --adaptive_floor_ms    周期下限（默认100）
+ *   --adaptive_ceiling_ms  周期上限（默认5000），以上两项与各监控器的配置周期取并集，配置周期为初始周期
+ *
+ * 放置选项（在创建任何线程之前应用，所有线程继承）：
+ *   --cpuset               绑定的CPU：auto（当前亲和性去掉isolcpus/nohz_full核心，只保留一个NUMA节点）
+ *                          或CPU列表如"0-1,8"（同样去掉独占核心）；默认不绑定。多节点主机上内存绑定到所选CPU的节点
+ *   --sched_idle           使用SCHED_IDLE调度策略，只在CPU空闲时运行
+ *   --nice                 nice值（默认0即不修改，负值需要CAP_SYS_NICE）
+ *
+ * 上报选项：
+ *   --server_address       服务器地址（默认localhost:50051）
+ *   --host_group           主机所属的分组（如集群名，默认为空）：服务器按分组维护聚合统计（GetAggregate）
+ *   --send_queue           流式上报发送队列容量（默认64条采样）
+ *   --unary                使用每次采样一次的一元调用SetMonitorInfo（兼容旧服务器）
+ *   --compact              流式上报使用紧凑格式（字典 + 量化差分，服务器不支持时自动回退）
+ *   --spill_dir            本地落盘缓冲目录（默认为空即不启用，仅用于流式上报）：发送队列已满时采样写入
+ *                          该目录下的分段日志，重新连接后按顺序限速重放
+ *   --spill_segment_mb     每个日志段的大小（默认8）
+ *   --spill_max_segments   最多保留的日志段数（默认16，超出时删除最旧的段）
+ *   --spill_fsync          同步策略：none、always（每条采样）或同步周期毫秒数（默认1000）
+ *   --spill_replay_rate    重放限速（默认20条/秒，需要大于采样产生的速率）
+ *   --stats_interval_ms    自身开销统计窗口（默认10000，0表示不统计）：每个窗口在一个批次中附带
+ *                          agent_stats（进程CPU、常驻内存、上报耗时和字节数）和各监控器的采样耗时
  *
  * 架构设计：
  * - 工厂模式：通过基类指针管理不同类型的监控器
@@ -34,72 +115,237 @@
  *
  * 线程模型：
  * - 主线程：等待监控线程结束（实际是join，会阻塞）
- * - 监控线程：负责定期采集和发送数据
+ * - 监控线程：运行调度循环，负责定期采集和发送数据
  *
  * 数据流：
  * 系统状态 → 监控器采集 → MonitorInfo消息 → RPC客户端 → 远程服务器
  */
-int main()
+int main(int argc, char** argv)
 {
+    // ==================== 解析命令行 ====================
+    monitor::Options options;
+    if (!options.Parse(argc, argv))
+    {
+        std::cerr << "用法: " << argv[0] << " [--<collector>_interval_ms=<毫秒>] ..." << std::endl;
+        return 1;
+    }
+
+    // ==================== CPU亲和性、调度策略和NUMA布局 ====================
+    // 必须在创建监控器（分配PerCpuMatrix等缓冲区）和任何线程（工作线程、RPC发送线程、gRPC内部线程）之前
+    monitor::CpuPlacement::Config placement_config;
+    placement_config.cpuset = options.GetString("cpuset", "");
+    placement_config.sched_idle = options.GetBool("sched_idle", false);
+    placement_config.nice = static_cast<int>(options.GetInt("nice", 0));
+    monitor::CpuPlacement placement;
+    std::string placement_error;
+    if (!placement.Apply(placement_config, &placement_error))
+    {
+        std::cerr << placement_error << std::endl;
+        return 1;
+    }
+    if (!placement.Cpus().empty())
+    {
+        std::cerr << "采集端绑定到CPU " << monitor::CpuPlacement::FormatCpuList(placement.Cpus());
+        if (!placement.Nodes().empty())
+        {
+            std::cerr << "，内存绑定到NUMA节点 " << monitor::CpuPlacement::FormatCpuList(placement.Nodes());
+        }
+        std::cerr << std::endl;
+    }
+    if (!placement.Warning().empty())
+    {
+        std::cerr << placement.Warning() << std::endl;
+    }
+
+    // ==================== 提高文件描述符软限制 ====================
+    // 进程监控和cgroup监控按软限制分配常驻fd预算，默认的1024在几百个容器的节点上不够用
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
     // ==================== 初始化监控器集合 ====================
-    // 使用基类指针存储不同类型的监控器，实现多态
-    std::vector<std::shared_ptr<monitor::MonitorInter>> runners_;
+    // 网络监控的数据源：procfs（默认）或netlink，rtnetlink不可用时退回procfs
+    const bool want_netlink = options.GetString("net_backend", "procfs") == "netlink";
+    auto net_monitor = std::make_shared<monitor::NetMonitor>(
+        want_netlink ? monitor::NetMonitor::Backend::NETLINK : monitor::NetMonitor::Backend::PROCFS);
+    if (want_netlink && net_monitor->GetBackend() != monitor::NetMonitor::Backend::NETLINK)
+    {
+        std::cerr << "rtnetlink不可用，网络监控使用/proc/net/dev" << std::endl;
+    }
 
-    // 添加各类监控器到集合中
+    // 使用基类指针存储不同类型的监控器，实现多态
     // 注意：使用new创建对象，由shared_ptr管理生命周期
-    runners_.emplace_back(new monitor::CpuSoftIrqMonitor());    // CPU软中断监控
-    runners_.emplace_back(new monitor::CpuLoadMonitor());       // CPU负载监控
-    runners_.emplace_back(new monitor::CpuStatMonitor());       // CPU状态监控
-    runners_.emplace_back(new monitor::MemMonitor());           // 内存监控
-    runners_.emplace_back(new monitor::NetMonitor());           // 网络监控
+    std::vector<CollectorConfig> runners_ = {
+        {"softirq", "softirq_interval_ms", 1000, std::shared_ptr<monitor::MonitorInter>(new monitor::CpuSoftIrqMonitor())},   // CPU软中断监控
+        {"cpu_load", "cpu_load_interval_ms", 250, std::shared_ptr<monitor::MonitorInter>(new monitor::CpuLoadMonitor())},     // CPU负载监控
+        {"cpu_stat", "cpu_stat_interval_ms", 500, std::shared_ptr<monitor::MonitorInter>(new monitor::CpuStatMonitor())},     // CPU状态监控
+        {"mem", "mem_interval_ms", 5000, std::shared_ptr<monitor::MonitorInter>(new monitor::MemMonitor())},                  // 内存监控
+        {"net", "net_interval_ms", 250, std::shared_ptr<monitor::MonitorInter>(net_monitor)},                                 // 网络监控
+        {"process", "process_interval_ms", 1000, std::shared_ptr<monitor::MonitorInter>(new monitor::ProcessMonitor(
+            static_cast<size_t>(std::max<int64_t>(options.GetInt("process_top_n", 10), 1))))},                      // 进程Top-N监控
+        {"cgroup", "cgroup_interval_ms", 1000, std::shared_ptr<monitor::MonitorInter>(new monitor::CgroupMonitor(
+            options.GetString("cgroup_root", "/sys/fs/cgroup"),
+            static_cast<size_t>(std::max<int64_t>(options.GetInt("cgroup_max_depth", 0), 0))))},                    // cgroup容器级监控
+    };
+
+#if defined(MONITOR_WITH_BPF)
+    // eBPF延迟监控默认关闭（需要加载BPF程序的权限），--bpf_latency_interval_ms大于0时启用
+    if (options.GetInt("bpf_latency_interval_ms", 0) > 0)
+    {
+        auto bpf_latency = std::make_shared<monitor::BpfLatencyMonitor>();
+        if (bpf_latency->Loaded())
+        {
+            runners_.push_back({"bpf_latency", "bpf_latency_interval_ms", 0, bpf_latency});
+        }
+        else
+        {
+            std::cerr << "eBPF延迟监控不可用: " << bpf_latency->Error() << std::endl;
+        }
+    }
+#endif
+
+    // ==================== 注册到调度器 ====================
+    // 配置工作线程后，同一批次到期的监控器并行执行，批次延迟取决于最慢的监控器
+    const int64_t workers = options.GetInt("workers", 0);
+    monitor::CollectorScheduler scheduler(workers > 0 ? static_cast<size_t>(workers) : 0);
+    // 自适应采样：关键信号所在的监控器按波动调整周期，其余监控器保持固定周期
+    const bool adaptive = options.GetBool("adaptive", false);
+    const int64_t adaptive_floor_ms = std::max<int64_t>(options.GetInt("adaptive_floor_ms", 100), 1);
+    const int64_t adaptive_ceiling_ms = options.GetInt("adaptive_ceiling_ms", 5000);
+    for (auto& runner : runners_)
+    {
+        int64_t interval_ms = options.GetInt(runner.option, runner.default_interval_ms);
+        if (interval_ms <= 0)
+        {
+            continue;  // 周期为0或负数表示禁用该监控器
+        }
+
+        std::shared_ptr<monitor::AdaptiveSampler> sampler;
+        if (adaptive)
+        {
+            monitor::AdaptiveSampler::Options sampler_options;
+            sampler_options.floor = std::chrono::milliseconds(std::min(adaptive_floor_ms, interval_ms));
+            sampler_options.ceiling = std::chrono::milliseconds(std::max(adaptive_ceiling_ms, interval_ms));
+            const std::string name = runner.name;
+            if (name == "cpu_stat")
+            {
+                sampler = monitor::AdaptiveSampler::ForCpuStat(sampler_options);
+            }
+            else if (name == "softirq")
+            {
+                sampler = monitor::AdaptiveSampler::ForSoftIrq(sampler_options);
+            }
+            else if (name == "net")
+            {
+                sampler = monitor::AdaptiveSampler::ForNet(sampler_options);
+            }
+            else if (name == "mem")
+            {
+                sampler = monitor::AdaptiveSampler::ForMem(sampler_options);
+            }
+        }
+        scheduler.Register(runner.name, runner.runner, std::chrono::milliseconds(interval_ms), sampler);
+    }
 
     // ==================== 初始化RPC客户端 ====================
-    monitor::RpcClient rpc_client_;
+    // 自身开销统计在RPC客户端之前构造：客户端析构时发送线程可能仍在回调上报观察者
+    const int64_t stats_interval_ms = options.GetInt("stats_interval_ms", 10000);
+    std::unique_ptr<monitor::AgentStatsRecorder> agent_stats;
+    if (stats_interval_ms > 0)
+    {
+        agent_stats = std::make_unique<monitor::AgentStatsRecorder>(std::chrono::milliseconds(stats_interval_ms));
+        agent_stats->SetPlacement(placement.Cpus(), placement.Nodes());
+    }
+    monitor::RpcClient rpc_client_(options.GetString("server_address", "localhost:50051"));
+
+    // 上报观察者必须在启动流式上报之前设置
+    if (agent_stats)
+    {
+        rpc_client_.SetSendObserver([recorder = agent_stats.get()](int64_t latency_ns, size_t bytes) {
+            recorder->RecordSend(latency_ns, bytes);
+        });
+    }
+
+    // 默认使用流式上报：采集线程只入队，由后台线程通过长连接发送
+    const bool unary = options.GetBool("unary", false);
+    const std::string spill_dir = options.GetString("spill_dir", "");
+    if (!spill_dir.empty() && unary)
+    {
+        std::cerr << "本地落盘缓冲只用于流式上报，--unary下不启用" << std::endl;
+    }
+    else if (!spill_dir.empty())
+    {
+        monitor::SpillLog::Options spill_options;
+        spill_options.dir = spill_dir;
+        spill_options.segment_bytes = static_cast<size_t>(std::max<int64_t>(options.GetInt("spill_segment_mb", 8), 1))
+            * 1024 * 1024;
+        spill_options.max_segments = static_cast<size_t>(std::max<int64_t>(options.GetInt("spill_max_segments", 16), 2));
+        std::string spill_error;
+        if (!monitor::SpillLog::ParseSyncPolicy(options.GetString("spill_fsync", "1000"), &spill_options))
+        {
+            std::cerr << "--spill_fsync只能是none、always或毫秒数" << std::endl;
+            return 1;
+        }
+        if (!rpc_client_.EnableSpill(spill_options,
+                static_cast<double>(std::max<int64_t>(options.GetInt("spill_replay_rate", 20), 1)), &spill_error))
+        {
+            std::cerr << spill_error << std::endl;
+            return 1;
+        }
+    }
+    if (!unary)
+    {
+        const int64_t send_queue = options.GetInt("send_queue", monitor::RpcClient::kDefaultSendQueueCapacity);
+        rpc_client_.StartStream(send_queue > 0 ? static_cast<size_t>(send_queue) : 1,
+            options.GetBool("compact", false));
+    }
 
     // ==================== 获取主机标识 ====================
     // 使用环境变量USER作为主机名标识
     // 注意：Windows下是USERNAME，Linux/Unix下是USER
     char* name = getenv("USER");
+    const std::string host_name = name ? std::string(name) : std::string("unknown_host");  // 默认值
+    const std::string host_group = options.GetString("host_group", "");
 
     // ==================== 启动监控线程 ====================
     std::unique_ptr<std::thread> thread_ = nullptr;
 
     // 使用lambda表达式创建监控线程
     thread_ = std::make_unique<std::thread>([&]() {
-        // 线程主循环：持续监控和上报
-        while (true)
-        {
-            // 创建监控数据消息
-            monitor::proto::MonitorInfo monitor_info;
+        // 线程主循环：调度器按截止时间运行到期的监控器，每个批次上报一次
+        scheduler.Run([&](monitor::proto::MonitorInfo* monitor_info) {
+            // 设置主机标识、分组和采样时间（服务器按该时间保存历史数据）
+            monitor_info->set_name(host_name);
+            monitor_info->set_host_group(host_group);
+            monitor_info->set_timestamp_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
 
-            // 设置主机标识
-            if (name)
+            // 每个统计窗口附带一次自身开销（服务器保留最近一次，其他批次不需要重复发送）
+            if (agent_stats && agent_stats->Due())
             {
-                monitor_info.set_name(std::string(name));
+                agent_stats->Export(rpc_client_.DroppedCount(), monitor_info->mutable_agent_stats());
+                monitor_info->mutable_agent_stats()->set_spill_pending(rpc_client_.SpillPending());
+                scheduler.ExportCollectorStats(monitor_info);
             }
-            else
+
+            // 通过RPC客户端发送监控数据
+            if (unary)
             {
-                monitor_info.set_name("unknown_host");  // 默认值
+                rpc_client_.SetMonitorInfo(*monitor_info);
             }
-
-            // 遍历所有监控器，采集数据
-            for (auto& runner : runners_)
+            else
             {
-                // 多态调用：每个监控器实现自己的UpdateOnce方法
-                runner->UpdateOnce(&monitor_info);
+                // 批次消息在调度器的Arena上，拷贝进复用的发送队列槽位
+                rpc_client_.PushMonitorInfo(*monitor_info);
             }
-
-            // 通过RPC客户端发送监控数据
-            rpc_client_.SetMonitorInfo(monitor_info);
-
-            // 休眠3秒，控制监控频率
-            // 注意：使用steady_clock确保休眠时间准确
-            std::this_thread::sleep_for(std::chrono::seconds(3));
-        }
+        });
     });
 
     // ==================== 等待线程结束 ====================
-    // 注意：由于监控线程是无限循环，这里会永久阻塞
+    // 注意：由于调度循环不会主动退出，这里会永久阻塞
     thread_->join();
 
     return 0;
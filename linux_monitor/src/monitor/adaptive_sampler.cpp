@@ -0,0 +1,144 @@
+// 包含对应的头文件
+#include "monitor/adaptive_sampler.h"
+
+// C++标准库头文件
+#include <algorithm>    // std::max、std::min、std::clamp
+#include <cmath>        // std::exp、std::sqrt、std::fabs
+#include <utility>      // std::move
+
+namespace monitor
+{
+    AdaptiveSampler::AdaptiveSampler(Extractor extractor, Threshold threshold, const Options& options)
+        : extractor_(std::move(extractor)), threshold_(threshold), options_(options)
+    {
+    }
+
+    /**
+     * @brief 更新统计并计算下一个周期的具体实现
+     * @param monitor_info 本批次的消息
+     * @param now_ns 采样完成的时间
+     * @param period_ns 当前周期
+     * @return int64_t 下一个周期
+     *
+     * 每个值先用更新前的均值计算偏差，再更新均值和方差：
+     * mean += alpha × d，variance = (1 - alpha) × (variance + alpha × d²)。
+     * 没有提取到信号（监控器本次采样失败）时保持当前周期。
+     */
+    int64_t AdaptiveSampler::Observe(const monitor::proto::MonitorInfo& monitor_info, int64_t now_ns,
+        int64_t period_ns)
+    {
+        const int64_t floor_ns = options_.floor.count();
+        const int64_t ceiling_ns = std::max(options_.ceiling.count(), floor_ns);
+
+        values_.clear();
+        extractor_(monitor_info, &values_);
+        if (values_.empty())
+        {
+            return std::clamp(period_ns, floor_ns, ceiling_ns);
+        }
+
+        // 第一次采样或实例数变化：以当前值为均值重新开始
+        if (signals_.size() != values_.size())
+        {
+            signals_.assign(values_.size(), Signal());
+            for (size_t i = 0; i < values_.size(); ++i)
+            {
+                signals_[i].mean = values_[i];
+            }
+            last_ns_ = now_ns;
+            last_score_ = 0;
+            calm_ = 0;
+            return std::clamp(period_ns, floor_ns, ceiling_ns);
+        }
+
+        const double dt = static_cast<double>(now_ns - last_ns_) / 1e9;
+        const double alpha = 1.0 - std::exp(-std::max(dt, 0.0) / std::max(options_.tau_seconds, 1e-3));
+        last_ns_ = now_ns;
+
+        double score = 0;
+        for (size_t i = 0; i < values_.size(); ++i)
+        {
+            Signal& signal = signals_[i];
+            const double deviation = values_[i] - signal.mean;
+            signal.mean += alpha * deviation;
+            signal.variance = (1.0 - alpha) * (signal.variance + alpha * deviation * deviation);
+
+            const double scale = threshold_.absolute + threshold_.relative * std::fabs(signal.mean);
+            if (scale > 0)
+            {
+                score = std::max(score, std::max(std::fabs(deviation), std::sqrt(signal.variance)) / scale);
+            }
+        }
+        last_score_ = score;
+
+        if (score >= options_.enter_score)
+        {
+            calm_ = 0;
+            return floor_ns;
+        }
+        if (score >= options_.exit_score)
+        {
+            calm_ = 0;
+            return std::clamp(period_ns, floor_ns, ceiling_ns);
+        }
+        if (++calm_ < options_.calm_samples)
+        {
+            return std::clamp(period_ns, floor_ns, ceiling_ns);
+        }
+        calm_ = 0;
+        return std::clamp(period_ns * 2, floor_ns, ceiling_ns);
+    }
+
+    std::shared_ptr<AdaptiveSampler> AdaptiveSampler::ForCpuStat(const Options& options)
+    {
+        return std::make_shared<AdaptiveSampler>(
+            [](const monitor::proto::MonitorInfo& monitor_info, std::vector<double>* values) {
+                for (const auto& cpu : monitor_info.cpu_stat())
+                {
+                    values->push_back(cpu.cpu_percent());
+                }
+            },
+            Threshold{10, 0}, options);
+    }
+
+    std::shared_ptr<AdaptiveSampler> AdaptiveSampler::ForSoftIrq(const Options& options)
+    {
+        return std::make_shared<AdaptiveSampler>(
+            [](const monitor::proto::MonitorInfo& monitor_info, std::vector<double>* values) {
+                for (const auto& cpu : monitor_info.soft_irq())
+                {
+                    values->push_back(cpu.net_rx());
+                }
+            },
+            Threshold{2000, 0.5}, options);   // 每秒2000次或均值的一半
+    }
+
+    std::shared_ptr<AdaptiveSampler> AdaptiveSampler::ForNet(const Options& options)
+    {
+        return std::make_shared<AdaptiveSampler>(
+            [](const monitor::proto::MonitorInfo& monitor_info, std::vector<double>* values) {
+                for (const auto& net : monitor_info.net_info())
+                {
+                    if (net.name() == "lo")
+                    {
+                        continue;   // 本机回环流量不代表主机负载
+                    }
+                    values->push_back(net.rcv_rate());
+                    values->push_back(net.send_rate());
+                }
+            },
+            Threshold{1024, 0.5}, options);   // 1MB/s或均值的一半
+    }
+
+    std::shared_ptr<AdaptiveSampler> AdaptiveSampler::ForMem(const Options& options)
+    {
+        return std::make_shared<AdaptiveSampler>(
+            [](const monitor::proto::MonitorInfo& monitor_info, std::vector<double>* values) {
+                if (monitor_info.has_mem_info())
+                {
+                    values->push_back(monitor_info.mem_info().used_percent());
+                }
+            },
+            Threshold{2, 0}, options);
+    }
+}  // namespace monitor
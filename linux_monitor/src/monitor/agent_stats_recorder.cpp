@@ -0,0 +1,116 @@
+// 包含对应的头文件
+#include "monitor/agent_stats_recorder.h"
+
+// 系统调用头文件
+#include <sys/resource.h>   // getrusage
+#include <unistd.h>         // sysconf
+
+// C++标准库头文件
+#include <fstream>          // 读取/proc/self/statm
+#include <utility>          // std::move
+
+// 包含工具类头文件
+#include "utils/cpu_placement.h"   // 放置校验
+
+namespace monitor
+{
+    AgentStatsRecorder::AgentStatsRecorder(std::chrono::milliseconds window)
+        : window_(window), window_start_(std::chrono::steady_clock::now()), cpu_start_us_(ProcessCpuMicros())
+    {
+    }
+
+    void AgentStatsRecorder::RecordSend(int64_t latency_ns, size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        send_latency_.Record(latency_ns);
+        bytes_ += bytes;
+    }
+
+    void AgentStatsRecorder::SetPlacement(std::vector<int> cpus, std::vector<int> nodes)
+    {
+        placement_cpus_ = std::move(cpus);
+        placement_nodes_ = std::move(nodes);
+    }
+
+    bool AgentStatsRecorder::Due() const
+    {
+        return std::chrono::steady_clock::now() - window_start_ >= window_;
+    }
+
+    /**
+     * @brief 导出统计的具体实现
+     * @param dropped 累计丢弃的采样数
+     * @param stats 输出参数，采集端统计
+     *
+     * 上报统计在锁内取出后立即清空，发送线程只在交换期间等待；
+     * CPU时间和常驻内存的系统调用在锁外执行。
+     */
+    void AgentStatsRecorder::Export(uint64_t dropped, monitor::proto::AgentStats* stats)
+    {
+        constexpr uint64_t kNanosPerMicro = 1000;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats->set_rpc_count(send_latency_.Count());
+            stats->set_rpc_p50_us(send_latency_.Percentile(0.5) / kNanosPerMicro);
+            stats->set_rpc_p99_us(send_latency_.Percentile(0.99) / kNanosPerMicro);
+            stats->set_rpc_max_us(send_latency_.Max() / kNanosPerMicro);
+            stats->set_bytes_serialized(bytes_);
+            send_latency_.Reset();
+            bytes_ = 0;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const int64_t cpu_now_us = ProcessCpuMicros();
+        const int64_t wall_us = std::chrono::duration_cast<std::chrono::microseconds>(now - window_start_).count();
+        if (wall_us > 0)
+        {
+            stats->set_cpu_percent(static_cast<float>(100.0 * (cpu_now_us - cpu_start_us_) / wall_us));
+        }
+        stats->set_window_ms(static_cast<uint64_t>(wall_us / 1000));
+        stats->set_rss_kb(ResidentKb());
+        stats->set_dropped(dropped);
+        if (!placement_cpus_.empty())
+        {
+            stats->set_off_cpuset_threads(CpuPlacement::ThreadsOutside(placement_cpus_));
+        }
+        if (!placement_nodes_.empty())
+        {
+            stats->set_remote_node_kb(CpuPlacement::RemoteNodeKb(placement_nodes_));
+        }
+
+        window_start_ = now;
+        cpu_start_us_ = cpu_now_us;
+    }
+
+    int64_t AgentStatsRecorder::ProcessCpuMicros()
+    {
+        struct rusage usage;
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+        auto micros = [](const struct timeval& tv) {
+            return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+        };
+        return micros(usage.ru_utime) + micros(usage.ru_stime);
+    }
+
+    /**
+     * @brief 读取常驻内存的具体实现
+     * @return uint64_t 常驻内存（KB）
+     *
+     * /proc/self/statm格式："size resident shared text lib data dt"（单位：页）。
+     */
+    uint64_t AgentStatsRecorder::ResidentKb()
+    {
+        std::ifstream statm("/proc/self/statm");
+        uint64_t size_pages = 0;
+        uint64_t resident_pages = 0;
+        if (!(statm >> size_pages >> resident_pages))
+        {
+            return 0;
+        }
+        const long page_size = ::sysconf(_SC_PAGESIZE);
+        return resident_pages * static_cast<uint64_t>(page_size > 0 ? page_size : 4096) / 1024;
+    }
+}  // namespace monitor
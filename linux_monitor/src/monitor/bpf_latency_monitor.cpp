@@ -0,0 +1,247 @@
+// 包含对应的头文件
+#include "monitor/bpf_latency_monitor.h"
+
+// 系统和libbpf头文件
+#include <linux/types.h>     // __u64（latency.h使用）
+#include <bpf/bpf.h>         // bpf_map_lookup_batch、bpf_map_lookup_elem
+#include <bpf/libbpf.h>      // libbpf_num_possible_cpus、bpf_map__fd
+
+// C++标准库头文件
+#include <cerrno>            // errno
+#include <cmath>             // std::ldexp
+#include <cstring>           // std::strerror
+
+// BPF程序的共享定义和bpftool生成的skeleton（构建目录中生成）
+#include "latency.h"
+#include "latency.skel.h"
+
+namespace monitor
+{
+    /// @brief 一个latency_hist占用的64位字数
+    static constexpr size_t kHistWords = sizeof(struct latency_hist) / sizeof(uint64_t);
+
+    /// @brief total_ns在latency_hist中的字下标
+    static constexpr size_t kTotalWord = LATENCY_SLOTS;
+
+    /// @brief 软中断类型名称，顺序与内核的softirq向量号和/proc/softirqs相同
+    static const char* const kSoftIrqNames[LATENCY_SOFTIRQ_VECS] = {
+        "HI", "TIMER", "NET_TX", "NET_RX", "BLOCK", "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU"};
+
+    /**
+     * @brief log2桶的上界
+     * @param slot 桶下标
+     * @return float 上界（微秒）
+     */
+    static float SlotUpperUs(size_t slot)
+    {
+        return static_cast<float>(std::ldexp(1.0, static_cast<int>(slot) + 1) / 1000.0);
+    }
+
+    /**
+     * @brief 构造函数的具体实现
+     *
+     * 打开、加载（内核校验器检查）并附加所有tracepoint程序，预先分配map值缓冲区和
+     * 所有直方图名称，采样路径不再分配内存。任何一步失败都记录原因并保持未加载状态。
+     */
+    BpfLatencyMonitor::BpfLatencyMonitor()
+    {
+        const int cpus = libbpf_num_possible_cpus();
+        if (cpus <= 0)
+        {
+            error_ = "无法获取CPU数";
+            return;
+        }
+        cpus_ = static_cast<size_t>(cpus);
+
+        struct latency_bpf* skeleton = latency_bpf__open_and_load();
+        if (skeleton == nullptr)
+        {
+            error_ = std::string("加载BPF程序失败: ") + std::strerror(errno);
+            return;
+        }
+        const int err = latency_bpf__attach(skeleton);
+        if (err != 0)
+        {
+            error_ = std::string("附加BPF程序失败: ") + std::strerror(-err);
+            latency_bpf__destroy(skeleton);
+            return;
+        }
+        skeleton_ = skeleton;
+
+        softirq_.fd = bpf_map__fd(skeleton_->maps.softirq_hist);
+        softirq_.entries = LATENCY_SOFTIRQ_VECS;
+        runq_.fd = bpf_map__fd(skeleton_->maps.runq_hist);
+        runq_.entries = 1;
+        for (HistogramMap* map : {&softirq_, &runq_})
+        {
+            map->current.assign(map->entries * cpus_ * kHistWords, 0);
+            map->previous.assign(map->current.size(), 0);
+            map->keys.resize(map->entries);
+        }
+
+        for (uint32_t key = 0; key < LATENCY_SOFTIRQ_VECS; ++key)
+        {
+            for (size_t cpu = 0; cpu < cpus_; ++cpu)
+            {
+                softirq_names_.push_back("cpu" + std::to_string(cpu) + "/" + kSoftIrqNames[key]);
+            }
+        }
+        for (size_t cpu = 0; cpu < cpus_; ++cpu)
+        {
+            runq_names_.push_back("cpu" + std::to_string(cpu));
+        }
+        delta_.resize(LATENCY_SLOTS);
+    }
+
+    BpfLatencyMonitor::~BpfLatencyMonitor()
+    {
+        if (skeleton_ != nullptr)
+        {
+            latency_bpf__destroy(skeleton_);
+        }
+    }
+
+    /**
+     * @brief 读取map的具体实现
+     * @param map 读取状态
+     * @return bool 成功返回true
+     *
+     * per-CPU map的每个键返回cpus_份值，按键连续存放；批量读取一次取回所有键，
+     * 读到最后一个键时内核返回ENOENT（数据已完整拷贝）。
+     */
+    bool BpfLatencyMonitor::ReadMap(HistogramMap* map)
+    {
+        if (batch_supported_)
+        {
+            struct bpf_map_batch_opts opts = {};
+            opts.sz = sizeof(opts);
+            __u32 count = map->entries;
+            __u32 next_key = 0;
+            const int err = bpf_map_lookup_batch(map->fd, nullptr, &next_key, map->keys.data(),
+                                                 map->current.data(), &count, &opts);
+            if ((err == 0 || err == -ENOENT) && count == map->entries)
+            {
+                return true;
+            }
+            batch_supported_ = false;   // 旧内核（EINVAL）或不支持批量操作的map类型，改为逐键读取
+        }
+
+        for (uint32_t key = 0; key < map->entries; ++key)
+        {
+            if (bpf_map_lookup_elem(map->fd, &key, map->current.data() + key * cpus_ * kHistWords) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 填充直方图增量的具体实现
+     *
+     * 累计值只增不减，增量即本周期内的事件；分位数取所在log2桶的上界（偏保守），
+     * 误差不超过一倍，足以区分微秒级和毫秒级的尾延迟。
+     */
+    void BpfLatencyMonitor::EmitDelta(const HistogramMap& map, uint32_t key, size_t cpu, const std::string& name,
+                                      google::protobuf::RepeatedPtrField<monitor::proto::LatencyInfo>* output)
+    {
+        const size_t offset = (key * cpus_ + cpu) * kHistWords;
+        const uint64_t* current = map.current.data() + offset;
+        const uint64_t* previous = map.previous.data() + offset;
+
+        uint64_t count = 0;
+        size_t highest = 0;
+        for (size_t slot = 0; slot < LATENCY_SLOTS; ++slot)
+        {
+            delta_[slot] = current[slot] - previous[slot];
+            count += delta_[slot];
+            if (delta_[slot] != 0)
+            {
+                highest = slot;
+            }
+        }
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto* info = output->Add();
+        info->set_name(name);
+        info->set_count(count);
+        info->set_avg_us(static_cast<float>(
+            static_cast<double>(current[kTotalWord] - previous[kTotalWord]) / 1000.0 / static_cast<double>(count)));
+
+        // 中位数和99分位：累计事件数首次达到ceil(q × count)的桶
+        const uint64_t rank50 = (count + 1) / 2;
+        const uint64_t rank99 = (count * 99 + 99) / 100;
+        uint64_t seen = 0;
+        bool has_p50 = false;
+        for (size_t slot = 0; slot <= highest; ++slot)
+        {
+            seen += delta_[slot];
+            if (!has_p50 && seen >= rank50)
+            {
+                info->set_p50_us(SlotUpperUs(slot));
+                has_p50 = true;
+            }
+            if (seen >= rank99)
+            {
+                info->set_p99_us(SlotUpperUs(slot));
+                break;
+            }
+        }
+        info->set_max_us(SlotUpperUs(highest));
+
+        for (size_t slot = 0; slot <= highest; ++slot)
+        {
+            info->add_buckets(delta_[slot]);
+        }
+    }
+
+    /**
+     * @brief 更新延迟监控信息的具体实现
+     * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+     *
+     * 详细执行流程：
+     * 1. 批量读取softirq_hist和runq_hist的全部键（每个map一次系统调用）
+     * 2. 已有上次读取时，按CPU输出每个直方图的本周期增量（没有事件的跳过）
+     * 3. 交换本次和上次的缓冲区
+     */
+    void BpfLatencyMonitor::UpdateOnce(monitor::proto::MonitorInfo* monitor_info)
+    {
+        if (skeleton_ == nullptr)
+        {
+            return;
+        }
+
+        if (ReadMap(&softirq_))
+        {
+            if (softirq_.has_prev)
+            {
+                for (size_t cpu = 0; cpu < cpus_; ++cpu)
+                {
+                    for (uint32_t key = 0; key < LATENCY_SOFTIRQ_VECS; ++key)
+                    {
+                        EmitDelta(softirq_, key, cpu, softirq_names_[key * cpus_ + cpu],
+                                  monitor_info->mutable_softirq_latency());
+                    }
+                }
+            }
+            softirq_.previous.swap(softirq_.current);
+            softirq_.has_prev = true;
+        }
+
+        if (ReadMap(&runq_))
+        {
+            if (runq_.has_prev)
+            {
+                for (size_t cpu = 0; cpu < cpus_; ++cpu)
+                {
+                    EmitDelta(runq_, 0, cpu, runq_names_[cpu], monitor_info->mutable_runq_latency());
+                }
+            }
+            runq_.previous.swap(runq_.current);
+            runq_.has_prev = true;
+        }
+    }
+}  // namespace monitor
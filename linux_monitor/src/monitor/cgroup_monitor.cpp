@@ -0,0 +1,537 @@
+// 包含对应的头文件
+#include "monitor/cgroup_monitor.h"
+
+// 系统调用头文件
+#include <dirent.h>          // opendir、readdir
+#include <fcntl.h>           // openat
+#include <sys/inotify.h>     // inotify_init1、inotify_add_watch
+#include <sys/resource.h>    // getrlimit
+#include <unistd.h>          // pread、read、close、access
+
+// C++标准库头文件
+#include <algorithm>         // std::count
+#include <cerrno>            // errno
+
+// 包含工具类头文件
+#include "utils/proc_parser.h"    // SplitFields、ToNumber
+
+namespace monitor
+{
+    /// @brief 各接口文件的文件名，顺序与CgroupFile一致
+    static const char* const kFileNames[] = {"cpu.stat", "memory.current", "memory.stat", "io.stat"};
+
+    /// @brief 目录watch关心的事件：子目录创建、删除、改名
+    static constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+    /// @brief 接口文件缓冲区的初始大小（memory.stat约1.5KB）
+    static constexpr size_t kInitialBuffer = 4096;
+
+    /// @brief inotify事件缓冲区大小
+    static constexpr size_t kEventBuffer = 64 * 1024;
+
+    /**
+     * @brief 计算cgroup路径的层数
+     * @param path 相对根目录的路径
+     * @return size_t 层数（根目录为0）
+     */
+    static size_t Depth(const std::string& path)
+    {
+        return path.empty() ? 0 : static_cast<size_t>(std::count(path.begin(), path.end(), '/')) + 1;
+    }
+
+    /**
+     * @brief 拼接子cgroup路径
+     * @param parent 父目录路径（根目录为空串）
+     * @param name 子目录名
+     * @return std::string 子cgroup路径
+     */
+    static std::string Join(const std::string& parent, std::string_view name)
+    {
+        std::string path = parent;
+        if (!path.empty())
+        {
+            path += '/';
+        }
+        path += name;
+        return path;
+    }
+
+    /**
+     * @brief 逐行处理文件内容
+     * @param content 文件内容
+     * @param handle 对每一行（不含换行符）调用
+     */
+    template <typename Handle>
+    static void ForEachLine(std::string_view content, Handle&& handle)
+    {
+        while (!content.empty())
+        {
+            const size_t end = content.find('\n');
+            handle(content.substr(0, end));
+            if (end == std::string_view::npos)
+            {
+                break;
+            }
+            content.remove_prefix(end + 1);
+        }
+    }
+
+    /**
+     * @brief 计算两次读取之间的增量（计数器回绕或cgroup重建时返回0）
+     */
+    static uint64_t Delta(uint64_t current, uint64_t previous)
+    {
+        return current >= previous ? current - previous : 0;
+    }
+
+    CgroupMonitor::CgroupMonitor(const std::string& root, size_t max_depth)
+        : root_(root), max_depth_(max_depth), buffer_(kInitialBuffer), events_(kEventBuffer)
+    {
+        // 混合模式（systemd的hybrid层级）下cgroup v2挂载在<root>/unified
+        if (::access((root_ + "/cgroup.controllers").c_str(), F_OK) != 0 &&
+            ::access((root_ + "/unified/cgroup.controllers").c_str(), F_OK) == 0)
+        {
+            root_ += "/unified";
+        }
+        root_fd_ = ::open(root_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        // 常驻fd最多占用软限制的四分之一（进程监控占用一半），为其他监控器和RPC连接留出余量
+        struct rlimit limit;
+        fd_budget_ = 256;
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+        {
+            fd_budget_ = static_cast<size_t>(limit.rlim_cur / 4);
+        }
+
+        inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (root_fd_ >= 0)
+        {
+            AddTree("", 0);
+        }
+    }
+
+    CgroupMonitor::~CgroupMonitor()
+    {
+        for (auto& entry : cgroups_)
+        {
+            CloseFds(&entry.second);
+        }
+        if (inotify_fd_ >= 0)
+        {
+            ::close(inotify_fd_);
+        }
+        if (root_fd_ >= 0)
+        {
+            ::close(root_fd_);
+        }
+    }
+
+    void CgroupMonitor::CloseFds(Cgroup* cgroup)
+    {
+        for (int& fd : cgroup->fds)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+                fd = -1;
+                --open_fds_;
+            }
+        }
+    }
+
+    /**
+     * @brief 加入cgroup子树的具体实现
+     * @param path 相对根目录的路径
+     * @param depth 层数
+     *
+     * 达到最大层数的cgroup照常上报，但不监视、不列举其子目录。
+     * 子目录名先收集到局部容器再递归，同一时刻只打开一个目录流。
+     */
+    void CgroupMonitor::AddTree(const std::string& path, size_t depth)
+    {
+        Cgroup* cgroup = nullptr;
+        if (!path.empty())
+        {
+            cgroup = &cgroups_[path];
+        }
+        if (max_depth_ != 0 && depth >= max_depth_)
+        {
+            return;
+        }
+
+        const std::string full_path = path.empty() ? root_ : root_ + "/" + path;
+        if (inotify_fd_ >= 0)
+        {
+            const int wd = ::inotify_add_watch(inotify_fd_, full_path.c_str(), kWatchMask);
+            if (wd >= 0)
+            {
+                watches_[wd] = path;
+                if (cgroup != nullptr)
+                {
+                    cgroup->wd = wd;
+                }
+            }
+        }
+
+        DIR* dir = ::opendir(full_path.c_str());
+        if (dir == nullptr)
+        {
+            return;
+        }
+        std::vector<std::string> children;
+        while (struct dirent* entry = ::readdir(dir))
+        {
+            if (entry->d_type == DT_DIR && entry->d_name[0] != '.')
+            {
+                children.emplace_back(entry->d_name);
+            }
+        }
+        ::closedir(dir);
+
+        for (const std::string& child : children)
+        {
+            AddTree(Join(path, child), depth + 1);
+        }
+    }
+
+    /**
+     * @brief 删除cgroup子树的具体实现
+     * @param path 相对根目录的路径
+     *
+     * rmdir要求目录为空，子cgroup通常已经先于父cgroup删除；这里仍按路径前缀清理，
+     * 以覆盖改名（IN_MOVED_FROM）和队列溢出后重新同步的情况。
+     * 被删除目录的watch由内核自动移除（之后收到IN_IGNORED），改名的目录显式移除watch。
+     */
+    void CgroupMonitor::RemoveTree(const std::string& path)
+    {
+        const std::string prefix = path + "/";
+        for (auto iter = cgroups_.begin(); iter != cgroups_.end();)
+        {
+            const std::string& key = iter->first;
+            if (key != path && key.compare(0, prefix.size(), prefix) != 0)
+            {
+                ++iter;
+                continue;
+            }
+            Cgroup& cgroup = iter->second;
+            CloseFds(&cgroup);
+            if (cgroup.wd >= 0)
+            {
+                ::inotify_rm_watch(inotify_fd_, cgroup.wd);
+                watches_.erase(cgroup.wd);
+            }
+            iter = cgroups_.erase(iter);
+        }
+    }
+
+    void CgroupMonitor::DrainEvents()
+    {
+        if (inotify_fd_ < 0)
+        {
+            return;
+        }
+
+        bool overflow = false;
+        while (true)
+        {
+            const ssize_t size = ::read(inotify_fd_, events_.data(), events_.size());
+            if (size < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (size <= 0)
+            {
+                break;   // EAGAIN：队列已读空
+            }
+
+            for (size_t offset = 0; offset + sizeof(struct inotify_event) <= static_cast<size_t>(size);)
+            {
+                const auto* event = reinterpret_cast<const struct inotify_event*>(events_.data() + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    overflow = true;
+                    continue;
+                }
+                if (event->mask & IN_IGNORED)
+                {
+                    watches_.erase(event->wd);   // 目录已删除，watch随之失效
+                    continue;
+                }
+                if (!(event->mask & IN_ISDIR) || event->len == 0)
+                {
+                    continue;
+                }
+                auto parent = watches_.find(event->wd);
+                if (parent == watches_.end())
+                {
+                    continue;
+                }
+
+                const std::string child = Join(parent->second, event->name);   // name以'\0'结尾
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    AddTree(child, Depth(child));
+                }
+                else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                {
+                    RemoveTree(child);
+                }
+            }
+        }
+
+        if (overflow)
+        {
+            // 丢失了部分事件：删除目录已经不存在的cgroup，再从根目录重新遍历
+            std::vector<std::string> vanished;
+            for (const auto& entry : cgroups_)
+            {
+                if (::faccessat(root_fd_, entry.first.c_str(), F_OK, 0) != 0)
+                {
+                    vanished.push_back(entry.first);
+                }
+            }
+            for (const std::string& path : vanished)
+            {
+                RemoveTree(path);
+            }
+            AddTree("", 0);
+        }
+    }
+
+    /**
+     * @brief 读取接口文件的具体实现
+     * @param path cgroup路径
+     * @param cgroup cgroup缓存项
+     * @param file 接口文件
+     * @return size_t 读取到的字节数
+     *
+     * 优先使用缓存的fd；fd预算用完时临时openat并在读取后关闭。
+     * 文件不存在时记为missing，kMissingRetryTicks个tick内不再尝试。
+     */
+    size_t CgroupMonitor::ReadFile(const std::string& path, Cgroup* cgroup, CgroupFile file)
+    {
+        if (cgroup->missing[file])
+        {
+            return 0;
+        }
+
+        int fd = cgroup->fds[file];
+        if (fd < 0)
+        {
+            path_buffer_.assign(path);
+            path_buffer_ += '/';
+            path_buffer_ += kFileNames[file];
+            fd = ::openat(root_fd_, path_buffer_.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                if (errno == ENOENT)
+                {
+                    cgroup->missing[file] = true;
+                    cgroup->retry_tick = tick_ + kMissingRetryTicks;
+                }
+                return 0;
+            }
+            if (open_fds_ < fd_budget_)
+            {
+                cgroup->fds[file] = fd;
+                ++open_fds_;
+            }
+        }
+
+        ssize_t size = 0;
+        while (true)
+        {
+            size = ::pread(fd, buffer_.data(), buffer_.size(), 0);
+            if (size < static_cast<ssize_t>(buffer_.size()))
+            {
+                break;
+            }
+            buffer_.resize(buffer_.size() * 2);   // 内容可能被截断，扩容后重读
+        }
+        if (cgroup->fds[file] != fd)
+        {
+            ::close(fd);
+        }
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    /**
+     * @brief 读取一个cgroup的具体实现
+     *
+     * 文件格式：
+     * - cpu.stat：每行"键 值"，如"usage_usec 123456"
+     * - memory.current：一个字节数
+     * - memory.stat：每行"键 值"，内存量以字节为单位
+     * - io.stat：每个设备一行，如"8:0 rbytes=1024 wbytes=0 rios=1 wios=0 dbytes=0 dios=0"
+     */
+    void CgroupMonitor::ReadCgroup(const std::string& path, Cgroup* cgroup,
+                                   std::chrono::steady_clock::time_point now,
+                                   monitor::proto::MonitorInfo* monitor_info)
+    {
+        if (cgroup->retry_tick != 0 && tick_ >= cgroup->retry_tick)
+        {
+            cgroup->missing.fill(false);   // 控制器可能已经启用
+            cgroup->retry_tick = 0;
+        }
+
+        Counters current;
+        uint64_t memory_current = 0;
+        uint64_t memory_anon = 0;
+        uint64_t memory_file = 0;
+        bool any = false;
+
+        if (size_t size = ReadFile(path, cgroup, CPU_STAT))
+        {
+            any = true;
+            ForEachLine(std::string_view(buffer_.data(), size), [&](std::string_view line) {
+                if (ProcParser::SplitFields(line, &fields_) < 2)
+                {
+                    return;
+                }
+                const uint64_t value = ProcParser::ToNumber<uint64_t>(fields_[1]);
+                if (fields_[0] == "usage_usec")
+                {
+                    current.usage_usec = value;
+                }
+                else if (fields_[0] == "user_usec")
+                {
+                    current.user_usec = value;
+                }
+                else if (fields_[0] == "system_usec")
+                {
+                    current.system_usec = value;
+                }
+                else if (fields_[0] == "nr_throttled")
+                {
+                    current.nr_throttled = value;
+                }
+                else if (fields_[0] == "throttled_usec")
+                {
+                    current.throttled_usec = value;
+                }
+            });
+        }
+
+        if (size_t size = ReadFile(path, cgroup, MEMORY_CURRENT))
+        {
+            any = true;
+            if (ProcParser::SplitFields(std::string_view(buffer_.data(), size), &fields_) >= 1)
+            {
+                memory_current = ProcParser::ToNumber<uint64_t>(fields_[0]);
+            }
+        }
+
+        if (size_t size = ReadFile(path, cgroup, MEMORY_STAT))
+        {
+            any = true;
+            ForEachLine(std::string_view(buffer_.data(), size), [&](std::string_view line) {
+                if (ProcParser::SplitFields(line, &fields_) < 2)
+                {
+                    return;
+                }
+                if (fields_[0] == "anon")
+                {
+                    memory_anon = ProcParser::ToNumber<uint64_t>(fields_[1]);
+                }
+                else if (fields_[0] == "file")
+                {
+                    memory_file = ProcParser::ToNumber<uint64_t>(fields_[1]);
+                }
+                else if (fields_[0] == "pgmajfault")
+                {
+                    current.pgmajfault = ProcParser::ToNumber<uint64_t>(fields_[1]);
+                }
+            });
+        }
+
+        if (size_t size = ReadFile(path, cgroup, IO_STAT))
+        {
+            any = true;
+            ForEachLine(std::string_view(buffer_.data(), size), [&](std::string_view line) {
+                const size_t count = ProcParser::SplitFields(line, &fields_);
+                for (size_t i = 1; i < count; ++i)   // 第一个字段是设备号
+                {
+                    const size_t equal = fields_[i].find('=');
+                    if (equal == std::string_view::npos)
+                    {
+                        continue;
+                    }
+                    const std::string_view key = fields_[i].substr(0, equal);
+                    const uint64_t value = ProcParser::ToNumber<uint64_t>(fields_[i].substr(equal + 1));
+                    if (key == "rbytes")
+                    {
+                        current.rbytes += value;
+                    }
+                    else if (key == "wbytes")
+                    {
+                        current.wbytes += value;
+                    }
+                    else if (key == "rios")
+                    {
+                        current.rios += value;
+                    }
+                    else if (key == "wios")
+                    {
+                        current.wios += value;
+                    }
+                }
+            });
+        }
+
+        if (!any)
+        {
+            return;   // 目录已被删除（等待inotify事件清理）或没有任何可读的接口文件
+        }
+
+        const double seconds = cgroup->has_prev
+            ? std::chrono::duration<double>(now - cgroup->prev_time).count() : 0.0;
+        if (seconds > 0)
+        {
+            const Counters& prev = cgroup->prev;
+            const double usec_to_percent = 100.0 / 1e6 / seconds;   // 微秒增量 → 占用百分比
+            auto* info = monitor_info->add_cgroup_info();
+            info->set_name(path);
+            info->set_cpu_percent(static_cast<float>(Delta(current.usage_usec, prev.usage_usec) * usec_to_percent));
+            info->set_cpu_user_percent(static_cast<float>(Delta(current.user_usec, prev.user_usec) * usec_to_percent));
+            info->set_cpu_system_percent(
+                static_cast<float>(Delta(current.system_usec, prev.system_usec) * usec_to_percent));
+            info->set_throttled_percent(
+                static_cast<float>(Delta(current.throttled_usec, prev.throttled_usec) * usec_to_percent));
+            info->set_nr_throttled(Delta(current.nr_throttled, prev.nr_throttled));
+            info->set_memory_current_kb(memory_current / 1024);
+            info->set_memory_anon_kb(memory_anon / 1024);
+            info->set_memory_file_kb(memory_file / 1024);
+            info->set_pgmajfault_rate(static_cast<float>(Delta(current.pgmajfault, prev.pgmajfault) / seconds));
+            info->set_io_read_kbps(static_cast<float>(Delta(current.rbytes, prev.rbytes) / 1024.0 / seconds));
+            info->set_io_write_kbps(static_cast<float>(Delta(current.wbytes, prev.wbytes) / 1024.0 / seconds));
+            info->set_io_read_iops(static_cast<float>(Delta(current.rios, prev.rios) / seconds));
+            info->set_io_write_iops(static_cast<float>(Delta(current.wios, prev.wios) / seconds));
+        }
+        cgroup->prev = current;
+        cgroup->prev_time = now;
+        cgroup->has_prev = true;
+    }
+
+    /**
+     * @brief 更新cgroup监控信息的具体实现
+     * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+     *
+     * 详细执行流程：
+     * 1. 读空inotify队列，加入新建的cgroup、删除已删除的cgroup（不遍历目录树）
+     * 2. 对每个cgroup pread四个接口文件，解析累计计数
+     * 3. 与上次读取做差，换算为速率填充cgroup_info（新cgroup下一次采样开始输出）
+     */
+    void CgroupMonitor::UpdateOnce(monitor::proto::MonitorInfo* monitor_info)
+    {
+        ++tick_;
+        DrainEvents();
+
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& entry : cgroups_)
+        {
+            ReadCgroup(entry.first, &entry.second, now, monitor_info);
+        }
+    }
+}  // namespace monitor
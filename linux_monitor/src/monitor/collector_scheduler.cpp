@@ -0,0 +1,290 @@
+// 包含对应的头文件
+#include "monitor/collector_scheduler.h"
+
+// 系统调用头文件
+#include <cerrno>       // EINTR
+#include <time.h>       // clock_gettime、clock_nanosleep
+
+// C++标准库头文件
+#include <utility>      // std::move
+
+namespace monitor
+{
+    static constexpr int64_t kNanosPerSecond = 1000000000;
+
+    CollectorScheduler::CollectorScheduler(size_t workers)
+    {
+        if (workers > 0)
+        {
+            pool_ = std::make_unique<WorkerPool>(workers);
+        }
+    }
+
+    void CollectorScheduler::Register(const std::string& name, std::shared_ptr<MonitorInter> collector,
+        std::chrono::nanoseconds period, std::shared_ptr<AdaptiveSampler> adaptive)
+    {
+        if (!collector || period.count() <= 0)
+        {
+            return;
+        }
+        collectors_.push_back(
+            Collector{name, std::move(collector), period.count(), LatencyHistogram(), std::move(adaptive)});
+    }
+
+    /**
+     * @brief 导出采样耗时的具体实现
+     * @param monitor_info 输出参数，批次消息
+     *
+     * 直方图记录纳秒，导出时换算为微秒；本窗口没有运行过的监控器（周期长于窗口）不导出。
+     */
+    void CollectorScheduler::ExportCollectorStats(monitor::proto::MonitorInfo* monitor_info)
+    {
+        constexpr uint64_t kNanosPerMicro = 1000;
+        for (auto& entry : collectors_)
+        {
+            if (entry.latency.Count() == 0)
+            {
+                continue;
+            }
+            auto* stats = monitor_info->add_collector_stats();
+            stats->set_name(entry.name);
+            stats->set_count(entry.latency.Count());
+            stats->set_p50_us(entry.latency.Percentile(0.5) / kNanosPerMicro);
+            stats->set_p99_us(entry.latency.Percentile(0.99) / kNanosPerMicro);
+            stats->set_max_us(entry.latency.Max() / kNanosPerMicro);
+            entry.latency.Reset();
+        }
+    }
+
+    void CollectorScheduler::RunTimed(Collector* entry, monitor::proto::MonitorInfo* monitor_info)
+    {
+        const int64_t start = NowNs();
+        entry->collector->UpdateOnce(monitor_info);
+        entry->latency.Record(NowNs() - start);
+    }
+
+    int64_t CollectorScheduler::NowNs()
+    {
+        struct timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * kNanosPerSecond + ts.tv_nsec;
+    }
+
+    /**
+     * @brief 睡眠到指定绝对时间的具体实现
+     * @param deadline_ns CLOCK_MONOTONIC绝对时间（纳秒）
+     *
+     * 使用TIMER_ABSTIME：被信号打断后用同一个绝对时间重新睡眠即可，
+     * 不需要计算剩余时间，也不会因为重复计算而漂移。
+     */
+    void CollectorScheduler::SleepUntil(int64_t deadline_ns)
+    {
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(deadline_ns / kNanosPerSecond);
+        ts.tv_nsec = static_cast<long>(deadline_ns % kNanosPerSecond);
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+        {
+        }
+    }
+
+    /**
+     * @brief 运行本批次到期监控器的具体实现
+     * @param monitor_info 输出参数，批次消息
+     *
+     * 串行模式下所有监控器直接填充批次消息；
+     * 并行模式下每个监控器填充自己的子消息，全部完成后在调度线程上依次移动合并。
+     * 每个监控器的耗时在执行它的线程上计时（并行模式下是单个监控器的耗时，不含排队）；
+     * 同一批次中一个监控器只出现一次，直方图不会被两个线程同时写入。
+     */
+    void CollectorScheduler::CollectDue(monitor::proto::MonitorInfo* monitor_info)
+    {
+        if (!pool_ || due_.size() <= 1)
+        {
+            for (const Deadline& entry : due_)
+            {
+                RunTimed(&collectors_[entry.index], monitor_info);
+            }
+            return;
+        }
+
+        // 子消息与批次消息在同一个Arena上，合并时交换字段只交换指针
+        sub_infos_.clear();
+        for (size_t i = 0; i < due_.size(); ++i)
+        {
+            sub_infos_.push_back(google::protobuf::Arena::CreateMessage<monitor::proto::MonitorInfo>(&arena_));
+        }
+        pool_->ParallelFor(due_.size(), [this](size_t i) {
+            RunTimed(&collectors_[due_[i].index], sub_infos_[i]);
+        });
+        for (size_t i = 0; i < due_.size(); ++i)
+        {
+            MergeByMove(sub_infos_[i], monitor_info);
+        }
+    }
+
+    /**
+     * @brief 移动合并子消息的具体实现
+     * @param from 子消息
+     * @param to 目标消息
+     *
+     * Reflection::SwapFields对同一Arena上的repeated和message字段只交换内部指针，
+     * 与逐元素MergeFrom相比没有任何拷贝；子消息拿到目标消息中原来的空字段。
+     * 字段列表使用成员缓冲区，预热后不再分配。
+     */
+    void CollectorScheduler::MergeByMove(monitor::proto::MonitorInfo* from, monitor::proto::MonitorInfo* to)
+    {
+        const google::protobuf::Reflection* reflection = from->GetReflection();
+        std::vector<const google::protobuf::FieldDescriptor*>& fields = merge_fields_;
+        fields.clear();
+        reflection->ListFields(*from, &fields);
+
+        std::vector<const google::protobuf::FieldDescriptor*>& movable = merge_movable_;
+        movable.clear();
+        bool conflict = false;
+        for (const auto* field : fields)
+        {
+            bool present = field->is_repeated() ? reflection->FieldSize(*to, field) > 0
+                                                : reflection->HasField(*to, field);
+            if (present)
+            {
+                conflict = true;
+            }
+            else
+            {
+                movable.push_back(field);
+            }
+        }
+
+        reflection->SwapFields(from, to, movable);
+
+        // 交换后子消息中只剩下冲突字段（被交换的字段已经变为空），合并即可
+        if (conflict)
+        {
+            to->MergeFrom(*from);
+        }
+    }
+
+    /**
+     * @brief 更新自适应周期的具体实现
+     * @param monitor_info 批次消息
+     *
+     * 在所有到期监控器合并完成后执行（并行模式下信号字段已经移动到批次消息中）；
+     * sample_interval记录的是本次采样所在的周期，下一个截止时间按更新后的周期计算。
+     */
+    void CollectorScheduler::Adapt(monitor::proto::MonitorInfo* monitor_info)
+    {
+        constexpr int64_t kNanosPerMilli = 1000000;
+        const int64_t now = NowNs();
+        for (const Deadline& entry : due_)
+        {
+            Collector& collector = collectors_[entry.index];
+            if (!collector.adaptive)
+            {
+                continue;
+            }
+            auto* interval = monitor_info->add_sample_interval();
+            interval->set_name(collector.name);
+            interval->set_interval_ms(static_cast<uint32_t>(collector.period_ns / kNanosPerMilli));
+            collector.period_ns = collector.adaptive->Observe(*monitor_info, now, collector.period_ns);
+        }
+    }
+
+    /**
+     * @brief 运行一个批次的具体实现
+     * @param handler 批次回调
+     * @param adapt 是否更新自适应周期
+     *
+     * 批次消息在arena_上构造，回调返回后Reset：
+     * 本批次所有子消息、字符串和repeated数组一次性回收，内存块回到ArenaBlockPool供下一批次复用。
+     */
+    void CollectorScheduler::RunBatch(const BatchHandler& handler, bool adapt)
+    {
+        auto* monitor_info = google::protobuf::Arena::CreateMessage<monitor::proto::MonitorInfo>(&arena_);
+        CollectDue(monitor_info);
+        if (adapt)
+        {
+            Adapt(monitor_info);
+        }
+        if (handler)
+        {
+            handler(monitor_info);
+        }
+        sub_infos_.clear();
+        arena_.Reset();
+    }
+
+    void CollectorScheduler::CollectAll(const BatchHandler& handler)
+    {
+        due_.clear();
+        for (size_t i = 0; i < collectors_.size(); ++i)
+        {
+            due_.push_back(Deadline{0, i});
+        }
+        RunBatch(handler, false);
+    }
+
+    /**
+     * @brief 调度循环的具体实现
+     * @param handler 批次回调
+     *
+     * 详细执行流程：
+     * 1. 所有监控器的第一个截止时间都设为当前时刻
+     * 2. 睡眠到堆顶的截止时间
+     * 3. 弹出所有在容差内到期的监控器，依次填充同一个MonitorInfo
+     * 4. 调用批次回调上报
+     * 5. 每个到期监控器的截止时间加一个周期（跳过已经错过的周期）后放回堆中；
+     *    自适应的监控器使用本批次更新后的周期
+     */
+    void CollectorScheduler::Run(const BatchHandler& handler)
+    {
+        running_.store(true);
+
+        deadlines_ = decltype(deadlines_)();
+        const int64_t start = NowNs();
+        for (size_t i = 0; i < collectors_.size(); ++i)
+        {
+            deadlines_.push(Deadline{start, i});
+        }
+
+        const int64_t slack_ns = std::chrono::nanoseconds(kBatchSlack).count();
+        while (running_.load() && !deadlines_.empty())
+        {
+            SleepUntil(deadlines_.top().deadline_ns);
+            if (!running_.load())
+            {
+                break;
+            }
+
+            // 收集本批次到期的监控器
+            const int64_t now = NowNs();
+            due_.clear();
+            while (!deadlines_.empty() && deadlines_.top().deadline_ns <= now + slack_ns)
+            {
+                due_.push_back(deadlines_.top());
+                deadlines_.pop();
+            }
+
+            // 到期的监控器填充同一个消息，只上报一次
+            RunBatch(handler, true);
+
+            // 计算下一个截止时间：在原截止时间上累加周期，保证长期无漂移；
+            // 本批次耗时过长导致错过的周期直接跳过
+            const int64_t done = NowNs();
+            for (Deadline entry : due_)
+            {
+                const int64_t period = collectors_[entry.index].period_ns;
+                entry.deadline_ns += period;
+                if (entry.deadline_ns <= done)
+                {
+                    entry.deadline_ns += ((done - entry.deadline_ns) / period + 1) * period;
+                }
+                deadlines_.push(entry);
+            }
+        }
+
+        for (auto& entry : collectors_)
+        {
+            entry.collector->Stop();
+        }
+    }
+}  // namespace monitor
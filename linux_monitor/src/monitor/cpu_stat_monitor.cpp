@@ -1,8 +1,13 @@
 // 包含对应的头文件
 #include "monitor/cpu_stat_monitor.h"
 
+// C++标准库头文件
+#include <algorithm>    // std::fill
+#include <charconv>     // std::from_chars
+
 // 包含工具类头文件
-#include "utils/read_file.h"
+#include "utils/counter_delta.h"   // 计数器差分速率内核
+#include "utils/proc_parser.h"
 
 // 包含Protobuf相关头文件
 #include "monitor_info.grpc.pb.h"
@@ -10,18 +15,119 @@
 
 namespace monitor
 {
+    /**
+     * @brief 根据CPU名称计算槽位索引的具体实现
+     * @param name CPU名称
+     * @param slot 输出参数，槽位索引
+     * @return bool 名称合法返回true
+     *
+     * 槽位映射：
+     * - "cpu"  → 0（所有CPU核心的汇总）
+     * - "cpuN" → N + 1
+     */
+    bool CpuStatMonitor::CpuSlot(std::string_view name, size_t* slot)
+    {
+        if (name.size() < 3 || name.substr(0, 3) != "cpu")
+        {
+            return false;
+        }
+        if (name.size() == 3)
+        {
+            *slot = 0;
+            return true;
+        }
+
+        size_t index = 0;
+        auto result = std::from_chars(name.data() + 3, name.data() + name.size(), index);
+        if (result.ec != std::errc() || result.ptr != name.data() + name.size())
+        {
+            return false;
+        }
+        *slot = index + 1;
+        return true;
+    }
+
+    /**
+     * @brief 确保槽位容量的具体实现
+     * @param slots 需要的槽位数
+     *
+     * 只在出现新的CPU编号时扩容（首次采样或CPU热插拔），
+     * 扩容时PerCpuMatrix会保留已有槽位的历史数据。
+     */
+    void CpuStatMonitor::EnsureSlots(size_t slots)
+    {
+        if (slots <= cur_stat_.Cpus())
+        {
+            return;
+        }
+        prev_stat_.Resize(FIELD_MAX, slots);
+        cur_stat_.Resize(FIELD_MAX, slots);
+        percent_.Resize(FIELD_MAX, slots);
+        total_diff_.resize(slots, 0.0);
+        busy_diff_.resize(slots, 0.0);
+        prev_seen_.resize(slots, 0);
+        cur_seen_.resize(slots, 0);
+        cpu_names_.resize(slots);
+    }
+
+    /**
+     * @brief 计算所有CPU使用率百分比的具体实现
+     *
+     * 计算公式（与原有算法一致）：
+     * - 总时间片 = user + nice + system + idle + iowait + irq + softirq + steal
+     *   （不包括guest和guest_nice，因为它们已包含在user和nice中）
+     * - 繁忙时间片 = 总时间片 - idle - iowait
+     * - 各状态百分比 = 状态时间变化量 / 总时间变化量 × 100%
+     *
+     * 差分都由CounterDelta在连续的uint64_t数组上按CPU槽位计算（计数器回退时差值按0处理）：
+     * 第一遍得到各字段的原始变化量并累加出总量，第二遍用每个CPU的100/总量作为逐元素缩放系数，
+     * 直接得到百分比。
+     */
+    void CpuStatMonitor::ComputePercents()
+    {
+        const size_t cpus = cur_stat_.Cpus();
+
+        // 第一步：各字段的原始变化量（暂存在percent_中），累加出每个CPU的总时间片和繁忙时间片变化量
+        for (size_t c = 0; c < cpus; ++c)
+        {
+            total_diff_[c] = 0.0;
+            busy_diff_[c] = 0.0;
+        }
+        for (size_t f = USER; f <= STEAL; ++f)
+        {
+            float* diff = percent_.Field(f);
+            CounterDelta::Rates(cur_stat_.Field(f), prev_stat_.Field(f), cpus, 1.0, diff);
+            const bool busy = (f != IDLE && f != IO_WAIT);
+            for (size_t c = 0; c < cpus; ++c)
+            {
+                total_diff_[c] += diff[c];
+                busy_diff_[c] += busy ? diff[c] : 0.0f;
+            }
+        }
+
+        // 第二步：把总变化量转换为缩放系数，复用total_diff_存储100/total
+        for (size_t c = 0; c < cpus; ++c)
+        {
+            total_diff_[c] = total_diff_[c] > 0 ? 100.0 / total_diff_[c] : 0.0;
+        }
+
+        // 第三步：各字段百分比 = 字段变化量 × 缩放系数
+        for (size_t f = USER; f <= STEAL; ++f)
+        {
+            CounterDelta::Rates(cur_stat_.Field(f), prev_stat_.Field(f), cpus, total_diff_.data(),
+                percent_.Field(f));
+        }
+    }
+
     /**
      * @brief 更新CPU状态监控信息的具体实现
      * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
      *
      * 详细执行流程：
-     * 1. 读取/proc/stat文件，解析各CPU核心的时间片统计
-     * 2. 对每个CPU核心：
-     *    a. 解析当前采样的时间片数据
-     *    b. 查找上一次采样数据
-     *    c. 如果找到旧数据，计算各种CPU状态的使用率百分比
-     *    d. 将百分比数据填充到Protobuf消息
-     *    e. 更新存储的历史数据
+     * 1. 读取/proc/stat文件，将各CPU核心的时间片计数写入当前采样矩阵
+     * 2. 对所有CPU槽位一次性计算各种CPU状态的使用率百分比
+     * 3. 对上次和本次采样都存在的CPU，将百分比数据填充到Protobuf消息
+     * 4. 交换当前和上次采样矩阵，作为下一次采样的历史数据
      *
      * /proc/stat文件格式示例：
      * cpu  145598 1961 36646 11275927 3070 0 4478 0 0 0
@@ -38,145 +144,94 @@ namespace monitor
      * 8. steal: 虚拟化环境偷走的时间
      * 9. guest: 运行虚拟CPU的时间
      * 10. guest_nice: 运行低优先级虚拟CPU的时间
+     *
+     * 计数器使用uint64_t存储：float只有24位尾数，
+     * 长时间运行的机器上jiffies超过2^24后差分结果会明显失真。
      */
     void CpuStatMonitor::UpdateOnce(monitor::proto::MonitorInfo* monitor_info)
     {
-        // 打开并读取/proc/stat文件
+        // 读取/proc/stat到复用缓冲区
         // 该文件包含所有CPU核心的时间片统计信息
-        ReadFile cpu_stat_file(std::string("/proc/stat"));
+        if (!stat_parser_.Load())
+        {
+            return;
+        }
 
-        // 存储从文件读取的原始数据（一行数据）
-        std::vector<std::string> cpu_stat_list;
+        // 清空本次采样的槽位标记
+        std::fill(cur_seen_.begin(), cur_seen_.end(), 0);
 
         // 逐行读取文件，直到文件结束
-        while (cpu_stat_file.ReadLine(&cpu_stat_list))
+        std::string_view line;
+        while (stat_parser_.NextLine(&line))
         {
-            // 检查是否为CPU相关行（以"cpu"开头）
-            if (cpu_stat_list[0].find("cpu") != std::string::npos)
+            // 只处理CPU相关行（以"cpu"开头），其余行（intr、ctxt等）直接跳过，不做分割
+            // CPU行在/proc/stat中连续出现在文件开头，遇到第一个非CPU行即可结束
+            if (line.substr(0, 3) != "cpu")
+            {
+                break;
+            }
+
+            // 分割为字段视图：cpu名称 + 10个时间片计数
+            size_t slot = 0;
+            if (ProcParser::SplitFields(line, &fields_) < FIELD_MAX + 1 ||
+                !CpuSlot(fields_[0], &slot))
             {
-                // 调试输出（注释掉的代码）
-                // std::cout << cpu_stat_list[0] << cpu_stat_list[1] << std::endl;
-
-                // 创建当前采样的CPU状态数据
-                struct CpuStat cpu_stat;
-
-                // 设置CPU核心标识
-                // "cpu" 表示所有CPU核心的总体统计
-                // "cpu0", "cpu1" 等表示具体的CPU核心
-                cpu_stat.cpu_name = cpu_stat_list[0];
-
-                // 解析各种CPU状态的时间片计数值
-                // 将字符串转换为浮点数，单位：jiffies（时间片）
-                cpu_stat.user = std::stof(cpu_stat_list[1]);        // 用户态时间
-                cpu_stat.nice = std::stof(cpu_stat_list[2]);        // 低优先级用户态时间
-                cpu_stat.system = std::stof(cpu_stat_list[3]);      // 系统态时间
-                cpu_stat.idle = std::stof(cpu_stat_list[4]);        // 空闲时间
-                cpu_stat.io_wait = std::stof(cpu_stat_list[5]);     // 等待I/O时间
-                cpu_stat.irq = std::stof(cpu_stat_list[6]);         // 硬件中断时间
-                cpu_stat.soft_irq = std::stof(cpu_stat_list[7]);    // 软中断时间
-                cpu_stat.steal = std::stof(cpu_stat_list[8]);       // 虚拟化偷走时间
-                cpu_stat.guest = std::stof(cpu_stat_list[9]);       // 虚拟CPU运行时间
-                cpu_stat.guest_nice = std::stof(cpu_stat_list[10]); // 低优先级虚拟CPU时间
-
-                // 查找该CPU核心上一次的采样数据
-                auto it = cpu_stat_map_.find(cpu_stat.cpu_name);
-                if (it != cpu_stat_map_.end())
-                {
-                    // 找到旧数据，进行差分计算
-                    // 调试输出（注释掉的代码）
-                    // std::cout << cpu_stat.cpu_name << std::endl;
-
-                    struct CpuStat old = it->second;
-
-                    // 向Protobuf消息添加一个新的CPU状态条目
-                    auto cpu_stat_msg = monitor_info->add_cpu_stat();
-
-                    // ==================== 关键计算部分 ====================
-                    // 计算总时间片和繁忙时间片
-
-                    // 计算新的总时间片（不包括guest和guest_nice，因为它们包含在user和nice中）
-                    float new_cpu_total_time = cpu_stat.user + cpu_stat.system +
-                        cpu_stat.idle + cpu_stat.nice +
-                        cpu_stat.io_wait + cpu_stat.irq +
-                        cpu_stat.soft_irq + cpu_stat.steal;
-
-                    // 计算旧的总时间片
-                    float old_cpu_total_time = old.user + old.system + old.idle + old.nice +
-                        old.io_wait + old.irq + old.soft_irq +
-                        old.steal;
-
-                    // 计算新的繁忙时间片（CPU在工作的时间）
-                    float new_cpu_busy_time = cpu_stat.user + cpu_stat.system +
-                        cpu_stat.nice + cpu_stat.irq +
-                        cpu_stat.soft_irq + cpu_stat.steal;
-
-                    // 计算旧的繁忙时间片
-                    float old_cpu_busy_time = old.user + old.system + old.nice + old.irq +
-                        old.soft_irq + old.steal;
-
-                    // 计算时间片差值（两次采样之间的变化）
-                    float total_time_diff = new_cpu_total_time - old_cpu_total_time;
-
-                    // 只在时间差为正数时计算百分比（避免除零或负值）
-                    if (total_time_diff > 0)
-                    {
-                        // 计算各种CPU使用率的百分比
-                        // 公式：（状态时间变化量 / 总时间变化量）× 100%
-
-                        // 总体CPU使用率（所有工作状态的时间占比）
-                        float cpu_percent = (new_cpu_busy_time - old_cpu_busy_time) /
-                            total_time_diff * 100.00;
-
-                        // 用户态使用率（普通优先级进程）
-                        float cpu_user_percent = (cpu_stat.user - old.user) /
-                            total_time_diff * 100.00;
-
-                        // 系统态使用率（内核代码）
-                        float cpu_system_percent = (cpu_stat.system - old.system) /
-                            total_time_diff * 100.00;
-
-                        // 低优先级用户态使用率
-                        float cpu_nice_percent = (cpu_stat.nice - old.nice) /
-                            total_time_diff * 100.00;
-
-                        // 空闲时间占比
-                        float cpu_idle_percent = (cpu_stat.idle - old.idle) /
-                            total_time_diff * 100.00;
-
-                        // 等待I/O时间占比
-                        float cpu_io_wait_percent = (cpu_stat.io_wait - old.io_wait) /
-                            total_time_diff * 100.00;
-
-                        // 硬件中断时间占比
-                        float cpu_irq_percent = (cpu_stat.irq - old.irq) /
-                            total_time_diff * 100.00;
-
-                        // 软中断时间占比
-                        float cpu_soft_irq_percent = (cpu_stat.soft_irq - old.soft_irq) /
-                            total_time_diff * 100.00;
-
-                        // ==================== 填充Protobuf消息 ====================
-                        // 设置CPU核心标识
-                        cpu_stat_msg->set_cpu_name(cpu_stat.cpu_name);
-
-                        // 设置各种CPU使用率百分比
-                        cpu_stat_msg->set_cpu_percent(cpu_percent);          // 总体使用率
-                        cpu_stat_msg->set_usr_percent(cpu_user_percent);     // 用户态使用率
-                        cpu_stat_msg->set_system_percent(cpu_system_percent); // 系统态使用率
-                        cpu_stat_msg->set_nice_percent(cpu_nice_percent);    // 低优先级使用率
-                        cpu_stat_msg->set_idle_percent(cpu_idle_percent);    // 空闲时间占比
-                        cpu_stat_msg->set_io_wait_percent(cpu_io_wait_percent); // I/O等待占比
-                        cpu_stat_msg->set_irq_percent(cpu_irq_percent);      // 硬件中断占比
-                        cpu_stat_msg->set_soft_irq_percent(cpu_soft_irq_percent); // 软中断占比
-                    }
-                }
-                // 更新存储的历史数据（用当前采样替换旧数据）
-                // 注意：guest和guest_nice字段被包含在user和nice中，所以计算总时间时不重复计算
-                cpu_stat_map_[cpu_stat.cpu_name] = cpu_stat;
+                continue;
             }
-            // 清空临时容器，准备读取下一行
-            cpu_stat_list.clear();
+            EnsureSlots(slot + 1);
+
+            // 槽位第一次出现或名称变化时才构造名称字符串
+            if (cpu_names_[slot] != fields_[0])
+            {
+                cpu_names_[slot].assign(fields_[0]);
+            }
+
+            // 解析各种CPU状态的时间片计数值，写入当前采样矩阵的对应槽位
+            for (size_t f = 0; f < FIELD_MAX; ++f)
+            {
+                cur_stat_.At(f, slot) = ProcParser::ToNumber<uint64_t>(fields_[f + 1]);
+            }
+            cur_seen_[slot] = 1;
+        }
+
+        // ==================== 关键计算部分 ====================
+        // 对所有CPU槽位一次性计算差分和百分比
+        ComputePercents();
+
+        // ==================== 填充Protobuf消息 ====================
+        // 按槽位顺序输出（汇总行"cpu"在前，之后依次为cpu0、cpu1...）
+        const size_t cpus = cur_stat_.Cpus();
+        for (size_t c = 0; c < cpus; ++c)
+        {
+            // 只在上次和本次采样都存在、且总时间差为正数时输出（避免除零或负值）
+            if (!cur_seen_[c] || !prev_seen_[c] || total_diff_[c] <= 0)
+            {
+                continue;
+            }
+
+            // 向Protobuf消息添加一个新的CPU状态条目
+            auto cpu_stat_msg = monitor_info->add_cpu_stat();
+
+            // 设置CPU核心标识
+            cpu_stat_msg->set_cpu_name(cpu_names_[c]);
+
+            // 总体CPU使用率（所有工作状态的时间占比）
+            cpu_stat_msg->set_cpu_percent(static_cast<float>(busy_diff_[c] * total_diff_[c]));
+
+            // 设置各种CPU使用率百分比
+            cpu_stat_msg->set_usr_percent(percent_.At(USER, c));          // 用户态使用率
+            cpu_stat_msg->set_system_percent(percent_.At(SYSTEM, c));     // 系统态使用率
+            cpu_stat_msg->set_nice_percent(percent_.At(NICE, c));         // 低优先级使用率
+            cpu_stat_msg->set_idle_percent(percent_.At(IDLE, c));         // 空闲时间占比
+            cpu_stat_msg->set_io_wait_percent(percent_.At(IO_WAIT, c));   // I/O等待占比
+            cpu_stat_msg->set_irq_percent(percent_.At(IRQ, c));           // 硬件中断占比
+            cpu_stat_msg->set_soft_irq_percent(percent_.At(SOFT_IRQ, c)); // 软中断占比
         }
+
+        // 更新历史数据：交换当前和上次采样（不拷贝数据）
+        prev_stat_.Swap(cur_stat_);
+        prev_seen_.swap(cur_seen_);
+
         // 函数返回，CPU状态数据已成功采集并填充到monitor_info中
         return;
     }
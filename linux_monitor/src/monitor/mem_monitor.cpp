@@ -2,7 +2,7 @@
 #include "monitor/mem_monitor.h"
 
 // 包含工具类头文件
-#include "utils/read_file.h"      // 文件读取工具类
+#include "utils/proc_parser.h"    // /proc零拷贝解析器
 
 namespace monitor
 {
@@ -39,101 +39,112 @@ namespace monitor
      */
     void MemMonitor::UpdateOnce(monitor::proto::MonitorInfo* monitor_info)
     {
-        // 打开/proc/meminfo文件
+        // 读取/proc/meminfo到复用缓冲区
         // 该文件包含系统当前内存使用情况的完整统计
-        ReadFile mem_file("/proc/meminfo");
-
-        // 创建内存信息结构体，初始化为0（注意：这里没有显式初始化）
-        struct MenInfo mem_info;
+        if (!meminfo_parser_.Load())
+        {
+            return;
+        }
 
-        // 存储从文件读取的原始数据（一行分割后的字段）
-        std::vector<std::string> mem_datas;
+        // 创建内存信息结构体，缺失的字段保持为0
+        struct MenInfo mem_info = {};
 
         // 逐行读取并解析文件内容
-        while (mem_file.ReadLine(&mem_datas))
+        std::string_view line;
+        while (meminfo_parser_.NextLine(&line))
         {
+            // 分割为字段视图，至少需要标签名和数值两列
+            if (ProcParser::SplitFields(line, &fields_) < 2)
+            {
+                continue;
+            }
+
             // 根据标签名提取对应的内存统计值
-            // 注意：mem_datas[0]是标签名，mem_datas[1]是数值，mem_datas[2]可能是"kB"
+            // 注意：fields_[0]是标签名，fields_[1]是数值，fields_[2]可能是"kB"
 
-            if (mem_datas[0] == "MemTotal:")
+            if (fields_[0] == "MemTotal:")
             {
-                mem_info.total = std::stoll(mem_datas[1]);          // 系统总物理内存
+                mem_info.total = ProcParser::ToNumber<int64_t>(fields_[1]);          // 系统总物理内存
             }
-            else if (mem_datas[0] == "MemFree:")
+            else if (fields_[0] == "MemFree:")
             {
-                mem_info.free = std::stoll(mem_datas[1]);           // 空闲内存
+                mem_info.free = ProcParser::ToNumber<int64_t>(fields_[1]);           // 空闲内存
             }
-            else if (mem_datas[0] == "MemAvailable:")
+            else if (fields_[0] == "MemAvailable:")
             {
-                mem_info.avail = std::stoll(mem_datas[1]);          // 可用内存（估算）
+                mem_info.avail = ProcParser::ToNumber<int64_t>(fields_[1]);          // 可用内存（估算）
             }
-            else if (mem_datas[0] == "Buffers:")
+            else if (fields_[0] == "Buffers:")
             {
-                mem_info.buffers = std::stoll(mem_datas[1]);        // 缓冲区内存
+                mem_info.buffers = ProcParser::ToNumber<int64_t>(fields_[1]);        // 缓冲区内存
             }
-            else if (mem_datas[0] == "Cached:")
+            else if (fields_[0] == "Cached:")
             {
-                mem_info.cached = std::stoll(mem_datas[1]);         // 页面缓存
+                mem_info.cached = ProcParser::ToNumber<int64_t>(fields_[1]);         // 页面缓存
             }
-            else if (mem_datas[0] == "SwapCached:")
+            else if (fields_[0] == "SwapCached:")
             {
-                mem_info.swap_cached = std::stoll(mem_datas[1]);    // 交换区缓存
+                mem_info.swap_cached = ProcParser::ToNumber<int64_t>(fields_[1]);    // 交换区缓存
             }
-            else if (mem_datas[0] == "Active:")
+            else if (fields_[0] == "Active:")
             {
-                mem_info.active = std::stoll(mem_datas[1]);         // 活跃内存
+                mem_info.active = ProcParser::ToNumber<int64_t>(fields_[1]);         // 活跃内存
             }
-            else if (mem_datas[0] == "Inactive:")
+            else if (fields_[0] == "Inactive:")
             {
-                mem_info.in_active = std::stoll(mem_datas[1]);      // 非活跃内存
+                mem_info.in_active = ProcParser::ToNumber<int64_t>(fields_[1]);      // 非活跃内存
             }
-            else if (mem_datas[0] == "Active(anon):")
+            else if (fields_[0] == "Active(anon):")
             {
-                mem_info.active_anon = std::stoll(mem_datas[1]);    // 活跃匿名页
+                mem_info.active_anon = ProcParser::ToNumber<int64_t>(fields_[1]);    // 活跃匿名页
             }
-            else if (mem_datas[0] == "Inactive(anon):")
+            else if (fields_[0] == "Inactive(anon):")
             {
-                mem_info.inactive_anon = std::stoll(mem_datas[1]);  // 非活跃匿名页
+                mem_info.inactive_anon = ProcParser::ToNumber<int64_t>(fields_[1]);  // 非活跃匿名页
             }
-            else if (mem_datas[0] == "Active(file):")
+            else if (fields_[0] == "Active(file):")
             {
-                mem_info.active_file = std::stoll(mem_datas[1]);    // 活跃文件页
+                mem_info.active_file = ProcParser::ToNumber<int64_t>(fields_[1]);    // 活跃文件页
             }
-            else if (mem_datas[0] == "Inactive(file):")
+            else if (fields_[0] == "Inactive(file):")
             {
-                mem_info.inactive_file = std::stoll(mem_datas[1]);  // 非活跃文件页
+                mem_info.inactive_file = ProcParser::ToNumber<int64_t>(fields_[1]);  // 非活跃文件页
             }
-            else if (mem_datas[0] == "Dirty:")
+            else if (fields_[0] == "Dirty:")
             {
-                mem_info.dirty = std::stoll(mem_datas[1]);          // 脏页
+                mem_info.dirty = ProcParser::ToNumber<int64_t>(fields_[1]);          // 脏页
             }
-            else if (mem_datas[0] == "Writeback:")
+            else if (fields_[0] == "Writeback:")
             {
-                mem_info.writeback = std::stoll(mem_datas[1]);      // 正在写回的页
+                mem_info.writeback = ProcParser::ToNumber<int64_t>(fields_[1]);      // 正在写回的页
             }
-            else if (mem_datas[0] == "AnonPages:")
+            else if (fields_[0] == "AnonPages:")
             {
-                mem_info.anon_pages = std::stoll(mem_datas[1]);     // 匿名页总数
+                mem_info.anon_pages = ProcParser::ToNumber<int64_t>(fields_[1]);     // 匿名页总数
             }
-            else if (mem_datas[0] == "Mapped:")
+            else if (fields_[0] == "Mapped:")
             {
-                mem_info.mapped = std::stoll(mem_datas[1]);         // 内存映射文件
+                mem_info.mapped = ProcParser::ToNumber<int64_t>(fields_[1]);         // 内存映射文件
             }
-            else if (mem_datas[0] == "KReclaimable:")
+            else if (fields_[0] == "KReclaimable:")
             {
-                mem_info.kReclaimable = std::stoll(mem_datas[1]);   // 内核可回收内存
+                mem_info.kReclaimable = ProcParser::ToNumber<int64_t>(fields_[1]);   // 内核可回收内存
             }
-            else if (mem_datas[0] == "SReclaimable:")
+            else if (fields_[0] == "SReclaimable:")
             {
-                mem_info.sReclaimable = std::stoll(mem_datas[1]);   // Slab可回收内存
+                mem_info.sReclaimable = ProcParser::ToNumber<int64_t>(fields_[1]);   // Slab可回收内存
             }
-            else if (mem_datas[0] == "SUnreclaim:")
+            else if (fields_[0] == "SUnreclaim:")
             {
-                mem_info.sUnreclaim = std::stoll(mem_datas[1]);     // Slab不可回收内存
+                mem_info.sUnreclaim = ProcParser::ToNumber<int64_t>(fields_[1]);     // Slab不可回收内存
             }
             // 注意：还有其他字段如SwapTotal、SwapFree等未被解析
-            // 清空临时容器，准备读取下一行
-            mem_datas.clear();
+        }
+
+        // MemTotal缺失说明文件内容异常，避免除零
+        if (mem_info.total <= 0)
+        {
+            return;
         }
 
         // 获取Protobuf消息中的内存信息子消息
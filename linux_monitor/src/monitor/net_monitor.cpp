@@ -1,24 +1,103 @@
 // 包含对应的头文件
 #include "monitor/net_monitor.h"
 
+// C++标准库头文件
+#include <algorithm>    // std::max
+
 // 包含工具类头文件
-#include "utils/read_file.h"      // 文件读取工具类
+#include "utils/counter_delta.h"  // 计数器差分速率内核
+#include "utils/proc_parser.h"    // /proc零拷贝解析器
 #include "utils/utils.h"          // 工具函数，如时间计算
 
 namespace monitor
 {
+    NetMonitor::NetMonitor(Backend backend) : net_dev_parser_("/proc/net/dev")
+    {
+        if (backend == Backend::NETLINK && netlink_.Open())
+        {
+            backend_ = Backend::NETLINK;
+        }
+    }
+
     /**
-     * @brief 更新网络监控信息的具体实现
-     * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+     * @brief 对齐上次采样的具体实现
      *
-     * 详细执行流程：
-     * 1. 读取/proc/net/dev文件，解析各网络接口的累计统计
-     * 2. 对每个网络接口：
-     *    a. 解析当前采样的累计数据
-     *    b. 查找上一次采样数据和采样时间
-     *    c. 如果找到旧数据，计算各种网络速率
-     *    d. 将速率数据填充到Protobuf消息
-     *    e. 更新存储的历史数据
+     * PROCFS：接口数量通常只有个位数，直接做O(n²)的名称匹配；
+     * NETLINK：面向几百个接口的主机，用ifindex到上次列索引的哈希表匹配。
+     * 该路径只在接口增删（如容器创建销毁虚拟网卡）时执行。
+     */
+    void NetMonitor::AlignPrevious()
+    {
+        const size_t iface_num = cur_names_.size();
+        aligned_counters_.Resize(FIELD_MAX, iface_num);
+        prev_valid_.assign(iface_num, 0);
+
+        if (backend_ == Backend::NETLINK)
+        {
+            prev_columns_.clear();
+            for (size_t j = 0; j < prev_ifindex_.size(); ++j)
+            {
+                prev_columns_.emplace(prev_ifindex_[j], j);
+            }
+        }
+
+        for (size_t i = 0; i < iface_num; ++i)
+        {
+            size_t match = prev_names_.size();
+            if (backend_ == Backend::NETLINK)
+            {
+                auto iter = prev_columns_.find(cur_ifindex_[i]);
+                if (iter != prev_columns_.end())
+                {
+                    match = iter->second;
+                }
+            }
+            else
+            {
+                for (size_t j = 0; j < prev_names_.size(); ++j)
+                {
+                    if (prev_names_[j] == cur_names_[i])
+                    {
+                        match = j;
+                        break;
+                    }
+                }
+            }
+            if (match >= prev_names_.size())
+            {
+                continue;
+            }
+            for (size_t f = 0; f < FIELD_MAX; ++f)
+            {
+                aligned_counters_.At(f, i) = prev_counters_.At(f, match);
+            }
+            prev_valid_[i] = 1;
+        }
+        prev_counters_.Swap(aligned_counters_);
+    }
+
+    void NetMonitor::PrepareColumn(size_t iface_num, std::string_view name)
+    {
+        // 接口第一次出现在该列或名称变化时才构造名称字符串
+        if (iface_num == cur_names_.size())
+        {
+            cur_names_.emplace_back(name);
+        }
+        else if (cur_names_[iface_num] != name)
+        {
+            cur_names_[iface_num].assign(name);
+        }
+        // 列数按倍数增长：一次出现大量新接口（如批量创建veth）时只搬移O(log n)次矩阵，
+        // 多出的列在UpdateOnce中收缩到本次的接口数
+        if (iface_num >= cur_counters_.Cpus())
+        {
+            cur_counters_.Resize(FIELD_MAX, std::max(iface_num + 1, cur_counters_.Cpus() * 2));
+        }
+    }
+
+    /**
+     * @brief 从/proc/net/dev读取本次采样的具体实现
+     * @return size_t 接口数
      *
      * /proc/net/dev文件格式示例：
      * Inter-|   Receive                                                |  Transmit
@@ -46,97 +125,186 @@ namespace monitor
      * 15. carrier: 载波错误
      * 16. compressed: 压缩包数
      */
-    void NetMonitor::UpdateOnce(monitor::proto::MonitorInfo* monitor_info)
+    size_t NetMonitor::LoadProcfs()
     {
-        // 打开并读取/proc/net/dev文件
+        // 读取/proc/net/dev到复用缓冲区
         // 该文件包含所有网络接口的累计统计数据
-        ReadFile net_file(std::string("/proc/net/dev"));
-
-        // 存储从文件读取的原始数据（一行分割后的字段）
-        std::vector<std::string> net_datas;
+        if (!net_dev_parser_.Load())
+        {
+            return 0;
+        }
 
         // 逐行读取文件，直到文件结束
-        while (net_file.ReadLine(&net_datas))
+        std::string_view line;
+        size_t iface_num = 0;
+        while (net_dev_parser_.NextLine(&line))
         {
             // 检查是否为有效的网络接口行
-            // 有效行的特征：接口名以':'结尾，且至少包含10个字段（确保有发送端数据）
-            std::string name = net_datas[0];
-            if (name.find(':') == name.size() - 1 && net_datas.size() >= 10)
+            // 有效行的特征：包含':'分隔接口名和统计数据（两行表头不含':'）
+            // 注意：接收字节数很大时内核输出形如"eth0:123456789"，冒号后没有空格，
+            // 因此先按':'切分出接口名，再对剩余部分分割字段
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos)
             {
-                // 创建当前采样的网络接口信息
-                struct NetInfo net_info;
-
-                // 处理接口名称：去掉末尾的':'
-                name.pop_back();
-                net_info.name = name;  // 如："eth0", "lo", "wlan0"
-
-                // ==================== 解析接收端统计数据 ====================
-                // 注意：所有值都是累计值，从系统启动或接口启动开始累加
-                net_info.rcv_bytes = std::stoll(net_datas[1]);      // 接收字节总数
-                net_info.rcv_packets = std::stoll(net_datas[2]);    // 接收数据包总数
-                net_info.err_in = std::stoll(net_datas[3]);         // 接收错误总数
-                net_info.drop_in = std::stoll(net_datas[4]);        // 接收丢包总数
-
-                // ==================== 解析发送端统计数据 ====================
-                // 发送端数据从第9个字段开始（索引8，因为是0-based）
-                net_info.snd_bytes = std::stoll(net_datas[9]);      // 发送字节总数
-                net_info.snd_packets = std::stoll(net_datas[10]);   // 发送数据包总数
-                net_info.err_out = std::stoll(net_datas[11]);       // 发送错误总数
-                net_info.drop_out = std::stoll(net_datas[12]);      // 发送丢包总数
-
-                // 记录当前采样时间点，用于计算速率
-                net_info.timepoint = std::chrono::steady_clock::now();
-
-                // 查找该网络接口上一次的采样数据
-                auto iter = net_info_.find(name);
-                if (iter != net_info_.end())
-                {
-                    // 找到旧数据，进行差分计算得到速率
-                    struct NetInfo old = std::move(iter->second);
+                continue;
+            }
 
-                    // 计算两次采样之间的时间差（单位：秒）
-                    // 使用steady_clock确保时间不受系统时钟调整影响
-                    double period = Utils::SteadyTimeSecond(net_info.timepoint, old.timepoint);
+            // 统计数据部分至少包含16个字段（接收8个 + 发送8个）
+            if (ProcParser::SplitFields(line.substr(colon + 1), &fields_) < 16)
+            {
+                continue;
+            }
 
-                    // 只在时间差为正数时计算速率（避免除零或负值）
-                    if (period > 0)
-                    {
-                        // 向Protobuf消息添加一个新的网络接口条目
-                        auto one_net_msg = monitor_info->add_net_info();
+            // 处理接口名称：去掉前导空白
+            std::string_view name_view = line.substr(0, colon);
+            size_t name_start = name_view.find_first_not_of(' ');
+            if (name_start == std::string_view::npos)
+            {
+                continue;
+            }
+            name_view = name_view.substr(name_start);  // 如："eth0", "lo", "wlan0"
+            PrepareColumn(iface_num, name_view);
 
-                        // 设置网络接口名称
-                        one_net_msg->set_name(net_info.name);
+            // ==================== 解析接收端统计数据 ====================
+            cur_counters_.At(RCV_BYTES, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[0]);    // 接收字节总数
+            cur_counters_.At(RCV_PACKETS, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[1]);  // 接收数据包总数
+            cur_counters_.At(ERR_IN, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[2]);       // 接收错误总数
+            cur_counters_.At(DROP_IN, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[3]);      // 接收丢包总数
 
-                        // ==================== 关键计算部分 ====================
-                        // 计算发送速率（KB/s）：(新字节数 - 旧字节数) / 时间间隔 / 1024
-                        // 注意：这里计算的是千字节/秒（KB/s），不是千比特/秒（Kbps）
-                        one_net_msg->set_send_rate((net_info.snd_bytes - old.snd_bytes) /
-                            1024.0 / period);
+            // ==================== 解析发送端统计数据 ====================
+            // 发送端数据从第9个字段开始（索引8，因为是0-based）
+            cur_counters_.At(SND_BYTES, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[8]);    // 发送字节总数
+            cur_counters_.At(SND_PACKETS, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[9]);  // 发送数据包总数
+            cur_counters_.At(ERR_OUT, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[10]);     // 发送错误总数
+            cur_counters_.At(DROP_OUT, iface_num) = ProcParser::ToNumber<uint64_t>(fields_[11]);    // 发送丢包总数
+            ++iface_num;
+        }
+        return iface_num;
+    }
 
-                        // 计算接收速率（KB/s）
-                        one_net_msg->set_rcv_rate((net_info.rcv_bytes - old.rcv_bytes) /
-                            1024.0 / period);
+    /**
+     * @brief 从rtnetlink读取本次采样的具体实现
+     * @return size_t 接口数
+     *
+     * 一次转储取回所有接口，各列的ifindex记入cur_ifindex_作为对齐依据。
+     */
+    size_t NetMonitor::LoadNetlink()
+    {
+        if (!netlink_.Load())
+        {
+            return 0;
+        }
 
-                        // 计算发送包速率（packets/s）
-                        one_net_msg->set_send_packets_rate(
-                            (net_info.snd_packets - old.snd_packets) / period);
+        NetlinkLinkReader::Link link;
+        size_t iface_num = 0;
+        while (netlink_.NextLink(&link))
+        {
+            PrepareColumn(iface_num, link.name);
+            if (iface_num == cur_ifindex_.size())
+            {
+                cur_ifindex_.push_back(link.ifindex);
+            }
+            else
+            {
+                cur_ifindex_[iface_num] = link.ifindex;
+            }
 
-                        // 计算接收包速率（packets/s）
-                        one_net_msg->set_rcv_packets_rate(
-                            (net_info.rcv_packets - old.rcv_packets) / period);
+            cur_counters_.At(RCV_BYTES, iface_num) = link.rx_bytes;
+            cur_counters_.At(RCV_PACKETS, iface_num) = link.rx_packets;
+            cur_counters_.At(ERR_IN, iface_num) = link.rx_errors;
+            cur_counters_.At(DROP_IN, iface_num) = link.rx_dropped;
+            cur_counters_.At(SND_BYTES, iface_num) = link.tx_bytes;
+            cur_counters_.At(SND_PACKETS, iface_num) = link.tx_packets;
+            cur_counters_.At(ERR_OUT, iface_num) = link.tx_errors;
+            cur_counters_.At(DROP_OUT, iface_num) = link.tx_dropped;
+            ++iface_num;
+        }
+        cur_ifindex_.resize(iface_num);
+        return iface_num;
+    }
 
-                        // 注意：这里没有计算错误率和丢包率，可以根据需要添加：
-                        // 错误率 = (新错误数 - 旧错误数) / (新包数 - 旧包数)
-                        // 丢包率 = (新丢包数 - 旧丢包数) / (新包数 - 旧包数)
-                    }
+    /**
+     * @brief 更新网络监控信息的具体实现
+     * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+     *
+     * 详细执行流程：
+     * 1. 从选定的数据源读取各网络接口的累计统计，按顺序写入当前采样矩阵
+     * 2. 接口列表与上次不同时，把上次采样对齐到本次的列顺序
+     * 3. 用CounterDelta对所有接口一次性计算速率（差值/时间间隔）
+     * 4. 将速率数据填充到Protobuf消息
+     * 5. 交换当前和上次采样矩阵，作为下一次采样的历史数据
+     */
+    void NetMonitor::UpdateOnce(monitor::proto::MonitorInfo* monitor_info)
+    {
+        // 同一次采样的所有网络接口共用一个时间点
+        const auto now = std::chrono::steady_clock::now();
+        const size_t iface_num = backend_ == Backend::NETLINK ? LoadNetlink() : LoadProcfs();
+        if (iface_num == 0)
+        {
+            return;
+        }
+
+        // 接口减少时收缩到本次的接口数（保留前iface_num列）
+        cur_names_.resize(iface_num);
+        cur_counters_.Resize(FIELD_MAX, iface_num);
+
+        // 计算两次采样之间的时间差（单位：秒）
+        // 使用steady_clock确保时间不受系统时钟调整影响
+        const double period = has_prev_ ? Utils::SteadyTimeSecond(now, prev_time_) : 0.0;
+
+        // 只在时间差为正数时计算速率（避免除零或负值）
+        if (period > 0)
+        {
+            // 接口列表变化时，把上次采样按名称（PROCFS）或ifindex（NETLINK）对齐到本次的列顺序
+            const bool same_layout = backend_ == Backend::NETLINK ? (cur_ifindex_ == prev_ifindex_)
+                                                                  : (cur_names_ == prev_names_);
+            if (!same_layout)
+            {
+                AlignPrevious();
+            }
+
+            // ==================== 关键计算部分 ====================
+            // 所有字段、所有接口的计数在矩阵中连续存放，一次调用算完
+            CounterDelta::Rates(cur_counters_, prev_counters_, 1.0 / period, &rate_);
+
+            for (size_t i = 0; i < iface_num; ++i)
+            {
+                // 新出现的接口没有上一次采样数据，下一次采样再输出
+                if (!same_layout && !prev_valid_[i])
+                {
+                    continue;
                 }
-                // 更新存储的历史数据（用当前采样替换旧数据）
-                // 使用std::move移动语义，避免不必要的拷贝
-                net_info_[name] = std::move(net_info);
+
+                // 向Protobuf消息添加一个新的网络接口条目
+                auto one_net_msg = monitor_info->add_net_info();
+
+                // 设置网络接口名称
+                one_net_msg->set_name(cur_names_[i]);
+
+                // 发送/接收速率（KB/s）：字节速率 / 1024
+                // 注意：这里计算的是千字节/秒（KB/s），不是千比特/秒（Kbps）
+                one_net_msg->set_send_rate(rate_.At(SND_BYTES, i) / 1024.0f);
+                one_net_msg->set_rcv_rate(rate_.At(RCV_BYTES, i) / 1024.0f);
+
+                // 发送/接收包速率（packets/s）
+                one_net_msg->set_send_packets_rate(rate_.At(SND_PACKETS, i));
+                one_net_msg->set_rcv_packets_rate(rate_.At(RCV_PACKETS, i));
+
+                // 错误和丢包速率（个/秒）
+                one_net_msg->set_rcv_errors_rate(rate_.At(ERR_IN, i));
+                one_net_msg->set_send_errors_rate(rate_.At(ERR_OUT, i));
+                one_net_msg->set_rcv_drop_rate(rate_.At(DROP_IN, i));
+                one_net_msg->set_send_drop_rate(rate_.At(DROP_OUT, i));
             }
-            // 清空临时容器，准备读取下一行
-            net_datas.clear();
         }
+
+        // 更新历史数据：交换当前和上次采样（不拷贝数据）
+        prev_counters_.Swap(cur_counters_);
+        prev_names_.swap(cur_names_);
+        prev_ifindex_.swap(cur_ifindex_);
+        prev_time_ = now;
+        has_prev_ = true;
+
         // 函数返回，网络监控数据已成功采集并填充到monitor_info中
         return;
     }
@@ -0,0 +1,365 @@
+// 包含对应的头文件
+#include "monitor/process_monitor.h"
+
+// 系统调用头文件
+#include <dirent.h>          // opendir、readdir
+#include <fcntl.h>           // openat
+#include <sys/resource.h>    // getrlimit
+#include <unistd.h>          // pread、close、sysconf
+
+// C++标准库头文件
+#include <algorithm>         // std::push_heap、std::pop_heap、std::sort
+#include <charconv>          // std::from_chars、std::to_chars
+
+// 包含工具类头文件
+#include "utils/proc_parser.h"    // /proc零拷贝解析器
+
+namespace monitor
+{
+    /// @brief stat缓冲区的初始大小（/proc/[pid]/stat通常只有几百字节）
+    static constexpr size_t kInitialStatBuffer = 1024;
+
+    /**
+     * @brief /proc/[pid]/stat中")"之后的字段下标（从状态字段开始计数，即字段编号减3）
+     */
+    enum StatField
+    {
+        STAT_UTIME = 11,         ///< 字段14：用户态时间（时钟tick）
+        STAT_STIME = 12,         ///< 字段15：内核态时间（时钟tick）
+        STAT_NUM_THREADS = 17,   ///< 字段20：线程数
+        STAT_RSS = 21,           ///< 字段24：常驻内存（页）
+    };
+
+    ProcessMonitor::ProcessMonitor(size_t top_n, std::chrono::milliseconds rescan_period, const std::string& proc_root)
+        : top_n_(top_n), rescan_period_(rescan_period), proc_root_(proc_root),
+          stat_buffer_(kInitialStatBuffer)
+    {
+        proc_fd_ = ::open(proc_root_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        // 常驻fd最多占用软限制的一半，为其他监控器和RPC连接留出余量
+        struct rlimit limit;
+        fd_budget_ = 512;
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+        {
+            fd_budget_ = static_cast<size_t>(limit.rlim_cur / 2);
+        }
+
+        const long clock_ticks = ::sysconf(_SC_CLK_TCK);
+        ticks_per_second_ = clock_ticks > 0 ? static_cast<double>(clock_ticks) : 100.0;
+        const long page_size = ::sysconf(_SC_PAGESIZE);
+        page_kb_ = static_cast<uint64_t>(page_size > 0 ? page_size : 4096) / 1024;
+    }
+
+    ProcessMonitor::~ProcessMonitor()
+    {
+        for (auto& entry : processes_)
+        {
+            CloseFd(&entry.second);
+        }
+        if (proc_fd_ >= 0)
+        {
+            ::close(proc_fd_);
+        }
+    }
+
+    void ProcessMonitor::CloseFd(Process* process)
+    {
+        if (process->fd >= 0)
+        {
+            ::close(process->fd);
+            process->fd = -1;
+            --open_fds_;
+        }
+    }
+
+    /**
+     * @brief 重扫/proc目录的具体实现
+     *
+     * /proc只列出线程组（进程），不列出线程，线程再多也不增加列举的条目数。
+     * 新进程加入缓存并在本次采样中第一次读取；不在列表中的进程关闭fd后删除。
+     */
+    void ProcessMonitor::Rescan()
+    {
+        DIR* dir = ::opendir(proc_root_.c_str());
+        if (dir == nullptr)
+        {
+            return;
+        }
+        ++scan_serial_;
+        while (struct dirent* entry = ::readdir(dir))
+        {
+            const char* name = entry->d_name;
+            if (name[0] < '0' || name[0] > '9')
+            {
+                continue;
+            }
+            uint32_t pid = 0;
+            const char* end = name + std::char_traits<char>::length(name);
+            auto result = std::from_chars(name, end, pid);
+            if (result.ec != std::errc() || result.ptr != end)
+            {
+                continue;
+            }
+            Process& process = processes_[pid];
+            process.seen_scan = scan_serial_;
+        }
+        ::closedir(dir);
+
+        for (auto iter = processes_.begin(); iter != processes_.end();)
+        {
+            if (iter->second.seen_scan != scan_serial_)
+            {
+                CloseFd(&iter->second);
+                iter = processes_.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    /**
+     * @brief 读取stat的具体实现
+     * @param pid 进程号
+     * @param process 缓存项
+     * @return size_t 读取到的字节数
+     *
+     * 优先使用缓存的fd；fd预算用完时临时openat并在读取后关闭。
+     * 路径用栈上的缓冲区拼接，不分配内存。
+     */
+    size_t ProcessMonitor::ReadStat(uint32_t pid, Process* process)
+    {
+        if (proc_fd_ < 0)
+        {
+            return 0;
+        }
+
+        int fd = process->fd;
+        if (fd < 0)
+        {
+            char path[32];
+            char* end = std::to_chars(path, path + sizeof(path) - 6, pid).ptr;
+            std::char_traits<char>::copy(end, "/stat", 6);
+            fd = ::openat(proc_fd_, path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return 0;
+            }
+            if (open_fds_ < fd_budget_)
+            {
+                process->fd = fd;
+                ++open_fds_;
+            }
+        }
+
+        ssize_t size = 0;
+        while (true)
+        {
+            size = ::pread(fd, stat_buffer_.data(), stat_buffer_.size(), 0);
+            if (size < static_cast<ssize_t>(stat_buffer_.size()))
+            {
+                break;
+            }
+            stat_buffer_.resize(stat_buffer_.size() * 2);   // 内容可能被截断，扩容后重读
+        }
+        if (process->fd != fd)
+        {
+            ::close(fd);
+        }
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    /**
+     * @brief 读取并解析进程的具体实现
+     * @param pid 进程号
+     * @param process 缓存项
+     * @param now 本次采样时间
+     * @return bool 读取成功返回true
+     *
+     * /proc/[pid]/stat格式："pid (comm) state ppid ..."，comm可能包含空格和括号，
+     * 因此以最后一个")"为界：之前是comm，之后按空白分割为字段视图。
+     */
+    bool ProcessMonitor::ReadProcess(uint32_t pid, Process* process, std::chrono::steady_clock::time_point now)
+    {
+        const size_t size = ReadStat(pid, process);
+        if (size == 0)
+        {
+            return false;   // 进程已退出（或fd绑定的原进程已退出、pid被复用）
+        }
+        std::string_view content(stat_buffer_.data(), size);
+        if (content.back() == '\n')
+        {
+            content.remove_suffix(1);
+        }
+        const size_t open = content.find('(');
+        const size_t close = content.rfind(')');
+        if (open == std::string_view::npos || close == std::string_view::npos || close < open ||
+            ProcParser::SplitFields(content.substr(close + 1), &fields_) <= STAT_RSS)
+        {
+            return false;
+        }
+
+        // 第一次读取时或进程exec改名后重建标识
+        const std::string_view comm = content.substr(open + 1, close - open - 1);
+        if (process->name.size() <= comm.size() || process->name.compare(0, comm.size(), comm) != 0 ||
+            process->name[comm.size()] != '[')
+        {
+            process->name.assign(comm);
+            process->name += '[';
+            process->name += std::to_string(pid);
+            process->name += ']';
+        }
+
+        const uint64_t cpu_ticks = ProcParser::ToNumber<uint64_t>(fields_[STAT_UTIME]) +
+                                   ProcParser::ToNumber<uint64_t>(fields_[STAT_STIME]);
+        uint64_t delta = 0;
+        if (process->has_prev && cpu_ticks >= process->cpu_ticks)
+        {
+            delta = cpu_ticks - process->cpu_ticks;
+            const double seconds = std::chrono::duration<double>(now - process->read_time).count();
+            process->cpu_percent = seconds > 0
+                ? static_cast<float>(100.0 * static_cast<double>(delta) / ticks_per_second_ / seconds) : 0.0f;
+        }
+        process->cpu_ticks = cpu_ticks;
+        process->read_time = now;
+        process->rss_kb = ProcParser::ToNumber<uint64_t>(fields_[STAT_RSS]) * page_kb_;
+        process->threads = ProcParser::ToNumber<uint32_t>(fields_[STAT_NUM_THREADS]);
+
+        // 空闲退避：连续没有CPU增量时读取间隔翻倍，有增量时恢复每个tick读取；
+        // 达到最大间隔后按pid分配到固定的相位，同时启动的大量空闲进程不会在同一个tick集中读取
+        if (process->has_prev && delta == 0)
+        {
+            ++process->idle_streak;
+        }
+        else
+        {
+            process->idle_streak = 0;
+        }
+        const uint64_t skip = std::min<uint64_t>(uint64_t{1} << std::min<uint32_t>(process->idle_streak, 31),
+                                                 kMaxIdleSkip);
+        if (skip < kMaxIdleSkip)
+        {
+            process->next_read_tick = tick_ + skip;
+        }
+        else
+        {
+            const uint64_t phase = pid % kMaxIdleSkip;
+            process->next_read_tick = tick_ - tick_ % kMaxIdleSkip + phase;
+            if (process->next_read_tick <= tick_)
+            {
+                process->next_read_tick += kMaxIdleSkip;
+            }
+        }
+        process->has_prev = true;
+        return true;
+    }
+
+    /**
+     * @brief 有界堆选择的具体实现
+     * @param by_cpu true按CPU使用率，false按常驻内存
+     * @param selected 输出参数，选中的pid
+     *
+     * heap_是以key为序的最小堆，堆顶是当前入选者中最小的一个：
+     * 新候选只有大于堆顶时才替换堆顶，每个进程的代价为O(log N)。
+     * 按CPU排名时跳过CPU使用率为0的进程。
+     */
+    void ProcessMonitor::SelectTop(bool by_cpu, std::vector<uint32_t>* selected)
+    {
+        if (top_n_ == 0)
+        {
+            return;
+        }
+        auto greater = [](const Candidate& a, const Candidate& b) { return a.key > b.key; };
+        heap_.clear();
+        for (const auto& entry : processes_)
+        {
+            const Process& process = entry.second;
+            if (!process.has_prev)
+            {
+                continue;
+            }
+            const float key = by_cpu ? process.cpu_percent : static_cast<float>(process.rss_kb);
+            if (key <= 0)
+            {
+                continue;
+            }
+            if (heap_.size() < top_n_)
+            {
+                heap_.push_back(Candidate{key, entry.first});
+                std::push_heap(heap_.begin(), heap_.end(), greater);
+            }
+            else if (key > heap_.front().key)
+            {
+                std::pop_heap(heap_.begin(), heap_.end(), greater);
+                heap_.back() = Candidate{key, entry.first};
+                std::push_heap(heap_.begin(), heap_.end(), greater);
+            }
+        }
+
+        // 最小堆按greater排序后为降序
+        std::sort_heap(heap_.begin(), heap_.end(), greater);
+        for (const Candidate& candidate : heap_)
+        {
+            selected->push_back(candidate.pid);
+        }
+    }
+
+    /**
+     * @brief 更新进程监控信息的具体实现
+     * @param monitor_info 输出参数，指向要填充的监控信息Protobuf消息
+     *
+     * 详细执行流程：
+     * 1. 距上次重扫超过rescan_period时列举/proc目录，同步进程缓存
+     * 2. 读取本tick到期的进程（新进程、忙碌进程、退避到期的空闲进程），删除已退出的进程
+     * 3. 按CPU使用率、按常驻内存各选出前N个进程
+     * 4. 合并去重后填充process_info（CPU排名在前）
+     */
+    void ProcessMonitor::UpdateOnce(monitor::proto::MonitorInfo* monitor_info)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (!scanned_ || now - last_rescan_ >= rescan_period_)
+        {
+            Rescan();
+            last_rescan_ = now;
+            scanned_ = true;
+        }
+        ++tick_;
+
+        exited_.clear();
+        for (auto& entry : processes_)
+        {
+            if (entry.second.next_read_tick <= tick_ && !ReadProcess(entry.first, &entry.second, now))
+            {
+                exited_.push_back(entry.first);
+            }
+        }
+        for (uint32_t pid : exited_)
+        {
+            auto iter = processes_.find(pid);
+            CloseFd(&iter->second);
+            processes_.erase(iter);
+        }
+
+        selected_.clear();
+        SelectTop(true, &selected_);
+        const size_t by_cpu = selected_.size();
+        SelectTop(false, &selected_);
+
+        for (size_t i = 0; i < selected_.size(); ++i)
+        {
+            const uint32_t pid = selected_[i];
+            if (i >= by_cpu && std::find(selected_.begin(), selected_.begin() + by_cpu, pid) != selected_.begin() + by_cpu)
+            {
+                continue;   // 已经在CPU排名中
+            }
+            const Process& process = processes_.find(pid)->second;
+            auto* info = monitor_info->add_process_info();
+            info->set_name(process.name);
+            info->set_pid(pid);
+            info->set_cpu_percent(process.cpu_percent);
+            info->set_rss_kb(process.rss_kb);
+            info->set_threads(process.threads);
+        }
+    }
+}  // namespace monitor
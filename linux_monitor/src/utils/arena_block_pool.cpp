@@ -0,0 +1,75 @@
+// 包含对应的头文件
+#include "utils/arena_block_pool.h"
+
+// C++标准库头文件
+#include <mutex>        // 保护空闲链表
+#include <new>          // operator new/delete
+#include <vector>       // 空闲链表
+
+namespace monitor
+{
+    namespace
+    {
+        /**
+         * @brief 进程内唯一的空闲块链表
+         *
+         * 使用函数内静态对象：Arena可能在其他静态对象的析构过程中释放内存块。
+         */
+        struct FreeList
+        {
+            std::mutex mutex;             ///< 保护blocks
+            std::vector<void*> blocks;    ///< 空闲的kBlockSize内存块
+        };
+
+        FreeList& Blocks()
+        {
+            static FreeList* free_list = new FreeList();   // 有意不析构，避免静态析构顺序问题
+            return *free_list;
+        }
+    }  // namespace
+
+    google::protobuf::ArenaOptions ArenaBlockPool::Options()
+    {
+        google::protobuf::ArenaOptions options;
+        options.start_block_size = kBlockSize;
+        options.max_block_size = kBlockSize;
+        options.block_alloc = &ArenaBlockPool::Allocate;
+        options.block_dealloc = &ArenaBlockPool::Release;
+        return options;
+    }
+
+    size_t ArenaBlockPool::CachedBlocks()
+    {
+        FreeList& free_list = Blocks();
+        std::lock_guard<std::mutex> lock(free_list.mutex);
+        return free_list.blocks.size();
+    }
+
+    void* ArenaBlockPool::Allocate(size_t size)
+    {
+        if (size == kBlockSize)
+        {
+            FreeList& free_list = Blocks();
+            std::lock_guard<std::mutex> lock(free_list.mutex);
+            if (!free_list.blocks.empty())
+            {
+                void* block = free_list.blocks.back();
+                free_list.blocks.pop_back();
+                return block;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void ArenaBlockPool::Release(void* block, size_t size)
+    {
+        if (size == kBlockSize)
+        {
+            FreeList& free_list = Blocks();
+            std::lock_guard<std::mutex> lock(free_list.mutex);
+            free_list.blocks.push_back(block);
+            return;
+        }
+        ::operator delete(block);
+    }
+}  // namespace monitor
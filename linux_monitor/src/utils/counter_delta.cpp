@@ -0,0 +1,297 @@
+// 包含对应的头文件
+#include "utils/counter_delta.h"
+
+// C++标准库头文件
+#include <atomic>       // 当前内核实现指针
+
+// SIMD指令集头文件
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>  // SSE4.2、AVX2
+#define MONITOR_COUNTER_DELTA_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>   // NEON
+#define MONITOR_COUNTER_DELTA_NEON 1
+#endif
+
+namespace monitor
+{
+    namespace
+    {
+        /// @brief 统一缩放系数的内核函数类型
+        using UniformKernel = void (*)(const uint64_t*, const uint64_t*, size_t, double, float*);
+
+        /// @brief 逐元素缩放系数的内核函数类型
+        using ScaledKernel = void (*)(const uint64_t*, const uint64_t*, size_t, const double*, float*);
+
+        /**
+         * @brief 一组内核实现
+         */
+        struct Kernels
+        {
+            CounterDelta::Isa isa;     ///< 实现类型
+            UniformKernel uniform;     ///< 统一缩放系数版本
+            ScaledKernel scaled;       ///< 逐元素缩放系数版本
+        };
+
+        /**
+         * @brief 单个计数器的差值（计数器回退时为0）
+         */
+        inline double SaturatedDelta(uint64_t cur, uint64_t prev)
+        {
+            return cur > prev ? static_cast<double>(cur - prev) : 0.0;
+        }
+
+        // ==================== 标量实现 ====================
+        // 也用于SIMD实现处理不足一个向量的尾部元素
+
+        void UniformScalar(const uint64_t* cur, const uint64_t* prev, size_t n,
+            double scale, float* out)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                out[i] = static_cast<float>(SaturatedDelta(cur[i], prev[i]) * scale);
+            }
+        }
+
+        void ScaledScalar(const uint64_t* cur, const uint64_t* prev, size_t n,
+            const double* scale, float* out)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                out[i] = static_cast<float>(SaturatedDelta(cur[i], prev[i]) * scale[i]);
+            }
+        }
+
+        constexpr Kernels kScalarKernels{CounterDelta::Isa::SCALAR, UniformScalar, ScaledScalar};
+
+#if defined(MONITOR_COUNTER_DELTA_X86)
+        // ==================== x86实现 ====================
+        // x86在AVX-512DQ之前没有uint64→double的转换指令，也没有无符号64位比较：
+        // - 无符号比较：两边异或符号位后用有符号比较
+        // - uint64→double：高低32位分别拼接到2^84和2^52的尾数中，相减后相加，结果精确舍入
+
+        /**
+         * @brief AVX2：4个计数器的饱和差值，转换为double
+         */
+        __attribute__((target("avx2"))) inline __m256d Delta4(const uint64_t* cur, const uint64_t* prev)
+        {
+            const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+            __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev));
+            __m256i gt = _mm256_cmpgt_epi64(_mm256_xor_si256(c, sign), _mm256_xor_si256(p, sign));
+            __m256i diff = _mm256_and_si256(_mm256_sub_epi64(c, p), gt);
+
+            __m256i lo = _mm256_blend_epi32(diff, _mm256_castpd_si256(_mm256_set1_pd(0x1p52)), 0xAA);
+            __m256i hi = _mm256_or_si256(_mm256_srli_epi64(diff, 32),
+                _mm256_castpd_si256(_mm256_set1_pd(0x1p84)));
+            __m256d hi_d = _mm256_sub_pd(_mm256_castsi256_pd(hi), _mm256_set1_pd(0x1p84 + 0x1p52));
+            return _mm256_add_pd(hi_d, _mm256_castsi256_pd(lo));
+        }
+
+        __attribute__((target("avx2"))) void UniformAvx2(const uint64_t* cur, const uint64_t* prev,
+            size_t n, double scale, float* out)
+        {
+            const __m256d s = _mm256_set1_pd(scale);
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256d rate = _mm256_mul_pd(Delta4(cur + i, prev + i), s);
+                _mm_storeu_ps(out + i, _mm256_cvtpd_ps(rate));
+            }
+            UniformScalar(cur + i, prev + i, n - i, scale, out + i);
+        }
+
+        __attribute__((target("avx2"))) void ScaledAvx2(const uint64_t* cur, const uint64_t* prev,
+            size_t n, const double* scale, float* out)
+        {
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256d rate = _mm256_mul_pd(Delta4(cur + i, prev + i), _mm256_loadu_pd(scale + i));
+                _mm_storeu_ps(out + i, _mm256_cvtpd_ps(rate));
+            }
+            ScaledScalar(cur + i, prev + i, n - i, scale + i, out + i);
+        }
+
+        /**
+         * @brief SSE4.2：2个计数器的饱和差值，转换为double
+         */
+        __attribute__((target("sse4.2"))) inline __m128d Delta2(const uint64_t* cur, const uint64_t* prev)
+        {
+            const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev));
+            __m128i gt = _mm_cmpgt_epi64(_mm_xor_si128(c, sign), _mm_xor_si128(p, sign));
+            __m128i diff = _mm_and_si128(_mm_sub_epi64(c, p), gt);
+
+            __m128i lo = _mm_blend_epi16(diff, _mm_castpd_si128(_mm_set1_pd(0x1p52)), 0xCC);
+            __m128i hi = _mm_or_si128(_mm_srli_epi64(diff, 32), _mm_castpd_si128(_mm_set1_pd(0x1p84)));
+            __m128d hi_d = _mm_sub_pd(_mm_castsi128_pd(hi), _mm_set1_pd(0x1p84 + 0x1p52));
+            return _mm_add_pd(hi_d, _mm_castsi128_pd(lo));
+        }
+
+        __attribute__((target("sse4.2"))) void UniformSse4(const uint64_t* cur, const uint64_t* prev,
+            size_t n, double scale, float* out)
+        {
+            const __m128d s = _mm_set1_pd(scale);
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                __m128d rate = _mm_mul_pd(Delta2(cur + i, prev + i), s);
+                _mm_storel_pi(reinterpret_cast<__m64*>(out + i), _mm_cvtpd_ps(rate));
+            }
+            UniformScalar(cur + i, prev + i, n - i, scale, out + i);
+        }
+
+        __attribute__((target("sse4.2"))) void ScaledSse4(const uint64_t* cur, const uint64_t* prev,
+            size_t n, const double* scale, float* out)
+        {
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                __m128d rate = _mm_mul_pd(Delta2(cur + i, prev + i), _mm_loadu_pd(scale + i));
+                _mm_storel_pi(reinterpret_cast<__m64*>(out + i), _mm_cvtpd_ps(rate));
+            }
+            ScaledScalar(cur + i, prev + i, n - i, scale + i, out + i);
+        }
+
+        constexpr Kernels kSse4Kernels{CounterDelta::Isa::SSE4, UniformSse4, ScaledSse4};
+        constexpr Kernels kAvx2Kernels{CounterDelta::Isa::AVX2, UniformAvx2, ScaledAvx2};
+#endif  // MONITOR_COUNTER_DELTA_X86
+
+#if defined(MONITOR_COUNTER_DELTA_NEON)
+        // ==================== ARM64 NEON实现 ====================
+        // ARMv8有无符号64位比较和uint64→double转换指令，直接使用
+
+        inline float64x2_t Delta2(const uint64_t* cur, const uint64_t* prev)
+        {
+            uint64x2_t c = vld1q_u64(cur);
+            uint64x2_t p = vld1q_u64(prev);
+            uint64x2_t diff = vandq_u64(vsubq_u64(c, p), vcgtq_u64(c, p));
+            return vcvtq_f64_u64(diff);
+        }
+
+        void UniformNeon(const uint64_t* cur, const uint64_t* prev, size_t n, double scale, float* out)
+        {
+            const float64x2_t s = vdupq_n_f64(scale);
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                vst1_f32(out + i, vcvt_f32_f64(vmulq_f64(Delta2(cur + i, prev + i), s)));
+            }
+            UniformScalar(cur + i, prev + i, n - i, scale, out + i);
+        }
+
+        void ScaledNeon(const uint64_t* cur, const uint64_t* prev, size_t n, const double* scale,
+            float* out)
+        {
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                vst1_f32(out + i, vcvt_f32_f64(vmulq_f64(Delta2(cur + i, prev + i), vld1q_f64(scale + i))));
+            }
+            ScaledScalar(cur + i, prev + i, n - i, scale + i, out + i);
+        }
+
+        constexpr Kernels kNeonKernels{CounterDelta::Isa::NEON, UniformNeon, ScaledNeon};
+#endif  // MONITOR_COUNTER_DELTA_NEON
+
+        /**
+         * @brief 查找当前CPU支持的指定内核实现
+         * @param isa 内核实现类型
+         * @return const Kernels* 不支持时返回nullptr
+         */
+        const Kernels* FindKernels(CounterDelta::Isa isa)
+        {
+            switch (isa)
+            {
+            case CounterDelta::Isa::SCALAR:
+                return &kScalarKernels;
+#if defined(MONITOR_COUNTER_DELTA_X86)
+            case CounterDelta::Isa::SSE4:
+                return __builtin_cpu_supports("sse4.2") ? &kSse4Kernels : nullptr;
+            case CounterDelta::Isa::AVX2:
+                return __builtin_cpu_supports("avx2") ? &kAvx2Kernels : nullptr;
+#endif
+#if defined(MONITOR_COUNTER_DELTA_NEON)
+            case CounterDelta::Isa::NEON:
+                return &kNeonKernels;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        /**
+         * @brief 检测当前CPU支持的最优内核实现
+         */
+        const Kernels* DetectKernels()
+        {
+#if defined(MONITOR_COUNTER_DELTA_X86)
+            __builtin_cpu_init();  // 可能在其他静态对象的构造过程中被调用，先确保CPU特性已初始化
+#endif
+            for (CounterDelta::Isa isa : {CounterDelta::Isa::AVX2, CounterDelta::Isa::NEON,
+                     CounterDelta::Isa::SSE4})
+            {
+                if (const Kernels* kernels = FindKernels(isa))
+                {
+                    return kernels;
+                }
+            }
+            return &kScalarKernels;
+        }
+
+        /**
+         * @brief 当前使用的内核实现（第一次调用时检测）
+         */
+        std::atomic<const Kernels*>& ActiveKernels()
+        {
+            static std::atomic<const Kernels*> active{DetectKernels()};
+            return active;
+        }
+    }  // namespace
+
+    void CounterDelta::Rates(const uint64_t* cur, const uint64_t* prev, size_t n,
+        double scale, float* out)
+    {
+        ActiveKernels().load(std::memory_order_relaxed)->uniform(cur, prev, n, scale, out);
+    }
+
+    void CounterDelta::Rates(const uint64_t* cur, const uint64_t* prev, size_t n,
+        const double* scale, float* out)
+    {
+        ActiveKernels().load(std::memory_order_relaxed)->scaled(cur, prev, n, scale, out);
+    }
+
+    CounterDelta::Isa CounterDelta::ActiveIsa()
+    {
+        return ActiveKernels().load(std::memory_order_relaxed)->isa;
+    }
+
+    const char* CounterDelta::IsaName(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::SCALAR:
+            return "scalar";
+        case Isa::SSE4:
+            return "sse4.2";
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::NEON:
+            return "neon";
+        }
+        return "unknown";
+    }
+
+    bool CounterDelta::ForceIsa(Isa isa)
+    {
+        const Kernels* kernels = FindKernels(isa);
+        if (kernels == nullptr)
+        {
+            return false;
+        }
+        ActiveKernels().store(kernels, std::memory_order_relaxed);
+        return true;
+    }
+}  // namespace monitor
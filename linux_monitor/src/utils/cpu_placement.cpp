@@ -0,0 +1,441 @@
+// 包含对应的头文件
+#include "utils/cpu_placement.h"
+
+// 系统调用头文件
+#include <dirent.h>             // opendir、readdir
+#include <linux/mempolicy.h>    // MPOL_BIND
+#include <sched.h>              // sched_setaffinity、sched_setscheduler、SCHED_IDLE
+#include <sys/resource.h>       // setpriority
+#include <sys/syscall.h>        // SYS_set_mempolicy、SYS_migrate_pages
+#include <unistd.h>             // syscall
+
+// C++标准库头文件
+#include <algorithm>            // std::sort、std::unique、std::binary_search
+#include <cerrno>               // errno
+#include <cstring>              // std::strerror
+#include <fstream>              // 读取/proc、/sys文件
+#include <iterator>             // std::back_inserter
+#include <map>                  // 节点到CPU的映射
+
+// 包含工具类头文件
+#include "utils/proc_parser.h"  // SplitFields、ToNumber
+
+namespace monitor
+{
+    /// @brief 独占核心列表：isolcpus=和nohz_full=启动参数
+    static const char* const kIsolatedFiles[] = {"/sys/devices/system/cpu/isolated",
+                                                 "/sys/devices/system/cpu/nohz_full"};
+
+    /// @brief NUMA节点目录
+    static const char kNodeDir[] = "/sys/devices/system/node";
+
+    /// @brief 内存策略节点掩码的位数（与libnuma相同，支持1024个节点）
+    static constexpr size_t kMaskBits = 1024;
+
+    /// @brief /proc/<pid>/stat中comm之后的字段下标：processor是第39个字段，state是第3个
+    static constexpr size_t kStatProcessor = 39 - 3;
+
+    /**
+     * @brief 列举/sys/devices/system/node下的节点
+     * @return std::map<int, std::vector<int>> 节点编号到该节点CPU列表的映射
+     */
+    static std::map<int, std::vector<int>> NodeCpus()
+    {
+        std::map<int, std::vector<int>> nodes;
+        DIR* dir = ::opendir(kNodeDir);
+        if (dir == nullptr)
+        {
+            return nodes;
+        }
+        while (struct dirent* entry = ::readdir(dir))
+        {
+            const std::string_view name(entry->d_name);
+            if (name.size() <= 4 || name.substr(0, 4) != "node" ||
+                name.find_first_not_of("0123456789", 4) != std::string_view::npos)
+            {
+                continue;
+            }
+            std::ifstream file(std::string(kNodeDir) + "/" + entry->d_name + "/cpulist");
+            std::string line;
+            std::getline(file, line);
+            std::vector<int> cpus;
+            if (CpuPlacement::ParseCpuList(line, &cpus))
+            {
+                nodes[ProcParser::ToNumber<int>(name.substr(4))] = std::move(cpus);
+            }
+        }
+        ::closedir(dir);
+        return nodes;
+    }
+
+    /**
+     * @brief 列举本进程的所有线程
+     * @return std::vector<pid_t> 线程id
+     */
+    static std::vector<pid_t> ThreadIds()
+    {
+        std::vector<pid_t> tids;
+        DIR* dir = ::opendir("/proc/self/task");
+        if (dir == nullptr)
+        {
+            return tids;
+        }
+        while (struct dirent* entry = ::readdir(dir))
+        {
+            if (entry->d_name[0] >= '0' && entry->d_name[0] <= '9')
+            {
+                tids.push_back(ProcParser::ToNumber<pid_t>(entry->d_name));
+            }
+        }
+        ::closedir(dir);
+        return tids;
+    }
+
+    /**
+     * @brief 解析CPU列表的具体实现
+     *
+     * 格式为逗号分隔的编号或闭区间，如"0-3,8,10-11"，与/sys下的cpulist和isolcpus=相同。
+     */
+    bool CpuPlacement::ParseCpuList(std::string_view text, std::vector<int>* cpus)
+    {
+        cpus->clear();
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' '))
+        {
+            text.remove_suffix(1);
+        }
+
+        while (!text.empty())
+        {
+            const size_t comma = text.find(',');
+            const std::string_view range = text.substr(0, comma);
+            text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+            const size_t dash = range.find('-');
+            const std::string_view first = range.substr(0, dash);
+            const std::string_view last = dash == std::string_view::npos ? first : range.substr(dash + 1);
+            if (first.empty() || last.empty() ||
+                first.find_first_not_of("0123456789") != std::string_view::npos ||
+                last.find_first_not_of("0123456789") != std::string_view::npos)
+            {
+                cpus->clear();
+                return false;
+            }
+            const int begin = ProcParser::ToNumber<int>(first);
+            const int end = ProcParser::ToNumber<int>(last);
+            if (begin > end || end >= CPU_SETSIZE)
+            {
+                cpus->clear();
+                return false;
+            }
+            for (int cpu = begin; cpu <= end; ++cpu)
+            {
+                cpus->push_back(cpu);
+            }
+        }
+
+        std::sort(cpus->begin(), cpus->end());
+        cpus->erase(std::unique(cpus->begin(), cpus->end()), cpus->end());
+        return true;
+    }
+
+    std::string CpuPlacement::FormatCpuList(const std::vector<int>& cpus)
+    {
+        std::string text;
+        for (size_t i = 0; i < cpus.size();)
+        {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            {
+                ++j;
+            }
+            if (!text.empty())
+            {
+                text += ',';
+            }
+            text += std::to_string(cpus[i]);
+            if (j > i)
+            {
+                text += '-';
+                text += std::to_string(cpus[j]);
+            }
+            i = j + 1;
+        }
+        return text;
+    }
+
+    std::vector<int> CpuPlacement::ReadCpuList(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> cpus;
+        ParseCpuList(line, &cpus);   // 格式错误时为空
+        return cpus;
+    }
+
+    /**
+     * @brief 应用放置配置的具体实现
+     *
+     * 详细执行流程：
+     * 1. 确定候选CPU：auto取当前亲和性（容器的cpuset已经体现在其中），否则解析CPU列表
+     * 2. 去掉isolcpus和nohz_full中的独占核心
+     * 3. auto模式只保留候选CPU最多的NUMA节点（相同时取编号小的）；显式列表跨节点时绑定到所有涉及的节点
+     * 4. 设置所有线程的亲和性和调度策略，多节点主机上绑定内存策略
+     */
+    bool CpuPlacement::Apply(const Config& config, std::string* error)
+    {
+        cpus_.clear();
+        nodes_.clear();
+        warning_.clear();
+
+        if (!config.cpuset.empty())
+        {
+            std::vector<int> candidates;
+            if (config.cpuset == "auto")
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                if (::sched_getaffinity(0, sizeof(set), &set) != 0)
+                {
+                    *error = std::string("获取CPU亲和性失败: ") + std::strerror(errno);
+                    return false;
+                }
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                {
+                    if (CPU_ISSET(cpu, &set))
+                    {
+                        candidates.push_back(cpu);
+                    }
+                }
+            }
+            else if (!ParseCpuList(config.cpuset, &candidates) || candidates.empty())
+            {
+                *error = "无法解析CPU列表: " + config.cpuset;
+                return false;
+            }
+
+            std::vector<int> isolated;
+            for (const char* path : kIsolatedFiles)
+            {
+                const std::vector<int> cpus = ReadCpuList(path);
+                isolated.insert(isolated.end(), cpus.begin(), cpus.end());
+            }
+            std::sort(isolated.begin(), isolated.end());
+            for (int cpu : candidates)
+            {
+                if (!std::binary_search(isolated.begin(), isolated.end(), cpu))
+                {
+                    cpus_.push_back(cpu);
+                }
+            }
+            if (cpus_.empty())
+            {
+                *error = "去掉独占核心（" + FormatCpuList(isolated) + "）后没有可用的CPU";
+                return false;
+            }
+
+            const std::map<int, std::vector<int>> node_cpus = NodeCpus();
+            if (node_cpus.size() > 1)
+            {
+                int best_node = -1;
+                size_t best_count = 0;
+                for (const auto& [node, cpus] : node_cpus)
+                {
+                    const size_t count = static_cast<size_t>(std::count_if(cpus.begin(), cpus.end(), [&](int cpu) {
+                        return std::binary_search(cpus_.begin(), cpus_.end(), cpu);
+                    }));
+                    if (count == 0)
+                    {
+                        continue;
+                    }
+                    nodes_.push_back(node);
+                    if (count > best_count)
+                    {
+                        best_node = node;
+                        best_count = count;
+                    }
+                }
+                if (config.cpuset == "auto" && best_node >= 0)
+                {
+                    const std::vector<int>& local = node_cpus.at(best_node);
+                    std::vector<int> kept;
+                    std::set_intersection(cpus_.begin(), cpus_.end(), local.begin(), local.end(),
+                                          std::back_inserter(kept));
+                    cpus_.swap(kept);
+                    nodes_.assign(1, best_node);
+                }
+            }
+        }
+
+        if (!ApplyThreads(config, error))
+        {
+            return false;
+        }
+        return nodes_.empty() || BindMemory(error);
+    }
+
+    /**
+     * @brief 设置线程属性的具体实现
+     *
+     * 亲和性、调度策略和nice在Linux上都是每个线程独立的属性，对/proc/self/task中的
+     * 每个线程分别设置；此后创建的线程从创建者继承。
+     */
+    bool CpuPlacement::ApplyThreads(const Config& config, std::string* error) const
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus_)
+        {
+            CPU_SET(cpu, &set);
+        }
+
+        for (pid_t tid : ThreadIds())
+        {
+            if (!cpus_.empty() && ::sched_setaffinity(tid, sizeof(set), &set) != 0)
+            {
+                const int saved_errno = errno;   // 格式化CPU列表时可能改写errno
+                *error = "设置CPU亲和性（" + FormatCpuList(cpus_) + "）失败: " + std::strerror(saved_errno);
+                return false;
+            }
+            if (config.sched_idle)
+            {
+                struct sched_param param = {};
+                if (::sched_setscheduler(tid, SCHED_IDLE, &param) != 0)
+                {
+                    *error = std::string("设置SCHED_IDLE失败: ") + std::strerror(errno);
+                    return false;
+                }
+            }
+            if (config.nice != 0 && ::setpriority(PRIO_PROCESS, static_cast<id_t>(tid), config.nice) != 0)
+            {
+                *error = "设置nice值" + std::to_string(config.nice) + "失败: " + std::strerror(errno);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 绑定内存策略的具体实现
+     *
+     * set_mempolicy只作用于调用线程及其之后创建的线程，因此Apply要在创建线程之前调用。
+     * migrate_pages尽力把启动阶段已经分配在其他节点上的页面迁移过来，失败不影响绑定，
+     * 只记录到warning_。源节点掩码只包含存在的节点：内核拒绝含有不存在节点的掩码。
+     */
+    bool CpuPlacement::BindMemory(std::string* error)
+    {
+        unsigned long local[kMaskBits / (8 * sizeof(unsigned long))] = {};
+        unsigned long remote[kMaskBits / (8 * sizeof(unsigned long))] = {};
+        constexpr size_t kWordBits = 8 * sizeof(unsigned long);
+        for (int node : nodes_)
+        {
+            local[node / kWordBits] |= 1UL << (node % kWordBits);
+        }
+        bool has_remote = false;
+        for (const auto& entry : NodeCpus())
+        {
+            const int node = entry.first;
+            if (node >= 0 && static_cast<size_t>(node) < kMaskBits &&
+                !std::binary_search(nodes_.begin(), nodes_.end(), node))
+            {
+                remote[node / kWordBits] |= 1UL << (node % kWordBits);
+                has_remote = true;
+            }
+        }
+
+        if (::syscall(SYS_set_mempolicy, MPOL_BIND, local, kMaskBits) != 0)
+        {
+            *error = std::string("绑定NUMA内存策略失败: ") + std::strerror(errno);
+            return false;
+        }
+        if (!has_remote)
+        {
+            return true;
+        }
+        const long unmoved = ::syscall(SYS_migrate_pages, 0, kMaskBits, remote, local);
+        if (unmoved < 0)
+        {
+            const int saved_errno = errno;   // 格式化节点列表时可能改写errno
+            warning_ = "迁移已有页面到NUMA节点" + FormatCpuList(nodes_) + "失败: " + std::strerror(saved_errno);
+        }
+        else if (unmoved > 0)
+        {
+            warning_ = std::to_string(unmoved) + "个已有页面未能迁移到NUMA节点" + FormatCpuList(nodes_);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 统计亲和性之外的线程的具体实现
+     *
+     * processor字段是线程最近一次运行的CPU；comm可能包含空格和括号，从最后一个')'之后开始分割。
+     */
+    uint64_t CpuPlacement::ThreadsOutside(const std::vector<int>& cpus)
+    {
+        uint64_t outside = 0;
+        std::vector<std::string_view> fields;
+        for (pid_t tid : ThreadIds())
+        {
+            std::ifstream file("/proc/self/task/" + std::to_string(tid) + "/stat");
+            std::string line;
+            if (!std::getline(file, line))
+            {
+                continue;   // 线程已退出
+            }
+            const size_t paren = line.rfind(')');
+            if (paren == std::string::npos ||
+                ProcParser::SplitFields(std::string_view(line).substr(paren + 1), &fields) <= kStatProcessor)
+            {
+                continue;
+            }
+            if (!std::binary_search(cpus.begin(), cpus.end(), ProcParser::ToNumber<int>(fields[kStatProcessor])))
+            {
+                ++outside;
+            }
+        }
+        return outside;
+    }
+
+    /**
+     * @brief 统计远端节点内存的具体实现
+     *
+     * numa_maps每个映射一行，N<节点>=<页数>给出该映射在各节点上的页面，
+     * kernelpagesize_kB给出页面大小（大页映射不是4KB）。
+     */
+    uint64_t CpuPlacement::RemoteNodeKb(const std::vector<int>& nodes)
+    {
+        std::ifstream file("/proc/self/numa_maps");
+        std::string line;
+        std::vector<std::string_view> fields;
+        uint64_t remote_kb = 0;
+        while (std::getline(file, line))
+        {
+            uint64_t remote_pages = 0;
+            uint64_t page_kb = 4;
+            ProcParser::SplitFields(line, &fields);
+            for (std::string_view field : fields)
+            {
+                const size_t equal = field.find('=');
+                if (equal == std::string_view::npos)
+                {
+                    continue;
+                }
+                const std::string_view key = field.substr(0, equal);
+                const std::string_view value = field.substr(equal + 1);
+                if (key.size() > 1 && key[0] == 'N' && key.find_first_not_of("0123456789", 1) == std::string_view::npos)
+                {
+                    if (!std::binary_search(nodes.begin(), nodes.end(), ProcParser::ToNumber<int>(key.substr(1))))
+                    {
+                        remote_pages += ProcParser::ToNumber<uint64_t>(value);
+                    }
+                }
+                else if (key == "kernelpagesize_kB")
+                {
+                    page_kb = ProcParser::ToNumber<uint64_t>(value);
+                }
+            }
+            remote_kb += remote_pages * page_kb;
+        }
+        return remote_kb;
+    }
+}  // namespace monitor
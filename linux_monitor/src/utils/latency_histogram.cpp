@@ -0,0 +1,66 @@
+// 包含对应的头文件
+#include "utils/latency_histogram.h"
+
+// C++标准库头文件
+#include <cmath>        // std::ceil
+
+namespace monitor
+{
+    uint64_t LatencyHistogram::UpperBound(size_t bucket)
+    {
+        if (bucket < kSubBuckets)
+        {
+            return bucket;
+        }
+        const uint64_t shift = (bucket - kSubBuckets) / kSubBuckets;
+        const uint64_t sub = (bucket - kSubBuckets) % kSubBuckets;
+        return ((kSubBuckets + sub + 1) << shift) - 1;
+    }
+
+    /**
+     * @brief 计算分位数的具体实现
+     * @param quantile 分位
+     * @return uint64_t 分位数
+     *
+     * 按桶顺序累加计数，找到累计次数首次达到ceil(quantile × count)的桶；
+     * 返回桶上界（偏保守），并以精确的最大值封顶。
+     */
+    uint64_t LatencyHistogram::Percentile(double quantile) const
+    {
+        if (count_ == 0)
+        {
+            return 0;
+        }
+        quantile = std::min(std::max(quantile, 0.0), 1.0);
+        const uint64_t rank = std::max<uint64_t>(
+            static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count_))), 1);
+
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < kBuckets; ++bucket)
+        {
+            seen += counts_[bucket];
+            if (seen >= rank)
+            {
+                return std::min(UpperBound(bucket), max_);
+            }
+        }
+        return max_;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        counts_.fill(0);
+        count_ = 0;
+        max_ = 0;
+    }
+
+    void LatencyHistogram::Merge(const LatencyHistogram& other)
+    {
+        for (size_t bucket = 0; bucket < kBuckets; ++bucket)
+        {
+            counts_[bucket] += other.counts_[bucket];
+        }
+        count_ += other.count_;
+        max_ = std::max(max_, other.max_);
+    }
+}  // namespace monitor
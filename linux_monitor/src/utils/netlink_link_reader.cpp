@@ -0,0 +1,353 @@
+// 包含对应的头文件
+#include "utils/netlink_link_reader.h"
+
+// 系统调用头文件
+#include <linux/if_link.h>      // rtnl_link_stats64、if_stats_msg、IFLA_*
+#include <linux/netlink.h>      // nlmsghdr、NLMSG_*宏
+#include <linux/rtnetlink.h>    // RTM_*、ifinfomsg、RTA_*宏
+#include <sys/socket.h>         // socket、bind、sendto、recv
+#include <sys/time.h>           // timeval
+#include <unistd.h>             // close
+
+// C++标准库头文件
+#include <algorithm>            // std::min
+#include <cerrno>               // errno
+#include <cstring>              // std::memcpy、strnlen
+
+namespace monitor
+{
+    /// @brief 每次recv预留的空间：内核按不超过32KB的块发送转储回复
+    static constexpr size_t kRecvChunk = 32768;
+
+    /**
+     * @brief 把rtnl_link_stats64换算为与/proc/net/dev一致的计数
+     * @param attr IFLA_STATS64或IFLA_STATS_LINK_64属性
+     * @param link 输出参数
+     *
+     * 新内核在结构体尾部追加字段，旧内核的属性可能比头文件中的结构体短，
+     * 只拷贝属性中实际存在的部分；这里用到的字段在所有版本中都存在。
+     */
+    static void FillCounters(const struct rtattr* attr, NetlinkLinkReader::Link* link)
+    {
+        struct rtnl_link_stats64 stats = {};
+        std::memcpy(&stats, RTA_DATA(attr), std::min<size_t>(RTA_PAYLOAD(attr), sizeof(stats)));
+        link->rx_bytes = stats.rx_bytes;
+        link->rx_packets = stats.rx_packets;
+        link->rx_errors = stats.rx_errors;
+        link->rx_dropped = stats.rx_dropped + stats.rx_missed_errors;   // 与/proc/net/dev的drop列相同
+        link->tx_bytes = stats.tx_bytes;
+        link->tx_packets = stats.tx_packets;
+        link->tx_errors = stats.tx_errors;
+        link->tx_dropped = stats.tx_dropped;
+    }
+
+    NetlinkLinkReader::~NetlinkLinkReader()
+    {
+        Close();
+    }
+
+    void NetlinkLinkReader::Close()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        if (events_fd_ >= 0)
+        {
+            ::close(events_fd_);
+            events_fd_ = -1;
+        }
+        names_dirty_ = true;   // 通知套接字关闭期间可能漏掉接口变化
+    }
+
+    /**
+     * @brief 打开套接字的具体实现
+     * @return bool 成功返回true
+     *
+     * 请求套接字设置1秒的接收超时，内核回复异常时不会卡住采集线程；
+     * 通知套接字以非阻塞方式加入RTMGRP_LINK组播组（不需要特权）。
+     */
+    bool NetlinkLinkReader::Open()
+    {
+        if (fd_ >= 0)
+        {
+            return true;
+        }
+
+        fd_ = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+        struct timeval timeout = {1, 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        events_fd_ = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+        struct sockaddr_nl local = {};
+        local.nl_family = AF_NETLINK;
+        local.nl_groups = RTMGRP_LINK;
+        if (events_fd_ < 0 || ::bind(events_fd_, reinterpret_cast<struct sockaddr*>(&local), sizeof(local)) != 0)
+        {
+            Close();
+            return false;
+        }
+        names_dirty_ = true;
+        return true;
+    }
+
+    /**
+     * @brief 转储的具体实现
+     * @param type 请求类型
+     * @return int 成功返回0，内核拒绝返回错误码，收发失败返回-1
+     *
+     * 每个recv读到一个数据报（一批完整的消息），直接追加到buffer_末尾；
+     * 带MSG_TRUNC的recv返回数据报的实际长度，超出预留空间说明被截断，视为失败。
+     * 序号不匹配的消息（上一次超时的请求迟到的回复）留在缓冲区中，NextLink会跳过。
+     */
+    int NetlinkLinkReader::Dump(uint16_t type)
+    {
+        struct
+        {
+            struct nlmsghdr header;
+            union
+            {
+                struct ifinfomsg link;
+                struct if_stats_msg stats;
+            };
+        } request = {};
+        const size_t payload = type == RTM_GETSTATS ? sizeof(request.stats) : sizeof(request.link);
+        request.header.nlmsg_len = NLMSG_LENGTH(payload);
+        request.header.nlmsg_type = type;
+        request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+        request.header.nlmsg_seq = ++seq_;
+        if (type == RTM_GETSTATS)
+        {
+            request.stats.family = AF_UNSPEC;
+            request.stats.filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64);   // 只要64位计数
+        }
+        else
+        {
+            request.link.ifi_family = AF_UNSPEC;
+        }
+
+        struct sockaddr_nl kernel = {};
+        kernel.nl_family = AF_NETLINK;
+        if (::sendto(fd_, &request, request.header.nlmsg_len, 0,
+                     reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) !=
+            static_cast<ssize_t>(request.header.nlmsg_len))
+        {
+            return -1;
+        }
+
+        size_ = 0;
+        offset_ = 0;
+        while (true)
+        {
+            if (buffer_.size() < size_ + kRecvChunk)
+            {
+                buffer_.resize(size_ + kRecvChunk);
+            }
+            const ssize_t received = ::recv(fd_, buffer_.data() + size_, kRecvChunk, MSG_TRUNC);
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (received <= 0 || static_cast<size_t>(received) > kRecvChunk)
+            {
+                size_ = 0;
+                return -1;
+            }
+
+            bool done = false;
+            int length = static_cast<int>(received);
+            for (auto* header = reinterpret_cast<struct nlmsghdr*>(buffer_.data() + size_);
+                 NLMSG_OK(header, length); header = NLMSG_NEXT(header, length))
+            {
+                if (header->nlmsg_seq != seq_)
+                {
+                    continue;
+                }
+                if (header->nlmsg_type == NLMSG_DONE)
+                {
+                    done = true;
+                }
+                else if (header->nlmsg_type == NLMSG_ERROR)
+                {
+                    const auto* error = static_cast<const struct nlmsgerr*>(NLMSG_DATA(header));
+                    size_ = 0;
+                    return error->error != 0 ? -error->error : -1;
+                }
+            }
+            size_ += static_cast<size_t>(received);
+            if (done)
+            {
+                return 0;
+            }
+        }
+    }
+
+    void NetlinkLinkReader::DrainEvents()
+    {
+        char discard[8192];   // 只关心有没有通知，不解析内容
+        while (true)
+        {
+            const ssize_t received = ::recv(events_fd_, discard, sizeof(discard), MSG_DONTWAIT);
+            if (received > 0)
+            {
+                names_dirty_ = true;
+            }
+            else if (received < 0 && errno == ENOBUFS)
+            {
+                names_dirty_ = true;   // 通知队列溢出，丢失的通知中可能有接口变化
+            }
+            else if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else
+            {
+                return;   // EAGAIN：已读空
+            }
+        }
+    }
+
+    bool NetlinkLinkReader::RefreshNames()
+    {
+        if (Dump(RTM_GETLINK) != 0)
+        {
+            return false;
+        }
+        names_.clear();
+        Link link;
+        while (NextLink(&link))
+        {
+            names_.emplace(link.ifindex, std::string(link.name));
+        }
+        names_dirty_ = false;
+        return true;
+    }
+
+    /**
+     * @brief 转储所有接口计数的具体实现
+     * @return bool 成功返回true
+     *
+     * 第一次RTM_GETSTATS被内核拒绝（不支持该消息类型）后固定使用RTM_GETLINK。
+     */
+    bool NetlinkLinkReader::Load()
+    {
+        if (!Open())
+        {
+            return false;
+        }
+
+        if (use_getstats_)
+        {
+            DrainEvents();
+            if (names_dirty_ && !RefreshNames())
+            {
+                Close();
+                return false;
+            }
+            const int result = Dump(RTM_GETSTATS);
+            if (result == 0)
+            {
+                return true;
+            }
+            if (result < 0)
+            {
+                Close();
+                return false;
+            }
+            use_getstats_ = false;
+        }
+
+        if (Dump(RTM_GETLINK) != 0)
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 获取下一个接口的具体实现
+     * @param link 输出参数
+     * @return bool 还有接口返回true
+     *
+     * RTM_NEWSTATS：if_stats_msg之后是IFLA_STATS_LINK_64属性，名称取自缓存；
+     * RTM_NEWLINK：ifinfomsg之后是IFLA_IFNAME、IFLA_STATS64等属性。
+     */
+    bool NetlinkLinkReader::NextLink(Link* link)
+    {
+        while (offset_ + sizeof(struct nlmsghdr) <= size_)
+        {
+            const auto* header = reinterpret_cast<const struct nlmsghdr*>(buffer_.data() + offset_);
+            if (header->nlmsg_len < sizeof(struct nlmsghdr) || header->nlmsg_len > size_ - offset_)
+            {
+                break;
+            }
+            offset_ += NLMSG_ALIGN(header->nlmsg_len);
+            if (header->nlmsg_seq != seq_)
+            {
+                continue;
+            }
+
+            const struct rtattr* attr = nullptr;
+            int length = 0;
+            if (header->nlmsg_type == RTM_NEWSTATS && header->nlmsg_len >= NLMSG_LENGTH(sizeof(struct if_stats_msg)))
+            {
+                const auto* message = static_cast<const struct if_stats_msg*>(NLMSG_DATA(header));
+                link->ifindex = message->ifindex;
+                auto name = names_.find(message->ifindex);
+                if (name == names_.end())
+                {
+                    names_dirty_ = true;   // 转储之间新建的接口，下一次刷新名称后再输出
+                    continue;
+                }
+                link->name = name->second;
+                attr = reinterpret_cast<const struct rtattr*>(
+                    reinterpret_cast<const char*>(message) + NLMSG_ALIGN(sizeof(struct if_stats_msg)));
+                length = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(struct if_stats_msg)));
+            }
+            else if (header->nlmsg_type == RTM_NEWLINK && header->nlmsg_len >= NLMSG_LENGTH(sizeof(struct ifinfomsg)))
+            {
+                const auto* message = static_cast<const struct ifinfomsg*>(NLMSG_DATA(header));
+                link->ifindex = static_cast<uint32_t>(message->ifi_index);
+                link->name = std::string_view();
+                attr = IFLA_RTA(message);
+                length = static_cast<int>(IFLA_PAYLOAD(header));
+            }
+            else
+            {
+                continue;
+            }
+
+            bool has_stats = false;
+            for (; RTA_OK(attr, length); attr = RTA_NEXT(attr, length))
+            {
+                if (attr->rta_type == IFLA_STATS_LINK_64 && header->nlmsg_type == RTM_NEWSTATS)
+                {
+                    FillCounters(attr, link);
+                    has_stats = true;
+                }
+                else if (attr->rta_type == IFLA_STATS64 && header->nlmsg_type == RTM_NEWLINK)
+                {
+                    FillCounters(attr, link);
+                    has_stats = true;
+                }
+                else if (attr->rta_type == IFLA_IFNAME && header->nlmsg_type == RTM_NEWLINK)
+                {
+                    const char* name = static_cast<const char*>(RTA_DATA(attr));
+                    link->name = std::string_view(name, strnlen(name, RTA_PAYLOAD(attr)));
+                }
+            }
+            if (has_stats && !link->name.empty())
+            {
+                return true;
+            }
+        }
+        offset_ = size_;
+        return false;
+    }
+}  // namespace monitor
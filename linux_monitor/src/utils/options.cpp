@@ -0,0 +1,79 @@
+// 包含对应的头文件
+#include "utils/options.h"
+
+// C++标准库头文件
+#include <charconv>     // std::from_chars
+#include <string_view>  // 参数视图
+
+namespace monitor
+{
+    /**
+     * @brief 解析命令行参数的具体实现
+     * @param argc 参数个数
+     * @param argv 参数数组
+     * @return bool 所有参数格式合法返回true
+     *
+     * 同一个选项出现多次时以最后一次为准。
+     */
+    bool Options::Parse(int argc, char** argv)
+    {
+        bool ok = true;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg(argv[i]);
+            if (arg.size() <= 2 || arg.substr(0, 2) != "--")
+            {
+                ok = false;
+                continue;
+            }
+            arg.remove_prefix(2);
+
+            size_t eq = arg.find('=');
+            if (eq == std::string_view::npos)
+            {
+                values_[std::string(arg)] = "true";
+            }
+            else
+            {
+                values_[std::string(arg.substr(0, eq))] = std::string(arg.substr(eq + 1));
+            }
+        }
+        return ok;
+    }
+
+    std::string Options::GetString(const std::string& key, const std::string& default_value) const
+    {
+        auto iter = values_.find(key);
+        return iter == values_.end() ? default_value : iter->second;
+    }
+
+    int64_t Options::GetInt(const std::string& key, int64_t default_value) const
+    {
+        auto iter = values_.find(key);
+        if (iter == values_.end())
+        {
+            return default_value;
+        }
+
+        const std::string& value = iter->second;
+        int64_t result = 0;
+        auto parsed = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (parsed.ec != std::errc() || parsed.ptr != value.data() + value.size())
+        {
+            return default_value;
+        }
+        return result;
+    }
+
+    bool Options::GetBool(const std::string& key, bool default_value) const
+    {
+        auto iter = values_.find(key);
+        if (iter == values_.end())
+        {
+            return default_value;
+        }
+
+        const std::string& value = iter->second;
+        return value == "true" || value == "1" || value == "yes" || value == "on";
+    }
+}  // namespace monitor
@@ -0,0 +1,87 @@
+// 包含对应的头文件
+#include "utils/proc_parser.h"
+
+namespace monitor
+{
+    /**
+     * @brief 读取整个文件的具体实现
+     * @return bool 读取成功返回true，失败返回false
+     *
+     * 实际的pread和缓冲区扩容由ProcfsSource完成，这里只负责重置行游标。
+     * 注意：/proc文件的内容在读取时由内核动态生成，
+     * 缓冲区足够大时一次pread即可拿到完整快照。
+     */
+    bool ProcParser::Load()
+    {
+        cursor_ = 0;
+        return source_->ReadAll(&buffer_, &size_);
+    }
+
+    /**
+     * @brief 获取下一行的具体实现
+     * @param line 输出参数，指向一行内容的视图
+     * @return bool 还有行返回true，到达末尾返回false
+     *
+     * 使用string_view::find查找换行符，返回的视图不包含换行符本身。
+     * 文件最后一行没有换行符时同样会被返回。
+     */
+    bool ProcParser::NextLine(std::string_view* line)
+    {
+        if (cursor_ >= size_)
+        {
+            return false;
+        }
+
+        std::string_view rest(buffer_.data() + cursor_, size_ - cursor_);
+        size_t end = rest.find('\n');
+        if (end == std::string_view::npos)
+        {
+            *line = rest;
+            cursor_ = size_;
+        }
+        else
+        {
+            *line = rest.substr(0, end);
+            cursor_ += end + 1;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 按空白字符分割一行的具体实现
+     * @param line 要分割的行
+     * @param fields 输出参数，存储分割后的字段视图
+     * @return size_t 字段个数
+     *
+     * 示例：对于行 "MemTotal:       16335784 kB"
+     * 分割结果为：["MemTotal:", "16335784", "kB"]（均为指向原行的视图）
+     */
+    size_t ProcParser::SplitFields(std::string_view line, std::vector<std::string_view>* fields)
+    {
+        fields->clear();
+
+        size_t pos = 0;
+        const size_t len = line.size();
+        while (pos < len)
+        {
+            // 跳过连续的空白字符
+            while (pos < len && (line[pos] == ' ' || line[pos] == '\t'))
+            {
+                ++pos;
+            }
+            if (pos >= len)
+            {
+                break;
+            }
+
+            // 查找字段结尾
+            size_t start = pos;
+            while (pos < len && line[pos] != ' ' && line[pos] != '\t')
+            {
+                ++pos;
+            }
+            fields->emplace_back(line.data() + start, pos - start);
+        }
+        return fields->size();
+    }
+}  // namespace monitor
@@ -0,0 +1,169 @@
+// 包含对应的头文件
+#include "utils/procfs_source.h"
+
+// 系统调用头文件
+#include <cerrno>       // errno、EINTR
+#include <fcntl.h>      // open
+#include <unistd.h>     // pread、dup2、close
+
+namespace monitor
+{
+    /**
+     * @brief 缓冲区初始容量
+     *
+     * 大多数/proc文件（loadavg、meminfo、net/dev）一页即可容纳，
+     * 较大的文件（多核机器上的stat、softirqs）会在第一次读取时扩容，之后保持不变。
+     */
+    static constexpr size_t kInitialBufferSize = 4096;
+
+    ProcfsSource::~ProcfsSource()
+    {
+        int fd = fd_.load();
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    /**
+     * @brief 打开文件或替换已有fd的具体实现
+     * @param stale_fd 调用者读取失败时使用的fd
+     * @return int 当前可用的fd，失败返回-1
+     *
+     * 已有fd时使用dup2把新打开的文件原子地放到旧fd号上：
+     * 其他线程即使正持有旧fd号，也不会读到被复用给其他文件的fd。
+     */
+    int ProcfsSource::Reopen(int stale_fd)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // 其他线程已经完成了打开或重新打开
+        int current = fd_.load();
+        if (current != stale_fd)
+        {
+            return current;
+        }
+
+        int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return -1;
+        }
+
+        if (current < 0)
+        {
+            fd_.store(fd);
+            return fd;
+        }
+
+        // 原子替换旧fd号指向的文件
+        if (::dup2(fd, current) < 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        ::close(fd);
+        return current;
+    }
+
+    /**
+     * @brief 读取整个文件的具体实现
+     * @param buffer 读取缓冲区
+     * @param size 读取到的有效字节数
+     * @return bool 读取成功返回true
+     *
+     * 详细执行流程：
+     * 1. 获取常驻fd（第一次调用时打开文件）
+     * 2. 从偏移0开始循环pread，直到返回0（文件结束）
+     * 3. 缓冲区写满时容量翻倍后继续读取
+     * 4. pread返回错误时重新打开文件并从头重试一次
+     */
+    bool ProcfsSource::ReadAll(std::vector<char>* buffer, size_t* size)
+    {
+        *size = 0;
+
+        int fd = fd_.load();
+        if (fd < 0)
+        {
+            fd = Reopen(-1);
+            if (fd < 0)
+            {
+                return false;
+            }
+        }
+
+        if (buffer->empty())
+        {
+            buffer->resize(kInitialBufferSize);
+        }
+
+        bool retried = false;
+        size_t offset = 0;
+        while (true)
+        {
+            // 缓冲区已满，扩容后继续读取剩余内容
+            if (offset == buffer->size())
+            {
+                buffer->resize(buffer->size() * 2);
+            }
+
+            ssize_t n = ::pread(fd, buffer->data() + offset, buffer->size() - offset, offset);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;  // 被信号中断，重试
+                }
+                if (retried)
+                {
+                    return false;
+                }
+
+                // fd失效（如网络命名空间变化、文件被重新创建），重新打开后从头读取
+                retried = true;
+                fd = Reopen(fd);
+                if (fd < 0)
+                {
+                    return false;
+                }
+                offset = 0;
+                continue;
+            }
+            if (n == 0)
+            {
+                break;  // 文件结束
+            }
+            offset += static_cast<size_t>(n);
+        }
+
+        *size = offset;
+        return true;
+    }
+
+    ProcfsRegistry& ProcfsRegistry::Instance()
+    {
+        static ProcfsRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief 获取指定路径数据源的具体实现
+     * @param path 文件路径
+     * @return std::shared_ptr<ProcfsSource> 共享的数据源
+     *
+     * 已有存活的数据源时直接复用，否则创建新的数据源并登记弱引用。
+     */
+    std::shared_ptr<ProcfsSource> ProcfsRegistry::Get(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto& weak = sources_[path];
+        std::shared_ptr<ProcfsSource> source = weak.lock();
+        if (!source)
+        {
+            source = std::make_shared<ProcfsSource>(path);
+            weak = source;
+        }
+        return source;
+    }
+}  // namespace monitor
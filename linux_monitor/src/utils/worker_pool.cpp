@@ -0,0 +1,91 @@
+// 包含对应的头文件
+#include "utils/worker_pool.h"
+
+namespace monitor
+{
+    WorkerPool::WorkerPool(size_t workers)
+    {
+        threads_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+        {
+            threads_.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief 并行执行一批任务的具体实现
+     * @param count 任务数
+     * @param task 任务函数
+     *
+     * 没有工作线程或只有一个任务时直接在调用线程上执行，省去线程切换。
+     */
+    void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& task)
+    {
+        if (threads_.empty() || count <= 1)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                task(i);
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_ = 0;
+        pending_ = count;
+        ++generation_;
+        work_cv_.notify_all();
+
+        done_cv_.wait(lock, [this]() { return pending_ == 0; });
+        task_ = nullptr;
+    }
+
+    /**
+     * @brief 工作线程主循环的具体实现
+     *
+     * 任务在锁外执行；领取下标和完成计数在锁内更新，
+     * 任务数很少（每批次只有几个监控器），锁竞争可以忽略。
+     */
+    void WorkerPool::WorkerLoop()
+    {
+        size_t seen_generation = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            work_cv_.wait(lock, [&]() { return stopping_ || generation_ != seen_generation; });
+            if (stopping_)
+            {
+                return;
+            }
+            seen_generation = generation_;
+
+            while (next_ < count_)
+            {
+                const size_t index = next_++;
+                const std::function<void(size_t)>* task = task_;
+                lock.unlock();
+                (*task)(index);
+                lock.lock();
+                if (--pending_ == 0)
+                {
+                    done_cv_.notify_one();
+                }
+            }
+        }
+    }
+}  // namespace monitor
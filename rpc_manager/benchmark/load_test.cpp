@@ -0,0 +1,887 @@
+// 系统调用头文件
+#include <sys/resource.h>   // getrusage、setrlimit
+#include <unistd.h>         // sysconf
+
+// C++标准库头文件
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// gRPC头文件
+#include <grpcpp/grpcpp.h>
+
+// 项目自定义头文件
+#include "codec/compact_codec.h"       // 紧凑上报格式编码
+#include "utils/latency_histogram.h"   // 耗时直方图
+#include "utils/options.h"             // 命令行选项解析
+
+// Protobuf和gRPC生成的头文件
+#include "monitor_info.grpc.pb.h"
+#include "monitor_info.pb.h"
+
+/**
+ * @brief 采集端→服务器→界面的端到端负载测试
+ *
+ * 在一个进程中模拟大量采集端和订阅者，对运行中的server施加负载：
+ * - 采集端：每个采集端是一台虚拟主机（load-00000、load-00001……），按--rate定时上报
+ *   --cpus个CPU、--nics块网卡的完整MonitorInfo（cpu_stat、soft_irq、mem_info、cpu_load、net_info），
+ *   数值随机游走；各采集端的相位随机分布，不会同时上报。
+ *   上报方式：--mode=stream（StreamMonitorInfo长连接，--compact时为StreamCompactMonitorInfo）
+ *   或--mode=unary（每次采样一次SetMonitorInfo）
+ * - 连接：采集端平均分配到--connections条连接（HTTP/2多路复用），0表示每个采集端一条，
+ *   与真实部署相同（需要两端的文件描述符上限足够）
+ * - 发送线程：--threads个线程按截止时间最小堆驱动各自的采集端，发送阻塞时（服务器跟不上）
+ *   错过的周期计入missed，实际速率低于目标速率即说明服务器饱和
+ * - 订阅者：--subscribers个Subscribe流（各自一条连接），第i个订阅第i × agents / subscribers台主机，
+ *   推送的timestamp_ms在发送记录中找到对应的发送时刻，差值即上报到推送的端到端延迟
+ *
+ * 统计只包含预热（--warmup_s）之后--duration_s秒内的数据，报告：
+ * - 上报吞吐（采样/秒、MB/秒）、错误和错过的周期、每次上报的耗时分位数
+ * - 推送速率和端到端延迟分位数
+ * - 服务器进程（--server_pid）在统计窗口内的CPU使用率和常驻内存，本进程的CPU使用率
+ * 最后一行"RESULT key=value ..."便于脚本比较不同版本的结果。
+ *
+ * 判断服务器是否饱和：一元调用下服务器跟不上时发送阻塞，表现为实际速率下降和错过的周期；
+ * 流式上报的Write在HTTP/2流控窗口（每条流约64KB，约60条完整采样）内不阻塞，
+ * 服务器跟不上时采样积压在窗口里，表现为端到端延迟上升到秒级、推送次数低于期望值
+ * （订阅推送只保留最新快照），而不是发送失败。
+ *
+ * 用法：
+ *   ./bin/server --address=localhost:50051 &
+ *   ./bin/rpc_load_test --agents=2000 --cpus=16 --nics=4 --rate=1 --mode=stream --compact=true \
+ *       --subscribers=20 --duration_s=30 --server_pid=$!
+ */
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 获取当前单调时间
+     * @return int64_t 纳秒
+     */
+    int64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 获取当前Unix时间
+     * @return int64_t 毫秒
+     */
+    int64_t WallMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 负载参数
+     */
+    struct Config
+    {
+        std::string address = "localhost:50051";   ///< 服务器地址
+        size_t agents = 1000;                      ///< 模拟的采集端数
+        size_t cpus = 8;                           ///< 每台主机的CPU数
+        size_t nics = 2;                           ///< 每台主机的网卡数
+        double rate = 1.0;                         ///< 每个采集端每秒的采样数
+        bool unary = false;                        ///< 使用一元调用
+        bool compact = false;                      ///< 流式上报使用紧凑格式
+        size_t connections = 64;                   ///< 连接数（0为每个采集端一条）
+        size_t threads = 4;                        ///< 发送线程数
+        size_t subscribers = 10;                   ///< 订阅者数
+        uint64_t subscribe_mask = 0;               ///< 订阅的字段掩码（0为全部字段）
+        size_t groups = 10;                        ///< 主机分组数（host_group）
+        int64_t warmup_s = 5;                      ///< 预热时间（新主机的历史列在第一次上报时分配）
+        int64_t duration_s = 10;                   ///< 统计时间
+        int pid = 0;                               ///< 服务器进程号（0为不统计服务器开销）
+    };
+
+    /**
+     * @brief 一台虚拟主机的采样内容：固定的实例结构 + 随机游走的数值
+     *
+     * 构造时通过反射收集所有float字段，之后每次采样只修改数值，
+     * 消息结构（CPU名、网卡名）不变，与真实采集端相同。
+     */
+    class Payload
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param name 主机名
+         * @param group 主机分组
+         * @param cpus CPU数
+         * @param nics 网卡数
+         * @param seed 随机种子
+         */
+        Payload(const std::string& name, const std::string& group, size_t cpus, size_t nics, uint64_t seed)
+            : state_(seed | 1)
+        {
+            info_.set_name(name);
+            info_.set_host_group(group);
+            for (size_t i = 0; i < cpus; ++i)
+            {
+                info_.add_cpu_stat()->set_cpu_name("cpu" + std::to_string(i));
+                info_.add_soft_irq()->set_cpu("cpu" + std::to_string(i));
+            }
+            for (size_t i = 0; i < nics; ++i)
+            {
+                info_.add_net_info()->set_name("eth" + std::to_string(i));
+            }
+            info_.mutable_mem_info();
+            info_.mutable_cpu_load();
+
+            const google::protobuf::Reflection* reflection = info_.GetReflection();
+            std::vector<const google::protobuf::FieldDescriptor*> fields;
+            reflection->ListFields(info_, &fields);
+            for (const auto* field : fields)
+            {
+                if (field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+                {
+                    continue;
+                }
+                const int count = field->is_repeated() ? reflection->FieldSize(info_, field) : 1;
+                for (int i = 0; i < count; ++i)
+                {
+                    google::protobuf::Message* element = field->is_repeated()
+                        ? reflection->MutableRepeatedMessage(&info_, field, i)
+                        : reflection->MutableMessage(&info_, field);
+                    AddSlots(element);
+                }
+            }
+        }
+
+        /**
+         * @brief 生成下一次采样
+         * @param timestamp_ms 采样时间
+         * @return const MonitorInfo& 采样消息
+         */
+        const monitor::proto::MonitorInfo& Next(int64_t timestamp_ms)
+        {
+            for (Slot& slot : slots_)
+            {
+                // 每步最多变化量程的2%，量化差分编码下大多数字段只占1~2字节
+                slot.value += slot.range * 0.02 * (Uniform() * 2 - 1);
+                slot.value = std::clamp(slot.value, 0.0, slot.range);
+                slot.message->GetReflection()->SetFloat(slot.message, slot.field, static_cast<float>(slot.value));
+            }
+            info_.set_timestamp_ms(timestamp_ms);
+            return info_;
+        }
+
+    private:
+        /**
+         * @brief 一个随机游走的数值字段
+         */
+        struct Slot
+        {
+            google::protobuf::Message* message;                 ///< 所在的子消息
+            const google::protobuf::FieldDescriptor* field;     ///< 字段
+            double value;                                       ///< 当前值
+            double range;                                       ///< 量程
+        };
+
+        /**
+         * @brief 收集子消息中的float字段并设置初始值
+         * @param element 子消息
+         */
+        void AddSlots(google::protobuf::Message* element)
+        {
+            const google::protobuf::Descriptor* descriptor = element->GetDescriptor();
+            const bool memory = descriptor == monitor::proto::MemInfo::descriptor();
+            for (int j = 0; j < descriptor->field_count(); ++j)
+            {
+                const google::protobuf::FieldDescriptor* field = descriptor->field(j);
+                if (field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_FLOAT)
+                {
+                    continue;
+                }
+                const bool percent = field->name().find("percent") != std::string::npos;
+                const double range = percent ? 100.0 : memory ? 16.0 * 1024 * 1024 : 10000.0;
+                slots_.push_back(Slot{element, field, Uniform() * range, range});
+            }
+        }
+
+        /**
+         * @brief xorshift64*均匀分布
+         * @return double [0, 1)
+         */
+        double Uniform()
+        {
+            state_ ^= state_ >> 12;
+            state_ ^= state_ << 25;
+            state_ ^= state_ >> 27;
+            return static_cast<double>((state_ * 0x2545F4914F6CDD1DULL) >> 11) / static_cast<double>(1ULL << 53);
+        }
+
+        monitor::proto::MonitorInfo info_;   ///< 采样消息
+        std::vector<Slot> slots_;            ///< 数值字段
+        uint64_t state_;                     ///< 随机数状态
+    };
+
+    /**
+     * @brief 一台虚拟主机最近的发送记录（timestamp_ms → 发送时刻），供订阅者计算端到端延迟
+     */
+    class SendLog
+    {
+    public:
+        /// @brief 保留的记录数（订阅推送落后超过该数目的采样时查不到发送时刻，不计入延迟）
+        static constexpr size_t kSlots = 64;
+
+        /**
+         * @brief 记录一次发送
+         * @param timestamp_ms 采样时间（同一主机内严格递增）
+         * @param sent_ns 发送时刻（单调时间）
+         */
+        void Record(int64_t timestamp_ms, int64_t sent_ns)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Entry& entry = entries_[static_cast<size_t>(timestamp_ms) % kSlots];
+            entry.timestamp_ms = timestamp_ms;
+            entry.sent_ns = sent_ns;
+        }
+
+        /**
+         * @brief 查找采样的发送时刻
+         * @param timestamp_ms 采样时间
+         * @param sent_ns 输出参数，发送时刻
+         * @return bool 找到返回true
+         */
+        bool Find(int64_t timestamp_ms, int64_t* sent_ns) const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const Entry& entry = entries_[static_cast<size_t>(timestamp_ms) % kSlots];
+            if (entry.timestamp_ms != timestamp_ms)
+            {
+                return false;
+            }
+            *sent_ns = entry.sent_ns;
+            return true;
+        }
+
+    private:
+        /**
+         * @brief 一条发送记录
+         */
+        struct Entry
+        {
+            int64_t timestamp_ms = -1;   ///< 采样时间
+            int64_t sent_ns = 0;         ///< 发送时刻
+        };
+
+        mutable std::mutex mutex_;       ///< 发送线程和订阅线程共用
+        Entry entries_[kSlots];          ///< 按timestamp_ms取模的槽位
+    };
+
+    /**
+     * @brief 一个模拟的采集端
+     */
+    struct Agent
+    {
+        std::unique_ptr<Payload> payload;                  ///< 采样内容
+        SendLog log;                                       ///< 发送记录
+        monitor::proto::GrpcManager::Stub* stub = nullptr; ///< 所在连接的存根
+        int64_t last_timestamp_ms = 0;                     ///< 上一次采样时间
+
+        // 流式上报的状态（断开后在下一次发送时重建）
+        std::unique_ptr<grpc::ClientContext> context;                                ///< 流的上下文
+        google::protobuf::Empty response;                                            ///< 流的响应
+        std::unique_ptr<grpc::ClientWriter<monitor::proto::MonitorInfo>> writer;     ///< 完整格式的流
+        std::unique_ptr<grpc::ClientWriter<monitor::proto::CompactFrame>> compact;   ///< 紧凑格式的流
+        std::unique_ptr<monitor::CompactEncoder> encoder;                            ///< 紧凑格式编码器（每条流一个）
+    };
+
+    /**
+     * @brief 一个发送线程的统计（线程结束后汇总）
+     */
+    struct SenderStats
+    {
+        uint64_t samples = 0;                 ///< 成功上报的采样数
+        uint64_t bytes = 0;                   ///< 序列化字节数
+        uint64_t errors = 0;                  ///< 失败的上报（含断开的流）
+        uint64_t missed = 0;                  ///< 发送阻塞导致错过的周期
+        monitor::LatencyHistogram latency;    ///< 每次上报的耗时
+    };
+
+    /**
+     * @brief 一个订阅线程的统计
+     */
+    struct SubscriberStats
+    {
+        uint64_t pushes = 0;                  ///< 收到的推送数
+        uint64_t unmatched = 0;               ///< 查不到发送时刻的推送（订阅建立时的快照、落后太多）
+        monitor::LatencyHistogram latency;    ///< 上报到推送的端到端延迟
+    };
+
+    /**
+     * @brief 进程开销快照
+     */
+    struct ProcessUsage
+    {
+        double cpu_seconds = 0;   ///< 累计的用户态+内核态时间（秒）
+        uint64_t rss_kb = 0;      ///< 常驻内存（KB）
+        uint64_t peak_kb = 0;     ///< 常驻内存峰值（KB）
+        bool ok = false;          ///< 读取成功
+    };
+
+    /**
+     * @brief 读取进程的CPU时间和常驻内存
+     * @param pid 进程号
+     * @return ProcessUsage 开销快照
+     *
+     * CPU时间来自/proc/<pid>/stat的utime、stime（第14、15个字段，时钟滴答），
+     * 内存来自/proc/<pid>/status的VmRSS、VmHWM。
+     */
+    ProcessUsage ReadProcess(int pid)
+    {
+        ProcessUsage usage;
+        std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+        std::string line;
+        if (!std::getline(stat, line))
+        {
+            return usage;
+        }
+        // 进程名可能包含空格，从最后一个')'之后开始分词（之后第1个字段是第3个字段state）
+        const size_t close = line.rfind(')');
+        if (close == std::string::npos)
+        {
+            return usage;
+        }
+        std::istringstream fields(line.substr(close + 2));
+        std::string field;
+        uint64_t utime = 0;
+        uint64_t stime = 0;
+        for (int index = 3; fields >> field && index <= 15; ++index)
+        {
+            if (index == 14)
+            {
+                utime = std::stoull(field);
+            }
+            else if (index == 15)
+            {
+                stime = std::stoull(field);
+            }
+        }
+        usage.cpu_seconds = static_cast<double>(utime + stime) / static_cast<double>(sysconf(_SC_CLK_TCK));
+
+        std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+        while (std::getline(status, line))
+        {
+            std::istringstream words(line);
+            std::string key;
+            uint64_t value = 0;
+            words >> key >> value;
+            if (key == "VmRSS:")
+            {
+                usage.rss_kb = value;
+            }
+            else if (key == "VmHWM:")
+            {
+                usage.peak_kb = value;
+            }
+        }
+        usage.ok = true;
+        return usage;
+    }
+
+    /**
+     * @brief 读取本进程的CPU时间
+     * @return double 用户态+内核态时间（秒）
+     */
+    double SelfCpuSeconds()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    /**
+     * @brief 负载测试
+     */
+    class LoadTest
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param config 负载参数
+         */
+        explicit LoadTest(const Config& config) : config_(config) {}
+
+        /**
+         * @brief 运行负载并输出报告
+         * @return int 进程退出码
+         */
+        int Run()
+        {
+            Setup();
+
+            std::vector<SenderStats> sender_stats(config_.threads);
+            std::vector<SubscriberStats> subscriber_stats(config_.subscribers);
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < config_.threads; ++t)
+            {
+                threads.emplace_back([this, t, &sender_stats]() { SendLoop(t, &sender_stats[t]); });
+            }
+            for (size_t s = 0; s < config_.subscribers; ++s)
+            {
+                threads.emplace_back([this, s, &subscriber_stats]() { SubscribeLoop(s, &subscriber_stats[s]); });
+            }
+
+            std::this_thread::sleep_for(std::chrono::seconds(config_.warmup_s));
+            const ProcessUsage server_start = config_.pid > 0 ? ReadProcess(config_.pid) : ProcessUsage();
+            const double self_start = SelfCpuSeconds();
+            const int64_t start_ns = NowNs();
+            measuring_.store(true);
+
+            std::this_thread::sleep_for(std::chrono::seconds(config_.duration_s));
+            measuring_.store(false);
+            const double elapsed = static_cast<double>(NowNs() - start_ns) / 1e9;
+            const ProcessUsage server_end = config_.pid > 0 ? ReadProcess(config_.pid) : ProcessUsage();
+            const double self_cpu = SelfCpuSeconds() - self_start;
+
+            Stop();
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            Report(sender_stats, subscriber_stats, elapsed, server_start, server_end, self_cpu);
+            return 0;
+        }
+
+    private:
+        /**
+         * @brief 创建连接和采集端
+         *
+         * 每条连接使用不同的频道参数，gRPC不会把它们合并到同一个子通道（同一条TCP连接）上。
+         * 采集端按序号轮流分配到各连接，每个订阅者单独一条连接。
+         */
+        void Setup()
+        {
+            const size_t connections = config_.connections == 0
+                ? config_.agents : std::min(config_.connections, config_.agents);
+            for (size_t c = 0; c < std::max<size_t>(connections, 1); ++c)
+            {
+                grpc::ChannelArguments arguments;
+                arguments.SetInt("monitor.load_test.connection", static_cast<int>(c));
+                stubs_.push_back(monitor::proto::GrpcManager::NewStub(
+                    grpc::CreateCustomChannel(config_.address, grpc::InsecureChannelCredentials(), arguments)));
+            }
+
+            // 订阅者是独立的界面进程，不与采集端共用连接
+            for (size_t s = 0; s < config_.subscribers; ++s)
+            {
+                grpc::ChannelArguments arguments;
+                arguments.SetInt("monitor.load_test.subscriber", static_cast<int>(s));
+                subscriber_stubs_.push_back(monitor::proto::GrpcManager::NewStub(
+                    grpc::CreateCustomChannel(config_.address, grpc::InsecureChannelCredentials(), arguments)));
+            }
+
+            agents_.resize(config_.agents);
+            for (size_t i = 0; i < config_.agents; ++i)
+            {
+                std::ostringstream name;
+                name << "load-" << std::setw(5) << std::setfill('0') << i;
+                const std::string group = config_.groups > 0 ? "load-group-" + std::to_string(i % config_.groups) : "";
+                agents_[i] = std::make_unique<Agent>();
+                agents_[i]->payload = std::make_unique<Payload>(name.str(), group, config_.cpus, config_.nics, i + 1);
+                agents_[i]->stub = stubs_[i % stubs_.size()].get();
+                names_.push_back(name.str());
+            }
+        }
+
+        /**
+         * @brief 发送线程：按截止时间驱动第t个分片中的采集端
+         * @param t 线程序号（负责序号 ≡ t mod threads 的采集端）
+         * @param stats 输出参数，线程统计
+         *
+         * 第一次上报的时间在一个周期内均匀分布；每次上报后截止时间加一个周期，
+         * 发送阻塞导致截止时间已经过去时跳过错过的周期（计入missed）。
+         */
+        void SendLoop(size_t t, SenderStats* stats)
+        {
+            const int64_t period_ns = static_cast<int64_t>(1e9 / std::max(config_.rate, 1e-3));
+            using Deadline = std::pair<int64_t, size_t>;
+            std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+            const int64_t start = NowNs();
+            for (size_t i = t; i < agents_.size(); i += config_.threads)
+            {
+                deadlines.push({start + static_cast<int64_t>((i * 2654435761ULL) % 1000) * period_ns / 1000, i});
+            }
+
+            while (!stopping_.load() && !deadlines.empty())
+            {
+                auto [deadline, index] = deadlines.top();
+                deadlines.pop();
+                const int64_t now = NowNs();
+                if (deadline > now)
+                {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<int64_t>(deadline - now, 100000000)));
+                    if (NowNs() < deadline)
+                    {
+                        deadlines.push({deadline, index});   // 最多睡100ms，以便及时响应停止
+                        continue;
+                    }
+                }
+
+                Send(agents_[index].get(), stats);
+
+                int64_t next = deadline + period_ns;
+                const int64_t done = NowNs();
+                if (next <= done - period_ns)
+                {
+                    const int64_t skipped = (done - next) / period_ns;
+                    if (measuring_.load())
+                    {
+                        stats->missed += static_cast<uint64_t>(skipped);
+                    }
+                    next += skipped * period_ns;
+                }
+                deadlines.push({next, index});
+            }
+
+            for (size_t i = t; i < agents_.size(); i += config_.threads)
+            {
+                CloseStream(agents_[i].get());
+            }
+        }
+
+        /**
+         * @brief 上报一次采样
+         * @param agent 采集端
+         * @param stats 输出参数，线程统计
+         */
+        void Send(Agent* agent, SenderStats* stats)
+        {
+            const int64_t timestamp_ms = std::max(WallMs(), agent->last_timestamp_ms + 1);
+            agent->last_timestamp_ms = timestamp_ms;
+            const monitor::proto::MonitorInfo& info = agent->payload->Next(timestamp_ms);
+
+            const int64_t start = NowNs();
+            agent->log.Record(timestamp_ms, start);
+            bool ok = false;
+            size_t bytes = 0;
+            if (config_.unary)
+            {
+                grpc::ClientContext context;
+                context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+                google::protobuf::Empty response;
+                ok = agent->stub->SetMonitorInfo(&context, info, &response).ok();
+                bytes = info.ByteSizeLong();
+            }
+            else if (config_.compact)
+            {
+                if (!agent->compact)
+                {
+                    agent->context = std::make_unique<grpc::ClientContext>();
+                    agent->compact = agent->stub->StreamCompactMonitorInfo(agent->context.get(), &agent->response);
+                    agent->encoder = std::make_unique<monitor::CompactEncoder>();
+                }
+                agent->encoder->Encode(info, &FrameScratch());
+                bytes = FrameScratch().ByteSizeLong();
+                ok = agent->compact->Write(FrameScratch());
+            }
+            else
+            {
+                if (!agent->writer)
+                {
+                    agent->context = std::make_unique<grpc::ClientContext>();
+                    agent->writer = agent->stub->StreamMonitorInfo(agent->context.get(), &agent->response);
+                }
+                bytes = info.ByteSizeLong();
+                ok = agent->writer->Write(info);
+            }
+            const int64_t latency = NowNs() - start;
+
+            if (!ok && !config_.unary)
+            {
+                CloseStream(agent);   // 下一次发送时重新建立流
+            }
+            if (!measuring_.load())
+            {
+                return;
+            }
+            if (ok)
+            {
+                ++stats->samples;
+                stats->bytes += bytes;
+                stats->latency.Record(latency);
+            }
+            else
+            {
+                ++stats->errors;
+            }
+        }
+
+        /**
+         * @brief 结束采集端的流
+         * @param agent 采集端
+         */
+        static void CloseStream(Agent* agent)
+        {
+            if (agent->writer)
+            {
+                agent->writer->WritesDone();
+                agent->writer->Finish();
+                agent->writer.reset();
+            }
+            if (agent->compact)
+            {
+                agent->compact->WritesDone();
+                agent->compact->Finish();
+                agent->compact.reset();
+            }
+            agent->encoder.reset();
+            agent->context.reset();
+        }
+
+        /**
+         * @brief 每个发送线程复用的紧凑帧
+         * @return CompactFrame& 线程局部的帧
+         */
+        static monitor::proto::CompactFrame& FrameScratch()
+        {
+            thread_local monitor::proto::CompactFrame frame;
+            return frame;
+        }
+
+        /**
+         * @brief 订阅线程：订阅一台主机，按推送的timestamp_ms计算端到端延迟
+         * @param s 订阅者序号
+         * @param stats 输出参数，订阅统计
+         *
+         * 流结束（服务器重启等）后重新订阅，直到停止。
+         */
+        void SubscribeLoop(size_t s, SubscriberStats* stats)
+        {
+            if (agents_.empty())
+            {
+                return;
+            }
+            const size_t index = (s * agents_.size() / std::max<size_t>(config_.subscribers, 1)) % agents_.size();
+            monitor::proto::SubscribeRequest request;
+            request.set_host(names_[index]);
+            request.set_fields_mask(config_.subscribe_mask);
+            monitor::proto::GrpcManager::Stub* stub = subscriber_stubs_[s].get();
+
+            monitor::proto::MonitorInfo sample;
+            while (!stopping_.load())
+            {
+                grpc::ClientContext context;
+                {
+                    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+                    if (stopping_.load())
+                    {
+                        break;
+                    }
+                    subscribe_contexts_.push_back(&context);
+                }
+                auto reader = stub->Subscribe(&context, request);
+                while (reader->Read(&sample))
+                {
+                    const int64_t now = NowNs();
+                    int64_t sent_ns = 0;
+                    if (!measuring_.load())
+                    {
+                        continue;
+                    }
+                    ++stats->pushes;
+                    if (agents_[index]->log.Find(sample.timestamp_ms(), &sent_ns))
+                    {
+                        stats->latency.Record(now - sent_ns);
+                    }
+                    else
+                    {
+                        ++stats->unmatched;
+                    }
+                }
+                reader->Finish();
+                {
+                    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+                    subscribe_contexts_.erase(
+                        std::find(subscribe_contexts_.begin(), subscribe_contexts_.end(), &context));
+                }
+                if (!stopping_.load())
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            }
+        }
+
+        /**
+         * @brief 停止发送线程并取消所有订阅
+         */
+        void Stop()
+        {
+            std::lock_guard<std::mutex> lock(subscribe_mutex_);
+            stopping_.store(true);
+            for (grpc::ClientContext* context : subscribe_contexts_)
+            {
+                context->TryCancel();
+            }
+        }
+
+        /**
+         * @brief 汇总并输出报告
+         */
+        void Report(const std::vector<SenderStats>& senders, const std::vector<SubscriberStats>& subscribers,
+            double elapsed, const ProcessUsage& server_start, const ProcessUsage& server_end, double self_cpu) const
+        {
+            SenderStats send;
+            for (const auto& stats : senders)
+            {
+                send.samples += stats.samples;
+                send.bytes += stats.bytes;
+                send.errors += stats.errors;
+                send.missed += stats.missed;
+                send.latency.Merge(stats.latency);
+            }
+            SubscriberStats push;
+            for (const auto& stats : subscribers)
+            {
+                push.pushes += stats.pushes;
+                push.unmatched += stats.unmatched;
+                push.latency.Merge(stats.latency);
+            }
+
+            auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+            const double offered = static_cast<double>(config_.agents) * config_.rate;
+            const double achieved = static_cast<double>(send.samples) / elapsed;
+            const double mb_per_s = static_cast<double>(send.bytes) / elapsed / (1024.0 * 1024.0);
+            const double self_percent = self_cpu / elapsed * 100.0;
+            const bool server = server_start.ok && server_end.ok;
+            const double server_percent = server ? (server_end.cpu_seconds - server_start.cpu_seconds) / elapsed * 100.0 : 0;
+
+            std::cout << std::fixed << std::setprecision(1);
+            std::cout << "=== 负载测试 ===" << std::endl;
+            std::cout << "配置: agents=" << config_.agents << " cpus=" << config_.cpus << " nics=" << config_.nics
+                      << " rate=" << config_.rate << "/s mode=" << (config_.unary ? "unary" : "stream")
+                      << " compact=" << (config_.compact && !config_.unary ? "true" : "false")
+                      << " connections=" << stubs_.size() << " threads=" << config_.threads
+                      << " subscribers=" << config_.subscribers << " duration=" << elapsed << "s" << std::endl;
+            std::cout << "上报: 目标 " << offered << " 采样/秒, 实际 " << achieved << " 采样/秒 ("
+                      << std::setprecision(2) << mb_per_s << " MB/秒, 每条 "
+                      << (send.samples > 0 ? static_cast<double>(send.bytes) / static_cast<double>(send.samples) : 0)
+                      << std::setprecision(1) << " 字节), 错误 " << send.errors << ", 错过的周期 " << send.missed << std::endl;
+            std::cout << "上报耗时(µs): p50 " << us(send.latency.Percentile(0.5)) << ", p99 "
+                      << us(send.latency.Percentile(0.99)) << ", max " << us(send.latency.Max()) << std::endl;
+            std::cout << "推送: " << static_cast<double>(push.pushes) / elapsed << " 次/秒 (期望 "
+                      << static_cast<double>(config_.subscribers) * config_.rate << ", 未匹配 " << push.unmatched
+                      << "), 端到端延迟(µs): p50 " << us(push.latency.Percentile(0.5)) << ", p90 "
+                      << us(push.latency.Percentile(0.9)) << ", p99 " << us(push.latency.Percentile(0.99))
+                      << ", p999 " << us(push.latency.Percentile(0.999)) << ", max " << us(push.latency.Max()) << std::endl;
+            if (server)
+            {
+                std::cout << "服务器: CPU " << server_percent << "% (单核为100%), 常驻内存 " << server_end.rss_kb / 1024
+                          << " MB (峰值 " << server_end.peak_kb / 1024 << " MB)" << std::endl;
+            }
+            std::cout << "负载进程: CPU " << self_percent << "%" << std::endl;
+
+            std::cout << std::setprecision(2) << "RESULT agents=" << config_.agents << " samples_per_s=" << achieved
+                      << " ingest_mb_per_s=" << mb_per_s << " errors=" << send.errors << " missed=" << send.missed
+                      << " send_p99_us=" << us(send.latency.Percentile(0.99))
+                      << " pushes_per_s=" << static_cast<double>(push.pushes) / elapsed
+                      << " latency_p50_us=" << us(push.latency.Percentile(0.5))
+                      << " latency_p99_us=" << us(push.latency.Percentile(0.99))
+                      << " latency_p999_us=" << us(push.latency.Percentile(0.999))
+                      << " server_cpu_percent=" << server_percent
+                      << " server_rss_mb=" << (server ? server_end.rss_kb / 1024 : 0) << std::endl;
+        }
+
+        Config config_;                                                      ///< 负载参数
+        std::vector<std::unique_ptr<monitor::proto::GrpcManager::Stub>> stubs_;   ///< 每条连接一个存根
+        std::vector<std::unique_ptr<monitor::proto::GrpcManager::Stub>> subscriber_stubs_;   ///< 每个订阅者一条连接
+        std::vector<std::unique_ptr<Agent>> agents_;                         ///< 模拟的采集端
+        std::vector<std::string> names_;                                     ///< 主机名
+        std::atomic<bool> measuring_{false};                                 ///< 是否在统计窗口内
+        std::atomic<bool> stopping_{false};                                  ///< 是否正在停止
+        std::mutex subscribe_mutex_;                                         ///< 保护subscribe_contexts_
+        std::vector<grpc::ClientContext*> subscribe_contexts_;               ///< 进行中的订阅
+    };
+
+    /**
+     * @brief 把文件描述符上限提高到硬上限（每个采集端一条连接时需要上千个fd）
+     */
+    void RaiseFileLimit()
+    {
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+        {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+}  // namespace
+
+/**
+ * @brief 负载测试主函数
+ * @param argc 参数个数
+ * @param argv 参数数组
+ * @return 程序退出码
+ *
+ * 命令行选项：
+ *   --server_address  服务器地址（默认localhost:50051）
+ *   --agents          模拟的采集端数（默认1000）
+ *   --cpus、--nics    每台主机的CPU数、网卡数（默认8、2）
+ *   --rate            每个采集端每秒的采样数（默认1，可以是小数）
+ *   --mode            stream（默认）或unary
+ *   --compact         流式上报使用紧凑格式（默认false）
+ *   --connections     连接数（默认64，0为每个采集端一条）
+ *   --threads         发送线程数（默认4）
+ *   --subscribers     订阅者数（默认10）
+ *   --subscribe_mask  订阅的字段掩码（默认0即全部字段）
+ *   --groups          主机分组数（默认10，0为不设置host_group）
+ *   --warmup_s、--duration_s  预热时间、统计时间（默认5、10秒）
+ *   --server_pid      服务器进程号（默认0即不统计服务器的CPU和内存）
+ */
+int main(int argc, char** argv)
+{
+    monitor::Options options;
+    const std::string mode = options.Parse(argc, argv) ? options.GetString("mode", "stream") : "";
+    if (mode != "stream" && mode != "unary")
+    {
+        std::cerr << "用法: " << argv[0] << " [--server_address=localhost:50051] [--agents=N] [--cpus=N] [--nics=N]"
+                  << " [--rate=R] [--mode=stream|unary] [--compact=true|false] [--connections=N] [--threads=N]"
+                  << " [--subscribers=N] [--subscribe_mask=N] [--groups=N] [--warmup_s=N] [--duration_s=N]"
+                  << " [--server_pid=PID]" << std::endl;
+        return 1;
+    }
+
+    Config config;
+    config.address = options.GetString("server_address", config.address);
+    config.agents = static_cast<size_t>(std::max<int64_t>(options.GetInt("agents", 1000), 0));
+    config.cpus = static_cast<size_t>(std::max<int64_t>(options.GetInt("cpus", 8), 1));
+    config.nics = static_cast<size_t>(std::max<int64_t>(options.GetInt("nics", 2), 0));
+    config.rate = std::stod(options.GetString("rate", "1"));
+    config.unary = mode == "unary";
+    config.compact = options.GetBool("compact", false);
+    config.connections = static_cast<size_t>(std::max<int64_t>(options.GetInt("connections", 64), 0));
+    config.threads = static_cast<size_t>(std::max<int64_t>(options.GetInt("threads", 4), 1));
+    config.subscribers = static_cast<size_t>(std::max<int64_t>(options.GetInt("subscribers", 10), 0));
+    config.subscribe_mask = static_cast<uint64_t>(options.GetInt("subscribe_mask", 0));
+    config.groups = static_cast<size_t>(std::max<int64_t>(options.GetInt("groups", 10), 0));
+    config.warmup_s = std::max<int64_t>(options.GetInt("warmup_s", 5), 0);
+    config.duration_s = std::max<int64_t>(options.GetInt("duration_s", 10), 1);
+    config.pid = static_cast<int>(options.GetInt("server_pid", 0));
+    if (config.rate <= 0)
+    {
+        std::cerr << "--rate必须大于0" << std::endl;
+        return 1;
+    }
+
+    RaiseFileLimit();
+    LoadTest test(config);
+    return test.Run();
+}
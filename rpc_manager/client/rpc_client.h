@@ -7,12 +7,25 @@
 #include <grpcpp/grpcpp.h>            // gRPC C++ API
 
 // 项目生成的Protobuf和gRPC代码
+#include "client/spill_log.h"         // 本地落盘缓冲
+#include "codec/compact_codec.h"      // 紧凑上报格式编解码
 #include "monitor_info.grpc.pb.h"     // gRPC服务存根定义
 #include "monitor_info.pb.h"          // Protobuf消息定义
 
 // 标准库头文件
+#include <algorithm>                  // std::min
+#include <chrono>                     // 重连退避时间
+#include <condition_variable>         // 发送队列通知
+#include <cstdint>                    // uint64_t
+#include <functional>                 // 订阅回调
 #include <iostream>                   // 错误输出
+#include <memory>                     // std::unique_ptr
+#include <mutex>                      // 保护发送队列
+#include <random>                     // 重放起始抖动
 #include <string>                     // 字符串处理
+#include <thread>                     // 后台发送线程
+#include <utility>                    // std::move
+#include <vector>                     // 有界发送队列（环形缓冲区）
 
 namespace monitor
 {
@@ -21,10 +34,38 @@ namespace monitor
      *
      * 封装了与监控服务器的gRPC通信功能
      * 提供设置和获取监控信息的接口
+     *
+     * 两种上报方式：
+     * - SetMonitorInfo：每次采样一次阻塞的一元调用
+     * - StartStream + PushMonitorInfo：后台线程维护一条StreamMonitorInfo长连接，
+     *   采集线程只把采样放入有界发送队列，不会被慢速服务器阻塞；
+     *   连接断开时自动按指数退避重连
+     *
+     * 可选本地落盘缓冲（EnableSpill）：发送队列已满时采样写入SpillLog而不是丢弃，
+     * 重新连接后先发完内存队列，再按写入顺序限速重放日志，追上之前新采样也追加到日志，
+     * 保证服务器按时间顺序收到所有采样（服务器的历史序列丢弃时间倒退的采样）。
+     *
+     * 流式上报可选紧凑格式（StreamCompactMonitorInfo，字典 + 量化差分），
+     * 按流协商：服务器返回UNIMPLEMENTED时回退到完整格式。
+     *
+     * 查询方可以用Subscribe代替轮询GetMonitorInfo，由服务器在有新采样时推送。
+     * 集群总览用ListHosts分页取主机名，用GetHostSummaries只取可见主机的概要；
+     * 整个分组的统计用GetAggregate取服务器维护的聚合。
      */
     class RpcClient
     {
     public:
+        /// @brief 发送队列默认容量（采样条数）
+        static constexpr size_t kDefaultSendQueueCapacity = 64;
+
+        /**
+         * @brief 上报观察者类型
+         *
+         * 每次上报成功后调用，参数为上报耗时（纳秒）和序列化字节数（紧凑格式为帧的字节数）。
+         * 一元调用在调用SetMonitorInfo的线程上回调，流式上报在后台发送线程上回调。
+         */
+        using SendObserver = std::function<void(int64_t latency_ns, size_t bytes)>;
+
         /**
          * @brief 构造函数
          * @param server_address gRPC服务器地址，格式："ip:port"
@@ -46,7 +87,15 @@ namespace monitor
         /**
          * @brief 析构函数
          */
-        ~RpcClient() = default;  // 使用默认析构，unique_ptr会自动管理资源
+        ~RpcClient() { StopStream(); }
+
+        /**
+         * @brief 设置上报观察者（用于采集端统计自身的上报开销）
+         * @param observer 观察者，为空时不计时
+         *
+         * 必须在StartStream和第一次SetMonitorInfo之前调用。
+         */
+        void SetSendObserver(SendObserver observer) { send_observer_ = std::move(observer); }
 
         /**
          * @brief 设置监控信息（客户端→服务器）
@@ -63,8 +112,14 @@ namespace monitor
             // 响应消息（使用Google的空消息类型）
             ::google::protobuf::Empty response;
 
-            // 调用远程RPC方法
+            // 调用远程RPC方法（设置了观察者时计时）
+            const auto start = std::chrono::steady_clock::now();
             ::grpc::Status status = stub_ptr_->SetMonitorInfo(&context, monito_info, &response);
+            if (status.ok() && send_observer_)
+            {
+                send_observer_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count(), monito_info.ByteSizeLong());
+            }
 
             // 检查RPC调用状态
             if (!status.ok())
@@ -117,8 +172,729 @@ namespace monitor
             }
         }
 
+        /**
+         * @brief 获取指定主机的监控信息（服务器→客户端）
+         * @param host 主机名（对应MonitorInfo::name）
+         * @param monito_info 输出参数，用于接收服务器返回的监控信息
+         * @return bool 调用成功返回true；主机不存在或调用失败返回false
+         */
+        bool GetMonitorInfo(const std::string& host, monitor::proto::MonitorInfo* monito_info)
+        {
+            // 参数检查
+            if (monito_info == nullptr)
+            {
+                std::cerr << "错误: monito_info 参数为空指针" << std::endl;
+                return false;
+            }
+
+            // 创建gRPC客户端上下文
+            ::grpc::ClientContext context;
+
+            // 请求消息：要查询的主机名
+            monitor::proto::HostRequest request;
+            request.set_host(host);
+
+            // 调用远程RPC方法
+            ::grpc::Status status = stub_ptr_->GetHostMonitorInfo(&context, request, monito_info);
+
+            // 检查RPC调用状态
+            if (!status.ok())
+            {
+                // 输出错误信息
+                std::cout << "RPC GetHostMonitorInfo 调用失败:" << std::endl;
+                std::cout << "  错误消息: " << status.error_message() << std::endl;
+                std::cout << "  错误代码: " << status.error_code() << std::endl;
+
+                // 清空输出参数
+                monito_info->Clear();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 查询指定主机某个指标的历史数据（服务器→客户端）
+         * @param request 主机、指标（如"cpu_stat.cpu_percent"）、实例（如"cpu0"）和时间区间
+         * @param response 输出参数，区间内的采样点
+         * @return bool 调用成功返回true；序列不存在或调用失败返回false
+         */
+        bool QueryRange(const monitor::proto::RangeRequest& request, monitor::proto::RangeResponse* response)
+        {
+            // 参数检查
+            if (response == nullptr)
+            {
+                std::cerr << "错误: response 参数为空指针" << std::endl;
+                return false;
+            }
+
+            // 创建gRPC客户端上下文
+            ::grpc::ClientContext context;
+
+            // 调用远程RPC方法
+            ::grpc::Status status = stub_ptr_->QueryRange(&context, request, response);
+
+            // 检查RPC调用状态
+            if (!status.ok())
+            {
+                // 输出错误信息
+                std::cout << "RPC QueryRange 调用失败:" << std::endl;
+                std::cout << "  错误消息: " << status.error_message() << std::endl;
+                std::cout << "  错误代码: " << status.error_code() << std::endl;
+
+                // 清空输出参数
+                response->Clear();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 分页列出服务器上的主机（服务器→客户端）
+         * @param start_after 从大于该名称的主机开始，为空时从第一台开始
+         * @param limit 本页最多返回的主机数，0表示不限制
+         * @param response 输出参数，本页的主机名（升序）和主机总数
+         * @return bool 调用成功返回true
+         */
+        bool ListHosts(const std::string& start_after, uint32_t limit, monitor::proto::HostListResponse* response)
+        {
+            // 参数检查
+            if (response == nullptr)
+            {
+                std::cerr << "错误: response 参数为空指针" << std::endl;
+                return false;
+            }
+
+            ::grpc::ClientContext context;
+            monitor::proto::HostListRequest request;
+            request.set_start_after(start_after);
+            request.set_limit(limit);
+
+            ::grpc::Status status = stub_ptr_->ListHosts(&context, request, response);
+            if (!status.ok())
+            {
+                std::cout << "RPC ListHosts 调用失败:" << std::endl;
+                std::cout << "  错误消息: " << status.error_message() << std::endl;
+                std::cout << "  错误代码: " << status.error_code() << std::endl;
+                response->Clear();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 批量获取主机概要（服务器→客户端）
+         * @param hosts 主机名列表
+         * @param response 输出参数，各主机的概要（不存在的主机不返回）和主机总数
+         * @return bool 调用成功返回true
+         */
+        bool GetHostSummaries(const std::vector<std::string>& hosts, monitor::proto::HostSummaryResponse* response)
+        {
+            // 参数检查
+            if (response == nullptr)
+            {
+                std::cerr << "错误: response 参数为空指针" << std::endl;
+                return false;
+            }
+
+            ::grpc::ClientContext context;
+            monitor::proto::HostSummaryRequest request;
+            for (const std::string& host : hosts)
+            {
+                request.add_host(host);
+            }
+
+            ::grpc::Status status = stub_ptr_->GetHostSummaries(&context, request, response);
+            if (!status.ok())
+            {
+                std::cout << "RPC GetHostSummaries 调用失败:" << std::endl;
+                std::cout << "  错误消息: " << status.error_message() << std::endl;
+                std::cout << "  错误代码: " << status.error_code() << std::endl;
+                response->Clear();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 查询主机分组的聚合统计（服务器→客户端）
+         * @param group 主机分组，为空时为所有主机
+         * @param metric 指标名（cpu_percent、mem_used_percent、load_avg_1、net_rcv_rate、net_send_rate）
+         * @param quantiles 需要的分位数（0~1）
+         * @param response 输出参数，组内各主机最新值的sum、avg、min、max和分位数
+         * @return bool 调用成功返回true
+         */
+        bool GetAggregate(const std::string& group, const std::string& metric, const std::vector<double>& quantiles,
+            monitor::proto::AggregateResponse* response)
+        {
+            // 参数检查
+            if (response == nullptr)
+            {
+                std::cerr << "错误: response 参数为空指针" << std::endl;
+                return false;
+            }
+
+            ::grpc::ClientContext context;
+            monitor::proto::AggregateRequest request;
+            request.set_group(group);
+            request.set_metric(metric);
+            for (double q : quantiles)
+            {
+                request.add_quantile(q);
+            }
+
+            ::grpc::Status status = stub_ptr_->GetAggregate(&context, request, response);
+            if (!status.ok())
+            {
+                std::cout << "RPC GetAggregate 调用失败:" << std::endl;
+                std::cout << "  错误消息: " << status.error_message() << std::endl;
+                std::cout << "  错误代码: " << status.error_code() << std::endl;
+                response->Clear();
+                return false;
+            }
+            return true;
+        }
+
+        /// @brief 订阅回调，每收到一份推送调用一次
+        using SampleHandler = std::function<void(const monitor::proto::MonitorInfo&)>;
+
+        /**
+         * @brief 订阅字段掩码中某个字段对应的位
+         * @param field_number MonitorInfo字段编号（如MonitorInfo::kCpuStatFieldNumber）
+         * @return uint64_t 掩码位
+         */
+        static constexpr uint64_t FieldBit(int field_number) { return uint64_t{1} << field_number; }
+
+        /**
+         * @brief 订阅主机监控数据（服务器→客户端推送）
+         * @param host 主机名，为空时订阅服务器上最近上报的主机
+         * @param fields_mask 需要的字段（FieldBit的组合），0表示全部字段
+         * @param handler 推送回调（在调用线程上执行）
+         * @return ::grpc::Status 订阅结束的状态；服务器不支持订阅时为UNIMPLEMENTED
+         *
+         * 阻塞直到连接断开、服务器结束订阅或CancelSubscribe。订阅建立时先收到一次当前数据，
+         * 之后只在该主机上报新采样时收到推送，调用者不需要轮询。
+         */
+        ::grpc::Status Subscribe(const std::string& host, uint64_t fields_mask, const SampleHandler& handler)
+        {
+            // 创建gRPC客户端上下文，登记后CancelSubscribe可以从其他线程取消
+            ::grpc::ClientContext context;
+            {
+                std::lock_guard<std::mutex> lock(subscribe_mutex_);
+                subscribe_context_ = &context;
+            }
+
+            monitor::proto::SubscribeRequest request;
+            request.set_host(host);
+            request.set_fields_mask(fields_mask);
+
+            // 读取缓冲区在整个订阅中复用
+            monitor::proto::MonitorInfo sample;
+            std::unique_ptr<::grpc::ClientReader<monitor::proto::MonitorInfo>> reader =
+                stub_ptr_->Subscribe(&context, request);
+            while (reader->Read(&sample))
+            {
+                handler(sample);
+            }
+
+            ::grpc::Status status = reader->Finish();
+            {
+                std::lock_guard<std::mutex> lock(subscribe_mutex_);
+                subscribe_context_ = nullptr;
+            }
+            if (!status.ok() && status.error_code() != ::grpc::StatusCode::UNIMPLEMENTED &&
+                status.error_code() != ::grpc::StatusCode::CANCELLED)
+            {
+                // 输出错误信息（UNIMPLEMENTED由调用者回退处理）
+                std::cout << "RPC Subscribe 结束:" << std::endl;
+                std::cout << "  错误消息: " << status.error_message() << std::endl;
+                std::cout << "  错误代码: " << status.error_code() << std::endl;
+            }
+            return status;
+        }
+
+        /**
+         * @brief 取消正在进行的订阅（任意线程）
+         *
+         * 阻塞中的Subscribe以CANCELLED返回，用于切换订阅的主机；没有进行中的订阅时无操作。
+         */
+        void CancelSubscribe()
+        {
+            std::lock_guard<std::mutex> lock(subscribe_mutex_);
+            if (subscribe_context_ != nullptr)
+            {
+                subscribe_context_->TryCancel();
+            }
+        }
+
+        /**
+         * @brief 启用本地落盘缓冲（只用于流式上报）
+         * @param options 日志配置
+         * @param replay_rate 重放限速（条/秒），需要大于采样产生的速率才能追上
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true；目录中已有未重放的采样时，连接后首先重放
+         *
+         * 必须在StartStream之前调用。
+         */
+        bool EnableSpill(const SpillLog::Options& options, double replay_rate, std::string* error)
+        {
+            auto spill = std::make_unique<SpillLog>();
+            if (!spill->Open(options, error))
+            {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            std::lock_guard<std::mutex> spill_lock(spill_mutex_);
+            spill_ = std::move(spill);
+            spilling_ = !spill_->Empty();
+            replay_rate_ = std::max(replay_rate, 0.1);
+            return true;
+        }
+
+        /**
+         * @brief 获取落盘缓冲中待重放的采样数
+         * @return uint64_t 条数，未启用时为0
+         */
+        uint64_t SpillPending()
+        {
+            std::lock_guard<std::mutex> lock(spill_mutex_);
+            return spill_ ? spill_->Records() : 0;
+        }
+
+        /**
+         * @brief 启动流式上报
+         * @param queue_capacity 发送队列容量（采样条数）
+         * @param compact 是否使用紧凑格式（服务器不支持时自动回退）
+         *
+         * 创建后台发送线程，重复调用无副作用。
+         */
+        void StartStream(size_t queue_capacity = kDefaultSendQueueCapacity, bool compact = false)
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (sender_)
+            {
+                return;
+            }
+            queue_capacity_ = std::max<size_t>(queue_capacity, 1);
+            send_ring_.resize(queue_capacity_);
+            ring_head_ = 0;
+            ring_size_ = 0;
+            compact_ = compact;
+            stopping_ = false;
+            sender_ = std::make_unique<std::thread>([this]() { SendLoop(); });
+        }
+
+        /**
+         * @brief 把一条采样拷贝进发送队列（非阻塞）
+         * @param monito_info 要发送的监控信息（可以在Arena上，调用返回后即可回收）
+         * @return bool 队列未满返回true；队列已满时丢弃最旧的一条采样并返回false
+         *
+         * 背压策略：服务器变慢或连接中断时队列逐渐填满，此后每次入队都挤掉最旧的采样，
+         * 采集线程永远不会阻塞，恢复后服务器收到的是最新的数据。
+         *
+         * 队列是预先分配的环形缓冲区，槽位中的消息循环复用：CopyFrom复用槽位里上一轮留下的
+         * 子消息和字符串缓冲区，结构不变的采样（CPU数、网卡数不变）入队时不做堆分配。
+         */
+        bool PushMonitorInfo(const monitor::proto::MonitorInfo& monito_info)
+        {
+            return Enqueue(monito_info, [&](monitor::proto::MonitorInfo* slot) { slot->CopyFrom(monito_info); });
+        }
+
+        /**
+         * @brief 把一条采样移动进发送队列（非阻塞）
+         * @param monito_info 要发送的监控信息（堆上的消息与槽位交换内容，不拷贝）
+         * @return bool 同PushMonitorInfo(const MonitorInfo&)
+         *
+         * Arena上的消息请使用const引用版本：跨Arena交换会退化为深拷贝。
+         */
+        bool PushMonitorInfo(monitor::proto::MonitorInfo&& monito_info)
+        {
+            return Enqueue(monito_info, [&](monitor::proto::MonitorInfo* slot) { slot->Swap(&monito_info); });
+        }
+
+        /**
+         * @brief 停止流式上报
+         *
+         * 取消正在进行的写入，结束当前流并等待发送线程退出，队列中未发送的采样被丢弃。
+         */
+        void StopStream()
+        {
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                if (!sender_)
+                {
+                    return;
+                }
+                stopping_ = true;
+                if (stream_context_)
+                {
+                    stream_context_->TryCancel();
+                }
+            }
+            queue_cv_.notify_all();
+            sender_->join();
+            sender_.reset();
+        }
+
+        /**
+         * @brief 获取因队列已满被丢弃的采样数
+         * @return uint64_t 丢弃条数（启用落盘缓冲时为日志超出上限被删除的采样数）
+         */
+        uint64_t DroppedCount()
+        {
+            uint64_t dropped = 0;
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                dropped = dropped_;
+            }
+            std::lock_guard<std::mutex> lock(spill_mutex_);
+            return dropped + (spill_ ? spill_->DroppedRecords() : 0);
+        }
+
     private:
+        /// @brief 重连退避的初始/最大等待时间
+        static constexpr std::chrono::milliseconds kMinReconnectBackoff{100};
+        static constexpr std::chrono::milliseconds kMaxReconnectBackoff{5000};
+
+        /// @brief 每条新流开始重放前的最大随机延迟：大量采集端同时恢复连接时错开重放
+        static constexpr std::chrono::milliseconds kMaxReplayJitter{2000};
+
+        /**
+         * @brief 发送线程主循环
+         *
+         * 详细执行流程：
+         * 1. 建立上报流（wait_for_ready：服务器未启动时等待连接而不是立即失败），
+         *    紧凑格式使用StreamCompactMonitorInfo，每条流使用新的编码器（字典和差分状态从头开始）
+         * 2. 从发送队列取出采样依次写入，队列为空时等待
+         * 3. 写入失败说明流已断开：结束该流，失败的采样保留到下一条流重新发送，退避后重新建立流
+         * 4. 服务器不支持紧凑格式（UNIMPLEMENTED）时立即改用完整格式重建流
+         * 5. 停止时调用WritesDone正常结束流
+         */
+        void SendLoop()
+        {
+            auto backoff = kMinReconnectBackoff;
+            monitor::proto::MonitorInfo pending;
+            bool has_pending = false;
+
+            while (true)
+            {
+                // 建立新的流
+                auto context = std::make_unique<::grpc::ClientContext>();
+                context->set_wait_for_ready(true);
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    if (stopping_)
+                    {
+                        return;
+                    }
+                    stream_context_ = context.get();
+                }
+                ::google::protobuf::Empty response;
+                ::grpc::Status status;
+                const bool compact = compact_;
+                StartReplayWindow();
+                if (compact)
+                {
+                    auto writer = stub_ptr_->StreamCompactMonitorInfo(context.get(), &response);
+                    CompactEncoder encoder;
+                    monitor::proto::CompactFrame frame;
+                    status = FinishStream(writer.get(), WriteQueue([&](const monitor::proto::MonitorInfo& info) {
+                        encoder.Encode(info, &frame);
+                        return TimedWrite(writer.get(), frame);
+                    }, &pending, &has_pending, &backoff));
+                }
+                else
+                {
+                    auto writer = stub_ptr_->StreamMonitorInfo(context.get(), &response);
+                    status = FinishStream(writer.get(), WriteQueue([&](const monitor::proto::MonitorInfo& info) {
+                        return TimedWrite(writer.get(), info);
+                    }, &pending, &has_pending, &backoff));
+                }
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    stream_context_ = nullptr;
+                    if (stopping_)
+                    {
+                        return;
+                    }
+                }
+
+                if (compact && status.error_code() == ::grpc::StatusCode::UNIMPLEMENTED)
+                {
+                    std::cout << "RPC StreamCompactMonitorInfo 服务器不支持，改用完整格式" << std::endl;
+                    compact_ = false;
+                    continue;
+                }
+
+                std::cout << "RPC StreamMonitorInfo 连接断开，" << backoff.count() << "ms后重连:" << std::endl;
+                std::cout << "  错误消息: " << status.error_message() << std::endl;
+                std::cout << "  错误代码: " << status.error_code() << std::endl;
+
+                // 退避等待，期间可被StopStream唤醒
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                queue_cv_.wait_for(lock, backoff, [this]() { return stopping_; });
+                backoff = std::min(backoff * 2, kMaxReconnectBackoff);
+            }
+        }
+
+        /**
+         * @brief 把发送队列中的采样依次写入当前流
+         * @param write 写入函数，返回false表示流已断开
+         * @param pending 待发送的采样（写入失败时保留）
+         * @param has_pending pending是否有效
+         * @param backoff 重连退避时间，写入成功后复位
+         * @return bool 流断开返回true，停止返回false
+         *
+         * 取采样的顺序：先取内存队列；队列为空且落盘缓冲中有采样时按令牌桶限速取日志的队首，
+         * 写入成功后才从日志中移除；日志取完且没有进行中的追加时退出落盘状态，之后的采样重新进入内存队列。
+         * 读取和移除日志记录只持有spill_mutex_，不阻塞采集线程入队。
+         */
+        template <typename WriteFn>
+        bool WriteQueue(WriteFn&& write, monitor::proto::MonitorInfo* pending, bool* has_pending,
+            std::chrono::milliseconds* backoff)
+        {
+            while (true)
+            {
+                if (!*has_pending)
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex_);
+                    while (true)
+                    {
+                        if (stopping_)
+                        {
+                            return false;
+                        }
+                        if (ring_size_ > 0)
+                        {
+                            // 与队首槽位交换：pending中已发送的旧消息留在槽位里，供下一次入队复用
+                            pending->Swap(&send_ring_[ring_head_]);
+                            ring_head_ = (ring_head_ + 1) % send_ring_.size();
+                            --ring_size_;
+                            pending_from_spill_ = false;
+                            break;
+                        }
+                        if (spilling_)
+                        {
+                            if (spill_appending_ == 0)
+                            {
+                                // 没有进行中的追加时其他线程不持有spill_mutex_，这里不会等待磁盘IO
+                                std::lock_guard<std::mutex> spill_lock(spill_mutex_);
+                                if (spill_->Empty())
+                                {
+                                    spilling_ = false;   // 已追上
+                                    continue;
+                                }
+                            }
+                            const auto wait = AcquireReplayToken();
+                            if (wait.count() > 0)
+                            {
+                                queue_cv_.wait_for(lock, wait);
+                                continue;
+                            }
+
+                            // 读取日志（可能读磁盘）期间释放queue_mutex_
+                            lock.unlock();
+                            bool empty = false;
+                            bool parsed = false;
+                            {
+                                std::lock_guard<std::mutex> spill_lock(spill_mutex_);
+                                empty = spill_->Empty();
+                                parsed = !empty && spill_->Front(pending);
+                                if (!empty && !parsed)
+                                {
+                                    spill_->PopFront();   // 无法解析的记录直接跳过
+                                }
+                            }
+                            lock.lock();
+                            if (parsed)
+                            {
+                                pending_from_spill_ = true;
+                                break;
+                            }
+                            if (empty && spill_appending_ > 0)
+                            {
+                                queue_cv_.wait(lock);   // 等待进行中的追加完成
+                            }
+                            continue;
+                        }
+                        queue_cv_.wait(lock);
+                    }
+                    *has_pending = true;
+                }
+
+                if (!write(*pending))
+                {
+                    return true;
+                }
+                *has_pending = false;
+                *backoff = kMinReconnectBackoff;
+                if (pending_from_spill_)
+                {
+                    std::lock_guard<std::mutex> lock(spill_mutex_);
+                    spill_->PopFront();
+                }
+            }
+        }
+
+        /**
+         * @brief 开始一条新流时重置重放令牌桶（调用者无需持锁）
+         *
+         * 令牌从负的随机值开始，第一条重放推迟[0, kMaxReplayJitter)；之后按replay_rate_补充，
+         * 桶容量为一秒的令牌。
+         */
+        void StartReplayWindow()
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            std::uniform_real_distribution<double> jitter(0.0, std::chrono::duration<double>(kMaxReplayJitter).count());
+            replay_tokens_ = -jitter(replay_random_) * replay_rate_;
+            replay_refill_ = std::chrono::steady_clock::now();
+        }
+
+        /**
+         * @brief 从重放令牌桶取一个令牌（调用者持有queue_mutex_）
+         * @return std::chrono::milliseconds 取到时返回0，否则返回需要等待的时间
+         */
+        std::chrono::milliseconds AcquireReplayToken()
+        {
+            const auto now = std::chrono::steady_clock::now();
+            replay_tokens_ = std::min(replay_tokens_ + std::chrono::duration<double>(now - replay_refill_).count() *
+                replay_rate_, std::max(replay_rate_, 1.0));
+            replay_refill_ = now;
+            if (replay_tokens_ >= 1.0)
+            {
+                replay_tokens_ -= 1.0;
+                return std::chrono::milliseconds(0);
+            }
+            return std::chrono::milliseconds(static_cast<int64_t>((1.0 - replay_tokens_) / replay_rate_ * 1000.0) + 1);
+        }
+
+        /**
+         * @brief 写入一条消息，设置了上报观察者时统计耗时和字节数
+         * @param writer 流写入器
+         * @param message 消息（MonitorInfo或CompactFrame）
+         * @return bool 写入成功返回true
+         *
+         * 流式写入的耗时是消息交给gRPC并通过流控所需的时间，服务器变慢时随之增大。
+         */
+        template <typename Writer, typename Message>
+        bool TimedWrite(Writer* writer, const Message& message)
+        {
+            if (!send_observer_)
+            {
+                return writer->Write(message);
+            }
+            const auto start = std::chrono::steady_clock::now();
+            if (!writer->Write(message))
+            {
+                return false;
+            }
+            send_observer_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count(), message.ByteSizeLong());
+            return true;
+        }
+
+        /**
+         * @brief 向环形发送队列写入一条采样
+         * @param info 采样（写入落盘缓冲时使用）
+         * @param fill 填充槽位的函数
+         * @return bool 队列未满返回true；队列已满时覆盖最旧的一条采样并返回false
+         *
+         * 启用落盘缓冲时，队列已满或正在重放日志的采样追加到日志末尾（保持时间顺序），
+         * 不丢弃内存队列中的采样；写入日志失败时计入日志的丢弃数。
+         * 追加日志（可能fsync）只持有spill_mutex_，不持有queue_mutex_：
+         * 发送线程取内存队列和判断是否退出落盘状态不会等待磁盘IO。
+         */
+        template <typename FillFn>
+        bool Enqueue(const monitor::proto::MonitorInfo& info, FillFn&& fill)
+        {
+            bool accepted = true;
+            bool spill = false;
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                if (send_ring_.empty())
+                {
+                    send_ring_.resize(queue_capacity_);   // 未调用StartStream时按默认容量分配
+                }
+                if (spill_ && (spilling_ || ring_size_ >= send_ring_.size()))
+                {
+                    spilling_ = true;
+                    ++spill_appending_;   // 追加完成前发送线程不会退出落盘状态
+                    spill = true;
+                }
+                else
+                {
+                    if (ring_size_ >= send_ring_.size())
+                    {
+                        // 队列已满：丢弃最旧的一条，其槽位直接用于新采样
+                        ring_head_ = (ring_head_ + 1) % send_ring_.size();
+                        --ring_size_;
+                        ++dropped_;
+                        accepted = false;
+                    }
+                    fill(&send_ring_[(ring_head_ + ring_size_) % send_ring_.size()]);
+                    ++ring_size_;
+                }
+            }
+            if (spill)
+            {
+                {
+                    std::lock_guard<std::mutex> spill_lock(spill_mutex_);
+                    accepted = spill_->Append(info);
+                }
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                --spill_appending_;
+            }
+            queue_cv_.notify_one();
+            return accepted;
+        }
+
+        /**
+         * @brief 结束一条上报流
+         * @param writer 流写入器
+         * @param broken 流是否已断开（未断开时先调用WritesDone）
+         * @return ::grpc::Status 流的最终状态
+         */
+        template <typename Writer>
+        static ::grpc::Status FinishStream(Writer* writer, bool broken)
+        {
+            if (!broken)
+            {
+                writer->WritesDone();
+            }
+            return writer->Finish();
+        }
+
         /// @brief gRPC服务存根智能指针，自动管理资源
         std::unique_ptr<monitor::proto::GrpcManager::Stub> stub_ptr_;
+
+        /// @brief 上报观察者（启动上报前设置，之后只读）
+        SendObserver send_observer_;
+
+        // ==================== 流式上报状态 ====================
+        std::mutex queue_mutex_;                                  ///< 保护以下所有成员
+        std::condition_variable queue_cv_;                        ///< 新采样或停止通知
+        std::vector<monitor::proto::MonitorInfo> send_ring_;      ///< 有界发送队列（环形缓冲区，槽位复用）
+        size_t ring_head_ = 0;                                    ///< 队首槽位
+        size_t ring_size_ = 0;                                    ///< 队列中的采样数
+        size_t queue_capacity_ = kDefaultSendQueueCapacity;       ///< 发送队列容量
+        uint64_t dropped_ = 0;                                    ///< 因队列已满丢弃的采样数
+        bool stopping_ = false;                                   ///< 停止标志
+        bool compact_ = false;                                    ///< 使用紧凑格式（仅发送线程在运行期间修改）
+        ::grpc::ClientContext* stream_context_ = nullptr;         ///< 当前流的上下文（用于取消）
+        std::unique_ptr<std::thread> sender_;                     ///< 后台发送线程
+
+        // ==================== 落盘缓冲状态（queue_mutex_保护，日志本身由spill_mutex_保护） ====================
+        std::mutex spill_mutex_;                                  ///< 保护spill_指向的日志（追加、读取、移除）
+        std::unique_ptr<SpillLog> spill_;                         ///< 落盘缓冲，未启用时为空（EnableSpill后不再改变）
+        bool spilling_ = false;                                   ///< 日志中有待重放的采样，新采样也追加到日志
+        size_t spill_appending_ = 0;                              ///< 已决定追加、尚未写入日志的采样数
+        double replay_rate_ = 1.0;                                ///< 重放限速（条/秒）
+        double replay_tokens_ = 0.0;                              ///< 重放令牌桶
+        std::chrono::steady_clock::time_point replay_refill_;     ///< 上次补充令牌的时间
+        std::minstd_rand replay_random_{std::random_device{}()};  ///< 重放起始抖动
+        bool pending_from_spill_ = false;                         ///< 待发送的采样来自日志（仅发送线程访问）
+
+        // ==================== 订阅状态 ====================
+        std::mutex subscribe_mutex_;                              ///< 保护subscribe_context_
+        ::grpc::ClientContext* subscribe_context_ = nullptr;      ///< 进行中的订阅的上下文（用于取消）
     };
 }  // namespace monitor
@@ -0,0 +1,579 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// 系统调用头文件
+#include <dirent.h>       // opendir、readdir
+#include <fcntl.h>        // open
+#include <sys/mman.h>     // mmap、msync、munmap
+#include <sys/stat.h>     // fstat、mkdir
+#include <unistd.h>       // ftruncate、close、unlink、sysconf
+
+// C++标准库头文件
+#include <algorithm>      // std::sort
+#include <array>          // CRC表
+#include <cerrno>         // errno
+#include <chrono>         // 定时同步
+#include <cstdint>        // uint32_t、uint64_t
+#include <cstdio>         // std::snprintf
+#include <cstring>        // std::memcpy、std::strerror
+#include <deque>          // 段队列
+#include <string>         // 目录和错误描述
+#include <vector>         // 恢复时的段序号
+
+// Protobuf生成的头文件
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+    /**
+     * @brief 采集端本地落盘缓冲（有界、内存映射、只追加的分段日志）
+     *
+     * 服务器不可达时发送队列填满后的采样不再丢弃，而是写入本日志；重新连接后由RpcClient
+     * 按写入顺序限速重放。进程重启后目录中未重放完的段自动恢复。
+     *
+     * 文件布局：目录下的spill-<序号>.log，每段固定大小（ftruncate预分配），MAP_SHARED映射：
+     *
+     *   [段头 64字节：magic、已重放偏移][记录][记录]...[长度0表示结束]
+     *   记录 = [uint32 长度][uint32 CRC32][序列化的MonitorInfo]
+     *
+     * - 追加只是一次memcpy（直接序列化到映射区），同步策略决定何时msync
+     * - 已重放偏移写在段头中（不单独同步），崩溃后最多重复重放一个同步周期内的记录
+     * - 恢复时逐条校验CRC，遇到撕裂写（长度越界或CRC不符）即认为该段到此结束
+     * - 每条记录之后紧跟一个长度0作为结束标记：在恢复的段上继续追加时，旧数据中CRC仍然正确的
+     *   残留记录不会在下次恢复时被重放
+     * - 段数达到上限时删除最旧的段（其中未重放的记录计入丢弃数），总占用不超过
+     *   segment_bytes × max_segments
+     * - 只映射队首（读）和队尾（写）两个段，中间的段不占用地址空间和常驻内存
+     *
+     * 线程模型：非线程安全，由RpcClient在日志锁（spill_mutex_）内调用。
+     */
+    class SpillLog
+    {
+    public:
+        /**
+         * @brief 同步策略
+         */
+        enum class SyncPolicy
+        {
+            NONE,       ///< 不主动同步，由内核回写（进程崩溃不丢数据，主机掉电可能丢失）
+            RECORD,     ///< 每条记录写入后msync（最安全，每条采样一次磁盘写）
+            INTERVAL    ///< 距上次同步超过sync_interval时msync
+        };
+
+        /**
+         * @brief 日志配置
+         */
+        struct Options
+        {
+            std::string dir;                                    ///< 段文件目录（不存在时创建）
+            size_t segment_bytes = 8 * 1024 * 1024;             ///< 每段大小
+            size_t max_segments = 16;                           ///< 最多保留的段数
+            SyncPolicy sync = SyncPolicy::INTERVAL;             ///< 同步策略
+            std::chrono::milliseconds sync_interval{1000};      ///< INTERVAL策略的同步周期
+        };
+
+        SpillLog() = default;
+        ~SpillLog() { Close(); }
+
+        // 持有映射和fd，禁止拷贝
+        SpillLog(const SpillLog&) = delete;
+        SpillLog& operator=(const SpillLog&) = delete;
+
+        /**
+         * @brief 解析同步策略（对应--spill_fsync选项）
+         * @param text "none"、"always"或同步周期的毫秒数
+         * @param options 输出参数，设置sync和sync_interval
+         * @return bool 格式正确返回true
+         */
+        static bool ParseSyncPolicy(const std::string& text, Options* options)
+        {
+            if (text == "none")
+            {
+                options->sync = SyncPolicy::NONE;
+                return true;
+            }
+            if (text == "always")
+            {
+                options->sync = SyncPolicy::RECORD;
+                return true;
+            }
+            if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+            {
+                return false;
+            }
+            options->sync = SyncPolicy::INTERVAL;
+            options->sync_interval = std::chrono::milliseconds(std::stoll(text));
+            return true;
+        }
+
+        /**
+         * @brief 打开日志目录并恢复已有的段
+         * @param options 日志配置
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true
+         */
+        bool Open(const Options& options, std::string* error)
+        {
+            Close();
+            options_ = options;
+            const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            options_.segment_bytes = std::max((options_.segment_bytes + page - 1) / page * page, page);
+            options_.max_segments = std::max<size_t>(options_.max_segments, 2);
+
+            if (::mkdir(options_.dir.c_str(), 0755) != 0 && errno != EEXIST)
+            {
+                *error = "创建落盘目录" + options_.dir + "失败: " + std::strerror(errno);
+                return false;
+            }
+
+            // 按序号恢复已有的段
+            std::vector<uint64_t> seqs;
+            DIR* dir = ::opendir(options_.dir.c_str());
+            if (dir == nullptr)
+            {
+                *error = "打开落盘目录" + options_.dir + "失败: " + std::strerror(errno);
+                return false;
+            }
+            while (struct dirent* entry = ::readdir(dir))
+            {
+                unsigned long long seq = 0;
+                char suffix = 0;
+                if (std::sscanf(entry->d_name, "spill-%llu.lo%c", &seq, &suffix) == 2 && suffix == 'g')
+                {
+                    seqs.push_back(seq);
+                }
+            }
+            ::closedir(dir);
+            std::sort(seqs.begin(), seqs.end());
+
+            for (uint64_t seq : seqs)
+            {
+                Segment segment;
+                segment.seq = seq;
+                if (!Recover(&segment))
+                {
+                    ::unlink(SegmentPath(seq).c_str());   // 损坏或已重放完的段
+                    continue;
+                }
+                segments_.push_back(segment);
+                next_seq_ = seq + 1;
+            }
+            while (segments_.size() > options_.max_segments)
+            {
+                DropFront();
+            }
+            for (size_t i = 1; i + 1 < segments_.size(); ++i)
+            {
+                Unmap(&segments_[i]);   // 只保留队首和队尾的映射
+            }
+            last_sync_ = std::chrono::steady_clock::now();
+            return true;
+        }
+
+        /**
+         * @brief 追加一条采样
+         * @param info 采样
+         * @return bool 成功返回true；记录超过段大小或磁盘错误时返回false（计入丢弃数）
+         */
+        bool Append(const monitor::proto::MonitorInfo& info)
+        {
+            const size_t payload = info.ByteSizeLong();
+            const size_t record = kRecordHeader + payload;
+            if (record > options_.segment_bytes - kSegmentHeader)
+            {
+                ++dropped_;
+                return false;
+            }
+
+            if (segments_.empty() || segments_.back().write_offset + record > options_.segment_bytes)
+            {
+                if (!segments_.empty())
+                {
+                    Sync(&segments_.back());   // 段已写满，同步剩余部分
+                    if (segments_.size() > 1)
+                    {
+                        Unmap(&segments_.back());
+                    }
+                }
+                if (segments_.size() >= options_.max_segments)
+                {
+                    DropFront();
+                }
+                if (!CreateSegment())
+                {
+                    ++dropped_;
+                    return false;
+                }
+            }
+
+            Segment& tail = segments_.back();
+            char* base = tail.base + tail.write_offset;
+            info.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(base + kRecordHeader));
+            const uint32_t length = static_cast<uint32_t>(payload);
+            const uint32_t crc = Crc32(base + kRecordHeader, payload);
+            Terminate(tail, tail.write_offset + record);   // 先写结束标记，再发布本条记录的长度
+            std::memcpy(base + 4, &crc, sizeof(crc));
+            std::memcpy(base, &length, sizeof(length));
+            tail.write_offset += record;
+            ++records_;
+
+            const auto now = std::chrono::steady_clock::now();
+            if (options_.sync == SyncPolicy::RECORD ||
+                (options_.sync == SyncPolicy::INTERVAL && now - last_sync_ >= options_.sync_interval))
+            {
+                Sync(&tail);
+                last_sync_ = now;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 日志中是否没有待重放的记录
+         * @return bool 为空返回true
+         */
+        bool Empty() const { return records_ == 0; }
+
+        /**
+         * @brief 待重放的记录数
+         * @return uint64_t 记录数
+         */
+        uint64_t Records() const { return records_; }
+
+        /**
+         * @brief 因段数超限或写入失败丢弃的记录数
+         * @return uint64_t 累计丢弃数
+         */
+        uint64_t DroppedRecords() const { return dropped_; }
+
+        /**
+         * @brief 读取最旧的一条待重放记录（不移除）
+         * @param info 输出参数，解析出的采样
+         * @return bool 成功返回true；日志为空或记录无法解析时返回false（无法解析的记录由PopFront跳过）
+         */
+        bool Front(monitor::proto::MonitorInfo* info)
+        {
+            if (!SkipExhausted())
+            {
+                return false;
+            }
+            Segment& head = segments_.front();
+            uint32_t length = 0;
+            std::memcpy(&length, head.base + head.read_offset, sizeof(length));
+            peek_seq_ = head.seq;
+            peek_offset_ = head.read_offset;
+            return info->ParseFromArray(head.base + head.read_offset + kRecordHeader, static_cast<int>(length));
+        }
+
+        /**
+         * @brief 移除Front读取的记录（重放成功后调用）
+         *
+         * Front之后队首段可能已因段数超限被删除，此时不做任何操作。
+         */
+        void PopFront()
+        {
+            if (segments_.empty() || segments_.front().seq != peek_seq_ ||
+                segments_.front().read_offset != peek_offset_ || segments_.front().base == nullptr)
+            {
+                return;
+            }
+            Segment& head = segments_.front();
+            uint32_t length = 0;
+            std::memcpy(&length, head.base + head.read_offset, sizeof(length));
+            head.read_offset += kRecordHeader + length;
+            StoreReadOffset(head);
+            --records_;
+            SkipExhausted();
+        }
+
+    private:
+        /// @brief 段头大小：magic(8) + 已重放偏移(8)，其余保留
+        static constexpr size_t kSegmentHeader = 64;
+
+        /// @brief 记录头大小：长度(4) + CRC32(4)
+        static constexpr size_t kRecordHeader = 8;
+
+        /// @brief 段文件的magic
+        static constexpr char kMagic[8] = {'M', 'O', 'N', 'S', 'P', 'I', 'L', '1'};
+
+        /**
+         * @brief 一个段
+         */
+        struct Segment
+        {
+            uint64_t seq = 0;             ///< 序号（文件名）
+            int fd = -1;                  ///< 段文件fd
+            char* base = nullptr;         ///< 映射地址，未映射时为空
+            size_t write_offset = 0;      ///< 下一条记录的写入位置
+            size_t read_offset = 0;       ///< 下一条待重放记录的位置
+            size_t synced_offset = 0;     ///< 已同步到的位置
+        };
+
+        /**
+         * @brief IEEE 802.3 CRC32（查表法）
+         */
+        static uint32_t Crc32(const char* data, size_t size)
+        {
+            static const std::array<uint32_t, 256> table = []() {
+                std::array<uint32_t, 256> result{};
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+                    }
+                    result[i] = crc;
+                }
+                return result;
+            }();
+            uint32_t crc = 0xFFFFFFFFu;
+            for (size_t i = 0; i < size; ++i)
+            {
+                crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+            }
+            return crc ^ 0xFFFFFFFFu;
+        }
+
+        std::string SegmentPath(uint64_t seq) const
+        {
+            char name[48];
+            std::snprintf(name, sizeof(name), "/spill-%020llu.log", static_cast<unsigned long long>(seq));
+            return options_.dir + name;
+        }
+
+        bool Map(Segment* segment)
+        {
+            if (segment->base != nullptr)
+            {
+                return true;
+            }
+            void* base = ::mmap(nullptr, options_.segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+            if (base == MAP_FAILED)
+            {
+                return false;
+            }
+            segment->base = static_cast<char*>(base);
+            return true;
+        }
+
+        void Unmap(Segment* segment)
+        {
+            if (segment->base != nullptr)
+            {
+                ::munmap(segment->base, options_.segment_bytes);
+                segment->base = nullptr;
+            }
+        }
+
+        /**
+         * @brief 在offset处写长度0的结束标记（剩余空间放不下记录头时恢复本来就会停止，不需要标记）
+         * @param segment 已映射的段
+         * @param offset 最后一条有效记录之后的位置
+         */
+        void Terminate(const Segment& segment, size_t offset)
+        {
+            if (offset + kRecordHeader <= options_.segment_bytes)
+            {
+                const uint32_t end = 0;
+                std::memcpy(segment.base + offset, &end, sizeof(end));
+            }
+        }
+
+        /**
+         * @brief 把段中未同步的部分（结束标记和段头）写回磁盘
+         */
+        void Sync(Segment* segment)
+        {
+            if (segment->base == nullptr || segment->synced_offset >= segment->write_offset)
+            {
+                return;
+            }
+            const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const size_t begin = segment->synced_offset / page * page;
+            const size_t end = std::min(segment->write_offset + sizeof(uint32_t), options_.segment_bytes);
+            ::msync(segment->base + begin, end - begin, MS_SYNC);
+            if (begin != 0)
+            {
+                ::msync(segment->base, page, MS_ASYNC);   // 段头中的已重放偏移
+            }
+            segment->synced_offset = segment->write_offset;
+        }
+
+        void StoreReadOffset(const Segment& segment)
+        {
+            const uint64_t offset = segment.read_offset;
+            std::memcpy(segment.base + sizeof(kMagic), &offset, sizeof(offset));
+        }
+
+        /**
+         * @brief 恢复一个已有的段
+         * @param segment 输入序号，输出fd、映射和偏移
+         * @return bool 段中还有待重放的记录返回true
+         */
+        bool Recover(Segment* segment)
+        {
+            segment->fd = ::open(SegmentPath(segment->seq).c_str(), O_RDWR | O_CLOEXEC);
+            struct stat st;
+            if (segment->fd < 0 || ::fstat(segment->fd, &st) != 0 ||
+                static_cast<size_t>(st.st_size) != options_.segment_bytes || !Map(segment) ||
+                std::memcmp(segment->base, kMagic, sizeof(kMagic)) != 0)
+            {
+                CloseSegment(segment);   // 段大小配置变化或不是本格式的文件
+                return false;
+            }
+
+            uint64_t read_offset = 0;
+            std::memcpy(&read_offset, segment->base + sizeof(kMagic), sizeof(read_offset));
+            size_t offset = kSegmentHeader;
+            uint64_t unread = 0;
+            while (offset + kRecordHeader <= options_.segment_bytes)
+            {
+                uint32_t length = 0;
+                uint32_t crc = 0;
+                std::memcpy(&length, segment->base + offset, sizeof(length));
+                std::memcpy(&crc, segment->base + offset + 4, sizeof(crc));
+                if (length == 0 || offset + kRecordHeader + length > options_.segment_bytes ||
+                    Crc32(segment->base + offset + kRecordHeader, length) != crc)
+                {
+                    break;
+                }
+                if (offset >= read_offset)
+                {
+                    ++unread;
+                }
+                offset += kRecordHeader + length;
+            }
+            Terminate(*segment, offset);   // 撕裂写或旧格式的段：截断在这里，之后的追加从这里覆盖
+            segment->write_offset = offset;
+            segment->synced_offset = offset;
+            segment->read_offset = std::max<size_t>(std::min<size_t>(read_offset, offset), kSegmentHeader);
+            if (unread == 0)
+            {
+                CloseSegment(segment);
+                return false;
+            }
+            records_ += unread;
+            return true;
+        }
+
+        bool CreateSegment()
+        {
+            Segment segment;
+            segment.seq = next_seq_++;
+            const std::string path = SegmentPath(segment.seq);
+            segment.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (segment.fd < 0 || ::ftruncate(segment.fd, static_cast<off_t>(options_.segment_bytes)) != 0 ||
+                !Map(&segment))
+            {
+                CloseSegment(&segment);
+                ::unlink(path.c_str());
+                return false;
+            }
+            std::memcpy(segment.base, kMagic, sizeof(kMagic));
+            segment.write_offset = kSegmentHeader;
+            segment.read_offset = kSegmentHeader;
+            StoreReadOffset(segment);
+            segments_.push_back(segment);
+            return true;
+        }
+
+        void CloseSegment(Segment* segment)
+        {
+            Unmap(segment);
+            if (segment->fd >= 0)
+            {
+                ::close(segment->fd);
+                segment->fd = -1;
+            }
+        }
+
+        /**
+         * @brief 删除最旧的段，其中未重放的记录计入丢弃数
+         */
+        void DropFront()
+        {
+            Segment& head = segments_.front();
+            const uint64_t unread = CountUnread(&head);
+            dropped_ += unread;
+            records_ -= unread;
+            CloseSegment(&head);
+            ::unlink(SegmentPath(head.seq).c_str());
+            segments_.pop_front();
+        }
+
+        /**
+         * @brief 统计段中read_offset之后的记录数
+         */
+        uint64_t CountUnread(Segment* segment)
+        {
+            if (!Map(segment))
+            {
+                return 0;
+            }
+            uint64_t count = 0;
+            size_t offset = segment->read_offset;
+            while (offset < segment->write_offset)
+            {
+                uint32_t length = 0;
+                std::memcpy(&length, segment->base + offset, sizeof(length));
+                offset += kRecordHeader + length;
+                ++count;
+            }
+            return count;
+        }
+
+        /**
+         * @brief 删除已重放完的队首段，并映射新的队首段
+         * @return bool 还有待重放的记录返回true
+         */
+        bool SkipExhausted()
+        {
+            while (!segments_.empty())
+            {
+                Segment& head = segments_.front();
+                if (!Map(&head))
+                {
+                    DropFront();
+                    continue;
+                }
+                if (head.read_offset < head.write_offset)
+                {
+                    return true;
+                }
+                if (segments_.size() == 1)
+                {
+                    return false;   // 当前写入段，后续记录追加到这里
+                }
+                CloseSegment(&head);
+                ::unlink(SegmentPath(head.seq).c_str());
+                segments_.pop_front();
+            }
+            return false;
+        }
+
+        void Close()
+        {
+            for (Segment& segment : segments_)
+            {
+                Sync(&segment);
+                if (segment.base != nullptr)
+                {
+                    StoreReadOffset(segment);
+                    ::msync(segment.base, kSegmentHeader, MS_SYNC);
+                }
+                CloseSegment(&segment);
+            }
+            segments_.clear();
+            records_ = 0;
+        }
+
+        Options options_;                                       ///< 日志配置
+        std::deque<Segment> segments_;                          ///< 按序号排列的段（队首最旧）
+        uint64_t next_seq_ = 0;                                 ///< 下一个新段的序号
+        uint64_t records_ = 0;                                  ///< 待重放的记录数
+        uint64_t dropped_ = 0;                                  ///< 累计丢弃的记录数
+        uint64_t peek_seq_ = 0;                                 ///< Front读取的记录所在段
+        size_t peek_offset_ = 0;                                ///< Front读取的记录位置
+        std::chrono::steady_clock::time_point last_sync_;       ///< 上次同步时间
+    };
+}  // namespace monitor
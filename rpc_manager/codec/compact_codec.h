@@ -0,0 +1,614 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cmath>          // std::llround、std::isnan
+#include <cstdint>        // int64_t、uint32_t
+#include <limits>         // 量化值的哨兵
+#include <string>         // 实例名
+#include <unordered_map>  // 实例名到id
+#include <vector>         // 分组布局、差分状态
+
+// Protobuf头文件
+#include <google/protobuf/io/coded_stream.h>   // 变长整数编码
+
+// Protobuf生成的头文件
+#include "compact_info.pb.h"
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+    /**
+     * @brief 紧凑格式的分组布局
+     *
+     * 编码器和解码器共用：由MonitorInfo的描述符推导每个消息字段（分组）
+     * 的实例名字段和数值字段，新增的监控字段无需修改编解码代码。
+     * 标记为snapshot_only的分组不参与字典和差分，按MonitorInfo的编码原样放入snapshot_fields。
+     */
+    class CompactLayout
+    {
+    public:
+        /**
+         * @brief 一个分组的布局
+         */
+        struct Group
+        {
+            const google::protobuf::FieldDescriptor* field = nullptr;            ///< MonitorInfo中的消息字段
+            const google::protobuf::FieldDescriptor* instance_field = nullptr;   ///< 实例名字段（单实例分组为空）
+            std::vector<const google::protobuf::FieldDescriptor*> value_fields;  ///< 数值字段，按字段编号顺序
+            bool snapshot_only = false;                                          ///< 原样发送，不做字典和差分
+        };
+
+        /**
+         * @brief 获取所有分组的布局（进程内只推导一次）
+         * @return const std::vector<Group>& 按MonitorInfo字段序号索引，非消息字段的field为空
+         */
+        static const std::vector<Group>& Groups()
+        {
+            static const std::vector<Group> groups = Build();
+            return groups;
+        }
+
+        /**
+         * @brief 按字段编号查找分组
+         * @param number MonitorInfo中的字段编号
+         * @return const Group* 不是消息字段时返回nullptr
+         */
+        static const Group* FindByNumber(uint32_t number)
+        {
+            const google::protobuf::FieldDescriptor* field =
+                monitor::proto::MonitorInfo::descriptor()->FindFieldByNumber(static_cast<int>(number));
+            if (field == nullptr)
+            {
+                return nullptr;
+            }
+            const Group& group = Groups()[field->index()];
+            return group.field ? &group : nullptr;
+        }
+
+    private:
+        static std::vector<Group> Build()
+        {
+            using google::protobuf::FieldDescriptor;
+            const google::protobuf::Descriptor* descriptor = monitor::proto::MonitorInfo::descriptor();
+            std::vector<Group> groups(descriptor->field_count());
+            for (int i = 0; i < descriptor->field_count(); ++i)
+            {
+                const FieldDescriptor* field = descriptor->field(i);
+                if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE)
+                {
+                    continue;
+                }
+                Group& group = groups[i];
+                group.field = field;
+                group.snapshot_only = field->options().GetExtension(monitor::proto::snapshot_only);
+
+                const google::protobuf::Descriptor* element = field->message_type();
+                for (int j = 0; j < element->field_count(); ++j)
+                {
+                    const FieldDescriptor* child = element->field(j);
+                    if (child->is_repeated())
+                    {
+                        continue;
+                    }
+                    switch (child->cpp_type())
+                    {
+                    case FieldDescriptor::CPPTYPE_STRING:
+                        if (field->is_repeated() && group.instance_field == nullptr)
+                        {
+                            group.instance_field = child;
+                        }
+                        break;
+                    case FieldDescriptor::CPPTYPE_FLOAT:
+                    case FieldDescriptor::CPPTYPE_DOUBLE:
+                    case FieldDescriptor::CPPTYPE_INT32:
+                    case FieldDescriptor::CPPTYPE_INT64:
+                    case FieldDescriptor::CPPTYPE_UINT32:
+                    case FieldDescriptor::CPPTYPE_UINT64:
+                        group.value_fields.push_back(child);
+                        break;
+                    default:
+                        break;
+                    }
+                }
+            }
+            return groups;
+        }
+    };
+
+    /**
+     * @brief 浮点字段的量化，编码器和解码器共用
+     *
+     * round(值 × float_scale)只对有限且不超过±kLimit的结果有定义（llround对NaN、无穷和
+     * 超出int64的值是未定义行为），其余值映射为保留的哨兵，解码时还原：
+     * - NaN → kNaN（INT64_MIN），±无穷 → kPositiveInfinity / kNegativeInfinity
+     * - 超出±kLimit的有限值截断到±kLimit
+     * 差值按uint64回绕计算（哨兵与普通值相减不会溢出），解码端以相同的回绕相加还原。
+     */
+    struct CompactQuantizer
+    {
+        static constexpr int64_t kNaN = std::numeric_limits<int64_t>::min();                 ///< NaN
+        static constexpr int64_t kNegativeInfinity = std::numeric_limits<int64_t>::min() + 1; ///< 负无穷
+        static constexpr int64_t kPositiveInfinity = std::numeric_limits<int64_t>::max();     ///< 正无穷
+        static constexpr int64_t kLimit = int64_t{1} << 62;                                   ///< 有限值的量化范围
+
+        /**
+         * @brief 量化一个浮点值
+         * @param value 原始值
+         * @param scale 量化系数
+         * @return int64_t 量化值或哨兵
+         */
+        static int64_t Quantize(double value, uint32_t scale)
+        {
+            if (std::isnan(value))
+            {
+                return kNaN;
+            }
+            if (std::isinf(value))
+            {
+                return value > 0 ? kPositiveInfinity : kNegativeInfinity;
+            }
+            const double scaled = value * scale;
+            if (!(scaled < static_cast<double>(kLimit)))
+            {
+                return kLimit;
+            }
+            if (!(scaled > -static_cast<double>(kLimit)))
+            {
+                return -kLimit;
+            }
+            return std::llround(scaled);
+        }
+
+        /**
+         * @brief 还原一个量化值
+         * @param value 量化值或哨兵
+         * @param scale 量化系数
+         * @return double 原始值（精度1 / scale）
+         */
+        static double Restore(int64_t value, uint32_t scale)
+        {
+            switch (value)
+            {
+            case kNaN:
+                return std::numeric_limits<double>::quiet_NaN();
+            case kNegativeInfinity:
+                return -std::numeric_limits<double>::infinity();
+            case kPositiveInfinity:
+                return std::numeric_limits<double>::infinity();
+            default:
+                return static_cast<double>(value) / scale;
+            }
+        }
+
+        /// @brief 差值（uint64回绕，任意两个int64相减都有定义）
+        static int64_t Delta(int64_t value, int64_t previous)
+        {
+            return static_cast<int64_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(previous));
+        }
+
+        /// @brief 由差值还原（Delta的逆运算）
+        static int64_t Apply(int64_t previous, int64_t delta)
+        {
+            return static_cast<int64_t>(static_cast<uint64_t>(previous) + static_cast<uint64_t>(delta));
+        }
+    };
+
+    /**
+     * @brief 紧凑格式编码器（客户端，一条流一个实例）
+     *
+     * 每条MonitorInfo编码为一个CompactFrame：
+     * - 实例名第一次出现时放入new_names并分配id，之后只发送id
+     * - 浮点字段量化为整数（CompactQuantizer，NaN和无穷为哨兵），非关键帧发送与该实例
+     *   上一次量化值的差（sint64，zigzag变长编码）
+     * - 流的第一帧、以及每keyframe_interval帧发送一次关键帧；
+     *   实例第一次出现时上一次值按0处理，差值即绝对值
+     * - snapshot_only分组（实例不断更替，如进程）按原始编码放入snapshot_fields，不占用字典和差分状态
+     * - 每kNameIdleFrames帧检查一次字典：此前kNameIdleFrames帧内没有出现过的实例（被删除的cgroup、
+     *   被移除的网卡）从字典删除并释放差分状态，id随帧的removed_names通知解码器，之后的新实例复用这些id
+     *
+     * 以256核主机的软中断为例：每个CPU 10个速率字段，完整格式每个CPU约60字节，
+     * 差分后大部分字段只占1~2字节，并省去了每帧重复的CPU名称。
+     */
+    class CompactEncoder
+    {
+    public:
+        /// @brief 默认浮点量化系数（精度0.01，与界面显示的小数位数一致）
+        static constexpr uint32_t kDefaultFloatScale = 100;
+
+        /// @brief 默认关键帧间隔（帧数）
+        static constexpr uint32_t kDefaultKeyframeInterval = 60;
+
+        /// @brief 实例连续这么多帧没有出现时从字典删除（1秒一帧约5分钟，删除后再出现只需重发一次名称）
+        static constexpr uint32_t kNameIdleFrames = 300;
+
+        /**
+         * @brief 构造函数
+         * @param float_scale 浮点量化系数
+         * @param keyframe_interval 关键帧间隔（帧数），0表示只有第一帧是关键帧
+         */
+        explicit CompactEncoder(uint32_t float_scale = kDefaultFloatScale,
+            uint32_t keyframe_interval = kDefaultKeyframeInterval)
+            : float_scale_(float_scale > 0 ? float_scale : 1), keyframe_interval_(keyframe_interval)
+        {
+            states_.resize(CompactLayout::Groups().size());
+        }
+
+        /**
+         * @brief 编码一条采样
+         * @param info 采样消息
+         * @param frame 输出参数，编码结果（会先清空，可复用）
+         */
+        void Encode(const monitor::proto::MonitorInfo& info, monitor::proto::CompactFrame* frame)
+        {
+            frame->Clear();
+            const bool keyframe = frames_ == 0 || (keyframe_interval_ > 0 && frames_ % keyframe_interval_ == 0);
+            if (frames_ == 0)
+            {
+                frame->set_host(info.name());
+                frame->set_host_group(info.host_group());
+                frame->set_float_scale(float_scale_);
+            }
+            frame->set_timestamp_ms(info.timestamp_ms());
+            frame->set_keyframe(keyframe);
+            if (frames_ > 0 && frames_ % kNameIdleFrames == 0)
+            {
+                EvictIdleNames(frame);   // 先于本帧的new_names，解码器按相同顺序处理
+            }
+
+            const google::protobuf::Reflection* reflection = info.GetReflection();
+            const std::vector<CompactLayout::Group>& groups = CompactLayout::Groups();
+            for (size_t g = 0; g < groups.size(); ++g)
+            {
+                const CompactLayout::Group& layout = groups[g];
+                if (layout.field == nullptr)
+                {
+                    continue;
+                }
+
+                if (layout.snapshot_only)
+                {
+                    EncodeSnapshotField(info, reflection, layout.field, frame->mutable_snapshot_fields());
+                }
+                else if (layout.field->is_repeated())
+                {
+                    const int count = reflection->FieldSize(info, layout.field);
+                    if (count == 0)
+                    {
+                        continue;
+                    }
+                    auto* out = frame->add_group();
+                    out->set_field(layout.field->number());
+                    for (int i = 0; i < count; ++i)
+                    {
+                        const google::protobuf::Message& element =
+                            reflection->GetRepeatedMessage(info, layout.field, i);
+                        const uint32_t id = layout.instance_field
+                            ? InstanceId(element.GetReflection()->GetStringReference(element, layout.instance_field, &scratch_), frame)
+                            : static_cast<uint32_t>(i);
+                        out->add_instance(id);
+                        EncodeElement(layout, element, id, keyframe, &states_[g], out);
+                    }
+                }
+                else if (reflection->HasField(info, layout.field))
+                {
+                    auto* out = frame->add_group();
+                    out->set_field(layout.field->number());
+                    EncodeElement(layout, reflection->GetMessage(info, layout.field), 0, keyframe, &states_[g], out);
+                }
+            }
+            ++frames_;
+        }
+
+    private:
+        /// @brief 一个分组的差分状态：按实例id索引的上一次量化值
+        using GroupState = std::vector<std::vector<int64_t>>;
+
+        uint32_t InstanceId(const std::string& name, monitor::proto::CompactFrame* frame)
+        {
+            auto iter = dictionary_.find(name);
+            if (iter != dictionary_.end())
+            {
+                last_seen_[iter->second] = frames_;
+                return iter->second;
+            }
+            uint32_t id = static_cast<uint32_t>(last_seen_.size());
+            if (free_ids_.empty())
+            {
+                last_seen_.push_back(frames_);
+            }
+            else
+            {
+                id = free_ids_.back();   // 与解码器相同：优先复用最后删除的id
+                free_ids_.pop_back();
+                last_seen_[id] = frames_;
+            }
+            dictionary_.emplace(name, id);
+            frame->add_new_names(name);
+            return id;
+        }
+
+        /**
+         * @brief 删除最近kNameIdleFrames帧内没有出现过的实例
+         * @param frame 当前帧，删除的id写入removed_names
+         */
+        void EvictIdleNames(monitor::proto::CompactFrame* frame)
+        {
+            for (auto iter = dictionary_.begin(); iter != dictionary_.end();)
+            {
+                const uint32_t id = iter->second;
+                if (frames_ - last_seen_[id] < kNameIdleFrames)
+                {
+                    ++iter;
+                    continue;
+                }
+                frame->add_removed_names(id);
+                free_ids_.push_back(id);
+                for (GroupState& state : states_)
+                {
+                    if (id < state.size())
+                    {
+                        std::vector<int64_t>().swap(state[id]);   // 复用时上一次值重新按0处理
+                    }
+                }
+                iter = dictionary_.erase(iter);
+            }
+        }
+
+        /**
+         * @brief 按MonitorInfo的线格式追加一个消息字段的全部元素（不拷贝元素）
+         * @param info 采样消息
+         * @param reflection 采样消息的反射
+         * @param field 消息字段
+         * @param out 输出参数，编码追加在末尾
+         */
+        static void EncodeSnapshotField(const monitor::proto::MonitorInfo& info,
+            const google::protobuf::Reflection* reflection, const google::protobuf::FieldDescriptor* field,
+            std::string* out)
+        {
+            using google::protobuf::io::CodedOutputStream;
+            auto append = [&](const google::protobuf::Message& element) {
+                uint8_t header[10];   // 标签和长度，各最多5字节（varint32）
+                const uint32_t tag = static_cast<uint32_t>(field->number()) << 3 | 2;   // 长度前缀类型
+                uint8_t* end = CodedOutputStream::WriteVarint32ToArray(tag, header);
+                end = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32_t>(element.ByteSizeLong()), end);
+                out->append(reinterpret_cast<const char*>(header), end - header);
+                element.AppendToString(out);
+            };
+            if (field->is_repeated())
+            {
+                const int count = reflection->FieldSize(info, field);
+                for (int i = 0; i < count; ++i)
+                {
+                    append(reflection->GetRepeatedMessage(info, field, i));
+                }
+            }
+            else if (reflection->HasField(info, field))
+            {
+                append(reflection->GetMessage(info, field));
+            }
+        }
+
+        void EncodeElement(const CompactLayout::Group& layout, const google::protobuf::Message& element,
+            uint32_t id, bool keyframe, GroupState* state, monitor::proto::CompactGroup* out)
+        {
+            if (state->size() <= id)
+            {
+                state->resize(id + 1);
+            }
+            std::vector<int64_t>& previous = (*state)[id];
+            previous.resize(layout.value_fields.size(), 0);   // 新实例的上一次值按0处理
+
+            const google::protobuf::Reflection* reflection = element.GetReflection();
+            for (size_t f = 0; f < layout.value_fields.size(); ++f)
+            {
+                const int64_t value = Quantize(element, reflection, layout.value_fields[f]);
+                out->add_value(keyframe ? value : CompactQuantizer::Delta(value, previous[f]));
+                previous[f] = value;
+            }
+        }
+
+        int64_t Quantize(const google::protobuf::Message& element, const google::protobuf::Reflection* reflection,
+            const google::protobuf::FieldDescriptor* field) const
+        {
+            using google::protobuf::FieldDescriptor;
+            switch (field->cpp_type())
+            {
+            case FieldDescriptor::CPPTYPE_FLOAT:
+                return CompactQuantizer::Quantize(static_cast<double>(reflection->GetFloat(element, field)), float_scale_);
+            case FieldDescriptor::CPPTYPE_DOUBLE:
+                return CompactQuantizer::Quantize(reflection->GetDouble(element, field), float_scale_);
+            case FieldDescriptor::CPPTYPE_INT32:
+                return reflection->GetInt32(element, field);
+            case FieldDescriptor::CPPTYPE_INT64:
+                return reflection->GetInt64(element, field);
+            case FieldDescriptor::CPPTYPE_UINT32:
+                return reflection->GetUInt32(element, field);
+            case FieldDescriptor::CPPTYPE_UINT64:
+                return static_cast<int64_t>(reflection->GetUInt64(element, field));
+            default:
+                return 0;
+            }
+        }
+
+        uint32_t float_scale_;                                  ///< 浮点量化系数
+        uint32_t keyframe_interval_;                            ///< 关键帧间隔
+        uint64_t frames_ = 0;                                   ///< 已编码帧数
+        std::unordered_map<std::string, uint32_t> dictionary_;  ///< 实例名到id
+        std::vector<uint64_t> last_seen_;                       ///< 按id索引：最近一次出现的帧序号（从0开始）
+        std::vector<uint32_t> free_ids_;                        ///< 已删除、待复用的id
+        std::vector<GroupState> states_;                        ///< 按分组序号索引的差分状态
+        std::string scratch_;                                   ///< 读取实例名的临时缓冲区
+    };
+
+    /**
+     * @brief 紧凑格式解码器（服务器，一条流一个实例）
+     *
+     * 维护与编码器对称的字典和差分状态，把每个CompactFrame还原为MonitorInfo；
+     * 每帧先处理removed_names再处理new_names，与编码器分配id的顺序一致。
+     */
+    class CompactDecoder
+    {
+    public:
+        /**
+         * @brief 解码一帧
+         * @param frame 编码帧
+         * @param info 输出参数，还原的采样消息（会先清空，可复用）
+         * @return bool 成功返回true；帧与流状态不一致（协议错误）时返回false
+         */
+        bool Decode(const monitor::proto::CompactFrame& frame, monitor::proto::MonitorInfo* info)
+        {
+            info->Clear();
+            if (frames_ == 0)
+            {
+                if (frame.float_scale() == 0)
+                {
+                    return false;   // 第一帧必须携带流参数
+                }
+                host_ = frame.host();
+                host_group_ = frame.host_group();
+                float_scale_ = frame.float_scale();
+                states_.resize(CompactLayout::Groups().size());
+            }
+            ++frames_;
+
+            for (uint32_t id : frame.removed_names())
+            {
+                if (id >= names_.size())
+                {
+                    return false;
+                }
+                std::string().swap(names_[id]);
+                for (GroupState& state : states_)
+                {
+                    if (id < state.size())
+                    {
+                        std::vector<int64_t>().swap(state[id]);
+                    }
+                }
+                free_ids_.push_back(id);
+            }
+            for (const std::string& name : frame.new_names())
+            {
+                if (free_ids_.empty())
+                {
+                    names_.push_back(name);
+                }
+                else
+                {
+                    names_[free_ids_.back()] = name;
+                    free_ids_.pop_back();
+                }
+            }
+
+            if (!frame.snapshot_fields().empty() && !info->MergeFromString(frame.snapshot_fields()))
+            {
+                return false;
+            }
+            info->set_name(host_);
+            info->set_host_group(host_group_);
+            info->set_timestamp_ms(frame.timestamp_ms());
+
+            const google::protobuf::Reflection* reflection = info->GetReflection();
+            for (const auto& group : frame.group())
+            {
+                const CompactLayout::Group* layout = CompactLayout::FindByNumber(group.field());
+                if (layout == nullptr || layout->snapshot_only)
+                {
+                    return false;
+                }
+                const size_t field_count = layout->value_fields.size();
+                GroupState& state = states_[layout->field->index()];
+
+                if (layout->field->is_repeated())
+                {
+                    if (static_cast<size_t>(group.value_size()) != group.instance_size() * field_count)
+                    {
+                        return false;
+                    }
+                    for (int i = 0; i < group.instance_size(); ++i)
+                    {
+                        const uint32_t id = group.instance(i);
+                        google::protobuf::Message* element = reflection->AddMessage(info, layout->field);
+                        if (layout->instance_field)
+                        {
+                            if (id >= names_.size())
+                            {
+                                return false;
+                            }
+                            element->GetReflection()->SetString(element, layout->instance_field, names_[id]);
+                        }
+                        DecodeElement(*layout, group, i * field_count, id, frame.keyframe(), &state, element);
+                    }
+                }
+                else
+                {
+                    if (static_cast<size_t>(group.value_size()) != field_count)
+                    {
+                        return false;
+                    }
+                    DecodeElement(*layout, group, 0, 0, frame.keyframe(), &state,
+                        reflection->MutableMessage(info, layout->field));
+                }
+            }
+            return true;
+        }
+
+    private:
+        /// @brief 一个分组的差分状态：按实例id索引的上一次量化值
+        using GroupState = std::vector<std::vector<int64_t>>;
+
+        void DecodeElement(const CompactLayout::Group& layout, const monitor::proto::CompactGroup& group,
+            size_t offset, uint32_t id, bool keyframe, GroupState* state, google::protobuf::Message* element)
+        {
+            using google::protobuf::FieldDescriptor;
+            if (state->size() <= id)
+            {
+                state->resize(id + 1);
+            }
+            std::vector<int64_t>& previous = (*state)[id];
+            previous.resize(layout.value_fields.size(), 0);
+
+            const google::protobuf::Reflection* reflection = element->GetReflection();
+            for (size_t f = 0; f < layout.value_fields.size(); ++f)
+            {
+                const int64_t encoded = group.value(static_cast<int>(offset + f));
+                const int64_t value = keyframe ? encoded : CompactQuantizer::Apply(previous[f], encoded);
+                previous[f] = value;
+
+                const FieldDescriptor* field = layout.value_fields[f];
+                switch (field->cpp_type())
+                {
+                case FieldDescriptor::CPPTYPE_FLOAT:
+                    reflection->SetFloat(element, field, static_cast<float>(CompactQuantizer::Restore(value, float_scale_)));
+                    break;
+                case FieldDescriptor::CPPTYPE_DOUBLE:
+                    reflection->SetDouble(element, field, CompactQuantizer::Restore(value, float_scale_));
+                    break;
+                case FieldDescriptor::CPPTYPE_INT32:
+                    reflection->SetInt32(element, field, static_cast<int32_t>(value));
+                    break;
+                case FieldDescriptor::CPPTYPE_INT64:
+                    reflection->SetInt64(element, field, value);
+                    break;
+                case FieldDescriptor::CPPTYPE_UINT32:
+                    reflection->SetUInt32(element, field, static_cast<uint32_t>(value));
+                    break;
+                case FieldDescriptor::CPPTYPE_UINT64:
+                    reflection->SetUInt64(element, field, static_cast<uint64_t>(value));
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        std::string host_;                       ///< 主机名（流的第一帧携带）
+        std::string host_group_;                 ///< 主机分组（流的第一帧携带）
+        uint32_t float_scale_ = 1;               ///< 浮点量化系数（流的第一帧携带）
+        uint64_t frames_ = 0;                    ///< 已解码帧数
+        std::vector<std::string> names_;         ///< 字典：实例id到实例名
+        std::vector<uint32_t> free_ids_;         ///< 已删除、待复用的id（与编码器的顺序一致）
+        std::vector<GroupState> states_;         ///< 按分组序号索引的差分状态
+    };
+}  // namespace monitor
@@ -0,0 +1,342 @@
+// 包含对应的头文件
+#include "aggregate_store.h"
+
+// C++标准库头文件
+#include <algorithm>    // std::max
+#include <chrono>       // 清理周期
+#include <cmath>        // std::isfinite、std::llround
+#include <functional>   // std::hash
+
+// 服务器内部模块
+#include "host_summary.h"   // TotalCpuPercent
+
+namespace monitor
+{
+    namespace
+    {
+        /// @brief 指标名，按AggregateStore::Metric顺序排列
+        constexpr const char* kMetricNames[AggregateStore::METRIC_MAX] = {
+            "cpu_percent",
+            "mem_used_percent",
+            "load_avg_1",
+            "net_rcv_rate",
+            "net_send_rate",
+        };
+
+        /// @brief 全集群分组的名称
+        const std::string kFleetGroup;
+    }  // namespace
+
+    bool AggregateStore::FindMetric(const std::string& name, Metric* metric)
+    {
+        for (int i = 0; i < METRIC_MAX; ++i)
+        {
+            if (name == kMetricNames[i])
+            {
+                *metric = static_cast<Metric>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    AggregateStore::~AggregateStore()
+    {
+        if (!expirer_.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(expiry_mutex_);
+            stopping_ = true;
+        }
+        expiry_cv_.notify_all();
+        expirer_.join();
+    }
+
+    void AggregateStore::StartExpiry(int64_t ttl_ms)
+    {
+        if (expirer_.joinable() || ttl_ms <= 0)
+        {
+            return;
+        }
+        host_ttl_ms_ = ttl_ms;
+        expirer_ = std::thread([this]() { ExpiryLoop(); });
+    }
+
+    void AggregateStore::ExpiryLoop()
+    {
+        const auto interval = std::chrono::milliseconds(std::max<int64_t>(host_ttl_ms_ / 4, 1000));
+        std::unique_lock<std::mutex> lock(expiry_mutex_);
+        while (!expiry_cv_.wait_for(lock, interval, [this]() { return stopping_; }))
+        {
+            lock.unlock();
+            const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            Expire(now_ms - host_ttl_ms_);
+            lock.lock();
+        }
+    }
+
+    AggregateStore::Shard& AggregateStore::ShardFor(const std::string& host)
+    {
+        return shards_[std::hash<std::string>()(host) % kShardCount];
+    }
+
+    /**
+     * @brief 提取指标值的具体实现
+     * @param sample 采样消息
+     * @param values 输出参数，各指标的值
+     * @param present 输出参数，是否出现
+     *
+     * 非有限值（NaN、无穷大）按未出现处理，不进入聚合。
+     */
+    void AggregateStore::Extract(const monitor::proto::MonitorInfo& sample, std::array<double, METRIC_MAX>* values,
+        std::array<bool, METRIC_MAX>* present)
+    {
+        present->fill(false);
+
+        float cpu_percent = 0;
+        if (TotalCpuPercent(sample, &cpu_percent))
+        {
+            (*values)[CPU_PERCENT] = cpu_percent;
+            (*present)[CPU_PERCENT] = true;
+        }
+        if (sample.has_mem_info())
+        {
+            (*values)[MEM_USED_PERCENT] = sample.mem_info().used_percent();
+            (*present)[MEM_USED_PERCENT] = true;
+        }
+        if (sample.has_cpu_load())
+        {
+            (*values)[LOAD_AVG_1] = sample.cpu_load().load_avg_1();
+            (*present)[LOAD_AVG_1] = true;
+        }
+        if (sample.net_info_size() > 0)
+        {
+            double rcv = 0;
+            double send = 0;
+            for (const auto& net : sample.net_info())
+            {
+                if (net.name() == "lo")
+                {
+                    continue;   // 本机回环流量不是主机对外的流量
+                }
+                rcv += net.rcv_rate();
+                send += net.send_rate();
+            }
+            (*values)[NET_RCV_RATE] = rcv;
+            (*values)[NET_SEND_RATE] = send;
+            (*present)[NET_RCV_RATE] = true;
+            (*present)[NET_SEND_RATE] = true;
+        }
+
+        for (int i = 0; i < METRIC_MAX; ++i)
+        {
+            (*present)[i] = (*present)[i] && std::isfinite((*values)[i]);
+        }
+    }
+
+    /**
+     * @brief 主机加入、离开分组的具体实现
+     * @param shard 主机所在的分片
+     * @param state 主机的最新值
+     * @param join 加入或移出
+     *
+     * 只处理主机的命名分组，全集群分组的成员关系不变。
+     */
+    void AggregateStore::MoveValues(GroupRollup* rollup, const HostState& state, bool join)
+    {
+        for (int i = 0; i < METRIC_MAX; ++i)
+        {
+            if (!state.present[i])
+            {
+                continue;
+            }
+            const int64_t scaled = std::llround(state.values[i] * kSumScale);
+            if (join)
+            {
+                rollup->metrics[i].sum += scaled;
+                rollup->metrics[i].sketch.Add(state.values[i]);
+            }
+            else
+            {
+                rollup->metrics[i].sum -= scaled;
+                rollup->metrics[i].sketch.Remove(state.values[i]);
+            }
+        }
+    }
+
+    void AggregateStore::MoveHost(Shard* shard, const HostState& state, bool join)
+    {
+        if (state.group.empty())
+        {
+            return;
+        }
+        GroupRollup& rollup = shard->groups[state.group];
+        MoveValues(&rollup, state, join);
+        if (join)
+        {
+            ++rollup.hosts;
+        }
+        else if (--rollup.hosts == 0)
+        {
+            shard->groups.erase(state.group);
+        }
+    }
+
+    /**
+     * @brief 更新主机最新值的具体实现
+     * @param sample 采样消息
+     * @param receive_ms 服务器接收时间
+     *
+     * 对采样中出现的每个指标，在全集群分组和主机的命名分组中删除旧值、加入新值，
+     * 每个指标只涉及常数个桶，与组内主机数无关。
+     */
+    void AggregateStore::Update(const monitor::proto::MonitorInfo& sample, int64_t receive_ms)
+    {
+        static const std::string kUnknownHost = "unknown_host";
+        const std::string& host = sample.name().empty() ? kUnknownHost : sample.name();
+
+        std::array<double, METRIC_MAX> values;
+        std::array<bool, METRIC_MAX> present;
+        Extract(sample, &values, &present);
+
+        Shard& shard = ShardFor(host);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto [iter, inserted] = shard.hosts.try_emplace(host);
+        HostState& state = iter->second;
+        state.receive_ms = std::max(state.receive_ms, receive_ms);
+        if (inserted)
+        {
+            ++shard.groups[kFleetGroup].hosts;
+            state.group = sample.host_group();
+            MoveHost(&shard, state, true);
+        }
+        else if (state.group != sample.host_group())
+        {
+            MoveHost(&shard, state, false);
+            state.group = sample.host_group();
+            MoveHost(&shard, state, true);
+        }
+
+        GroupRollup* fleet = &shard.groups[kFleetGroup];
+        GroupRollup* named = state.group.empty() ? nullptr : &shard.groups[state.group];
+        for (int i = 0; i < METRIC_MAX; ++i)
+        {
+            if (!present[i] || (state.present[i] && sample.timestamp_ms() < state.timestamps[i]))
+            {
+                continue;
+            }
+            const int64_t scaled = std::llround(values[i] * kSumScale);
+            for (GroupRollup* rollup : {fleet, named})
+            {
+                if (rollup == nullptr)
+                {
+                    continue;
+                }
+                Rollup& metric = rollup->metrics[i];
+                if (state.present[i])
+                {
+                    metric.sum -= std::llround(state.values[i] * kSumScale);
+                    metric.sketch.Remove(state.values[i]);
+                }
+                metric.sum += scaled;
+                metric.sketch.Add(values[i]);
+            }
+            state.values[i] = values[i];
+            state.present[i] = true;
+            state.timestamps[i] = sample.timestamp_ms();
+        }
+    }
+
+    /**
+     * @brief 移出停止上报的主机的具体实现
+     * @param cutoff_ms 截止时间
+     * @return 移出的主机数
+     *
+     * 逐个分片持锁扫描主机表，与写入只在同一分片上竞争；被移出的值从全集群分组和命名分组中精确删除。
+     */
+    size_t AggregateStore::Expire(int64_t cutoff_ms)
+    {
+        size_t expired = 0;
+        for (Shard& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto iter = shard.hosts.begin(); iter != shard.hosts.end();)
+            {
+                const HostState& state = iter->second;
+                if (state.receive_ms >= cutoff_ms)
+                {
+                    ++iter;
+                    continue;
+                }
+                MoveHost(&shard, state, false);
+                GroupRollup& fleet = shard.groups[kFleetGroup];
+                MoveValues(&fleet, state, false);
+                if (--fleet.hosts == 0)
+                {
+                    shard.groups.erase(kFleetGroup);
+                }
+                iter = shard.hosts.erase(iter);
+                ++expired;
+            }
+        }
+        return expired;
+    }
+
+    /**
+     * @brief 查询分组聚合的具体实现
+     * @param request 查询请求
+     * @param response 输出参数，聚合结果
+     * @return 分组存在返回true
+     *
+     * 逐个分片合并该分组的草图和sum，每个分片只短暂持锁。
+     */
+    bool AggregateStore::Query(const monitor::proto::AggregateRequest& request,
+        monitor::proto::AggregateResponse* response) const
+    {
+        Metric metric;
+        if (!FindMetric(request.metric(), &metric))
+        {
+            return false;
+        }
+
+        bool found = request.group().empty();
+        uint32_t hosts = 0;
+        int64_t sum = 0;
+        QuantileSketch merged;
+        for (const Shard& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto iter = shard.groups.find(request.group());
+            if (iter == shard.groups.end())
+            {
+                continue;
+            }
+            found = true;
+            hosts += iter->second.hosts;
+            sum += iter->second.metrics[metric].sum;
+            merged.Merge(iter->second.metrics[metric].sketch);
+        }
+        if (!found)
+        {
+            return false;
+        }
+
+        const uint64_t count = merged.Count();
+        response->set_hosts(hosts);
+        response->set_count(count);
+        response->set_sum(static_cast<double>(sum) / kSumScale);
+        response->set_avg(count > 0 ? static_cast<double>(sum) / kSumScale / static_cast<double>(count) : 0);
+        response->set_min(merged.Quantile(0));
+        response->set_max(merged.Quantile(1));
+        for (double q : request.quantile())
+        {
+            response->add_quantile_value(merged.Quantile(q));
+        }
+        response->set_relative_accuracy(QuantileSketch::kRelativeAccuracy);
+        return true;
+    }
+}  // namespace monitor
@@ -0,0 +1,209 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <array>          // 固定数量的分片、指标
+#include <condition_variable>   // 唤醒过期清理线程
+#include <cstddef>        // size_t
+#include <cstdint>        // int64_t
+#include <mutex>          // 分片锁
+#include <string>         // 主机名、分组名
+#include <thread>         // 过期清理线程
+#include <unordered_map>  // 主机表、分组表
+
+// 服务器内部模块
+#include "quantile_sketch.h"   // 可删除、可合并的分位数草图
+
+// Protobuf生成的头文件
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+    /**
+     * @brief 按主机分组的流式聚合统计
+     *
+     * 回答"集群X的CPU使用率p99"一类的问题时，不需要把组内每台主机的数据拉到客户端：
+     * 每次写入时增量更新主机所在分组的聚合（sum、count和分位数草图），查询只读取聚合。
+     *
+     * 统计对象是组内每台主机的最新值：主机的新采样到达时，从聚合中删除该主机的旧值、
+     * 加入新值（QuantileSketch支持精确删除），聚合始终等于当前各主机最新值的统计。
+     * 主机按MonitorInfo::host_group分组，所有主机同时属于空名分组（全集群）；
+     * 分组变化时主机的各指标从旧分组移到新分组。
+     * 停止上报的主机（下线、改名）由过期清理（StartExpiry）在超过TTL后从全集群和命名分组中移出，
+     * 不会永久留在聚合里。
+     *
+     * 指标（每台主机一个值）：
+     * - cpu_percent：总CPU使用率（见TotalCpuPercent）
+     * - mem_used_percent：内存使用率
+     * - load_avg_1：1分钟平均负载
+     * - net_rcv_rate、net_send_rate：除lo外所有网卡的接收、发送速率之和（KB/s）
+     *
+     * 精度：sum以0.001为单位的整数累加，删除旧值后没有浮点误差累积；
+     * 分位数、最小值和最大值来自草图，相对误差不超过QuantileSketch::kRelativeAccuracy。
+     *
+     * 并发：按主机名分片，每个分片有自己的主机表和分组聚合，写入只锁住主机所在的分片；
+     * 查询依次锁住各分片并合并该分组的聚合，代价为O(分片数×草图桶数)，与组内主机数无关。
+     */
+    class AggregateStore
+    {
+    public:
+        /// @brief 分片数
+        static constexpr size_t kShardCount = 16;
+
+        AggregateStore() = default;
+
+        /**
+         * @brief 析构函数，启动了过期清理时停止清理线程
+         */
+        ~AggregateStore();
+
+        // 持有线程，禁止拷贝
+        AggregateStore(const AggregateStore&) = delete;
+        AggregateStore& operator=(const AggregateStore&) = delete;
+
+        /**
+         * @brief 聚合的指标
+         */
+        enum Metric
+        {
+            CPU_PERCENT = 0,     ///< 总CPU使用率（%）
+            MEM_USED_PERCENT,    ///< 内存使用率（%）
+            LOAD_AVG_1,          ///< 1分钟平均负载
+            NET_RCV_RATE,        ///< 接收速率之和（KB/s）
+            NET_SEND_RATE,       ///< 发送速率之和（KB/s）
+            METRIC_MAX           ///< 指标总数
+        };
+
+        /**
+         * @brief 根据指标名查找指标
+         * @param name 指标名（如"cpu_percent"）
+         * @param metric 输出参数，指标
+         * @return bool 指标存在返回true
+         */
+        static bool FindMetric(const std::string& name, Metric* metric);
+
+        /**
+         * @brief 用一条采样更新主机的最新值
+         * @param sample 采样消息（只读取，不修改）
+         * @param receive_ms 服务器接收时间（Unix毫秒），用于判断主机是否停止上报
+         *
+         * 只更新采样中出现的指标（客户端按各监控器的采样周期分批上报）；
+         * 早于该指标最新值的采样（重连后重放的落盘数据）不覆盖最新值。
+         */
+        void Update(const monitor::proto::MonitorInfo& sample, int64_t receive_ms);
+
+        /**
+         * @brief 移出最近一次上报早于cutoff_ms的主机
+         * @param cutoff_ms 截止时间（Unix毫秒，服务器时钟）
+         * @return size_t 移出的主机数
+         *
+         * 主机的所有指标从全集群分组和命名分组中删除，之后再上报时按新主机重新加入。
+         */
+        size_t Expire(int64_t cutoff_ms);
+
+        /**
+         * @brief 启动过期清理线程
+         * @param ttl_ms 主机停止上报多久后移出聚合
+         *
+         * 每max(ttl_ms / 4, 1秒)清理一次，主机最晚在停止上报后约1.25 × ttl_ms移出。重复调用无副作用。
+         */
+        void StartExpiry(int64_t ttl_ms);
+
+        /**
+         * @brief 查询一个分组的聚合
+         * @param request 分组、指标名和需要的分位数
+         * @param response 输出参数，聚合结果
+         * @return bool 分组存在返回true（空名分组总是存在）
+         */
+        bool Query(const monitor::proto::AggregateRequest& request,
+            monitor::proto::AggregateResponse* response) const;
+
+    private:
+        /// @brief sum的定点系数（精度0.001）
+        static constexpr double kSumScale = 1000;
+
+        /**
+         * @brief 一个分组的一个指标的聚合
+         */
+        struct Rollup
+        {
+            int64_t sum = 0;            ///< 各主机最新值之和（乘以kSumScale）
+            QuantileSketch sketch;      ///< 各主机最新值的分布
+        };
+
+        /**
+         * @brief 一个分组在一个分片内的聚合
+         */
+        struct GroupRollup
+        {
+            uint32_t hosts = 0;                          ///< 分片内属于该分组的主机数
+            std::array<Rollup, METRIC_MAX> metrics;      ///< 各指标的聚合
+        };
+
+        /**
+         * @brief 一台主机计入聚合的最新值
+         */
+        struct HostState
+        {
+            std::string group;                           ///< 所属分组
+            std::array<double, METRIC_MAX> values{};     ///< 各指标的最新值
+            std::array<bool, METRIC_MAX> present{};      ///< 各指标是否已有值
+            std::array<int64_t, METRIC_MAX> timestamps{};   ///< 各指标最新值的采样时间
+            int64_t receive_ms = 0;                      ///< 最近一次上报的服务器接收时间
+        };
+
+        /**
+         * @brief 分片：一把锁保护主机表和分组聚合
+         */
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex;                                   ///< 分片锁
+            std::unordered_map<std::string, HostState> hosts;           ///< 主机名到最新值
+            std::unordered_map<std::string, GroupRollup> groups;        ///< 分组名到聚合（空名为全集群）
+        };
+
+        /**
+         * @brief 从采样中提取各指标的值
+         * @param sample 采样消息
+         * @param values 输出参数，各指标的值
+         * @param present 输出参数，采样中是否出现了该指标
+         */
+        static void Extract(const monitor::proto::MonitorInfo& sample, std::array<double, METRIC_MAX>* values,
+            std::array<bool, METRIC_MAX>* present);
+
+        /**
+         * @brief 把主机的所有已有值加入或移出一个分组的聚合
+         * @param rollup 分组聚合
+         * @param state 主机的最新值
+         * @param join true为加入，false为移出
+         */
+        static void MoveValues(GroupRollup* rollup, const HostState& state, bool join);
+
+        /**
+         * @brief 把主机的所有已有值加入或移出分组（主机加入、离开分组时使用）
+         * @param shard 主机所在的分片（调用方持有分片锁）
+         * @param state 主机的最新值
+         * @param join true为加入，false为移出（移出后没有主机的分组被删除）
+         */
+        static void MoveHost(Shard* shard, const HostState& state, bool join);
+
+        /**
+         * @brief 根据主机名选择分片
+         */
+        Shard& ShardFor(const std::string& host);
+
+        /**
+         * @brief 过期清理线程主循环
+         */
+        void ExpiryLoop();
+
+        std::array<Shard, kShardCount> shards_;    ///< 分片
+
+        // ==================== 过期清理 ====================
+        int64_t host_ttl_ms_ = 0;                  ///< 主机停止上报多久后移出聚合
+        std::mutex expiry_mutex_;                  ///< 保护stopping_
+        std::condition_variable expiry_cv_;        ///< 唤醒清理线程
+        bool stopping_ = false;                    ///< 是否正在停止
+        std::thread expirer_;                      ///< 过期清理线程
+    };
+}  // namespace monitor
@@ -0,0 +1,133 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// gRPC相关头文件
+#include <grpcpp/support/message_allocator.h>
+
+// Protobuf头文件
+#include <google/protobuf/arena.h>
+
+// C++标准库头文件
+#include <cstddef>      // size_t
+#include <memory>       // std::unique_ptr
+#include <mutex>        // 保护空闲列表
+#include <vector>       // 内存块、空闲列表
+
+namespace monitor
+{
+    /**
+     * @brief 基于Protobuf Arena的回调接口消息分配器
+     *
+     * 通过生成代码的SetMessageAllocatorFor_<方法>注册到回调式一元方法上，
+     * gRPC把请求直接反序列化到Arena上：解析出的所有子消息（每个CPU一条SoftIrq、CpuStat等）
+     * 只是Arena内的指针移动，调用结束时整体Reset，而不是逐个析构释放。
+     *
+     * 每个MessageHolder持有自己的Arena和一块预分配的初始内存块，用完后放回空闲列表复用：
+     * - 一次请求只在一个线程上反序列化，所有分配都落在初始内存块内
+     * - 某次请求超出初始内存块时，回收时把初始内存块扩大到实际用量，之后同样大小的请求不再分配
+     * - 是否超出按SpaceUsed（对象实际占用）判断，而不是SpaceAllocated：在其他线程上的分配
+     *   会让Arena另开一个小块，SpaceAllocated总是大于初始内存块，按它判断会让每次调用都把块加倍
+     * 稳态下持续上报的主机数不变时，处理一条请求不调用malloc。
+     *
+     * 分配器必须比注册它的服务器活得更久（gRPC要求）。
+     *
+     * @tparam Request 请求消息类型
+     * @tparam Response 响应消息类型
+     */
+    template <typename Request, typename Response>
+    class ArenaMessageAllocator : public ::grpc::MessageAllocator<Request, Response>
+    {
+    public:
+        /// @brief 初始内存块大小
+        static constexpr size_t kInitialBlockSize = 64 * 1024;
+
+        /**
+         * @brief 为一次调用分配请求和响应消息
+         * @return ::grpc::MessageHolder<Request, Response>* 消息持有者，调用结束时gRPC调用其Release
+         */
+        ::grpc::MessageHolder<Request, Response>* AllocateMessages() override
+        {
+            Holder* holder = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!free_.empty())
+                {
+                    holder = free_.back();
+                    free_.pop_back();
+                }
+                else
+                {
+                    holders_.push_back(std::make_unique<Holder>(this));
+                    holder = holders_.back().get();
+                    free_.reserve(holders_.size());   // 保证回收时push_back不分配
+                }
+            }
+            holder->Prepare();
+            return holder;
+        }
+
+    private:
+        /**
+         * @brief 一次调用的消息持有者：Arena + 初始内存块
+         */
+        class Holder : public ::grpc::MessageHolder<Request, Response>
+        {
+        public:
+            explicit Holder(ArenaMessageAllocator* owner) : owner_(owner)
+            {
+                ResetArena(kInitialBlockSize);
+            }
+
+            /**
+             * @brief 在Arena上创建本次调用的请求和响应
+             */
+            void Prepare()
+            {
+                this->set_request(google::protobuf::Arena::CreateMessage<Request>(arena_.get()));
+                this->set_response(google::protobuf::Arena::CreateMessage<Response>(arena_.get()));
+            }
+
+            /**
+             * @brief 调用结束：回收Arena并放回空闲列表
+             */
+            void Release() override
+            {
+                const size_t used = static_cast<size_t>(arena_->SpaceUsed());
+                if (used > block_.size())
+                {
+                    ResetArena(used * 2);   // 超出初始内存块：扩大后重建，只在消息变大时发生
+                }
+                else
+                {
+                    arena_->Reset();
+                }
+                owner_->Recycle(this);
+            }
+
+        private:
+            void ResetArena(size_t block_size)
+            {
+                arena_.reset();
+                block_.assign(block_size, 0);
+                google::protobuf::ArenaOptions options;
+                options.initial_block = block_.data();
+                options.initial_block_size = block_.size();
+                arena_ = std::make_unique<google::protobuf::Arena>(options);
+            }
+
+            ArenaMessageAllocator* owner_;                    ///< 所属分配器
+            std::vector<char> block_;                         ///< 初始内存块（Reset后保留）
+            std::unique_ptr<google::protobuf::Arena> arena_;  ///< 本持有者的Arena
+        };
+
+        void Recycle(Holder* holder)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(holder);
+        }
+
+        std::mutex mutex_;                              ///< 保护以下成员
+        std::vector<std::unique_ptr<Holder>> holders_;  ///< 所有持有者（所有权）
+        std::vector<Holder*> free_;                     ///< 空闲的持有者
+    };
+}  // namespace monitor
@@ -0,0 +1,318 @@
+// 包含对应的头文件
+#include "async_ingest.h"
+
+// 系统头文件
+#include <pthread.h>    // pthread_setaffinity_np
+#include <sched.h>      // cpu_set_t
+
+// C++标准库头文件
+#include <algorithm>    // std::max
+#include <atomic>       // 无效帧日志限流
+#include <chrono>       // 限流周期
+#include <cstdint>      // uint64_t
+#include <iostream>     // 日志输出
+#include <string>       // 客户端地址
+
+// gRPC相关头文件
+#include <grpcpp/support/async_stream.h>
+
+// 服务器内部模块
+#include "codec/compact_codec.h"   // 紧凑上报格式解码
+
+namespace monitor
+{
+    namespace
+    {
+        /// @brief 无效帧日志的最小间隔
+        constexpr std::chrono::seconds kInvalidFrameLogInterval(1);
+
+        /// @brief 上次输出无效帧日志的时间（steady_clock纳秒）
+        std::atomic<int64_t> g_invalid_frame_logged{0};
+
+        /// @brief 上次输出之后被限流省略的无效帧数
+        std::atomic<uint64_t> g_invalid_frame_suppressed{0};
+
+        /**
+         * @brief 记录一个无效的上报帧（所有poller合计每秒最多输出一条）
+         * @param name 方法名
+         * @param peer 客户端地址
+         *
+         * 由poller线程调用：异常客户端持续发送坏帧时不能让日志输出拖慢完成队列，
+         * 被省略的条数合并到下一条日志中；输出到stderr且不主动刷新。
+         */
+        void LogInvalidFrame(const char* name, const std::string& peer)
+        {
+            const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+            const int64_t interval = std::chrono::nanoseconds(kInvalidFrameLogInterval).count();
+            int64_t last = g_invalid_frame_logged.load(std::memory_order_relaxed);
+            if ((last != 0 && now - last < interval) ||
+                !g_invalid_frame_logged.compare_exchange_strong(last, now, std::memory_order_relaxed))
+            {
+                g_invalid_frame_suppressed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            const uint64_t suppressed = g_invalid_frame_suppressed.exchange(0, std::memory_order_relaxed);
+            std::cerr << "[" << name << "] 无效的上报帧: " << peer;
+            if (suppressed > 0)
+            {
+                std::cerr << "（此前省略 " << suppressed << " 条）";
+            }
+            std::cerr << '\n';
+        }
+
+        /**
+         * @brief 一条客户端流式上报的状态机
+         *
+         * 状态依次为：等待连接 → 循环读取 → 结束。每次只有一个操作在进行，
+         * 完成后由poller线程调用Proceed推进到下一步；流结束后对象自行删除。
+         *
+         * @tparam Frame 流中的消息类型
+         */
+        template <typename Frame>
+        class IngestStream : public AsyncIngestServer::Call
+        {
+        public:
+            IngestStream(GrpcManagerImpl* service, ::grpc::ServerCompletionQueue* cq, const char* name)
+                : service_(service), cq_(cq), reader_(&context_), name_(name)
+            {
+            }
+
+            void Proceed(bool ok) override
+            {
+                switch (state_)
+                {
+                case State::kAccept:
+                    if (!ok)
+                    {
+                        delete this;   // 完成队列已关闭，不再接受新连接
+                        return;
+                    }
+                    Spawn();   // 立即为下一条连接挂起请求
+                    state_ = State::kRead;
+                    reader_.Read(&frame_, this);
+                    return;
+
+                case State::kRead:
+                    if (!ok)
+                    {
+                        // 客户端结束流或连接断开
+                        state_ = State::kFinish;
+                        reader_.Finish(response_, ::grpc::Status::OK, this);
+                        return;
+                    }
+                    if (!Consume(&frame_))
+                    {
+                        LogInvalidFrame(name_, context_.peer());
+                        state_ = State::kFinish;
+                        reader_.FinishWithError(
+                            ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "malformed frame"), this);
+                        return;
+                    }
+                    reader_.Read(&frame_, this);
+                    return;
+
+                case State::kFinish:
+                    delete this;
+                    return;
+                }
+            }
+
+        protected:
+            /**
+             * @brief 在完成队列上挂起一个等待新连接的请求
+             */
+            virtual void Request() = 0;
+
+            /**
+             * @brief 为下一条连接创建新的状态机并挂起请求
+             */
+            virtual void Spawn() = 0;
+
+            /**
+             * @brief 处理一帧
+             * @param frame 读到的帧（可以移走字段，下一次读取前会被覆盖）
+             * @return bool 帧合法返回true
+             */
+            virtual bool Consume(Frame* frame) = 0;
+
+            GrpcManagerImpl* service_;                                        ///< 服务实现
+            ::grpc::ServerCompletionQueue* cq_;                               ///< 所属完成队列
+            ::grpc::ServerContext context_;                                   ///< 调用上下文
+            ::grpc::ServerAsyncReader<::google::protobuf::Empty, Frame> reader_;   ///< 流读取器
+
+        private:
+            enum class State
+            {
+                kAccept,   ///< 等待新连接
+                kRead,     ///< 读取中
+                kFinish,   ///< 结束中
+            };
+
+            const char* name_;                                                ///< 方法名（日志用）
+            State state_ = State::kAccept;                                    ///< 当前状态
+            Frame frame_;                                                     ///< 读取缓冲区（整条流复用）
+            ::google::protobuf::Empty response_;                              ///< 空响应
+        };
+
+        /**
+         * @brief 完整格式的流式上报（StreamMonitorInfo）
+         */
+        class FullStream : public IngestStream<monitor::proto::MonitorInfo>
+        {
+        public:
+            FullStream(GrpcManagerImpl* service, ::grpc::ServerCompletionQueue* cq)
+                : IngestStream(service, cq, "StreamMonitorInfo")
+            {
+            }
+
+            void Request() override
+            {
+                service_->RequestStreamMonitorInfo(&context_, &reader_, cq_, cq_, this);
+            }
+
+        protected:
+            void Spawn() override
+            {
+                (new FullStream(service_, cq_))->Request();
+            }
+
+            bool Consume(monitor::proto::MonitorInfo* frame) override
+            {
+                service_->Ingest(frame);
+                return true;
+            }
+        };
+
+        /**
+         * @brief 紧凑格式的流式上报（StreamCompactMonitorInfo）
+         *
+         * 每条流一个解码器，把字典 + 量化差分编码的帧还原为MonitorInfo后按完整格式存储。
+         */
+        class CompactStream : public IngestStream<monitor::proto::CompactFrame>
+        {
+        public:
+            CompactStream(GrpcManagerImpl* service, ::grpc::ServerCompletionQueue* cq)
+                : IngestStream(service, cq, "StreamCompactMonitorInfo")
+            {
+            }
+
+            void Request() override
+            {
+                service_->RequestStreamCompactMonitorInfo(&context_, &reader_, cq_, cq_, this);
+            }
+
+        protected:
+            void Spawn() override
+            {
+                (new CompactStream(service_, cq_))->Request();
+            }
+
+            bool Consume(monitor::proto::CompactFrame* frame) override
+            {
+                if (!decoder_.Decode(*frame, &sample_))
+                {
+                    return false;
+                }
+                service_->Ingest(&sample_);
+                return true;
+            }
+
+        private:
+            CompactDecoder decoder_;                 ///< 本条流的解码状态
+            monitor::proto::MonitorInfo sample_;     ///< 解码缓冲区
+        };
+    }  // namespace
+
+    AsyncIngestServer::AsyncIngestServer(GrpcManagerImpl* service, const ServerOptions& options)
+        : service_(service), options_(options)
+    {
+        if (options_.completion_queues <= 0)
+        {
+            options_.completion_queues = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+    }
+
+    AsyncIngestServer::~AsyncIngestServer()
+    {
+        Shutdown();
+    }
+
+    void AsyncIngestServer::AddCompletionQueues(::grpc::ServerBuilder* builder)
+    {
+        for (int i = 0; i < options_.completion_queues; ++i)
+        {
+            cqs_.push_back(builder->AddCompletionQueue());
+        }
+    }
+
+    void AsyncIngestServer::Start()
+    {
+        for (size_t i = 0; i < cqs_.size(); ++i)
+        {
+            (new FullStream(service_, cqs_[i].get()))->Request();
+            (new CompactStream(service_, cqs_[i].get()))->Request();
+            pollers_.emplace_back(&AsyncIngestServer::Poll, this, i);
+        }
+    }
+
+    void AsyncIngestServer::Shutdown()
+    {
+        if (shutdown_)
+        {
+            return;
+        }
+        shutdown_ = true;
+
+        for (auto& cq : cqs_)
+        {
+            cq->Shutdown();
+        }
+        for (auto& poller : pollers_)
+        {
+            poller.join();
+        }
+        pollers_.clear();
+    }
+
+    void AsyncIngestServer::Poll(size_t index)
+    {
+        PinThread(index);
+
+        ::grpc::ServerCompletionQueue* cq = cqs_[index].get();
+        void* tag = nullptr;
+        bool ok = false;
+        // Next在队列关闭且所有事件取完后返回false
+        while (cq->Next(&tag, &ok))
+        {
+            static_cast<Call*>(tag)->Proceed(ok);
+        }
+    }
+
+    void AsyncIngestServer::PinThread(size_t index) const
+    {
+        if (!options_.pin_pollers)
+        {
+            return;
+        }
+
+        int cpu = 0;
+        if (!options_.poller_cpus.empty())
+        {
+            cpu = options_.poller_cpus[index % options_.poller_cpus.size()];
+        }
+        else
+        {
+            cpu = static_cast<int>(index % std::max(1u, std::thread::hardware_concurrency()));
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0)
+        {
+            std::cerr << "[AsyncIngestServer] poller " << index << " 绑定CPU " << cpu
+                      << " 失败，错误码: " << err << '\n';
+        }
+    }
+}  // namespace monitor
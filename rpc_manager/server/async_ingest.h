@@ -0,0 +1,113 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// gRPC相关头文件
+#include <grpcpp/completion_queue.h>
+#include <grpcpp/server_builder.h>
+
+// C++标准库头文件
+#include <memory>   // std::unique_ptr
+#include <thread>   // poller线程
+#include <vector>   // 完成队列、线程列表
+
+// 服务器内部模块
+#include "rpc_manager.h"      // 服务实现（存储采样）
+#include "server_options.h"   // 完成队列数、绑核参数
+
+namespace monitor
+{
+    /**
+     * @brief 流式上报的异步服务器
+     *
+     * 在多个完成队列上驱动StreamMonitorInfo和StreamCompactMonitorInfo两个异步方法，
+     * 每个完成队列由一个poller线程独占处理，poller线程可以绑定到指定的CPU核心：
+     * - 一条流的所有事件都在接受它的完成队列上处理，同一条流不存在并发，也不需要加锁
+     * - 线程数固定为完成队列数，与连接数无关，几千条长连接不会产生几千个线程
+     * - 每个完成队列始终挂起一个等待新连接的请求，接受一条流后立即挂起下一个
+     *
+     * 使用顺序：
+     * @code
+     *   AsyncIngestServer ingest(&service, options);
+     *   ingest.AddCompletionQueues(&builder);      // BuildAndStart之前
+     *   auto server = builder.BuildAndStart();
+     *   ingest.Start();                            // BuildAndStart之后
+     *   ...
+     *   server->Shutdown();
+     *   ingest.Shutdown();                         // 关闭完成队列并等待poller退出
+     * @endcode
+     */
+    class AsyncIngestServer
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param service 服务实现（必须比本对象活得更久），其基类需包含两个流式方法的WithAsyncMethod
+         * @param options 完成队列数、绑核参数
+         */
+        AsyncIngestServer(GrpcManagerImpl* service, const ServerOptions& options);
+
+        /**
+         * @brief 析构函数，未调用Shutdown时自动调用
+         */
+        ~AsyncIngestServer();
+
+        AsyncIngestServer(const AsyncIngestServer&) = delete;
+        AsyncIngestServer& operator=(const AsyncIngestServer&) = delete;
+
+        /**
+         * @brief 向构建器添加完成队列
+         * @param builder 服务器构建器（必须在BuildAndStart之前调用）
+         */
+        void AddCompletionQueues(::grpc::ServerBuilder* builder);
+
+        /**
+         * @brief 挂起等待新连接的请求并启动poller线程
+         *
+         * 必须在BuildAndStart成功之后调用。
+         */
+        void Start();
+
+        /**
+         * @brief 关闭完成队列并等待poller线程退出
+         *
+         * 必须在grpc::Server::Shutdown之后调用。
+         */
+        void Shutdown();
+
+        /**
+         * @brief 一次异步操作的完成回调
+         *
+         * 完成队列的tag即指向本对象的指针，poller取出事件后调用Proceed。
+         */
+        class Call
+        {
+        public:
+            virtual ~Call() = default;
+
+            /**
+             * @brief 处理一次完成事件
+             * @param ok 操作是否成功（流结束、服务器关闭时为false）
+             */
+            virtual void Proceed(bool ok) = 0;
+        };
+
+    private:
+        /**
+         * @brief poller线程主循环
+         * @param index 完成队列序号
+         */
+        void Poll(size_t index);
+
+        /**
+         * @brief 把当前线程绑定到CPU核心
+         * @param index poller序号
+         */
+        void PinThread(size_t index) const;
+
+        GrpcManagerImpl* service_;                                          ///< 服务实现
+        ServerOptions options_;                                             ///< 运行参数
+        std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> cqs_;   ///< 完成队列
+        std::vector<std::thread> pollers_;                                  ///< 每个完成队列一个poller线程
+        bool shutdown_ = false;                                             ///< 是否已关闭
+    };
+}  // namespace monitor
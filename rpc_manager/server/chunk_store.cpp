@@ -0,0 +1,1146 @@
+// 包含对应的头文件
+#include "chunk_store.h"
+
+// C++标准库头文件
+#include <algorithm>    // std::sort、std::max
+#include <cerrno>       // errno
+#include <chrono>       // 合并周期
+#include <cmath>        // std::isfinite
+#include <cstdio>       // std::snprintf
+#include <cstring>      // std::memcpy、std::strerror
+#include <iostream>     // 错误日志
+#include <limits>       // NaN、无穷大
+#include <map>          // 按分区拆分
+#include <utility>      // std::move
+
+// 系统头文件
+#include <dirent.h>     // opendir、readdir
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>   // mkdir、fstat
+#include <unistd.h>     // pread、write、fsync、unlink
+
+// 服务器内部模块
+#include "gorilla_codec.h"   // 时间戳和浮点数编码
+
+namespace monitor
+{
+    namespace
+    {
+        /// @brief 块文件格式版本
+        constexpr uint32_t kVersion = 1;
+
+        /// @brief 缺失数据的占位值
+        constexpr float kMissing = std::numeric_limits<float>::quiet_NaN();
+
+        /**
+         * @brief 块文件头（64字节）
+         */
+        struct ChunkHeader
+        {
+            char magic[8];            ///< kMagic
+            uint32_t version;         ///< kVersion
+            uint32_t level;           ///< 合并层数
+            uint64_t first_seq;       ///< 首序号
+            uint64_t last_seq;        ///< 末序号
+            int64_t t_min;            ///< 最早的点
+            int64_t t_max;            ///< 最晚的点
+            uint64_t index_offset;    ///< 索引在文件中的位置
+            uint64_t index_bytes;     ///< 索引字节数
+        };
+        static_assert(sizeof(ChunkHeader) == 64, "chunk header must be 64 bytes");
+
+        // ==================== 索引的定宽小端编码 ====================
+
+        template <typename T>
+        void Put(std::string* out, T value)
+        {
+            out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void PutString(std::string* out, const std::string& value)
+        {
+            Put<uint16_t>(out, static_cast<uint16_t>(value.size()));
+            out->append(value);
+        }
+
+        /**
+         * @brief 带边界检查的索引读取游标
+         */
+        struct Cursor
+        {
+            const uint8_t* position;   ///< 当前位置
+            const uint8_t* end;        ///< 结束位置
+
+            template <typename T>
+            bool Get(T* value)
+            {
+                if (end - position < static_cast<ptrdiff_t>(sizeof(T)))
+                {
+                    return false;
+                }
+                std::memcpy(value, position, sizeof(T));
+                position += sizeof(T);
+                return true;
+            }
+
+            bool GetString(std::string* value)
+            {
+                uint16_t length = 0;
+                if (!Get(&length) || end - position < length)
+                {
+                    return false;
+                }
+                value->assign(reinterpret_cast<const char*>(position), length);
+                position += length;
+                return true;
+            }
+        };
+
+        /**
+         * @brief 获取当前Unix时间（毫秒）
+         * @return int64_t 毫秒数
+         */
+        int64_t NowMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        /**
+         * @brief 计算时间所在的分区号（向下取整）
+         * @param timestamp_ms 时间
+         * @param partition_ms 分区长度
+         * @return int64_t 分区号
+         */
+        int64_t PartitionOf(int64_t timestamp_ms, int64_t partition_ms)
+        {
+            const int64_t partition = timestamp_ms / partition_ms;
+            return (timestamp_ms % partition_ms < 0) ? partition - 1 : partition;
+        }
+
+        /**
+         * @brief 判断块a是否排在块b之前（按分区、首序号）
+         */
+        template <typename ChunkPtr>
+        bool ChunkBefore(const ChunkPtr& a, const ChunkPtr& b)
+        {
+            return a->partition != b->partition ? a->partition < b->partition : a->first_seq < b->first_seq;
+        }
+
+        /**
+         * @brief 把主机名转义为目录名
+         * @param host 主机名
+         * @return std::string 字母、数字、'-'、'_'和非开头的'.'保持不变，其余按%XX转义
+         */
+        std::string EscapeHost(const std::string& host)
+        {
+            static const char kHex[] = "0123456789ABCDEF";
+            std::string name;
+            for (size_t i = 0; i < host.size(); ++i)
+            {
+                const unsigned char c = static_cast<unsigned char>(host[i]);
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                    c == '-' || c == '_' || (c == '.' && i > 0))
+                {
+                    name.push_back(static_cast<char>(c));
+                }
+                else
+                {
+                    name.push_back('%');
+                    name.push_back(kHex[c >> 4]);
+                    name.push_back(kHex[c & 0xF]);
+                }
+            }
+            return name.empty() ? std::string("%") : name;
+        }
+
+        /**
+         * @brief 把目录名还原为主机名
+         * @param name 目录名
+         * @return std::string 主机名
+         */
+        std::string UnescapeHost(const std::string& name)
+        {
+            if (name == "%")
+            {
+                return std::string();
+            }
+            auto hex = [](char c) {
+                return c >= '0' && c <= '9' ? c - '0' : (c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1);
+            };
+            std::string host;
+            for (size_t i = 0; i < name.size(); ++i)
+            {
+                if (name[i] == '%' && i + 2 < name.size() && hex(name[i + 1]) >= 0 && hex(name[i + 2]) >= 0)
+                {
+                    host.push_back(static_cast<char>(hex(name[i + 1]) * 16 + hex(name[i + 2])));
+                    i += 2;
+                }
+                else
+                {
+                    host.push_back(name[i]);
+                }
+            }
+            return host;
+        }
+
+        /**
+         * @brief 判断字符串是否以后缀结尾
+         */
+        bool EndsWith(const std::string& text, const std::string& suffix)
+        {
+            return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+
+        /**
+         * @brief 生成块文件或合并记录的文件名
+         * @param first_seq 首序号
+         * @param last_seq 末序号
+         * @param suffix 后缀（".chunk"或".merge"）
+         * @return std::string 文件名（不含目录）
+         */
+        std::string SeqFileName(uint64_t first_seq, uint64_t last_seq, const char* suffix)
+        {
+            char name[64];
+            std::snprintf(name, sizeof(name), "%020llu-%020llu%s",
+                static_cast<unsigned long long>(first_seq), static_cast<unsigned long long>(last_seq), suffix);
+            return name;
+        }
+
+        /**
+         * @brief 先写临时文件再rename发布一个文件
+         * @param dir 所在目录
+         * @param name 文件名
+         * @param contents 文件内容
+         * @param sync 是否fsync文件和目录
+         * @return bool 发布成功返回true
+         *
+         * 读者和重启后的扫描只会看到完整的文件；崩溃留下的临时文件在启动时删除。
+         */
+        bool PublishFile(const std::string& dir, const std::string& name, const std::string& contents, bool sync)
+        {
+            const std::string path = dir + "/" + name;
+            const std::string temp = path + ".tmp";
+            const int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0)
+            {
+                std::cerr << "[ChunkStore] open " << temp << ": " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            size_t written = 0;
+            while (written < contents.size())
+            {
+                const ssize_t n = write(fd, contents.data() + written, contents.size() - written);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    break;
+                }
+                written += static_cast<size_t>(n);
+            }
+            const bool ok = written == contents.size() && (!sync || fsync(fd) == 0);
+            close(fd);
+            if (!ok || rename(temp.c_str(), path.c_str()) != 0)
+            {
+                std::cerr << "[ChunkStore] 写入失败 " << path << ": " << std::strerror(errno) << std::endl;
+                unlink(temp.c_str());
+                return false;
+            }
+            if (sync)
+            {
+                const int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if (dir_fd >= 0)
+                {
+                    fsync(dir_fd);   // rename本身落盘
+                    close(dir_fd);
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief 读取整个小文件
+         * @param path 路径
+         * @param contents 输出参数，文件内容
+         * @return bool 成功返回true
+         */
+        bool ReadFile(const std::string& path, std::string* contents)
+        {
+            const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            char buffer[4096];
+            ssize_t n = 0;
+            while ((n = read(fd, buffer, sizeof(buffer))) > 0 || (n < 0 && errno == EINTR))
+            {
+                if (n > 0)
+                {
+                    contents->append(buffer, static_cast<size_t>(n));
+                }
+            }
+            close(fd);
+            return n == 0;
+        }
+
+        /**
+         * @brief 把一段块数据追加到合并结果中
+         * @param merged 合并结果
+         * @param groups 一个块的数据（时间晚于merged中同名分组的数据）
+         *
+         * 列按(实例名, 字段名)对齐：一侧没有的列补NaN。
+         */
+        void AppendGroups(std::vector<ChunkGroup>* merged, std::vector<ChunkGroup>* groups)
+        {
+            for (ChunkGroup& group : *groups)
+            {
+                auto target = std::find_if(merged->begin(), merged->end(),
+                    [&](const ChunkGroup& g) { return g.name == group.name; });
+                if (target == merged->end())
+                {
+                    merged->push_back(std::move(group));
+                    continue;
+                }
+
+                const size_t before = target->timestamps.size();
+                target->timestamps.insert(target->timestamps.end(), group.timestamps.begin(), group.timestamps.end());
+                for (ChunkColumn& column : group.columns)
+                {
+                    auto existing = std::find_if(target->columns.begin(), target->columns.end(),
+                        [&](const ChunkColumn& c) { return c.instance == column.instance && c.field == column.field; });
+                    if (existing == target->columns.end())
+                    {
+                        ChunkColumn added{column.instance, column.field, std::vector<float>(before, kMissing)};
+                        target->columns.push_back(std::move(added));
+                        existing = target->columns.end() - 1;
+                    }
+                    existing->values.insert(existing->values.end(), column.values.begin(), column.values.end());
+                }
+                for (ChunkColumn& column : target->columns)
+                {
+                    column.values.resize(target->timestamps.size(), kMissing);
+                }
+            }
+        }
+
+        /**
+         * @brief 编码一个块文件
+         * @param groups 数据
+         * @param header 输出参数，文件头（填充时间范围和索引位置）
+         * @return std::string 文件内容
+         */
+        std::string EncodeChunk(const std::vector<ChunkGroup>& groups, ChunkHeader* header)
+        {
+            std::string body(sizeof(ChunkHeader), '\0');
+            std::string index;
+            header->t_min = std::numeric_limits<int64_t>::max();
+            header->t_max = std::numeric_limits<int64_t>::min();
+
+            uint32_t group_count = 0;
+            for (const ChunkGroup& group : groups)
+            {
+                group_count += group.timestamps.empty() ? 0 : 1;
+            }
+            Put<uint32_t>(&index, group_count);
+
+            for (const ChunkGroup& group : groups)
+            {
+                if (group.timestamps.empty())
+                {
+                    continue;
+                }
+                const uint64_t ts_offset = body.size();
+                TimestampEncoder timestamps(&body);
+                for (int64_t timestamp : group.timestamps)
+                {
+                    timestamps.Append(timestamp);
+                }
+                header->t_min = std::min(header->t_min, group.timestamps.front());
+                header->t_max = std::max(header->t_max, group.timestamps.back());
+
+                PutString(&index, group.name);
+                Put<uint32_t>(&index, static_cast<uint32_t>(group.timestamps.size()));
+                Put<int64_t>(&index, group.timestamps.front());
+                Put<int64_t>(&index, group.timestamps.back());
+                Put<uint64_t>(&index, ts_offset);
+                Put<uint32_t>(&index, static_cast<uint32_t>(body.size() - ts_offset));
+                Put<uint32_t>(&index, static_cast<uint32_t>(group.columns.size()));
+
+                for (const ChunkColumn& column : group.columns)
+                {
+                    const uint64_t offset = body.size();
+                    FloatEncoder values(&body);
+                    float v_min = std::numeric_limits<float>::infinity();
+                    float v_max = -std::numeric_limits<float>::infinity();
+                    for (float value : column.values)
+                    {
+                        values.Append(value);
+                        if (std::isfinite(value))
+                        {
+                            v_min = std::min(v_min, value);
+                            v_max = std::max(v_max, value);
+                        }
+                    }
+                    PutString(&index, column.instance);
+                    PutString(&index, column.field);
+                    Put<float>(&index, v_min);
+                    Put<float>(&index, v_max);
+                    Put<uint64_t>(&index, offset);
+                    Put<uint32_t>(&index, static_cast<uint32_t>(body.size() - offset));
+                }
+            }
+
+            header->index_offset = body.size();
+            header->index_bytes = index.size();
+            body.append(index);
+            std::memcpy(&body[0], header, sizeof(ChunkHeader));
+            return body;
+        }
+    }  // namespace
+
+    /**
+     * @brief 映射后的块文件和解析后的索引
+     *
+     * 析构时解除映射；合并或过期删除的块在仍被查询持有时保持映射有效。
+     */
+    class ChunkStore::MappedChunk
+    {
+    public:
+        /**
+         * @brief 一列的索引
+         */
+        struct Column
+        {
+            std::string instance;   ///< 实例名
+            std::string field;      ///< 字段名
+            float v_min = 0;        ///< 最小值（全部缺失时为+inf）
+            float v_max = 0;        ///< 最大值（全部缺失时为-inf）
+            uint64_t offset = 0;    ///< 数值在文件中的位置
+            uint32_t bytes = 0;     ///< 数值字节数
+        };
+
+        /**
+         * @brief 一个分组的索引
+         */
+        struct Group
+        {
+            std::string name;             ///< 分组名
+            uint32_t points = 0;          ///< 点数
+            int64_t t_min = 0;            ///< 最早的点
+            int64_t t_max = 0;            ///< 最晚的点
+            uint64_t ts_offset = 0;       ///< 时间戳在文件中的位置
+            uint32_t ts_bytes = 0;        ///< 时间戳字节数
+            std::vector<Column> columns;  ///< 各列
+        };
+
+        ~MappedChunk()
+        {
+            if (data_ != nullptr)
+            {
+                munmap(const_cast<uint8_t*>(data_), size_);
+            }
+        }
+
+        /**
+         * @brief 映射块文件并解析索引
+         * @param path 文件路径
+         * @return std::shared_ptr<const MappedChunk> 映射，失败时为空
+         */
+        static std::shared_ptr<const MappedChunk> Open(const std::string& path)
+        {
+            const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return nullptr;
+            }
+            struct stat st;
+            if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ChunkHeader))
+            {
+                close(fd);
+                return nullptr;
+            }
+            void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);   // 映射不依赖fd
+            if (data == MAP_FAILED)
+            {
+                return nullptr;
+            }
+
+            auto chunk = std::shared_ptr<MappedChunk>(new MappedChunk());
+            chunk->data_ = static_cast<const uint8_t*>(data);
+            chunk->size_ = static_cast<size_t>(st.st_size);
+            return chunk->ParseIndex() ? chunk : nullptr;
+        }
+
+        /**
+         * @brief 查找分组
+         * @param name 分组名
+         * @return const Group* 分组索引，不存在时为nullptr
+         */
+        const Group* Find(const std::string& name) const
+        {
+            for (const Group& group : groups_)
+            {
+                if (group.name == name)
+                {
+                    return &group;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief 获取文件中某个位置的数据
+         * @param offset 位置（ParseIndex已检查不越界）
+         * @return const uint8_t* 数据
+         */
+        const uint8_t* At(uint64_t offset) const { return data_ + offset; }
+
+        /**
+         * @brief 解码整个块（合并时使用）
+         * @param groups 输出参数，各分组的数据
+         * @return bool 成功返回true
+         */
+        bool Decode(std::vector<ChunkGroup>* groups) const
+        {
+            groups->clear();
+            for (const Group& index : groups_)
+            {
+                ChunkGroup group;
+                group.name = index.name;
+                group.timestamps.resize(index.points);
+                TimestampDecoder timestamps(At(index.ts_offset), index.ts_bytes);
+                for (int64_t& timestamp : group.timestamps)
+                {
+                    if (!timestamps.Next(&timestamp))
+                    {
+                        return false;
+                    }
+                }
+                for (const Column& column_index : index.columns)
+                {
+                    ChunkColumn column{column_index.instance, column_index.field, std::vector<float>(index.points)};
+                    FloatDecoder values(At(column_index.offset), column_index.bytes);
+                    for (float& value : column.values)
+                    {
+                        if (!values.Next(&value))
+                        {
+                            return false;
+                        }
+                    }
+                    group.columns.push_back(std::move(column));
+                }
+                groups->push_back(std::move(group));
+            }
+            return true;
+        }
+
+    private:
+        MappedChunk() = default;
+
+        /**
+         * @brief 解析文件末尾的索引
+         * @return bool 索引完整且所有位置都在文件内返回true
+         */
+        bool ParseIndex()
+        {
+            ChunkHeader header;
+            std::memcpy(&header, data_, sizeof(header));
+            if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+                header.index_offset > size_ || header.index_bytes > size_ - header.index_offset)
+            {
+                return false;
+            }
+
+            Cursor cursor{data_ + header.index_offset, data_ + header.index_offset + header.index_bytes};
+            uint32_t group_count = 0;
+            if (!cursor.Get(&group_count))
+            {
+                return false;
+            }
+            auto in_file = [this](uint64_t offset, uint32_t bytes) {
+                return offset <= size_ && bytes <= size_ - offset;
+            };
+            groups_.resize(group_count);
+            for (Group& group : groups_)
+            {
+                uint32_t column_count = 0;
+                if (!cursor.GetString(&group.name) || !cursor.Get(&group.points) || !cursor.Get(&group.t_min) ||
+                    !cursor.Get(&group.t_max) || !cursor.Get(&group.ts_offset) || !cursor.Get(&group.ts_bytes) ||
+                    !cursor.Get(&column_count) || !in_file(group.ts_offset, group.ts_bytes))
+                {
+                    return false;
+                }
+                group.columns.resize(column_count);
+                for (Column& column : group.columns)
+                {
+                    if (!cursor.GetString(&column.instance) || !cursor.GetString(&column.field) ||
+                        !cursor.Get(&column.v_min) || !cursor.Get(&column.v_max) || !cursor.Get(&column.offset) ||
+                        !cursor.Get(&column.bytes) || !in_file(column.offset, column.bytes))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        const uint8_t* data_ = nullptr;   ///< 映射地址
+        size_t size_ = 0;                 ///< 文件大小
+        std::vector<Group> groups_;       ///< 各分组的索引
+    };
+
+    ChunkStore::~ChunkStore()
+    {
+        {
+            std::lock_guard<std::mutex> lock(stop_mutex_);
+            stopping_ = true;
+        }
+        stop_cv_.notify_all();
+        if (compactor_.joinable())
+        {
+            compactor_.join();
+        }
+    }
+
+    std::string ChunkStore::HostDir(const std::string& host) const
+    {
+        return options_.dir + "/" + EscapeHost(host);
+    }
+
+    std::shared_ptr<const ChunkStore::MappedChunk> ChunkStore::Map(const Chunk& chunk)
+    {
+        std::call_once(chunk.map_once, [&chunk]() { chunk.mapped = MappedChunk::Open(chunk.path); });
+        return chunk.mapped;
+    }
+
+    /**
+     * @brief 打开数据目录的具体实现
+     * @param options 存储配置
+     * @param error 输出参数，失败原因
+     * @return 成功返回true
+     *
+     * 每个块只pread文件头，索引在第一次查询时才映射解析，启动时间与数据量无关。
+     * 合并记录只在其合并结果已发布时生效，且只删除记录中列出的源块，不会误删其他分区的块。
+     */
+    bool ChunkStore::Open(const Options& options, std::string* error)
+    {
+        options_ = options;
+        options_.partition_ms = std::max<int64_t>(options_.partition_ms, 1);
+        options_.fan_in = std::max<size_t>(options_.fan_in, 2);
+        if (mkdir(options_.dir.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            *error = "mkdir " + options_.dir + ": " + std::strerror(errno);
+            return false;
+        }
+        DIR* root = opendir(options_.dir.c_str());
+        if (root == nullptr)
+        {
+            *error = "opendir " + options_.dir + ": " + std::strerror(errno);
+            return false;
+        }
+
+        uint64_t max_seq = 0;
+        while (dirent* host_entry = readdir(root))
+        {
+            const std::string host_name = host_entry->d_name;
+            if (host_name == "." || host_name == "..")
+            {
+                continue;
+            }
+            const std::string host_dir = options_.dir + "/" + host_name;
+            DIR* dir = opendir(host_dir.c_str());
+            if (dir == nullptr)
+            {
+                continue;   // 不是目录
+            }
+
+            ChunkList chunks;
+            std::vector<std::string> markers;
+            while (dirent* entry = readdir(dir))
+            {
+                const std::string name = entry->d_name;
+                const std::string path = host_dir + "/" + name;
+                if (EndsWith(name, ".tmp"))
+                {
+                    unlink(path.c_str());   // 未发布的块或合并记录（写入或合并到一半）
+                    continue;
+                }
+                if (EndsWith(name, ".merge"))
+                {
+                    markers.push_back(name);
+                    continue;
+                }
+                if (!EndsWith(name, ".chunk"))
+                {
+                    continue;
+                }
+
+                ChunkHeader header;
+                struct stat st;
+                const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                const bool valid = fd >= 0 && fstat(fd, &st) == 0 &&
+                    pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                    std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+                    header.index_offset + header.index_bytes <= static_cast<uint64_t>(st.st_size);
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+                if (!valid)
+                {
+                    std::cerr << "[ChunkStore] 跳过损坏的块: " << path << std::endl;
+                    continue;
+                }
+
+                auto chunk = std::make_shared<Chunk>();
+                chunk->path = path;
+                chunk->first_seq = header.first_seq;
+                chunk->last_seq = header.last_seq;
+                chunk->level = header.level;
+                chunk->t_min = header.t_min;
+                chunk->t_max = header.t_max;
+                chunk->partition = PartitionOf(header.t_min, options_.partition_ms);
+                chunk->bytes = static_cast<uint64_t>(st.st_size);
+                chunks.push_back(std::move(chunk));
+            }
+            closedir(dir);
+
+            // 按合并记录删除源块（合并结果已发布、源块还没删除时崩溃）；
+            // 合并结果未发布时源块仍然有效，只删除记录
+            std::vector<std::string> replaced;
+            for (const std::string& marker : markers)
+            {
+                const std::string marker_path = host_dir + "/" + marker;
+                const std::string result = host_dir + "/" + marker.substr(0, marker.size() - 6) + ".chunk";
+                const bool published = std::any_of(chunks.begin(), chunks.end(),
+                    [&](const std::shared_ptr<Chunk>& chunk) { return chunk->path == result; });
+                std::string contents;
+                if (published && ReadFile(marker_path, &contents))
+                {
+                    size_t begin = 0;
+                    for (size_t end = contents.find('\n'); end != std::string::npos; end = contents.find('\n', begin))
+                    {
+                        replaced.push_back(host_dir + "/" + contents.substr(begin, end - begin));
+                        begin = end + 1;
+                    }
+                }
+                unlink(marker_path.c_str());
+            }
+            ChunkList kept;
+            for (const auto& chunk : chunks)
+            {
+                if (std::find(replaced.begin(), replaced.end(), chunk->path) != replaced.end())
+                {
+                    unlink(chunk->path.c_str());
+                    continue;
+                }
+                max_seq = std::max(max_seq, chunk->last_seq);
+                kept.push_back(chunk);
+            }
+            if (!kept.empty())
+            {
+                std::sort(kept.begin(), kept.end(), ChunkBefore<std::shared_ptr<Chunk>>);
+                hosts_[UnescapeHost(host_name)] = std::move(kept);
+            }
+        }
+        closedir(root);
+        next_seq_ = max_seq + 1;
+
+        compactor_ = std::thread([this]() { CompactionLoop(); });
+        return true;
+    }
+
+    /**
+     * @brief 发布块文件的具体实现
+     * @param host 主机名
+     * @param groups 数据
+     * @param level 合并层数
+     * @param first_seq 首序号
+     * @param last_seq 末序号
+     * @return 发布的块，失败时为空
+     *
+     * 先写临时文件（可选fsync），再rename为正式文件名：读者和重启后的扫描只会看到完整的块。
+     */
+    std::shared_ptr<ChunkStore::Chunk> ChunkStore::WriteChunk(const std::string& host,
+        const std::vector<ChunkGroup>& groups, uint32_t level, uint64_t first_seq, uint64_t last_seq) const
+    {
+        ChunkHeader header;
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.level = level;
+        header.first_seq = first_seq;
+        header.last_seq = last_seq;
+        const std::string body = EncodeChunk(groups, &header);
+
+        const std::string dir = HostDir(host);
+        if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            std::cerr << "[ChunkStore] mkdir " << dir << ": " << std::strerror(errno) << std::endl;
+            return nullptr;
+        }
+        const std::string name = SeqFileName(first_seq, last_seq, ".chunk");
+        if (!PublishFile(dir, name, body, options_.sync))
+        {
+            return nullptr;
+        }
+
+        auto chunk = std::make_shared<Chunk>();
+        chunk->path = dir + "/" + name;
+        chunk->first_seq = first_seq;
+        chunk->last_seq = last_seq;
+        chunk->level = level;
+        chunk->t_min = header.t_min;
+        chunk->t_max = header.t_max;
+        chunk->partition = PartitionOf(header.t_min, options_.partition_ms);
+        chunk->bytes = body.size();
+        return chunk;
+    }
+
+    /**
+     * @brief 写入一批数据的具体实现
+     * @param host 主机名
+     * @param groups 各分组的数据
+     * @return 全部写入成功返回true
+     *
+     * 按分区拆分，保证每个块只属于一个分区（分区内的块可以整体合并和过期删除）。
+     */
+    bool ChunkStore::Write(const std::string& host, const std::vector<ChunkGroup>& groups)
+    {
+        std::map<int64_t, std::vector<ChunkGroup>> partitions;
+        for (const ChunkGroup& group : groups)
+        {
+            for (size_t i = 0; i < group.timestamps.size(); ++i)
+            {
+                std::vector<ChunkGroup>& part = partitions[PartitionOf(group.timestamps[i], options_.partition_ms)];
+                if (part.empty() || part.back().name != group.name)
+                {
+                    ChunkGroup split;
+                    split.name = group.name;
+                    for (const ChunkColumn& column : group.columns)
+                    {
+                        split.columns.push_back(ChunkColumn{column.instance, column.field, {}});
+                    }
+                    part.push_back(std::move(split));
+                }
+                ChunkGroup& split = part.back();
+                split.timestamps.push_back(group.timestamps[i]);
+                for (size_t c = 0; c < group.columns.size(); ++c)
+                {
+                    split.columns[c].values.push_back(group.columns[c].values[i]);
+                }
+            }
+        }
+
+        bool ok = true;
+        for (const auto& [partition, part] : partitions)
+        {
+            uint64_t seq = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                seq = next_seq_++;
+            }
+            std::shared_ptr<Chunk> chunk = WriteChunk(host, part, 0, seq, seq);
+            if (!chunk)
+            {
+                ok = false;
+                continue;
+            }
+            Replace(host, {}, chunk);
+        }
+        return ok;
+    }
+
+    void ChunkStore::Replace(const std::string& host, const ChunkList& removed, const std::shared_ptr<Chunk>& added)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ChunkList& chunks = hosts_[host];
+        chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [&](const std::shared_ptr<Chunk>& chunk) {
+            return std::find(removed.begin(), removed.end(), chunk) != removed.end();
+        }), chunks.end());
+        if (added)
+        {
+            chunks.insert(std::upper_bound(chunks.begin(), chunks.end(), added, ChunkBefore<std::shared_ptr<Chunk>>),
+                added);
+        }
+    }
+
+    /**
+     * @brief 区间查询的具体实现
+     * @return 磁盘上存在该序列返回true
+     *
+     * 先按文件头的时间范围跳过不相交的块，再按分组索引的时间范围跳过；
+     * 时间戳和数值同步解码，越过区间终点即停止。
+     */
+    bool ChunkStore::QueryRange(const std::string& host, const std::string& group, const std::string& instance,
+        const std::string& field, int64_t t0_ms, int64_t t1_ms, int64_t before_ms,
+        monitor::proto::RangeResponse* response) const
+    {
+        ChunkList chunks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = hosts_.find(host);
+            if (iter == hosts_.end())
+            {
+                return false;
+            }
+            chunks = iter->second;
+        }
+
+        bool found = false;
+        for (const auto& chunk : chunks)
+        {
+            if (chunk->t_max < t0_ms || chunk->t_min > t1_ms || chunk->t_min >= before_ms)
+            {
+                continue;
+            }
+            std::shared_ptr<const MappedChunk> mapped = Map(*chunk);
+            const MappedChunk::Group* index = mapped ? mapped->Find(group) : nullptr;
+            if (index == nullptr)
+            {
+                continue;
+            }
+            auto column = std::find_if(index->columns.begin(), index->columns.end(),
+                [&](const MappedChunk::Column& c) { return c.instance == instance && c.field == field; });
+            if (column == index->columns.end())
+            {
+                continue;
+            }
+            found = true;
+            if (index->t_max < t0_ms || index->t_min > t1_ms)
+            {
+                continue;
+            }
+
+            TimestampDecoder timestamps(mapped->At(index->ts_offset), index->ts_bytes);
+            FloatDecoder values(mapped->At(column->offset), column->bytes);
+            for (uint32_t i = 0; i < index->points; ++i)
+            {
+                int64_t timestamp = 0;
+                float value = 0;
+                if (!timestamps.Next(&timestamp) || !values.Next(&value) || timestamp > t1_ms || timestamp >= before_ms)
+                {
+                    break;
+                }
+                if (timestamp < t0_ms || value != value)
+                {
+                    continue;   // 区间之前，或该实例在这次采样中缺失（NaN）
+                }
+                response->add_timestamp_ms(timestamp);
+                response->add_value(value);
+            }
+        }
+        return found;
+    }
+
+    int64_t ChunkStore::LastTimestamp(const std::string& host, const std::string& group) const
+    {
+        ChunkList chunks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = hosts_.find(host);
+            if (iter == hosts_.end())
+            {
+                return 0;
+            }
+            chunks = iter->second;
+        }
+        for (auto iter = chunks.rbegin(); iter != chunks.rend(); ++iter)
+        {
+            std::shared_ptr<const MappedChunk> mapped = Map(**iter);
+            const MappedChunk::Group* index = mapped ? mapped->Find(group) : nullptr;
+            if (index != nullptr)
+            {
+                return index->t_max;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief 合并连续块的具体实现
+     * @param host 主机名
+     * @param sources 被合并的块
+     * @return 成功返回true
+     *
+     * 源块在合并时已被映射，发布合并结果并删除源文件后，正在读取源块的查询不受影响。
+     * 发布合并结果前先发布一份合并记录（源块的文件名），删除源块后再删除记录：
+     * 中途崩溃时启动扫描按记录删除源块，而不是按序号范围猜测哪些块被覆盖。
+     */
+    bool ChunkStore::Merge(const std::string& host, const ChunkList& sources)
+    {
+        std::vector<ChunkGroup> merged;
+        std::vector<ChunkGroup> groups;
+        uint32_t level = 0;
+        uint64_t first_seq = sources.front()->first_seq;
+        uint64_t last_seq = sources.front()->last_seq;
+        for (const auto& source : sources)
+        {
+            std::shared_ptr<const MappedChunk> mapped = Map(*source);
+            if (!mapped || !mapped->Decode(&groups))
+            {
+                std::cerr << "[ChunkStore] 无法读取块: " << source->path << std::endl;
+                return false;
+            }
+            AppendGroups(&merged, &groups);
+            level = std::max(level, source->level + 1);
+            first_seq = std::min(first_seq, source->first_seq);
+            last_seq = std::max(last_seq, source->last_seq);
+        }
+
+        std::string record;
+        for (const auto& source : sources)
+        {
+            record += source->path.substr(source->path.rfind('/') + 1);
+            record += '\n';
+        }
+        const std::string dir = HostDir(host);
+        const std::string marker = SeqFileName(first_seq, last_seq, ".merge");
+        if (!PublishFile(dir, marker, record, options_.sync))
+        {
+            return false;
+        }
+
+        std::shared_ptr<Chunk> chunk = WriteChunk(host, merged, level, first_seq, last_seq);
+        if (!chunk)
+        {
+            unlink((dir + "/" + marker).c_str());
+            return false;
+        }
+        Replace(host, sources, chunk);
+        for (const auto& source : sources)
+        {
+            unlink(source->path.c_str());
+        }
+        unlink((dir + "/" + marker).c_str());
+        return true;
+    }
+
+    /**
+     * @brief 一轮合并的具体实现
+     * @param now_ms 当前时间
+     *
+     * 每台主机：删除过期的块；已结束的分区合并为一个块；
+     * 其余分区中连续fan_in个同层的块合并为一个上一层的块，直到没有可合并的块。
+     */
+    void ChunkStore::Compact(int64_t now_ms)
+    {
+        std::vector<std::pair<std::string, ChunkList>> hosts;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            hosts.assign(hosts_.begin(), hosts_.end());
+        }
+
+        for (auto& [host, chunks] : hosts)
+        {
+            {
+                std::lock_guard<std::mutex> lock(stop_mutex_);
+                if (stopping_)
+                {
+                    return;
+                }
+            }
+
+            // 过期删除
+            ChunkList expired;
+            ChunkList live;
+            for (const auto& chunk : chunks)
+            {
+                (chunk->t_max < now_ms - options_.retention_ms ? expired : live).push_back(chunk);
+            }
+            if (!expired.empty())
+            {
+                Replace(host, expired, nullptr);
+                for (const auto& chunk : expired)
+                {
+                    unlink(chunk->path.c_str());
+                }
+            }
+
+            // 逐个分区合并（块已按分区排序）
+            for (size_t begin = 0; begin < live.size();)
+            {
+                size_t end = begin;
+                while (end < live.size() && live[end]->partition == live[begin]->partition)
+                {
+                    ++end;
+                }
+                ChunkList partition(live.begin() + static_cast<ptrdiff_t>(begin), live.begin() + static_cast<ptrdiff_t>(end));
+                const int64_t partition_end = (live[begin]->partition + 1) * options_.partition_ms;
+                begin = end;
+
+                if (partition_end + kPartitionGraceMs <= now_ms)
+                {
+                    if (partition.size() >= 2)
+                    {
+                        Merge(host, partition);
+                    }
+                    continue;
+                }
+
+                bool merged = true;
+                while (merged)
+                {
+                    merged = false;
+                    for (size_t i = 0; i + options_.fan_in <= partition.size(); ++i)
+                    {
+                        const auto run_end = partition.begin() + static_cast<ptrdiff_t>(i + options_.fan_in);
+                        const bool same_level = std::all_of(partition.begin() + static_cast<ptrdiff_t>(i), run_end,
+                            [&](const std::shared_ptr<Chunk>& chunk) { return chunk->level == partition[i]->level; });
+                        if (!same_level)
+                        {
+                            continue;
+                        }
+                        ChunkList run(partition.begin() + static_cast<ptrdiff_t>(i), run_end);
+                        if (!Merge(host, run))
+                        {
+                            break;
+                        }
+                        // 用合并结果替换本地列表中的源块，继续检查更高层
+                        {
+                            std::lock_guard<std::mutex> lock(mutex_);
+                            partition.clear();
+                            for (const auto& chunk : hosts_[host])
+                            {
+                                if (chunk->partition == run.front()->partition)
+                                {
+                                    partition.push_back(chunk);
+                                }
+                            }
+                        }
+                        merged = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    size_t ChunkStore::ChunkCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        for (const auto& entry : hosts_)
+        {
+            count += entry.second.size();
+        }
+        return count;
+    }
+
+    void ChunkStore::CompactionLoop()
+    {
+        std::unique_lock<std::mutex> lock(stop_mutex_);
+        while (!stop_cv_.wait_for(lock, std::chrono::milliseconds(options_.compaction_interval_ms),
+            [this]() { return stopping_; }))
+        {
+            lock.unlock();
+            Compact(NowMs());
+            lock.lock();
+        }
+    }
+}  // namespace monitor
@@ -0,0 +1,233 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <condition_variable>   // 唤醒合并线程
+#include <cstddef>              // size_t
+#include <cstdint>              // 定宽整数
+#include <memory>               // std::shared_ptr
+#include <mutex>                // 块列表锁
+#include <string>               // 主机名、路径
+#include <thread>               // 合并线程
+#include <unordered_map>        // 主机表
+#include <vector>               // 块列表、列数据
+
+// Protobuf生成的头文件
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+    /**
+     * @brief 一列数据（一个实例的一个数值字段），与所在分组的时间戳一一对应
+     */
+    struct ChunkColumn
+    {
+        std::string instance;        ///< 实例名（单实例分组为空）
+        std::string field;           ///< 数值字段名（如"cpu_percent"）
+        std::vector<float> values;   ///< 数值，缺失为NaN
+    };
+
+    /**
+     * @brief 一个分组（MonitorInfo的一个消息字段）在一段时间内的列式数据
+     */
+    struct ChunkGroup
+    {
+        std::string name;                   ///< 分组名（如"cpu_stat"）
+        std::vector<int64_t> timestamps;    ///< 采样时间（严格升序）
+        std::vector<ChunkColumn> columns;   ///< 各列
+    };
+
+    /**
+     * @brief 历史数据的磁盘存储：按时间分区的不可变列式块文件
+     *
+     * 目录结构：<dir>/<主机名>/<首序号>-<末序号>.chunk，每个文件是一台主机在一个分区
+     * （默认1天）内一段时间的全部分组。文件写入临时文件后rename发布，发布后不再修改。
+     *
+     * 块文件格式：
+     * - 64字节文件头：magic、版本、合并层数、序号范围、时间范围、索引位置
+     * - 数据区：每个分组一段时间戳（二阶差分编码），每列一段数值（Gorilla异或编码）
+     * - 索引（文件末尾）：每个分组的点数、时间范围和时间戳位置，每列的实例名、字段名、
+     *   最小/最大值和数值位置
+     * 查询时mmap块文件，只解析索引，再解码所需分组的时间戳和所需的一列：
+     * 查询一台主机一天的一条序列只访问该分区的块中这两段数据所在的页面。
+     *
+     * 合并：后台线程每compaction_interval_ms运行一次：
+     * - 分层合并：同一分区中连续fan_in个同层的块合并为一个上一层的块
+     *   （默认每分钟落盘一次时，第1层8分钟，第2层约1小时，第3层约8.5小时），写放大约为层数
+     * - 分区结束（加上kPartitionGraceMs）后，分区内剩余的块合并为一个
+     * - 删除所有数据都早于保留期限的块
+     * 合并结果的序号范围覆盖被合并的块；发布前先写一份列出源块文件名的合并记录（<首序号>-<末序号>.merge），
+     * 合并到一半崩溃时，启动时只删除已发布的合并结果的记录中列出的源块。
+     *
+     * 顺序：同一主机同一分组的数据按块序号递增落盘，块按(分区, 首序号)排序后依次读取即为时间顺序。
+     */
+    class ChunkStore
+    {
+    public:
+        /// @brief 文件头中的magic
+        static constexpr char kMagic[8] = {'M', 'O', 'N', 'C', 'H', 'N', 'K', '1'};
+
+        /// @brief 分区结束后等待迟到数据的时间（最后一次落盘可能在分区结束之后）
+        static constexpr int64_t kPartitionGraceMs = 10 * 60 * 1000;
+
+        /**
+         * @brief 存储配置
+         */
+        struct Options
+        {
+            std::string dir;                                    ///< 数据目录
+            int64_t retention_ms = 30LL * 24 * 3600 * 1000;     ///< 保留期限（默认30天）
+            int64_t partition_ms = 24LL * 3600 * 1000;          ///< 分区长度（默认1天）
+            int64_t compaction_interval_ms = 60 * 1000;         ///< 合并周期
+            size_t fan_in = 8;                                  ///< 分层合并时一次合并的块数
+            bool sync = true;                                   ///< 发布前fsync块文件
+        };
+
+        ChunkStore() = default;
+
+        /**
+         * @brief 析构函数，停止合并线程
+         */
+        ~ChunkStore();
+
+        // 持有线程和映射，禁止拷贝
+        ChunkStore(const ChunkStore&) = delete;
+        ChunkStore& operator=(const ChunkStore&) = delete;
+
+        /**
+         * @brief 打开数据目录并启动合并线程
+         * @param options 存储配置
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true
+         *
+         * 扫描已有的块文件（只读取文件头），删除未发布的临时文件，并按合并记录删除已被合并结果替代的源块。
+         */
+        bool Open(const Options& options, std::string* error);
+
+        /**
+         * @brief 把一台主机的一批数据写为新的块（跨分区时每个分区一个块）
+         * @param host 主机名
+         * @param groups 各分组的数据，同一分组的时间戳必须晚于之前写入的数据
+         * @return bool 全部写入成功返回true
+         */
+        bool Write(const std::string& host, const std::vector<ChunkGroup>& groups);
+
+        /**
+         * @brief 查询一条序列在时间区间内的数据
+         * @param host 主机名
+         * @param group 分组名
+         * @param instance 实例名
+         * @param field 数值字段名
+         * @param t0_ms 起始时间（包含）
+         * @param t1_ms 结束时间（包含）
+         * @param before_ms 只返回早于该时间的点（之后的点由内存中的环形缓冲区提供）
+         * @param response 输出参数，点追加在末尾（时间升序）
+         * @return bool 磁盘上存在该序列返回true
+         */
+        bool QueryRange(const std::string& host, const std::string& group, const std::string& instance,
+            const std::string& field, int64_t t0_ms, int64_t t1_ms, int64_t before_ms,
+            monitor::proto::RangeResponse* response) const;
+
+        /**
+         * @brief 获取一个分组已经落盘的最新时间
+         * @param host 主机名
+         * @param group 分组名
+         * @return int64_t 最新时间戳，没有数据时返回0
+         *
+         * 服务器重启后用于丢弃不晚于磁盘数据的采样，保证块中每个分组的时间严格递增。
+         */
+        int64_t LastTimestamp(const std::string& host, const std::string& group) const;
+
+        /**
+         * @brief 执行一轮合并和过期删除
+         * @param now_ms 当前时间（Unix毫秒）
+         */
+        void Compact(int64_t now_ms);
+
+        /**
+         * @brief 获取块文件总数
+         * @return size_t 块数
+         */
+        size_t ChunkCount() const;
+
+    private:
+        class MappedChunk;
+
+        /**
+         * @brief 一个块文件的元数据（文件头）
+         */
+        struct Chunk
+        {
+            std::string path;               ///< 文件路径
+            uint64_t first_seq = 0;         ///< 首序号
+            uint64_t last_seq = 0;          ///< 末序号（合并结果覆盖被合并块的序号范围）
+            uint32_t level = 0;             ///< 合并层数（新落盘的块为0）
+            int64_t t_min = 0;              ///< 最早的点
+            int64_t t_max = 0;              ///< 最晚的点
+            int64_t partition = 0;          ///< 分区号（t_min / partition_ms）
+            uint64_t bytes = 0;             ///< 文件大小
+            mutable std::once_flag map_once;                       ///< 保证只映射一次
+            mutable std::shared_ptr<const MappedChunk> mapped;     ///< 映射和解析后的索引
+        };
+
+        /// @brief 一台主机的块，按(分区, 首序号)排序
+        using ChunkList = std::vector<std::shared_ptr<Chunk>>;
+
+        /**
+         * @brief 映射块文件并解析索引（第一次访问时）
+         * @param chunk 块
+         * @return std::shared_ptr<const MappedChunk> 映射，文件损坏或不存在时为空
+         */
+        static std::shared_ptr<const MappedChunk> Map(const Chunk& chunk);
+
+        /**
+         * @brief 编码并发布一个块文件
+         * @param host 主机名
+         * @param groups 数据（都在同一分区内）
+         * @param level 合并层数
+         * @param first_seq 首序号
+         * @param last_seq 末序号
+         * @return std::shared_ptr<Chunk> 发布的块，失败时为空
+         */
+        std::shared_ptr<Chunk> WriteChunk(const std::string& host, const std::vector<ChunkGroup>& groups,
+            uint32_t level, uint64_t first_seq, uint64_t last_seq) const;
+
+        /**
+         * @brief 合并一台主机的若干个连续块
+         * @param host 主机名
+         * @param sources 被合并的块（同一分区，按顺序）
+         * @return bool 成功返回true
+         */
+        bool Merge(const std::string& host, const ChunkList& sources);
+
+        /**
+         * @brief 从块列表中删除若干块并加入替代的块，保持排序
+         * @param host 主机名
+         * @param removed 删除的块
+         * @param added 加入的块，可为空
+         */
+        void Replace(const std::string& host, const ChunkList& removed, const std::shared_ptr<Chunk>& added);
+
+        /**
+         * @brief 合并线程主循环
+         */
+        void CompactionLoop();
+
+        /**
+         * @brief 获取主机的数据目录（主机名中的特殊字符按%XX转义）
+         * @param host 主机名
+         * @return std::string 目录路径
+         */
+        std::string HostDir(const std::string& host) const;
+
+        Options options_;                                    ///< 存储配置
+        mutable std::mutex mutex_;                           ///< 保护hosts_和next_seq_
+        std::unordered_map<std::string, ChunkList> hosts_;   ///< 主机名到块列表
+        uint64_t next_seq_ = 1;                              ///< 下一个块序号
+
+        std::mutex stop_mutex_;                              ///< 保护stopping_
+        std::condition_variable stop_cv_;                    ///< 唤醒合并线程
+        bool stopping_ = false;                              ///< 是否正在停止
+        std::thread compactor_;                              ///< 合并线程
+    };
+}  // namespace monitor
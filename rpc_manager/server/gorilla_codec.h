@@ -0,0 +1,372 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <cstddef>   // size_t
+#include <cstdint>   // 定宽整数
+#include <cstring>   // std::memcpy
+#include <string>    // 编码输出
+
+namespace monitor
+{
+    /**
+     * @brief 按位写入（高位在前）
+     */
+    class BitWriter
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param out 输出缓冲区，写入的位追加在其末尾
+         */
+        explicit BitWriter(std::string* out) : out_(out) {}
+
+        /**
+         * @brief 写入若干位
+         * @param bits 数值，只使用低count位
+         * @param count 位数（0~64）
+         */
+        void Write(uint64_t bits, int count)
+        {
+            while (count > 0)
+            {
+                if (free_ == 0)
+                {
+                    out_->push_back('\0');
+                    free_ = 8;
+                }
+                const int n = count < free_ ? count : free_;
+                const uint8_t chunk = static_cast<uint8_t>((bits >> (count - n)) & ((1u << n) - 1));
+                out_->back() = static_cast<char>(static_cast<uint8_t>(out_->back()) | (chunk << (free_ - n)));
+                free_ -= n;
+                count -= n;
+            }
+        }
+
+    private:
+        std::string* out_;   ///< 输出缓冲区
+        int free_ = 0;       ///< 最后一个字节中尚未使用的位数
+    };
+
+    /**
+     * @brief 按位读取（高位在前），越界时读取失败
+     */
+    class BitReader
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param data 数据
+         * @param size 字节数
+         */
+        BitReader(const uint8_t* data, size_t size) : data_(data), bits_(size * 8) {}
+
+        /**
+         * @brief 读取若干位
+         * @param count 位数（0~64）
+         * @param value 输出参数，读取的数值
+         * @return bool 剩余位数足够返回true
+         */
+        bool Read(int count, uint64_t* value)
+        {
+            if (position_ + static_cast<size_t>(count) > bits_)
+            {
+                return false;
+            }
+            uint64_t result = 0;
+            while (count > 0)
+            {
+                const int offset = static_cast<int>(position_ % 8);
+                const int n = count < 8 - offset ? count : 8 - offset;
+                const uint8_t byte = data_[position_ / 8];
+                result = (result << n) | ((byte >> (8 - offset - n)) & ((1u << n) - 1));
+                position_ += n;
+                count -= n;
+            }
+            *value = result;
+            return true;
+        }
+
+    private:
+        const uint8_t* data_;   ///< 数据
+        size_t bits_;           ///< 总位数
+        size_t position_ = 0;   ///< 下一个读取的位
+    };
+
+    /**
+     * @brief 时间戳的二阶差分编码（Gorilla）
+     *
+     * 第一个时间戳写64位，之后写与上一个差值之差（delta-of-delta）：
+     * 0写1位'0'；[-63,64]写'10'+7位；[-255,256]写'110'+9位；[-2047,2048]写'1110'+12位；
+     * 其余写'1111'+64位。固定周期采样的时间戳每个点只占1位，抖动几毫秒时占9位。
+     */
+    class TimestampEncoder
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param out 输出缓冲区
+         */
+        explicit TimestampEncoder(std::string* out) : writer_(out) {}
+
+        /**
+         * @brief 追加一个时间戳
+         * @param timestamp_ms 时间戳（毫秒）
+         */
+        void Append(int64_t timestamp_ms)
+        {
+            if (count_++ == 0)
+            {
+                writer_.Write(static_cast<uint64_t>(timestamp_ms), 64);
+                previous_ = timestamp_ms;
+                return;
+            }
+            const int64_t delta = timestamp_ms - previous_;
+            const int64_t dod = delta - previous_delta_;
+            if (dod == 0)
+            {
+                writer_.Write(0, 1);
+            }
+            else if (dod >= -63 && dod <= 64)
+            {
+                writer_.Write(0b10, 2);
+                writer_.Write(static_cast<uint64_t>(dod + 63), 7);
+            }
+            else if (dod >= -255 && dod <= 256)
+            {
+                writer_.Write(0b110, 3);
+                writer_.Write(static_cast<uint64_t>(dod + 255), 9);
+            }
+            else if (dod >= -2047 && dod <= 2048)
+            {
+                writer_.Write(0b1110, 4);
+                writer_.Write(static_cast<uint64_t>(dod + 2047), 12);
+            }
+            else
+            {
+                writer_.Write(0b1111, 4);
+                writer_.Write(static_cast<uint64_t>(dod), 64);
+            }
+            previous_delta_ = delta;
+            previous_ = timestamp_ms;
+        }
+
+    private:
+        BitWriter writer_;            ///< 位输出
+        size_t count_ = 0;            ///< 已写入的时间戳数
+        int64_t previous_ = 0;        ///< 上一个时间戳
+        int64_t previous_delta_ = 0;  ///< 上一个差值
+    };
+
+    /**
+     * @brief 时间戳二阶差分解码
+     */
+    class TimestampDecoder
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param data 编码数据
+         * @param size 字节数
+         */
+        TimestampDecoder(const uint8_t* data, size_t size) : reader_(data, size) {}
+
+        /**
+         * @brief 读取下一个时间戳
+         * @param timestamp_ms 输出参数，时间戳
+         * @return bool 成功返回true，数据截断时返回false
+         */
+        bool Next(int64_t* timestamp_ms)
+        {
+            uint64_t bits = 0;
+            if (count_++ == 0)
+            {
+                if (!reader_.Read(64, &bits))
+                {
+                    return false;
+                }
+                previous_ = static_cast<int64_t>(bits);
+                *timestamp_ms = previous_;
+                return true;
+            }
+
+            // 前缀：连续的1的个数（最多4个）决定后续位数
+            int ones = 0;
+            while (ones < 4)
+            {
+                if (!reader_.Read(1, &bits))
+                {
+                    return false;
+                }
+                if (bits == 0)
+                {
+                    break;
+                }
+                ++ones;
+            }
+            static constexpr int kWidths[] = {0, 7, 9, 12, 64};
+            static constexpr int64_t kBiases[] = {0, 63, 255, 2047, 0};
+            int64_t dod = 0;
+            if (ones > 0)
+            {
+                if (!reader_.Read(kWidths[ones], &bits))
+                {
+                    return false;
+                }
+                dod = static_cast<int64_t>(bits) - kBiases[ones];
+            }
+            previous_delta_ += dod;
+            previous_ += previous_delta_;
+            *timestamp_ms = previous_;
+            return true;
+        }
+
+    private:
+        BitReader reader_;            ///< 位输入
+        size_t count_ = 0;            ///< 已读取的时间戳数
+        int64_t previous_ = 0;        ///< 上一个时间戳
+        int64_t previous_delta_ = 0;  ///< 上一个差值
+    };
+
+    /**
+     * @brief 浮点数的异或编码（Gorilla，32位float）
+     *
+     * 第一个值写32位，之后写与上一个值的位模式的异或：
+     * 相同写1位'0'；否则写'1'，有效位落在上一次的前导零/尾随零窗口内时写'0'+窗口内的位，
+     * 否则写'1'+5位前导零数+5位（有效位数-1）+有效位。变化缓慢的指标每个点只占几位，
+     * 缺失值（NaN）连续出现时每个点1位。
+     */
+    class FloatEncoder
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param out 输出缓冲区
+         */
+        explicit FloatEncoder(std::string* out) : writer_(out) {}
+
+        /**
+         * @brief 追加一个值
+         * @param value 数值
+         */
+        void Append(float value)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            if (count_++ == 0)
+            {
+                writer_.Write(bits, 32);
+                previous_ = bits;
+                return;
+            }
+
+            const uint32_t x = bits ^ previous_;
+            previous_ = bits;
+            if (x == 0)
+            {
+                writer_.Write(0, 1);
+                return;
+            }
+            writer_.Write(1, 1);
+            const int leading = __builtin_clz(x);
+            const int trailing = __builtin_ctz(x);
+            if (has_window_ && leading >= leading_ && trailing >= trailing_)
+            {
+                writer_.Write(0, 1);
+                writer_.Write(x >> trailing_, 32 - leading_ - trailing_);
+                return;
+            }
+            const int length = 32 - leading - trailing;
+            writer_.Write(1, 1);
+            writer_.Write(static_cast<uint64_t>(leading), 5);
+            writer_.Write(static_cast<uint64_t>(length - 1), 5);
+            writer_.Write(x >> trailing, length);
+            leading_ = leading;
+            trailing_ = trailing;
+            has_window_ = true;
+        }
+
+    private:
+        BitWriter writer_;          ///< 位输出
+        size_t count_ = 0;          ///< 已写入的值个数
+        uint32_t previous_ = 0;     ///< 上一个值的位模式
+        int leading_ = 0;           ///< 当前窗口的前导零数
+        int trailing_ = 0;          ///< 当前窗口的尾随零数
+        bool has_window_ = false;   ///< 是否已有窗口
+    };
+
+    /**
+     * @brief 浮点数异或解码
+     */
+    class FloatDecoder
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param data 编码数据
+         * @param size 字节数
+         */
+        FloatDecoder(const uint8_t* data, size_t size) : reader_(data, size) {}
+
+        /**
+         * @brief 读取下一个值
+         * @param value 输出参数，数值
+         * @return bool 成功返回true，数据截断时返回false
+         */
+        bool Next(float* value)
+        {
+            uint64_t bits = 0;
+            if (count_++ == 0)
+            {
+                if (!reader_.Read(32, &bits))
+                {
+                    return false;
+                }
+                previous_ = static_cast<uint32_t>(bits);
+            }
+            else
+            {
+                if (!reader_.Read(1, &bits))
+                {
+                    return false;
+                }
+                if (bits == 1)
+                {
+                    if (!reader_.Read(1, &bits))
+                    {
+                        return false;
+                    }
+                    if (bits == 1)
+                    {
+                        uint64_t leading = 0;
+                        uint64_t length = 0;
+                        if (!reader_.Read(5, &leading) || !reader_.Read(5, &length))
+                        {
+                            return false;
+                        }
+                        leading_ = static_cast<int>(leading);
+                        trailing_ = 32 - leading_ - static_cast<int>(length + 1);
+                        if (trailing_ < 0)
+                        {
+                            return false;
+                        }
+                    }
+                    if (!reader_.Read(32 - leading_ - trailing_, &bits))
+                    {
+                        return false;
+                    }
+                    previous_ ^= static_cast<uint32_t>(bits << trailing_);
+                }
+            }
+            std::memcpy(value, &previous_, sizeof(*value));
+            return true;
+        }
+
+    private:
+        BitReader reader_;          ///< 位输入
+        size_t count_ = 0;          ///< 已读取的值个数
+        uint32_t previous_ = 0;     ///< 上一个值的位模式
+        int leading_ = 0;           ///< 当前窗口的前导零数
+        int trailing_ = 0;          ///< 当前窗口的尾随零数
+    };
+}  // namespace monitor
@@ -0,0 +1,374 @@
+// 包含对应的头文件
+#include "host_store.h"
+
+// C++标准库头文件
+#include <functional>   // std::hash
+#include <utility>      // std::move
+
+namespace monitor
+{
+    namespace
+    {
+        /**
+         * @brief 获取MonitorInfo字段在声明顺序中的位置（快照部分的下标）
+         * @param number 字段编号
+         * @return int 字段下标，没有该字段时返回-1
+         */
+        int FieldIndex(int number)
+        {
+            const google::protobuf::FieldDescriptor* field =
+                monitor::proto::MonitorInfo::descriptor()->FindFieldByNumber(number);
+            return field ? field->index() : -1;
+        }
+
+        /**
+         * @brief 通过反射把一个顶层字段从旧快照拷贝到新快照
+         * @param from 旧快照
+         * @param to 新快照
+         * @param field 字段描述符
+         */
+        void CopyField(const google::protobuf::Message& from, google::protobuf::Message* to,
+            const google::protobuf::FieldDescriptor* field)
+        {
+            using google::protobuf::FieldDescriptor;
+            const google::protobuf::Reflection* reflection = from.GetReflection();
+
+            if (field->is_repeated())
+            {
+                const int size = reflection->FieldSize(from, field);
+                for (int i = 0; i < size; ++i)
+                {
+                    switch (field->cpp_type())
+                    {
+                    case FieldDescriptor::CPPTYPE_MESSAGE:
+                        reflection->AddMessage(to, field)->CopyFrom(reflection->GetRepeatedMessage(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_STRING:
+                        reflection->AddString(to, field, reflection->GetRepeatedString(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_INT32:
+                        reflection->AddInt32(to, field, reflection->GetRepeatedInt32(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_INT64:
+                        reflection->AddInt64(to, field, reflection->GetRepeatedInt64(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_UINT32:
+                        reflection->AddUInt32(to, field, reflection->GetRepeatedUInt32(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_UINT64:
+                        reflection->AddUInt64(to, field, reflection->GetRepeatedUInt64(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_FLOAT:
+                        reflection->AddFloat(to, field, reflection->GetRepeatedFloat(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_DOUBLE:
+                        reflection->AddDouble(to, field, reflection->GetRepeatedDouble(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_BOOL:
+                        reflection->AddBool(to, field, reflection->GetRepeatedBool(from, field, i));
+                        break;
+                    case FieldDescriptor::CPPTYPE_ENUM:
+                        reflection->AddEnumValue(to, field, reflection->GetRepeatedEnumValue(from, field, i));
+                        break;
+                    }
+                }
+                return;
+            }
+
+            switch (field->cpp_type())
+            {
+            case FieldDescriptor::CPPTYPE_MESSAGE:
+                reflection->MutableMessage(to, field)->CopyFrom(reflection->GetMessage(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_STRING:
+                reflection->SetString(to, field, reflection->GetString(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_INT32:
+                reflection->SetInt32(to, field, reflection->GetInt32(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_INT64:
+                reflection->SetInt64(to, field, reflection->GetInt64(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_UINT32:
+                reflection->SetUInt32(to, field, reflection->GetUInt32(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_UINT64:
+                reflection->SetUInt64(to, field, reflection->GetUInt64(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_FLOAT:
+                reflection->SetFloat(to, field, reflection->GetFloat(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_DOUBLE:
+                reflection->SetDouble(to, field, reflection->GetDouble(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_BOOL:
+                reflection->SetBool(to, field, reflection->GetBool(from, field));
+                break;
+            case FieldDescriptor::CPPTYPE_ENUM:
+                reflection->SetEnumValue(to, field, reflection->GetEnumValue(from, field));
+                break;
+            }
+        }
+    }  // namespace
+
+    /**
+     * @brief 获取字段编码的具体实现
+     * @return 字段编码
+     *
+     * 只包含一个顶层字段的消息，序列化结果就是该字段的线格式编码。
+     */
+    const std::string& SnapshotPart::Serialized() const
+    {
+        std::call_once(serialize_once_, [this]() { message_.SerializeToString(&serialized_); });
+        return serialized_;
+    }
+
+    const monitor::proto::MonitorInfo& SampleSnapshot::Field(int number) const
+    {
+        const int index = FieldIndex(number);
+        return index >= 0 && parts_[index] ? parts_[index]->Message() : monitor::proto::MonitorInfo::default_instance();
+    }
+
+    /**
+     * @brief 获取序列化结果的具体实现
+     * @return 序列化结果
+     *
+     * 按字段声明顺序拼接各部分的编码；快照发布后不可变，序列化结果在其生命周期内始终有效。
+     */
+    const std::string& SampleSnapshot::Serialized() const
+    {
+        std::call_once(serialize_once_, [this]() {
+            size_t size = 0;
+            for (const Part& part : parts_)
+            {
+                size += part ? part->Serialized().size() : 0;
+            }
+            serialized_.reserve(size);
+            for (const Part& part : parts_)
+            {
+                if (part)
+                {
+                    serialized_.append(part->Serialized());
+                }
+            }
+        });
+        return serialized_;
+    }
+
+    HostStore::Shard& HostStore::ShardFor(const std::string& host)
+    {
+        return shards_[std::hash<std::string>()(host) % kShardCount];
+    }
+
+    const HostStore::Shard& HostStore::ShardFor(const std::string& host) const
+    {
+        return shards_[std::hash<std::string>()(host) % kShardCount];
+    }
+
+    HostStore::HostSlot* HostStore::FindSlot(const Shard& shard, const std::string& host)
+    {
+        std::shared_ptr<const HostTable> table = shard.table.load(std::memory_order_acquire);
+        if (!table)
+        {
+            return nullptr;
+        }
+        auto iter = table->find(host);
+        return iter == table->end() ? nullptr : iter->second.get();
+    }
+
+    /**
+     * @brief 查找或创建主机槽位的具体实现
+     * @param shard 主机所在分片
+     * @param host 主机名
+     * @return 主机槽位
+     *
+     * 新主机只在第一次上报时出现一次：在分片锁内复制主机表、插入新槽位后整体发布，
+     * 正在读取旧表的读者不受影响。槽位由shared_ptr持有，新旧主机表共享同一槽位。
+     */
+    HostStore::HostSlot* HostStore::FindOrCreateSlot(Shard& shard, const std::string& host)
+    {
+        if (HostSlot* slot = FindSlot(shard, host))
+        {
+            return slot;
+        }
+
+        std::lock_guard<std::mutex> lock(shard.insert_mutex);
+        std::shared_ptr<const HostTable> table = shard.table.load(std::memory_order_acquire);
+        if (table)
+        {
+            auto iter = table->find(host);
+            if (iter != table->end())
+            {
+                return iter->second.get();   // 等锁期间已被其他写者创建
+            }
+        }
+
+        auto next = table ? std::make_shared<HostTable>(*table) : std::make_shared<HostTable>();
+        auto slot = std::make_shared<HostSlot>();
+        (*next)[host] = slot;
+        shard.table.store(std::move(next), std::memory_order_release);
+        return slot.get();
+    }
+
+    /**
+     * @brief 构造新快照的具体实现
+     * @param previous 旧快照
+     * @param host 主机名
+     * @param sample_parts 采样中出现的字段部分
+     * @return 新快照
+     *
+     * 采样中出现的字段使用新部分；采样中没有、旧快照中有的字段与旧快照共享同一部分
+     * （局部批次保留其他监控器的最新数据，只复制指针）。
+     */
+    std::shared_ptr<SampleSnapshot> HostStore::BuildSnapshot(
+        const Snapshot& previous, const std::string& host, const std::vector<SampleSnapshot::Part>& sample_parts)
+    {
+        auto next = std::make_shared<SampleSnapshot>();
+        next->name_ = host;
+        next->parts_ = sample_parts;
+        if (previous)
+        {
+            for (size_t i = 0; i < sample_parts.size(); ++i)
+            {
+                if (!sample_parts[i])
+                {
+                    next->parts_[i] = previous->parts_[i];
+                }
+            }
+        }
+        return next;
+    }
+
+    bool HostStore::Publish(HostSlot* slot, Snapshot* previous, std::shared_ptr<SampleSnapshot> next)
+    {
+        // 交换失败时previous被更新为当前发布的快照
+        if (slot->snapshot.compare_exchange_strong(*previous, std::move(next),
+                std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            latest_.store(slot, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 写入采样的具体实现
+     * @param sample 采样消息
+     *
+     * 采样中出现的字段逐个交换进各自的新部分（repeated/message字段只交换指针）。
+     * 新快照构造完成后用比较并交换发布：
+     * 如果构造期间同一主机被其他写者更新（同名主机并发上报），用同一组新部分基于最新快照重新构造。
+     */
+    HostStore::Snapshot HostStore::Update(monitor::proto::MonitorInfo* sample)
+    {
+        if (sample->name().empty())
+        {
+            sample->set_name("unknown_host");
+        }
+        const std::string host = sample->name();   // 主机名随字段一起交换走
+        HostSlot* slot = FindOrCreateSlot(ShardFor(host), host);
+
+        std::vector<const google::protobuf::FieldDescriptor*> sample_fields;
+        const google::protobuf::Reflection* reflection = sample->GetReflection();
+        reflection->ListFields(*sample, &sample_fields);
+
+        std::vector<SampleSnapshot::Part> sample_parts(monitor::proto::MonitorInfo::descriptor()->field_count());
+        for (const auto* field : sample_fields)
+        {
+            auto part = std::make_shared<SnapshotPart>();
+            reflection->SwapFields(part->MutableMessage(), sample, {field});
+            sample_parts[field->index()] = std::move(part);
+        }
+
+        Snapshot previous = slot->snapshot.load(std::memory_order_acquire);
+        while (true)
+        {
+            std::shared_ptr<SampleSnapshot> next = BuildSnapshot(previous, host, sample_parts);
+            if (Publish(slot, &previous, next))
+            {
+                return next;
+            }
+        }
+    }
+
+    /**
+     * @brief 写入只读采样的具体实现
+     * @param sample 采样消息
+     *
+     * 与移动版本相同的比较并交换流程，采样字段通过反射逐个拷贝进各自的新部分。
+     */
+    HostStore::Snapshot HostStore::Update(const monitor::proto::MonitorInfo& sample)
+    {
+        static const std::string kUnknownHost = "unknown_host";
+        const std::string& host = sample.name().empty() ? kUnknownHost : sample.name();
+        HostSlot* slot = FindOrCreateSlot(ShardFor(host), host);
+
+        std::vector<const google::protobuf::FieldDescriptor*> sample_fields;
+        sample.GetReflection()->ListFields(sample, &sample_fields);
+
+        std::vector<SampleSnapshot::Part> sample_parts(monitor::proto::MonitorInfo::descriptor()->field_count());
+        for (const auto* field : sample_fields)
+        {
+            auto part = std::make_shared<SnapshotPart>();
+            CopyField(sample, part->MutableMessage(), field);
+            sample_parts[field->index()] = std::move(part);
+        }
+        auto name = std::make_shared<SnapshotPart>();
+        name->MutableMessage()->set_name(host);
+        sample_parts[FieldIndex(monitor::proto::MonitorInfo::kNameFieldNumber)] = std::move(name);
+
+        Snapshot previous = slot->snapshot.load(std::memory_order_acquire);
+        while (true)
+        {
+            std::shared_ptr<SampleSnapshot> next = BuildSnapshot(previous, host, sample_parts);
+            if (Publish(slot, &previous, next))
+            {
+                return next;
+            }
+        }
+    }
+
+    HostStore::Snapshot HostStore::Get(const std::string& host) const
+    {
+        HostSlot* slot = FindSlot(ShardFor(host), host);
+        return slot ? slot->snapshot.load(std::memory_order_acquire) : Snapshot();
+    }
+
+    HostStore::Snapshot HostStore::Latest() const
+    {
+        const HostSlot* slot = latest_.load(std::memory_order_acquire);
+        return slot ? slot->snapshot.load(std::memory_order_acquire) : Snapshot();
+    }
+
+    std::vector<std::string> HostStore::Hosts() const
+    {
+        std::vector<std::string> hosts;
+        for (const Shard& shard : shards_)
+        {
+            std::shared_ptr<const HostTable> table = shard.table.load(std::memory_order_acquire);
+            if (!table)
+            {
+                continue;
+            }
+            for (const auto& item : *table)
+            {
+                hosts.push_back(item.first);
+            }
+        }
+        return hosts;
+    }
+
+    size_t HostStore::Size() const
+    {
+        size_t size = 0;
+        for (const Shard& shard : shards_)
+        {
+            std::shared_ptr<const HostTable> table = shard.table.load(std::memory_order_acquire);
+            if (table)
+            {
+                size += table->size();
+            }
+        }
+        return size;
+    }
+}  // namespace monitor
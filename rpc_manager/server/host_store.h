@@ -0,0 +1,244 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <array>          // 固定数量的分片
+#include <atomic>         // 快照的原子发布
+#include <memory>         // std::shared_ptr
+#include <mutex>          // std::once_flag、新增主机锁
+#include <string>         // 主机名
+#include <unordered_map>  // 分片内的主机表
+#include <vector>         // 主机列表
+
+// Protobuf生成的头文件
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+    /**
+     * @brief 快照中的一个顶层字段
+     *
+     * 消息中只设置了一个顶层字段。字段在两次上报之间没有变化时，新旧快照共享同一个部分，
+     * 局部批次不再深拷贝其他监控器的数据；序列化结果同样按部分缓存。
+     */
+    class SnapshotPart
+    {
+    public:
+        /**
+         * @brief 获取只包含该字段的消息
+         * @return const monitor::proto::MonitorInfo& 监控数据
+         */
+        const monitor::proto::MonitorInfo& Message() const { return message_; }
+
+        /**
+         * @brief 获取可修改的消息（只在发布前构造时使用）
+         * @return monitor::proto::MonitorInfo* 监控数据
+         */
+        monitor::proto::MonitorInfo* MutableMessage() { return &message_; }
+
+        /**
+         * @brief 获取该字段的编码
+         * @return const std::string& 字段的线格式编码，与部分的生命周期相同
+         *
+         * 线程安全：并发的第一次调用只有一个执行序列化，其余等待其完成。
+         */
+        const std::string& Serialized() const;
+
+    private:
+        monitor::proto::MonitorInfo message_;       ///< 只包含一个顶层字段的监控数据
+        mutable std::once_flag serialize_once_;     ///< 保证只序列化一次
+        mutable std::string serialized_;            ///< 序列化缓存
+    };
+
+    /**
+     * @brief 一台主机某一时刻的不可变数据快照
+     *
+     * 按MonitorInfo的顶层字段分成不可变的部分，新快照只替换采样中出现的部分，其余部分与旧快照共享。
+     * 发布后内容不再修改，可以被任意多个读者同时持有；
+     * 完整的序列化结果在第一次需要时由各部分的编码拼接而成（protobuf允许按字段拼接编码）并缓存，
+     * 同一快照被多个客户端查询时只拼接一次，没有变化的部分不重复序列化。
+     */
+    class SampleSnapshot
+    {
+    public:
+        /// @brief 共享的字段部分
+        using Part = std::shared_ptr<const SnapshotPart>;
+
+        /**
+         * @brief 获取主机名
+         * @return const std::string& 主机名
+         */
+        const std::string& Name() const { return name_; }
+
+        /**
+         * @brief 获取包含指定字段的消息
+         * @param number 字段编号（如MonitorInfo::kCpuStatFieldNumber）
+         * @return const monitor::proto::MonitorInfo& 只包含该字段的消息；快照中没有该字段时为默认实例
+         */
+        const monitor::proto::MonitorInfo& Field(int number) const;
+
+        /**
+         * @brief 获取所有字段部分
+         * @return const std::vector<Part>& 按MonitorInfo字段的声明顺序（Descriptor::field(i)）排列，没有的字段为空指针
+         */
+        const std::vector<Part>& Parts() const { return parts_; }
+
+        /**
+         * @brief 获取序列化后的监控数据
+         * @return const std::string& 序列化结果，与快照生命周期相同
+         *
+         * 线程安全：并发的第一次调用只有一个执行拼接，其余等待其完成。
+         */
+        const std::string& Serialized() const;
+
+    private:
+        friend class HostStore;
+
+        std::string name_;                          ///< 主机名
+        std::vector<Part> parts_;                   ///< 各顶层字段的部分
+        mutable std::once_flag serialize_once_;     ///< 保证只拼接一次
+        mutable std::string serialized_;            ///< 序列化缓存
+    };
+
+    /**
+     * @brief 多主机监控数据存储
+     *
+     * 以MonitorInfo::name为键保存每台主机的最新数据，供整个集群的客户端共用一个服务器。
+     *
+     * 并发设计：
+     * - 原子发布：每台主机的最新数据是std::atomic<std::shared_ptr<const SampleSnapshot>>，
+     *   读者一次原子加载拿到当前快照，快照在读者持有期间不会被修改，不需要深拷贝，也不持锁
+     * - 写入：在旧快照基础上构造新快照（不持锁），再用比较并交换发布；
+     *   同一主机的并发写入在交换失败时基于最新快照重试
+     * - 主机表：按主机名哈希分到kShardCount个分片，每个分片的主机表本身也是原子发布的
+     *   不可变表，只有新主机第一次出现时才在分片锁内复制并替换主机表，查询路径不持锁
+     * - 字段合并：客户端按各监控器的采样周期分批上报，新快照由采样中出现的字段
+     *   （移动，不拷贝）加上旧快照中其余字段的共享部分组成
+     */
+    class HostStore
+    {
+    public:
+        /// @brief 不可变的主机数据快照
+        using Snapshot = std::shared_ptr<const SampleSnapshot>;
+
+        /// @brief 分片数
+        static constexpr size_t kShardCount = 16;
+
+        /**
+         * @brief 写入一条采样
+         * @param sample 采样消息，写入后内容不再可用
+         * @return Snapshot 本次发布的快照（推送给订阅者）
+         *
+         * 主机名为空的采样按"unknown_host"处理。
+         */
+        Snapshot Update(monitor::proto::MonitorInfo* sample);
+
+        /**
+         * @brief 写入一条只读采样
+         * @param sample 采样消息（只读取，可以在Arena上）
+         * @return Snapshot 本次发布的快照
+         *
+         * 采样中出现的字段直接拷贝进新快照，用于请求消息在调用结束后即被回收的场景
+         * （回调接口的Arena请求），省去先拷贝出一份再移动的中间副本。
+         */
+        Snapshot Update(const monitor::proto::MonitorInfo& sample);
+
+        /**
+         * @brief 获取指定主机的最新快照
+         * @param host 主机名
+         * @return Snapshot 主机不存在时返回空指针
+         */
+        Snapshot Get(const std::string& host) const;
+
+        /**
+         * @brief 获取最近一次更新的主机的快照
+         * @return Snapshot 没有任何主机时返回空指针
+         *
+         * 用于兼容不指定主机的GetMonitorInfo。
+         */
+        Snapshot Latest() const;
+
+        /**
+         * @brief 获取所有主机名
+         * @return std::vector<std::string> 主机名列表（无序）
+         */
+        std::vector<std::string> Hosts() const;
+
+        /**
+         * @brief 获取主机数量
+         * @return size_t 主机数量（不复制主机名）
+         */
+        size_t Size() const;
+
+    private:
+        /**
+         * @brief 单台主机的发布槽位
+         *
+         * 槽位创建后在存储的整个生命周期内地址不变，可以用裸指针引用。
+         */
+        struct HostSlot
+        {
+            std::atomic<Snapshot> snapshot;   ///< 当前发布的快照
+        };
+
+        /// @brief 分片内的主机表（发布后不可变，新增主机时整体替换）
+        using HostTable = std::unordered_map<std::string, std::shared_ptr<HostSlot>>;
+
+        /**
+         * @brief 分片：原子发布的主机表 + 新增主机时使用的锁
+         *
+         * 按缓存行对齐，避免相邻分片产生伪共享。
+         */
+        struct alignas(64) Shard
+        {
+            std::mutex insert_mutex;                            ///< 新增主机时串行化主机表的替换
+            std::atomic<std::shared_ptr<const HostTable>> table;  ///< 当前主机表
+        };
+
+        /**
+         * @brief 根据主机名选择分片
+         */
+        Shard& ShardFor(const std::string& host);
+        const Shard& ShardFor(const std::string& host) const;
+
+        /**
+         * @brief 查找主机槽位
+         * @param shard 主机所在分片
+         * @param host 主机名
+         * @return HostSlot* 主机不存在时返回nullptr
+         */
+        static HostSlot* FindSlot(const Shard& shard, const std::string& host);
+
+        /**
+         * @brief 查找主机槽位，不存在时创建
+         * @param shard 主机所在分片
+         * @param host 主机名
+         * @return HostSlot* 主机槽位
+         */
+        static HostSlot* FindOrCreateSlot(Shard& shard, const std::string& host);
+
+        /**
+         * @brief 由旧快照和新采样的字段部分构造新快照
+         * @param previous 旧快照（可能为空）
+         * @param host 主机名
+         * @param sample_parts 采样中出现的字段部分（按字段声明顺序，没有的字段为空指针）
+         * @return std::shared_ptr<SampleSnapshot> 新快照（尚未发布）
+         *
+         * 采样中没有的字段直接引用旧快照的部分，不拷贝。
+         */
+        static std::shared_ptr<SampleSnapshot> BuildSnapshot(
+            const Snapshot& previous, const std::string& host, const std::vector<SampleSnapshot::Part>& sample_parts);
+
+        /**
+         * @brief 发布新快照，并记录最近一次更新的主机
+         * @param slot 主机槽位
+         * @param previous 期望的当前快照，交换失败时更新为实际的当前快照
+         * @param next 新快照
+         * @return bool 发布成功返回true
+         */
+        bool Publish(HostSlot* slot, Snapshot* previous, std::shared_ptr<SampleSnapshot> next);
+
+        std::array<Shard, kShardCount> shards_;          ///< 分片
+        std::atomic<const HostSlot*> latest_{nullptr};   ///< 最近一次更新的主机槽位
+    };
+}  // namespace monitor
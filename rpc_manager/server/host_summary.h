@@ -0,0 +1,90 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+#include <algorithm>   // std::max
+#include <cstdint>     // uint64_t
+
+// Protobuf生成的头文件
+#include "monitor_info.pb.h"
+
+// 服务器内部模块
+#include "host_store.h"   // 主机快照
+
+namespace monitor
+{
+    /**
+     * @brief 计算采样中的总CPU使用率
+     * @param info 采样消息
+     * @param percent 输出参数，总CPU使用率（%）
+     * @return bool 采样中有cpu_stat时返回true
+     *
+     * 取汇总行"cpu"，采样中没有汇总行时取各核的平均值。
+     */
+    inline bool TotalCpuPercent(const monitor::proto::MonitorInfo& info, float* percent)
+    {
+        float cpu_sum = 0;
+        for (const auto& cpu : info.cpu_stat())
+        {
+            if (cpu.cpu_name() == "cpu")
+            {
+                *percent = cpu.cpu_percent();
+                return true;
+            }
+            cpu_sum += cpu.cpu_percent();
+        }
+        if (info.cpu_stat_size() == 0)
+        {
+            return false;
+        }
+        *percent = cpu_sum / info.cpu_stat_size();
+        return true;
+    }
+
+    /**
+     * @brief 从主机的最新快照提取集群总览使用的概要
+     * @param snapshot 主机的最新快照
+     * @param summary 输出参数，主机概要
+     *
+     * 直接读取快照中共享的各字段部分，不合并出完整消息。
+     * CPU使用率见TotalCpuPercent；流量最大的网卡按收发速率之和选取。
+     * 采集端开销取最近一次上报的agent_stats，监控器耗时取p99最大的一个。
+     */
+    inline void BuildHostSummary(const SampleSnapshot& snapshot, monitor::proto::HostSummary* summary)
+    {
+        using monitor::proto::MonitorInfo;
+        summary->set_host(snapshot.Name());
+        summary->set_timestamp_ms(snapshot.Field(MonitorInfo::kTimestampMsFieldNumber).timestamp_ms());
+        summary->set_load_avg_1(snapshot.Field(MonitorInfo::kCpuLoadFieldNumber).cpu_load().load_avg_1());
+        summary->set_mem_used_percent(snapshot.Field(MonitorInfo::kMemInfoFieldNumber).mem_info().used_percent());
+
+        float cpu_percent = 0;
+        if (TotalCpuPercent(snapshot.Field(MonitorInfo::kCpuStatFieldNumber), &cpu_percent))
+        {
+            summary->set_cpu_percent(cpu_percent);
+        }
+
+        const monitor::proto::NetInfo* top = nullptr;
+        for (const auto& net : snapshot.Field(MonitorInfo::kNetInfoFieldNumber).net_info())
+        {
+            if (top == nullptr || net.send_rate() + net.rcv_rate() > top->send_rate() + top->rcv_rate())
+            {
+                top = &net;
+            }
+        }
+        if (top != nullptr)
+        {
+            summary->set_top_nic(top->name());
+            summary->set_top_nic_rate(top->send_rate() + top->rcv_rate());
+        }
+
+        const monitor::proto::AgentStats& agent = snapshot.Field(MonitorInfo::kAgentStatsFieldNumber).agent_stats();
+        summary->set_agent_cpu_percent(agent.cpu_percent());
+        summary->set_agent_rss_kb(agent.rss_kb());
+        uint64_t slowest = 0;
+        for (const auto& collector : snapshot.Field(MonitorInfo::kCollectorStatsFieldNumber).collector_stats())
+        {
+            slowest = std::max(slowest, collector.p99_us());
+        }
+        summary->set_slowest_collector_p99_us(slowest);
+    }
+}  // namespace monitor
@@ -4,10 +4,26 @@
 // gRPC相关头文件
 #include <grpcpp/support/status.h>
 #include <grpcpp/server_context.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/proto_buffer_reader.h>
+#include <grpcpp/support/server_callback.h>
+#include <grpcpp/support/slice.h>
 
 // C++标准库头文件
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <unordered_map>
-#include <iostream>
+#include <string>
+
+// 服务器内部模块
+#include "aggregate_store.h"      // 分组聚合统计
+#include "arena_message_allocator.h"  // Arena请求分配器
+#include "host_store.h"           // 多主机分片存储
+#include "host_summary.h"         // 集群总览的主机概要
+#include "snapshot_buffer.h"      // 快照序列化缓存转响应字节
+#include "subscription_hub.h"     // 订阅推送
+#include "time_series_store.h"    // 多主机历史数据存储
 
 // Protobuf和gRPC生成的头文件
 #include "monitor_info.grpc.pb.h"
@@ -20,67 +36,365 @@ namespace monitor
      *
      * 继承自Protobuf生成的GrpcManager::Service基类
      * 实现监控数据的接收和提供功能
+     *
+     * 服务器不再使用同步接口（同步服务器为每个进行中的调用占用一个线程，
+     * 几千个客户端的长连接上报会耗尽线程池）：
+     * - 流式上报（StreamMonitorInfo、StreamCompactMonitorInfo）使用异步接口，
+     *   由AsyncIngestServer在多个完成队列上驱动，每个完成队列一个绑核的poller线程
+     * - 其余方法使用回调接口，由gRPC内部的回调线程执行，不阻塞等待
+     * 监控数据按主机保存在分片存储HostStore中，不同主机的写入互不竞争，
+     * 查询拿到的是原子发布的不可变快照。
+     *
+     * 查询方法（GetMonitorInfo、GetHostMonitorInfo）使用原始字节的回调接口：
+     * 响应直接引用快照缓存的序列化结果，不拷贝消息、也不按请求重复序列化，
+     * 多个界面轮询同一台主机时每个快照只序列化一次。
+     *
+     * 一元上报SetMonitorInfo使用回调接口 + ArenaMessageAllocator：
+     * 请求直接反序列化到复用的Arena上，存储时只拷贝一次进快照。
+     *
+     * 订阅Subscribe替代界面的定时轮询：每次写入发布新快照后由SubscriptionHub推送给该主机的订阅者。
+     *
+     * 集群总览只取需要的部分：ListHosts按主机名分页，GetHostSummaries只返回请求的主机的概要行；
+     * 整个分组的统计（平均值、p99等）由GetAggregate直接返回服务器增量维护的聚合。
      */
-    class GrpcManagerImpl : public monitor::proto::GrpcManager::Service
+    using GrpcManagerServiceBase = monitor::proto::GrpcManager::WithAsyncMethod_StreamMonitorInfo<
+        monitor::proto::GrpcManager::WithAsyncMethod_StreamCompactMonitorInfo<
+            monitor::proto::GrpcManager::WithCallbackMethod_GetAggregate<
+                monitor::proto::GrpcManager::WithCallbackMethod_GetHostSummaries<
+                    monitor::proto::GrpcManager::WithCallbackMethod_ListHosts<
+                        monitor::proto::GrpcManager::WithCallbackMethod_QueryRange<
+                            monitor::proto::GrpcManager::WithRawCallbackMethod_Subscribe<
+                                monitor::proto::GrpcManager::WithCallbackMethod_SetMonitorInfo<
+                                    monitor::proto::GrpcManager::WithRawCallbackMethod_GetMonitorInfo<
+                                        monitor::proto::GrpcManager::WithRawCallbackMethod_GetHostMonitorInfo<
+                                            monitor::proto::GrpcManager::Service>>>>>>>>>>;
+
+    class GrpcManagerImpl : public GrpcManagerServiceBase
     {
     public:
         /**
          * @brief 构造函数
          */
-        GrpcManagerImpl() {}
+        GrpcManagerImpl()
+        {
+            SetMessageAllocatorFor_SetMonitorInfo(&set_allocator_);
+        }
 
         /**
          * @brief 析构函数
          */
         virtual ~GrpcManagerImpl() {}
 
+        /**
+         * @brief 把历史数据持久化到磁盘（启动服务器之前调用）
+         * @param options 块存储配置（目录、保留期限、分区长度等）
+         * @param flush_interval_ms 落盘周期（毫秒）
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true
+         *
+         * 启用后QueryRange可以查询保留期限内的数据，早于内存环形缓冲区的部分从磁盘块读取。
+         */
+        bool PersistHistory(const ChunkStore::Options& options, int64_t flush_interval_ms, std::string* error)
+        {
+            return history_.EnablePersistence(options, flush_interval_ms, error);
+        }
+
+        /**
+         * @brief 启用聚合统计的主机过期（启动服务器之前调用）
+         * @param ttl_ms 主机停止上报多久后移出分组聚合
+         *
+         * 下线或改名的主机不再计入集群的主机数和分位数。
+         */
+        void ExpireAggregateHosts(int64_t ttl_ms)
+        {
+            aggregates_.StartExpiry(ttl_ms);
+        }
+
         /**
          * @brief 设置监控信息RPC方法
          * @param context gRPC服务器上下文
-         * @param request 客户端发送的监控信息
+         * @param request 客户端发送的监控信息（在Arena上，调用结束后回收）
          * @param response 空响应
-         * @return gRPC状态码
+         * @return 已完成的响应reactor
          *
          * 客户端调用此方法将监控数据发送到服务器
          */
-        ::grpc::Status SetMonitorInfo(
-            ::grpc::ServerContext* context,
+        ::grpc::ServerUnaryReactor* SetMonitorInfo(
+            ::grpc::CallbackServerContext* context,
             const ::monitor::proto::MonitorInfo* request,
             ::google::protobuf::Empty* response) override
         {
+            // 先写入历史和聚合，再用新采样中出现的字段覆盖该主机的旧数据
+            const int64_t now_ms = NowMs();
+            history_.Append(*request, now_ms);
+            aggregates_.Update(*request, now_ms);
+            const uint64_t present_fields = hub_.HasSubscribers() ? SubscriptionHub::FieldsOf(*request) : 0;
+            hub_.Publish(store_.Update(*request), present_fields);
+
+            ::grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+        /**
+         * @brief 获取监控信息RPC方法
+         * @param context gRPC服务器上下文
+         * @param request 空请求（原始字节）
+         * @param response 服务器返回的监控信息（原始字节）
+         * @return 已完成的响应reactor
+         *
+         * 客户端调用此方法从服务器获取监控数据。
+         * 不指定主机，返回最近一次上报的主机的数据（单主机部署时即唯一的主机）。
+         */
+        ::grpc::ServerUnaryReactor* GetMonitorInfo(
+            ::grpc::CallbackServerContext* context,
+            const ::grpc::ByteBuffer* request,
+            ::grpc::ByteBuffer* response) override
+        {
+            // 返回存储的监控数据（没有任何主机时返回空消息）
+            SnapshotToBuffer(store_.Latest(), response);
+
+            ::grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+        /**
+         * @brief 获取指定主机监控信息RPC方法
+         * @param context gRPC服务器上下文
+         * @param request 主机名（原始字节，HostRequest）
+         * @param response 服务器返回的监控信息（原始字节）
+         * @return 已完成的响应reactor，主机不存在时以NOT_FOUND结束
+         */
+        ::grpc::ServerUnaryReactor* GetHostMonitorInfo(
+            ::grpc::CallbackServerContext* context,
+            const ::grpc::ByteBuffer* request,
+            ::grpc::ByteBuffer* response) override
+        {
+            ::grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
 
-            // 清空旧数据并存储新数据
-            monitor_infos_.Clear();
-            monitor_infos_ = *request;
+            monitor::proto::HostRequest host_request;
+            if (!ParseRequest(*request, &host_request))
+            {
+                reactor->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed HostRequest"));
+                return reactor;
+            }
 
-            // 调试输出
-            std::cout << "[SetMonitorInfo] request->soft_irq_size(): " << request->soft_irq_size() << std::endl;
+            HostStore::Snapshot snapshot = store_.Get(host_request.host());
+            if (!snapshot)
+            {
+                reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown host: " + host_request.host()));
+                return reactor;
+            }
+            SnapshotToBuffer(snapshot, response);
 
-            return grpc::Status::OK;
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
         }
 
         /**
-         * @brief 获取监控信息RPC方法
+         * @brief 历史区间查询RPC方法
+         * @param context gRPC服务器上下文
+         * @param request 主机、指标、实例和时间区间
+         * @param response 区间内的采样点
+         * @return 已完成的响应reactor，主机或指标不存在时以NOT_FOUND结束
+         */
+        ::grpc::ServerUnaryReactor* QueryRange(
+            ::grpc::CallbackServerContext* context,
+            const ::monitor::proto::RangeRequest* request,
+            ::monitor::proto::RangeResponse* response) override
+        {
+            ::grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+            if (!history_.QueryRange(*request, response))
+            {
+                reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND,
+                    "unknown series: " + request->host() + "/" + request->metric() + "/" + request->instance()));
+                return reactor;
+            }
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+        /**
+         * @brief 订阅主机监控数据RPC方法
          * @param context gRPC服务器上下文
-         * @param request 空请求
-         * @param response 服务器返回的监控信息
-         * @return gRPC状态码
+         * @param request 主机名和字段掩码（原始字节，SubscribeRequest）
+         * @return 推送reactor，客户端断开或服务器关闭时结束
          *
-         * 客户端调用此方法从服务器获取监控数据
+         * 不指定主机时订阅最近一次上报的主机；还没有任何主机时订阅第一台上报的主机。
          */
-        ::grpc::Status GetMonitorInfo(
-            ::grpc::ServerContext* context,
-            const ::google::protobuf::Empty* request,
-            ::monitor::proto::MonitorInfo* response) override
+        ::grpc::ServerWriteReactor<::grpc::ByteBuffer>* Subscribe(
+            ::grpc::CallbackServerContext* context,
+            const ::grpc::ByteBuffer* request) override
         {
-            // 返回存储的监控数据
-            *response = monitor_infos_;
+            monitor::proto::SubscribeRequest subscribe_request;
+            if (!ParseRequest(*request, &subscribe_request))
+            {
+                return new RejectedWriteReactor(
+                    grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed SubscribeRequest"));
+            }
 
-            return grpc::Status::OK;
+            HostStore::Snapshot current = subscribe_request.host().empty()
+                ? store_.Latest() : store_.Get(subscribe_request.host());
+            const std::string host = current ? current->Name() : subscribe_request.host();
+            return new SubscribeReactor(&hub_, host, subscribe_request.fields_mask(), current);
+        }
+
+        /**
+         * @brief 分页列出主机RPC方法
+         * @param context gRPC服务器上下文
+         * @param request 起始位置（不含）和每页数量
+         * @param response 本页的主机名（升序）和主机总数
+         * @return 已完成的响应reactor
+         *
+         * 按名称分页而不是按下标分页：翻页期间有主机加入时，已取到的页不会错位。
+         */
+        ::grpc::ServerUnaryReactor* ListHosts(
+            ::grpc::CallbackServerContext* context,
+            const ::monitor::proto::HostListRequest* request,
+            ::monitor::proto::HostListResponse* response) override
+        {
+            std::vector<std::string> hosts = store_.Hosts();
+            std::sort(hosts.begin(), hosts.end());
+            response->set_total(static_cast<uint32_t>(hosts.size()));
+
+            auto begin = std::upper_bound(hosts.begin(), hosts.end(), request->start_after());
+            if (request->start_after().empty())
+            {
+                begin = hosts.begin();
+            }
+            for (auto iter = begin; iter != hosts.end(); ++iter)
+            {
+                if (request->limit() > 0 && static_cast<uint32_t>(response->host_size()) >= request->limit())
+                {
+                    break;
+                }
+                response->add_host(*iter);
+            }
+
+            ::grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+        /**
+         * @brief 批量获取主机概要RPC方法
+         * @param context gRPC服务器上下文
+         * @param request 主机名列表
+         * @param response 各主机的概要（不存在的主机跳过）和主机总数
+         * @return 已完成的响应reactor
+         */
+        ::grpc::ServerUnaryReactor* GetHostSummaries(
+            ::grpc::CallbackServerContext* context,
+            const ::monitor::proto::HostSummaryRequest* request,
+            ::monitor::proto::HostSummaryResponse* response) override
+        {
+            for (const std::string& host : request->host())
+            {
+                HostStore::Snapshot snapshot = store_.Get(host);
+                if (snapshot)
+                {
+                    BuildHostSummary(*snapshot, response->add_summary());
+                }
+            }
+            response->set_total(static_cast<uint32_t>(store_.Size()));
+
+            ::grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+        /**
+         * @brief 分组聚合查询RPC方法
+         * @param context gRPC服务器上下文
+         * @param request 分组、指标名和需要的分位数
+         * @param response 该分组各主机最新值的聚合
+         * @return 已完成的响应reactor，指标名或分位数不合法时以INVALID_ARGUMENT结束，
+         *         分组不存在时以NOT_FOUND结束
+         */
+        ::grpc::ServerUnaryReactor* GetAggregate(
+            ::grpc::CallbackServerContext* context,
+            const ::monitor::proto::AggregateRequest* request,
+            ::monitor::proto::AggregateResponse* response) override
+        {
+            ::grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+
+            AggregateStore::Metric metric;
+            if (!AggregateStore::FindMetric(request->metric(), &metric))
+            {
+                reactor->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "unknown metric: " + request->metric()));
+                return reactor;
+            }
+            for (double q : request->quantile())
+            {
+                if (!(q >= 0 && q <= 1))
+                {
+                    reactor->Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        "quantile out of range [0, 1]: " + std::to_string(q)));
+                    return reactor;
+                }
+            }
+            if (!aggregates_.Query(*request, response))
+            {
+                reactor->Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown group: " + request->group()));
+                return reactor;
+            }
+            reactor->Finish(grpc::Status::OK);
+            return reactor;
+        }
+
+        /**
+         * @brief 存储一条流式上报的采样
+         * @param sample 采样（字段会被移走）
+         *
+         * 由AsyncIngestServer的poller线程调用，多个线程可同时调用。
+         */
+        void Ingest(monitor::proto::MonitorInfo* sample)
+        {
+            const int64_t now_ms = NowMs();
+            history_.Append(*sample, now_ms);   // Update会移走字段，先写入历史、聚合和计算出现的字段
+            aggregates_.Update(*sample, now_ms);
+            const uint64_t present_fields = hub_.HasSubscribers() ? SubscriptionHub::FieldsOf(*sample) : 0;
+            hub_.Publish(store_.Update(sample), present_fields);
         }
 
     private:
-        /// @brief 存储最新的监控信息
-        monitor::proto::MonitorInfo monitor_infos_;
+        /**
+         * @brief 获取当前Unix时间（毫秒）
+         * @return int64_t 毫秒数
+         */
+        static int64_t NowMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        /**
+         * @brief 把原始请求字节解析为Protobuf消息
+         * @param request 请求字节
+         * @param message 输出参数，解析结果
+         * @return bool 解析成功返回true
+         */
+        static bool ParseRequest(const ::grpc::ByteBuffer& request, google::protobuf::Message* message)
+        {
+            ::grpc::ByteBuffer buffer(request);   // 只增加切片引用计数
+            ::grpc::ProtoBufferReader reader(&buffer);
+            return message->ParseFromZeroCopyStream(&reader);
+        }
+
+        /// @brief 按主机分片的监控数据存储
+        HostStore store_;
+
+        /// @brief 每台主机最近一段时间的历史数据
+        TimeSeriesStore history_;
+
+        /// @brief 各主机分组的聚合统计
+        AggregateStore aggregates_;
+
+        /// @brief 订阅者登记和推送
+        SubscriptionHub hub_;
+
+        /// @brief SetMonitorInfo的Arena请求分配器
+        ArenaMessageAllocator<monitor::proto::MonitorInfo, google::protobuf::Empty> set_allocator_;
     };
 }  // namespace monitor
@@ -1,58 +1,202 @@
+#include <chrono>
+#include <csignal>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <grpc/grpc.h>
 #include <grpcpp/server_builder.h>
 #include <grpcpp/server.h>
+#include "async_ingest.h"
 #include "rpc_manager.h"
+#include "server_options.h"
+#include "utils/options.h"
 
-// 服务器监听地址常量
-constexpr char kServerPortInfo[] = "0.0.0.0:50051";
+/**
+ * @brief 解析逗号分隔的CPU列表
+ * @param text 形如"0,2,4"的字符串
+ * @param cpus 输出参数，解析出的CPU编号
+ * @return bool 格式合法返回true
+ */
+bool ParseCpuList(const std::string& text, std::vector<int>* cpus)
+{
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        try
+        {
+            size_t used = 0;
+            int cpu = std::stoi(item, &used);
+            if (used != item.size() || cpu < 0)
+            {
+                return false;
+            }
+            cpus->push_back(cpu);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 从命令行解析服务器运行参数
+ * @param argc 参数个数
+ * @param argv 参数数组
+ * @param options 输出参数，运行参数
+ * @return bool 参数合法返回true
+ */
+bool ParseServerOptions(int argc, char** argv, monitor::ServerOptions* options)
+{
+    monitor::Options parser;
+    if (!parser.Parse(argc, argv))
+    {
+        return false;
+    }
+
+    options->address = parser.GetString("address", options->address);
+    options->completion_queues = static_cast<int>(parser.GetInt("completion_queues", options->completion_queues));
+    options->pin_pollers = parser.GetBool("pin_pollers", options->pin_pollers);
+    options->max_concurrent_streams =
+        static_cast<int>(parser.GetInt("max_concurrent_streams", options->max_concurrent_streams));
+    options->max_receive_message_bytes =
+        static_cast<int>(parser.GetInt("max_receive_message_bytes", options->max_receive_message_bytes));
+    options->max_send_message_bytes =
+        static_cast<int>(parser.GetInt("max_send_message_bytes", options->max_send_message_bytes));
+    options->history_dir = parser.GetString("history_dir", options->history_dir);
+    options->history_retention_days =
+        static_cast<int>(parser.GetInt("history_retention_days", options->history_retention_days));
+    options->history_partition_hours =
+        static_cast<int>(parser.GetInt("history_partition_hours", options->history_partition_hours));
+    options->history_flush_interval_s =
+        static_cast<int>(parser.GetInt("history_flush_interval_s", options->history_flush_interval_s));
+    options->aggregate_host_ttl_s =
+        static_cast<int>(parser.GetInt("aggregate_host_ttl_s", options->aggregate_host_ttl_s));
+    if (options->history_retention_days <= 0 || options->history_partition_hours <= 0 ||
+        options->history_flush_interval_s <= 0 || options->aggregate_host_ttl_s < 0)
+    {
+        return false;
+    }
+    if (parser.Has("poller_cpus") && !ParseCpuList(parser.GetString("poller_cpus", ""), &options->poller_cpus))
+    {
+        return false;
+    }
+    return true;
+}
 
 /**
  * @brief 初始化并启动gRPC服务器
+ * @param options 服务器运行参数
  *
- * 创建gRPC服务器实例，配置监听端口，注册服务，并启动服务器
+ * 创建gRPC服务器实例，配置监听端口，注册服务，并启动服务器；
+ * 收到SIGINT或SIGTERM后关闭服务器并等待poller线程退出
  */
-void InitServer()
+void InitServer(const monitor::ServerOptions& options)
 {
+    // 在创建任何线程之前屏蔽退出信号，所有线程继承该掩码，由主线程通过sigwait统一处理
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
     // 创建gRPC服务器构建器
     grpc::ServerBuilder builder;
 
     // 添加监听端口
-    // 0.0.0.0:50051 表示监听所有网络接口的50051端口
     // InsecureServerCredentials() 使用不安全的连接（适合本地测试）
-    builder.AddListeningPort(kServerPortInfo, grpc::InsecureServerCredentials());
+    builder.AddListeningPort(options.address, grpc::InsecureServerCredentials());
+
+    // 连接和消息大小限制（0表示保持gRPC默认值）
+    if (options.max_concurrent_streams > 0)
+    {
+        builder.AddChannelArgument(GRPC_ARG_MAX_CONCURRENT_STREAMS, options.max_concurrent_streams);
+    }
+    if (options.max_receive_message_bytes > 0)
+    {
+        builder.SetMaxReceiveMessageSize(options.max_receive_message_bytes);
+    }
+    if (options.max_send_message_bytes > 0)
+    {
+        builder.SetMaxSendMessageSize(options.max_send_message_bytes);
+    }
 
     // 创建RPC服务实现实例
     monitor::GrpcManagerImpl grpc_server;
 
-    // 向构建器注册服务
+    // 历史数据持久化（在接收数据之前打开块存储，重启后从已落盘的最新时间继续）
+    if (!options.history_dir.empty())
+    {
+        monitor::ChunkStore::Options history;
+        history.dir = options.history_dir;
+        history.retention_ms = options.history_retention_days * 24LL * 3600 * 1000;
+        history.partition_ms = options.history_partition_hours * 3600LL * 1000;
+        std::string error;
+        if (!grpc_server.PersistHistory(history, options.history_flush_interval_s * 1000LL, &error))
+        {
+            std::cout << "历史数据目录打开失败: " << error << std::endl;
+            return;
+        }
+    }
+
+    // 停止上报的主机超过TTL后移出分组聚合
+    grpc_server.ExpireAggregateHosts(options.aggregate_host_ttl_s * 1000LL);
+
+    // 向构建器注册服务，流式上报的完成队列必须在BuildAndStart之前添加
     builder.RegisterService(&grpc_server);
+    monitor::AsyncIngestServer ingest(&grpc_server, options);
+    ingest.AddCompletionQueues(&builder);
 
     // 构建并启动服务器
-    // BuildAndStart() 创建服务器并开始监听
     std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
+    if (!server)
+    {
+        std::cout << "gRPC服务器启动失败，监听地址: " << options.address << std::endl;
+        return;
+    }
+    ingest.Start();
 
     // 输出服务器启动信息
-    std::cout << "gRPC服务器已启动，监听端口: " << kServerPortInfo << std::endl;
+    std::cout << "gRPC服务器已启动，监听端口: " << options.address << std::endl;
     std::cout << "按 Ctrl+C 停止服务器" << std::endl;
 
-    // 等待服务器停止（阻塞调用）
-    server->Wait();
+    // 等待退出信号
+    int signal = 0;
+    sigwait(&signals, &signal);
+    std::cout << "收到信号 " << signal << "，正在停止服务器" << std::endl;
 
-    return;
+    // 先关闭服务器（超时后取消仍在进行的流），再关闭完成队列
+    server->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    ingest.Shutdown();
 }
 
 /**
  * @brief 服务器程序主函数
+ * @param argc 参数个数
+ * @param argv 参数数组
  * @return 程序退出码
  *
  * 程序入口点，启动gRPC监控服务器
  */
-int main()
+int main(int argc, char** argv)
 {
+    monitor::ServerOptions options;
+    if (!ParseServerOptions(argc, argv, &options))
+    {
+        std::cout << "用法: " << argv[0] << " [--address=0.0.0.0:50051] [--completion_queues=N]"
+                  << " [--pin_pollers=true|false] [--poller_cpus=0,1,...] [--max_concurrent_streams=N]"
+                  << " [--max_receive_message_bytes=N] [--max_send_message_bytes=N]"
+                  << " [--history_dir=DIR] [--history_retention_days=N] [--history_partition_hours=N]"
+                  << " [--history_flush_interval_s=N]" << std::endl;
+        return 1;
+    }
+
     // 初始化并启动服务器
-    InitServer();
+    InitServer(options);
 
     return 0;
 }
@@ -0,0 +1,30 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <string>   // 监听地址
+#include <vector>   // 绑核列表
+
+namespace monitor
+{
+    /**
+     * @brief 服务器运行参数
+     *
+     * 由server_main从命令行解析（--key=value），未指定的字段保持默认值。
+     */
+    struct ServerOptions
+    {
+        std::string address = "0.0.0.0:50051";   ///< 监听地址（--address）
+        int completion_queues = 0;               ///< 流式上报的完成队列数（--completion_queues），0表示CPU核心数
+        bool pin_pollers = true;                 ///< 是否把poller线程绑定到CPU核心（--pin_pollers）
+        std::vector<int> poller_cpus;            ///< 绑核列表（--poller_cpus=0,2,4），为空时第i个poller绑定到核心i % 核心数
+        int max_concurrent_streams = 0;          ///< 每个HTTP/2连接的最大并发流数（--max_concurrent_streams），0表示gRPC默认值
+        int max_receive_message_bytes = 0;       ///< 接收消息大小上限（--max_receive_message_bytes），0表示gRPC默认值（4MB）
+        int max_send_message_bytes = 0;          ///< 发送消息大小上限（--max_send_message_bytes），0表示gRPC默认值（不限制）
+        std::string history_dir;                 ///< 历史数据目录（--history_dir），为空时只保存在内存中
+        int history_retention_days = 30;         ///< 历史数据保留天数（--history_retention_days）
+        int history_partition_hours = 24;        ///< 历史数据分区长度（--history_partition_hours）
+        int history_flush_interval_s = 60;       ///< 历史数据落盘周期（--history_flush_interval_s）
+        int aggregate_host_ttl_s = 300;          ///< 停止上报的主机移出聚合统计的时间（--aggregate_host_ttl_s），0表示不移出
+    };
+}  // namespace monitor
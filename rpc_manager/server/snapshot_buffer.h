@@ -0,0 +1,39 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// gRPC相关头文件
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/slice.h>
+
+// C++标准库头文件
+#include <string>   // 序列化缓存
+
+// 服务器内部模块
+#include "host_store.h"   // 主机快照
+
+namespace monitor
+{
+    /**
+     * @brief 用快照缓存的序列化结果构造响应
+     * @param snapshot 主机快照（可能为空）
+     * @param response 输出参数，响应字节
+     *
+     * 响应切片直接指向快照内的序列化缓存，切片持有一份快照引用，
+     * 发送完成、切片释放时再释放，期间新快照发布不影响正在发送的响应。
+     */
+    inline void SnapshotToBuffer(const HostStore::Snapshot& snapshot, ::grpc::ByteBuffer* response)
+    {
+        if (!snapshot)
+        {
+            ::grpc::Slice empty;
+            *response = ::grpc::ByteBuffer(&empty, 1);
+            return;
+        }
+
+        const std::string& bytes = snapshot->Serialized();
+        auto* holder = new HostStore::Snapshot(snapshot);
+        ::grpc::Slice slice(const_cast<char*>(bytes.data()), bytes.size(),
+            [](void* user_data) { delete static_cast<HostStore::Snapshot*>(user_data); }, holder);
+        *response = ::grpc::ByteBuffer(&slice, 1);
+    }
+}  // namespace monitor
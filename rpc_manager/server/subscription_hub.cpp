@@ -0,0 +1,207 @@
+// 包含对应的头文件
+#include "subscription_hub.h"
+
+// C++标准库头文件
+#include <algorithm>    // std::find
+
+// 服务器内部模块
+#include "snapshot_buffer.h"   // 快照序列化缓存转响应字节
+
+namespace monitor
+{
+    // ==================== SubscriptionHub ====================
+
+    uint64_t SubscriptionHub::FieldsOf(const monitor::proto::MonitorInfo& sample)
+    {
+        std::vector<const google::protobuf::FieldDescriptor*> fields;
+        sample.GetReflection()->ListFields(sample, &fields);
+
+        uint64_t mask = 0;
+        for (const auto* field : fields)
+        {
+            if (field->number() < 64)
+            {
+                mask |= uint64_t{1} << field->number();
+            }
+        }
+        return mask;
+    }
+
+    void SubscriptionHub::Add(const std::string& host, Subscriber* subscriber)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hosts_[host].push_back(subscriber);
+        subscribed_[subscriber] = host;
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void SubscriptionHub::Remove(Subscriber* subscriber)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = subscribed_.find(subscriber);
+        if (iter == subscribed_.end())
+        {
+            return;
+        }
+
+        auto host_iter = hosts_.find(iter->second);
+        if (host_iter != hosts_.end())
+        {
+            auto& subscribers = host_iter->second;
+            subscribers.erase(std::find(subscribers.begin(), subscribers.end(), subscriber));
+            if (subscribers.empty())
+            {
+                hosts_.erase(host_iter);
+            }
+        }
+        subscribed_.erase(iter);
+        count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 推送快照的具体实现
+     * @param snapshot 新快照
+     * @param present_fields 本次采样中出现的字段
+     *
+     * 尚未绑定主机的订阅者（主机名为空）绑定到本次发布的主机，之后只接收该主机的快照。
+     */
+    void SubscriptionHub::Publish(const HostStore::Snapshot& snapshot, uint64_t present_fields)
+    {
+        if (!snapshot || !HasSubscribers())
+        {
+            return;
+        }
+
+        const std::string& host = snapshot->Name();
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto unbound = hosts_.find(std::string());
+        if (unbound != hosts_.end())
+        {
+            std::vector<Subscriber*> waiting = std::move(unbound->second);
+            hosts_.erase(unbound);
+            auto& target = hosts_[host];
+            for (Subscriber* subscriber : waiting)
+            {
+                target.push_back(subscriber);
+                subscribed_[subscriber] = host;
+            }
+        }
+
+        auto iter = hosts_.find(host);
+        if (iter == hosts_.end())
+        {
+            return;
+        }
+        for (Subscriber* subscriber : iter->second)
+        {
+            const uint64_t wanted = subscriber->FieldsMask();
+            if (wanted == 0 || (wanted & present_fields) != 0)
+            {
+                subscriber->Push(snapshot);
+            }
+        }
+    }
+
+    // ==================== SubscribeReactor ====================
+
+    SubscribeReactor::SubscribeReactor(SubscriptionHub* hub, const std::string& host, uint64_t fields_mask,
+                                       const HostStore::Snapshot& current)
+        : hub_(hub), fields_mask_(fields_mask)
+    {
+        // 先登记再推送当前快照：登记之后发布的快照不会丢失，最多重复推送一次
+        hub_->Add(host, this);
+        if (current)
+        {
+            Push(current);
+        }
+    }
+
+    void SubscribeReactor::Push(const HostStore::Snapshot& snapshot)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_)
+        {
+            return;
+        }
+        pending_ = snapshot;   // 覆盖尚未发送的旧快照
+        if (!writing_)
+        {
+            WritePendingLocked();
+        }
+    }
+
+    void SubscribeReactor::OnWriteDone(bool ok)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writing_ = false;
+        if (!ok)
+        {
+            return;   // 客户端已断开，随后OnCancel结束调用
+        }
+        if (pending_ && !finished_)
+        {
+            WritePendingLocked();
+        }
+    }
+
+    void SubscribeReactor::OnCancel()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!finished_)
+        {
+            finished_ = true;
+            Finish(::grpc::Status::CANCELLED);
+        }
+    }
+
+    void SubscribeReactor::OnDone()
+    {
+        hub_->Remove(this);   // 返回后不会再有Push
+        delete this;
+    }
+
+    void SubscribeReactor::WritePendingLocked()
+    {
+        ToBuffer(pending_, &buffer_);
+        pending_.reset();
+        writing_ = true;
+        StartWrite(&buffer_);
+    }
+
+    /**
+     * @brief 序列化订阅字段的具体实现
+     * @param snapshot 主机快照
+     * @param buffer 输出参数，响应字节
+     *
+     * 订阅全部字段时直接引用快照缓存的序列化结果；
+     * 只订阅部分字段时拼接主机名、采样时间和选中字段各自缓存的编码，不拷贝子消息。
+     */
+    void SubscribeReactor::ToBuffer(const HostStore::Snapshot& snapshot, ::grpc::ByteBuffer* buffer) const
+    {
+        if (fields_mask_ == 0)
+        {
+            SnapshotToBuffer(snapshot, buffer);
+            return;
+        }
+
+        const google::protobuf::Descriptor* descriptor = monitor::proto::MonitorInfo::descriptor();
+        const std::vector<SampleSnapshot::Part>& parts = snapshot->Parts();
+        std::string bytes;
+        for (int i = 0; i < descriptor->field_count(); ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+            const bool header = field->number() == monitor::proto::MonitorInfo::kNameFieldNumber
+                || field->number() == monitor::proto::MonitorInfo::kTimestampMsFieldNumber;
+            const bool wanted = field->number() < 64 && (fields_mask_ & (uint64_t{1} << field->number())) != 0
+                && field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE;
+            if (parts[i] && (header || wanted))
+            {
+                bytes.append(parts[i]->Serialized());
+            }
+        }
+
+        ::grpc::Slice slice(bytes);
+        *buffer = ::grpc::ByteBuffer(&slice, 1);
+    }
+}  // namespace monitor
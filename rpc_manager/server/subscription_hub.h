@@ -0,0 +1,151 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// gRPC相关头文件
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/server_callback.h>
+
+// C++标准库头文件
+#include <atomic>         // 订阅者计数
+#include <cstdint>        // uint64_t
+#include <mutex>          // 保护订阅表
+#include <string>         // 主机名
+#include <unordered_map>  // 主机到订阅者的映射
+#include <vector>         // 订阅者列表
+
+// 服务器内部模块
+#include "host_store.h"   // 主机快照
+
+namespace monitor
+{
+    /**
+     * @brief 订阅推送中心
+     *
+     * 按主机名登记订阅者，每次有主机的新快照发布时推送给该主机的订阅者。
+     * 没有订阅者时Publish只有一次原子加载；推送本身不阻塞，由订阅者决定何时发送。
+     */
+    class SubscriptionHub
+    {
+    public:
+        /**
+         * @brief 订阅者接口
+         */
+        class Subscriber
+        {
+        public:
+            virtual ~Subscriber() = default;
+
+            /**
+             * @brief 推送一份新快照（在发布线程上调用，不能阻塞）
+             * @param snapshot 主机快照
+             */
+            virtual void Push(const HostStore::Snapshot& snapshot) = 0;
+
+            /**
+             * @brief 订阅的字段
+             * @return uint64_t 第n位对应MonitorInfo字段编号n，0表示全部字段
+             */
+            virtual uint64_t FieldsMask() const = 0;
+        };
+
+        /**
+         * @brief 计算采样中出现的字段
+         * @param sample 采样消息
+         * @return uint64_t 第n位对应字段编号n
+         */
+        static uint64_t FieldsOf(const monitor::proto::MonitorInfo& sample);
+
+        /**
+         * @brief 登记订阅者
+         * @param host 主机名，为空时订阅下一台发布快照的主机
+         * @param subscriber 订阅者（Remove之前必须保持有效）
+         */
+        void Add(const std::string& host, Subscriber* subscriber);
+
+        /**
+         * @brief 注销订阅者，返回后不会再收到Push
+         * @param subscriber 订阅者
+         */
+        void Remove(Subscriber* subscriber);
+
+        /**
+         * @brief 是否有订阅者
+         * @return bool 没有任何订阅者时返回false
+         */
+        bool HasSubscribers() const { return count_.load(std::memory_order_relaxed) > 0; }
+
+        /**
+         * @brief 推送新发布的快照
+         * @param snapshot 新快照
+         * @param present_fields 本次采样中出现的字段（FieldsOf的结果），只推送给订阅了其中任一字段的订阅者
+         */
+        void Publish(const HostStore::Snapshot& snapshot, uint64_t present_fields);
+
+    private:
+        mutable std::mutex mutex_;                                           ///< 保护以下成员
+        std::unordered_map<std::string, std::vector<Subscriber*>> hosts_;    ///< 主机名到订阅者
+        std::unordered_map<Subscriber*, std::string> subscribed_;            ///< 订阅者到主机名（空表示尚未绑定）
+        std::atomic<size_t> count_{0};                                       ///< 订阅者数量
+    };
+
+    /**
+     * @brief Subscribe方法的服务端推送reactor
+     *
+     * 直接发送快照缓存的序列化结果（订阅全部字段时不拷贝、不重复序列化），
+     * 同一时刻只有一次写操作：写入期间到达的快照只保留最新的一份，
+     * 慢速客户端跳过中间的快照，不会在服务器上堆积。
+     * 客户端断开或服务器关闭时结束调用，OnDone中注销并释放自身。
+     */
+    class SubscribeReactor : public ::grpc::ServerWriteReactor<::grpc::ByteBuffer>,
+                             public SubscriptionHub::Subscriber
+    {
+    public:
+        /**
+         * @brief 构造函数，登记订阅并推送当前快照
+         * @param hub 订阅推送中心
+         * @param host 主机名（为空时订阅下一台发布快照的主机）
+         * @param fields_mask 订阅的字段，0表示全部字段
+         * @param current 主机的当前快照（可能为空）
+         */
+        SubscribeReactor(SubscriptionHub* hub, const std::string& host, uint64_t fields_mask,
+                         const HostStore::Snapshot& current);
+
+        void Push(const HostStore::Snapshot& snapshot) override;
+        uint64_t FieldsMask() const override { return fields_mask_; }
+
+        void OnWriteDone(bool ok) override;
+        void OnCancel() override;
+        void OnDone() override;
+
+    private:
+        /**
+         * @brief 发送待发送的快照（调用者持有mutex_）
+         */
+        void WritePendingLocked();
+
+        /**
+         * @brief 把快照中订阅的字段序列化为响应字节
+         * @param snapshot 主机快照
+         * @param buffer 输出参数，响应字节
+         */
+        void ToBuffer(const HostStore::Snapshot& snapshot, ::grpc::ByteBuffer* buffer) const;
+
+        SubscriptionHub* hub_;              ///< 订阅推送中心
+        const uint64_t fields_mask_;        ///< 订阅的字段
+        std::mutex mutex_;                  ///< 保护以下成员
+        HostStore::Snapshot pending_;       ///< 等待发送的最新快照
+        ::grpc::ByteBuffer buffer_;         ///< 正在发送的响应（写完成前保持有效）
+        bool writing_ = false;              ///< 是否有写操作在进行
+        bool finished_ = false;             ///< 是否已调用Finish
+    };
+
+    /**
+     * @brief 直接以错误状态结束的推送reactor（请求非法时使用）
+     */
+    class RejectedWriteReactor : public ::grpc::ServerWriteReactor<::grpc::ByteBuffer>
+    {
+    public:
+        explicit RejectedWriteReactor(const ::grpc::Status& status) { Finish(status); }
+        void OnDone() override { delete this; }
+    };
+}  // namespace monitor
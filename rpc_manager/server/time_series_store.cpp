@@ -0,0 +1,575 @@
+// 包含对应的头文件
+#include "time_series_store.h"
+
+// C++标准库头文件
+#include <algorithm>    // std::fill、std::min、std::copy_n
+#include <chrono>       // 落盘周期
+#include <functional>   // std::hash
+#include <limits>       // NaN
+
+namespace monitor
+{
+    namespace
+    {
+        /// @brief 缺失数据的占位值
+        constexpr float kMissing = std::numeric_limits<float>::quiet_NaN();
+
+        /**
+         * @brief 判断字段是否可以作为一列保存
+         * @param field 字段描述符
+         * @return bool 单值的数值字段返回true
+         */
+        bool IsValueField(const google::protobuf::FieldDescriptor* field)
+        {
+            using google::protobuf::FieldDescriptor;
+            if (field->is_repeated())
+            {
+                return false;
+            }
+            switch (field->cpp_type())
+            {
+            case FieldDescriptor::CPPTYPE_FLOAT:
+            case FieldDescriptor::CPPTYPE_DOUBLE:
+            case FieldDescriptor::CPPTYPE_INT32:
+            case FieldDescriptor::CPPTYPE_INT64:
+            case FieldDescriptor::CPPTYPE_UINT32:
+            case FieldDescriptor::CPPTYPE_UINT64:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * @brief 通过反射读取数值字段并转换为float
+         * @param message 消息
+         * @param field 数值字段
+         * @return float 字段值
+         */
+        float ReadValue(const google::protobuf::Message& message, const google::protobuf::FieldDescriptor* field)
+        {
+            using google::protobuf::FieldDescriptor;
+            const google::protobuf::Reflection* reflection = message.GetReflection();
+            switch (field->cpp_type())
+            {
+            case FieldDescriptor::CPPTYPE_FLOAT:
+                return reflection->GetFloat(message, field);
+            case FieldDescriptor::CPPTYPE_DOUBLE:
+                return static_cast<float>(reflection->GetDouble(message, field));
+            case FieldDescriptor::CPPTYPE_INT32:
+                return static_cast<float>(reflection->GetInt32(message, field));
+            case FieldDescriptor::CPPTYPE_INT64:
+                return static_cast<float>(reflection->GetInt64(message, field));
+            case FieldDescriptor::CPPTYPE_UINT32:
+                return static_cast<float>(reflection->GetUInt32(message, field));
+            case FieldDescriptor::CPPTYPE_UINT64:
+                return static_cast<float>(reflection->GetUInt64(message, field));
+            default:
+                return kMissing;
+            }
+        }
+    }  // namespace
+
+    TimeSeriesStore::TimeSeriesStore(size_t capacity)
+        : capacity_(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    TimeSeriesStore::~TimeSeriesStore()
+    {
+        if (!flusher_.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex_);
+            stopping_ = true;
+        }
+        flush_cv_.notify_all();
+        flusher_.join();
+        Flush();   // 正常关闭时不丢失最后一个周期的数据
+    }
+
+    bool TimeSeriesStore::EnablePersistence(const ChunkStore::Options& options, int64_t flush_interval_ms,
+        std::string* error)
+    {
+        auto chunks = std::make_unique<ChunkStore>();
+        if (!chunks->Open(options, error))
+        {
+            return false;
+        }
+        chunks_ = std::move(chunks);
+        flush_interval_ms_ = flush_interval_ms > 0 ? flush_interval_ms : 1;
+        flusher_ = std::thread([this]() { FlushLoop(); });
+        return true;
+    }
+
+    void TimeSeriesStore::FlushLoop()
+    {
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        while (!flush_cv_.wait_for(lock, std::chrono::milliseconds(flush_interval_ms_), [this]() { return stopping_; }))
+        {
+            lock.unlock();
+            Flush();
+            lock.lock();
+        }
+    }
+
+    TimeSeriesStore::Shard& TimeSeriesStore::ShardFor(const std::string& host)
+    {
+        return shards_[std::hash<std::string>()(host) % kShardCount];
+    }
+
+    const TimeSeriesStore::Shard& TimeSeriesStore::ShardFor(const std::string& host) const
+    {
+        return shards_[std::hash<std::string>()(host) % kShardCount];
+    }
+
+    /**
+     * @brief 创建分组的具体实现
+     * @param field MonitorInfo中的消息字段
+     * @return 空分组
+     *
+     * 分组的列定义完全由Protobuf描述符推导：新增的监控字段无需修改存储代码即可保存历史。
+     */
+    std::unique_ptr<TimeSeriesStore::Group> TimeSeriesStore::CreateGroup(
+        const google::protobuf::FieldDescriptor* field) const
+    {
+        auto group = std::make_unique<Group>();
+        const google::protobuf::Descriptor* element = field->message_type();
+        for (int i = 0; i < element->field_count(); ++i)
+        {
+            const google::protobuf::FieldDescriptor* child = element->field(i);
+            if (field->is_repeated() && group->instance_field == nullptr &&
+                child->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING && !child->is_repeated())
+            {
+                group->instance_field = child;
+            }
+            else if (IsValueField(child))
+            {
+                group->value_fields.push_back(child);
+            }
+        }
+        group->timestamps.assign(capacity_, 0);
+        return group;
+    }
+
+    /**
+     * @brief 查找或分配实例的具体实现
+     * @param group 分组
+     * @param instance 实例名
+     * @return 实例序号
+     *
+     * 新实例的列一次性按capacity分配并填充NaN（新实例出现之前的历史点视为缺失）。
+     */
+    size_t TimeSeriesStore::InstanceIndex(Group* group, const std::string& instance) const
+    {
+        auto iter = group->instances.find(instance);
+        if (iter != group->instances.end())
+        {
+            return iter->second;
+        }
+
+        const size_t index = group->instances.size();
+        group->instances.emplace(instance, index);
+        group->names.push_back(instance);
+        group->values.resize((index + 1) * group->value_fields.size() * capacity_, kMissing);
+        group->written.resize(index + 1, 0);
+        group->idle.resize(index + 1, 0);
+        return index;
+    }
+
+    /**
+     * @brief 删除实例的具体实现
+     * @param group 分组
+     * @param instance 实例序号
+     *
+     * 列存储在这里只缩短，由调用方在一次采样的所有删除完成后统一释放多余的容量。
+     */
+    void TimeSeriesStore::EvictInstance(Group* group, size_t instance) const
+    {
+        const size_t last = group->names.size() - 1;
+        const size_t span = group->value_fields.size() * capacity_;
+        group->instances.erase(group->names[instance]);
+        if (instance != last)
+        {
+            std::copy_n(group->values.begin() + last * span, span, group->values.begin() + instance * span);
+            group->names[instance] = std::move(group->names[last]);
+            group->instances[group->names[instance]] = instance;
+            group->written[instance] = group->written[last];
+            group->idle[instance] = group->idle[last];
+        }
+        group->names.pop_back();
+        group->written.pop_back();
+        group->idle.pop_back();
+        group->values.resize(last * span);
+    }
+
+    void TimeSeriesStore::WriteElement(Group* group, const google::protobuf::Message& element, size_t instance) const
+    {
+        const size_t field_count = group->value_fields.size();
+        float* column = group->values.data() + instance * field_count * capacity_ + group->head;
+        for (size_t f = 0; f < field_count; ++f)
+        {
+            column[f * capacity_] = ReadValue(element, group->value_fields[f]);
+        }
+        group->written[instance] = 1;
+    }
+
+    /**
+     * @brief 追加分组采样点的具体实现
+     * @param group 分组
+     * @param sample 采样消息
+     * @param field MonitorInfo中该分组对应的字段
+     * @param timestamp_ms 采样时间
+     *
+     * 本次采样中出现的实例写入字段值，没有出现的实例（如网卡被移除）写入NaN，
+     * 避免环被覆盖一圈后残留上一圈的旧值；连续一整圈都没有出现的实例环中已没有数据，
+     * 删除并释放其列（此时也没有未落盘的点）。
+     */
+    void TimeSeriesStore::AppendGroup(Group* group, const monitor::proto::MonitorInfo& sample,
+        const google::protobuf::FieldDescriptor* field, int64_t timestamp_ms) const
+    {
+        if ((group->size > 0 && timestamp_ms <= group->timestamps[(group->head + capacity_ - 1) % capacity_]) ||
+            timestamp_ms <= group->flushed_ms)
+        {
+            return;
+        }
+
+        const google::protobuf::Reflection* reflection = sample.GetReflection();
+        std::fill(group->written.begin(), group->written.end(), 0);
+
+        if (field->is_repeated())
+        {
+            const int count = reflection->FieldSize(sample, field);
+            std::string scratch;
+            for (int i = 0; i < count; ++i)
+            {
+                const google::protobuf::Message& element = reflection->GetRepeatedMessage(sample, field, i);
+                const std::string& name = group->instance_field
+                    ? element.GetReflection()->GetStringReference(element, group->instance_field, &scratch)
+                    : scratch;
+                WriteElement(group, element, InstanceIndex(group, name));
+            }
+        }
+        else
+        {
+            WriteElement(group, reflection->GetMessage(sample, field), InstanceIndex(group, std::string()));
+        }
+
+        // 缺失的实例写入NaN；连续缺失一整圈的实例被删除
+        // （从后往前遍历：删除时移过来的最后一个实例已经处理过）
+        const size_t field_count = group->value_fields.size();
+        bool evicted = false;
+        for (size_t instance = group->written.size(); instance-- > 0;)
+        {
+            if (group->written[instance])
+            {
+                group->idle[instance] = 0;
+                continue;
+            }
+            float* column = group->values.data() + instance * field_count * capacity_ + group->head;
+            for (size_t f = 0; f < field_count; ++f)
+            {
+                column[f * capacity_] = kMissing;
+            }
+            if (++group->idle[instance] >= capacity_)
+            {
+                EvictInstance(group, instance);
+                evicted = true;
+            }
+        }
+        if (evicted)
+        {
+            group->values.shrink_to_fit();
+        }
+
+        group->timestamps[group->head] = timestamp_ms;
+        group->head = (group->head + 1) % capacity_;
+        group->size = std::min(group->size + 1, capacity_);
+    }
+
+    /**
+     * @brief 写入采样的具体实现
+     * @param sample 采样消息
+     * @param receive_ms 服务器接收时间
+     *
+     * 采样只包含本批次到期的监控器的分组，每个分组独立追加一个采样点。
+     */
+    void TimeSeriesStore::Append(const monitor::proto::MonitorInfo& sample, int64_t receive_ms)
+    {
+        static const std::string kUnknownHost = "unknown_host";
+        const std::string& host = sample.name().empty() ? kUnknownHost : sample.name();
+        const int64_t timestamp_ms = sample.timestamp_ms() > 0 ? sample.timestamp_ms() : receive_ms;
+
+        HostSeries* series = nullptr;
+        {
+            Shard& shard = ShardFor(host);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            std::unique_ptr<HostSeries>& entry = shard.hosts[host];
+            if (!entry)
+            {
+                entry = std::make_unique<HostSeries>();
+                entry->groups.resize(monitor::proto::MonitorInfo::descriptor()->field_count());
+            }
+            series = entry.get();   // 主机序列创建后不会被删除，出锁后仍然有效
+        }
+
+        // 直接遍历描述符而不是ListFields，稳态写入路径上不做堆分配
+        const google::protobuf::Descriptor* descriptor = sample.GetDescriptor();
+        const google::protobuf::Reflection* reflection = sample.GetReflection();
+
+        std::lock_guard<std::mutex> lock(series->mutex);
+        for (int i = 0; i < descriptor->field_count(); ++i)
+        {
+            const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+            if (field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE ||
+                field->options().GetExtension(monitor::proto::snapshot_only))
+            {
+                continue;   // 主机名、时间戳等标量字段，以及只保存最新快照的分组
+            }
+            const bool present = field->is_repeated() ? reflection->FieldSize(sample, field) > 0
+                                                      : reflection->HasField(sample, field);
+            if (!present)
+            {
+                continue;   // 本批次没有该监控器的数据
+            }
+            std::unique_ptr<Group>& group = series->groups[field->index()];
+            if (!group)
+            {
+                group = CreateGroup(field);
+                if (chunks_)
+                {
+                    group->flushed_ms = chunks_->LastTimestamp(host, field->name());
+                }
+            }
+            AppendGroup(group.get(), sample, field, timestamp_ms);
+        }
+    }
+
+    /**
+     * @brief 落盘的具体实现
+     *
+     * 每个分组取flushed_ms之后的点（时间戳环有序，二分定位），全部缺失的列不写入；
+     * 写入成功后才推进flushed_ms。
+     */
+    void TimeSeriesStore::Flush()
+    {
+        if (!chunks_)
+        {
+            return;
+        }
+
+        std::vector<std::pair<std::string, HostSeries*>> hosts;
+        for (Shard& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& entry : shard.hosts)
+            {
+                hosts.emplace_back(entry.first, entry.second.get());
+            }
+        }
+
+        const google::protobuf::Descriptor* descriptor = monitor::proto::MonitorInfo::descriptor();
+        std::vector<ChunkGroup> batch;
+        std::vector<std::pair<Group*, int64_t>> flushed;
+        for (const auto& [host, series] : hosts)
+        {
+            batch.clear();
+            flushed.clear();
+            {
+                std::lock_guard<std::mutex> lock(series->mutex);
+                for (size_t g = 0; g < series->groups.size(); ++g)
+                {
+                    Group* group = series->groups[g].get();
+                    if (group == nullptr || group->size == 0)
+                    {
+                        continue;
+                    }
+                    const size_t oldest = (group->head + capacity_ - group->size) % capacity_;
+                    auto physical = [&](size_t i) { return (oldest + i) % capacity_; };
+
+                    size_t low = 0;
+                    size_t high = group->size;
+                    while (low < high)
+                    {
+                        const size_t mid = low + (high - low) / 2;
+                        if (group->timestamps[physical(mid)] <= group->flushed_ms)
+                        {
+                            low = mid + 1;
+                        }
+                        else
+                        {
+                            high = mid;
+                        }
+                    }
+                    if (low == group->size)
+                    {
+                        continue;   // 没有新的点
+                    }
+
+                    ChunkGroup out;
+                    out.name = descriptor->field(static_cast<int>(g))->name();
+                    for (size_t i = low; i < group->size; ++i)
+                    {
+                        out.timestamps.push_back(group->timestamps[physical(i)]);
+                    }
+
+                    const size_t field_count = group->value_fields.size();
+                    for (size_t instance = 0; instance < group->names.size(); ++instance)
+                    {
+                        for (size_t f = 0; f < field_count; ++f)
+                        {
+                            const float* column = group->values.data() + (instance * field_count + f) * capacity_;
+                            ChunkColumn out_column{group->names[instance], group->value_fields[f]->name(), {}};
+                            out_column.values.reserve(out.timestamps.size());
+                            bool any = false;
+                            for (size_t i = low; i < group->size; ++i)
+                            {
+                                const float value = column[physical(i)];
+                                any = any || value == value;
+                                out_column.values.push_back(value);
+                            }
+                            if (any)
+                            {
+                                out.columns.push_back(std::move(out_column));
+                            }
+                        }
+                    }
+                    flushed.emplace_back(group, out.timestamps.back());
+                    batch.push_back(std::move(out));
+                }
+            }
+
+            if (batch.empty() || !chunks_->Write(host, batch))
+            {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(series->mutex);
+            for (const auto& [group, timestamp_ms] : flushed)
+            {
+                group->flushed_ms = std::max(group->flushed_ms, timestamp_ms);
+            }
+        }
+    }
+
+    /**
+     * @brief 区间查询的具体实现
+     * @param request 查询请求
+     * @param response 查询结果
+     * @return 主机和指标在内存或磁盘上存在返回true
+     *
+     * 时间戳环按时间有序，二分查找区间起点后顺序拷贝到区间终点，缺失（NaN）的点不返回。
+     * 内存中的点先复制出来（持有主机锁期间不做磁盘IO），早于内存中最早一点的部分从磁盘块读取，
+     * 两部分按时间衔接，不重复。
+     */
+    bool TimeSeriesStore::QueryRange(const monitor::proto::RangeRequest& request,
+        monitor::proto::RangeResponse* response) const
+    {
+        response->Clear();
+
+        // 解析指标名"<分组>.<字段>"
+        const std::string& metric = request.metric();
+        const size_t dot = metric.find('.');
+        if (dot == std::string::npos)
+        {
+            return false;
+        }
+        const google::protobuf::FieldDescriptor* group_field =
+            monitor::proto::MonitorInfo::descriptor()->FindFieldByName(metric.substr(0, dot));
+        if (group_field == nullptr || group_field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+        {
+            return false;
+        }
+        const std::string value_name = metric.substr(dot + 1);
+
+        const HostSeries* series = nullptr;
+        {
+            const Shard& shard = ShardFor(request.host());
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto iter = shard.hosts.find(request.host());
+            if (iter != shard.hosts.end())
+            {
+                series = iter->second.get();
+            }
+        }
+
+        bool in_memory = false;
+        int64_t memory_oldest = std::numeric_limits<int64_t>::max();
+        std::vector<int64_t> timestamps;
+        std::vector<float> values;
+        if (series != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(series->mutex);
+            const Group* group = series->groups[group_field->index()].get();
+            const size_t oldest = group ? (group->head + capacity_ - group->size) % capacity_ : 0;
+            if (group != nullptr && group->size > 0)
+            {
+                memory_oldest = group->timestamps[oldest];
+            }
+
+            const float* column = nullptr;
+            if (group != nullptr)
+            {
+                auto field_iter = std::find_if(group->value_fields.begin(), group->value_fields.end(),
+                    [&](const google::protobuf::FieldDescriptor* field) { return field->name() == value_name; });
+                auto instance_iter = group->instances.find(request.instance());
+                if (field_iter != group->value_fields.end() && instance_iter != group->instances.end())
+                {
+                    const size_t column_index = instance_iter->second * group->value_fields.size() +
+                                                (field_iter - group->value_fields.begin());
+                    column = group->values.data() + column_index * capacity_;
+                }
+            }
+            in_memory = column != nullptr;
+            if (in_memory)
+            {
+                // 逻辑序号i（0为最旧的点）到环中物理位置的映射
+                auto physical = [&](size_t i) { return (oldest + i) % capacity_; };
+
+                // 二分查找第一个不早于t0的点
+                size_t low = 0;
+                size_t high = group->size;
+                while (low < high)
+                {
+                    const size_t mid = low + (high - low) / 2;
+                    if (group->timestamps[physical(mid)] < request.t0_ms())
+                    {
+                        low = mid + 1;
+                    }
+                    else
+                    {
+                        high = mid;
+                    }
+                }
+
+                for (size_t i = low; i < group->size && group->timestamps[physical(i)] <= request.t1_ms(); ++i)
+                {
+                    const size_t index = physical(i);
+                    if (column[index] != column[index])
+                    {
+                        continue;   // NaN：该实例在这次采样中缺失
+                    }
+                    timestamps.push_back(group->timestamps[index]);
+                    values.push_back(column[index]);
+                }
+            }
+        }
+
+        bool on_disk = false;
+        if (chunks_ && request.t0_ms() < memory_oldest)
+        {
+            on_disk = chunks_->QueryRange(request.host(), group_field->name(), request.instance(), value_name,
+                request.t0_ms(), request.t1_ms(), memory_oldest, response);
+        }
+
+        response->mutable_timestamp_ms()->Reserve(response->timestamp_ms_size() + static_cast<int>(timestamps.size()));
+        response->mutable_value()->Reserve(response->value_size() + static_cast<int>(values.size()));
+        for (size_t i = 0; i < timestamps.size(); ++i)
+        {
+            response->add_timestamp_ms(timestamps[i]);
+            response->add_value(values[i]);
+        }
+        return in_memory || on_disk;
+    }
+}  // namespace monitor
@@ -0,0 +1,210 @@
+// 头文件保护宏，防止重复包含
+#pragma once
+
+// C++标准库头文件
+#include <array>          // 固定数量的分片
+#include <condition_variable>   // 唤醒落盘线程
+#include <cstddef>        // size_t
+#include <cstdint>        // int64_t
+#include <memory>         // std::unique_ptr
+#include <mutex>          // 分片锁、主机锁
+#include <string>         // 主机名、实例名
+#include <thread>         // 落盘线程
+#include <unordered_map>  // 主机表、实例表
+#include <vector>         // 列存储
+
+// 服务器内部模块
+#include "chunk_store.h"  // 磁盘块存储
+
+// Protobuf生成的头文件
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+    /**
+     * @brief 多主机时间序列存储
+     *
+     * 保存每台主机最近capacity个采样点的历史数据，供界面绘制趋势图。
+     *
+     * 数据组织（列式环形缓冲区）：
+     * - 分组：MonitorInfo的每个消息字段（cpu_stat、net_info、mem_info、cpu_load、soft_irq）是一个分组，
+     *   各监控器采样周期不同，每个分组有自己的时间戳环；
+     *   标记为snapshot_only的字段（process_info，实例随pid不断更替）只保存在HostStore的最新快照中
+     * - 实例：repeated分组按元素中的第一个字符串字段（cpu_name、name、cpu）区分实例，
+     *   单实例分组（cpu_load、mem_info）只有一个空名实例
+     * - 列：每个实例的每个数值字段是一列，长度为capacity的连续float数组，
+     *   与分组的时间戳环共用写入位置；某次采样中缺失的实例写入NaN
+     *
+     * 内存：所有列在分组或实例第一次出现时按capacity一次性分配，
+     * 稳态写入只覆盖环中的旧数据，不做堆分配。
+     * 连续缺失一整圈（capacity个采样点）的实例（被删除的cgroup、被移除的网卡）环中已全是NaN，
+     * 删除该实例并释放其列，实例不断更替的分组占用的内存不会无限增长。
+     * 以capacity=3600（1秒采样保存1小时）估算：每列约14KB，
+     * 16核心、4网卡的主机约300列，约4MB；500台主机约2GB。
+     *
+     * 并发：按主机名分片，每台主机一把锁，写入和查询只锁住对应主机。
+     *
+     * 持久化（可选，EnablePersistence）：环形缓冲区作为最近数据的内存层，
+     * 落盘线程每flush_interval_ms把每个分组中尚未落盘的点编码为ChunkStore的不可变块；
+     * QueryRange中早于内存里最早一点的部分从磁盘块读取，重启后的历史同样可查。
+     * 落盘周期必须小于环形缓冲区覆盖的时间（capacity × 最短采样周期），否则被覆盖的点不会落盘。
+     */
+    class TimeSeriesStore
+    {
+    public:
+        /// @brief 默认每条序列保存的采样点数（1秒采样保存1小时）
+        static constexpr size_t kDefaultCapacity = 3600;
+
+        /// @brief 分片数
+        static constexpr size_t kShardCount = 16;
+
+        /**
+         * @brief 构造函数
+         * @param capacity 每条序列保存的采样点数
+         */
+        explicit TimeSeriesStore(size_t capacity = kDefaultCapacity);
+
+        /**
+         * @brief 析构函数，启用了持久化时停止落盘线程并把剩余数据落盘
+         */
+        ~TimeSeriesStore();
+
+        /**
+         * @brief 启用磁盘持久化并启动落盘线程
+         * @param options 磁盘块存储配置
+         * @param flush_interval_ms 落盘周期
+         * @param error 输出参数，失败原因
+         * @return bool 成功返回true
+         *
+         * 必须在第一次Append之前调用。
+         */
+        bool EnablePersistence(const ChunkStore::Options& options, int64_t flush_interval_ms, std::string* error);
+
+        /**
+         * @brief 把所有分组中尚未落盘的点写为磁盘块
+         *
+         * 在主机锁内只复制数据，编码和写文件在锁外进行；写入失败的数据在下一次落盘时重试。
+         */
+        void Flush();
+
+        /**
+         * @brief 写入一条采样
+         * @param sample 采样消息（只读取，不修改）
+         * @param receive_ms 服务器接收时间（Unix毫秒），采样未携带时间戳时使用
+         *
+         * 时间戳不晚于分组中最新采样的数据（重连后重发的旧采样）被丢弃，保证时间戳环有序；
+         * 启用持久化时，不晚于磁盘上该分组最新数据的采样同样被丢弃（服务器重启后）。
+         */
+        void Append(const monitor::proto::MonitorInfo& sample, int64_t receive_ms);
+
+        /**
+         * @brief 查询一条序列在时间区间内的数据
+         * @param request 查询请求（主机、指标、实例、时间区间）
+         * @param response 输出参数，区间内的采样点（升序）
+         * @return bool 主机和指标在内存或磁盘上存在返回true
+         */
+        bool QueryRange(const monitor::proto::RangeRequest& request,
+            monitor::proto::RangeResponse* response) const;
+
+    private:
+        /**
+         * @brief 一个分组的列式环形缓冲区
+         */
+        struct Group
+        {
+            const google::protobuf::FieldDescriptor* instance_field = nullptr;    ///< 实例名字段（单实例分组为空）
+            std::vector<const google::protobuf::FieldDescriptor*> value_fields;   ///< 数值字段，列内顺序
+            std::unordered_map<std::string, size_t> instances;                  ///< 实例名到实例序号
+            std::vector<std::string> names;     ///< 实例序号到实例名
+            std::vector<size_t> idle;           ///< 各实例连续缺失的采样点数
+            std::vector<int64_t> timestamps;    ///< 时间戳环，长度为capacity
+            std::vector<float> values;          ///< 列存储：第(实例序号×字段数+字段序号)列从该列×capacity开始
+            std::vector<uint8_t> written;       ///< 本次采样中已写入的实例（复用缓冲区）
+            size_t head = 0;                    ///< 下一个写入位置
+            size_t size = 0;                    ///< 已保存的采样点数
+            int64_t flushed_ms = 0;             ///< 已落盘的最新时间
+        };
+
+        /**
+         * @brief 一台主机的所有分组
+         */
+        struct HostSeries
+        {
+            mutable std::mutex mutex;                       ///< 主机锁
+            std::vector<std::unique_ptr<Group>> groups;     ///< 按MonitorInfo字段序号索引，首次出现时创建
+        };
+
+        /**
+         * @brief 分片：一把锁保护一张主机表
+         */
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex;                                           ///< 分片锁
+            std::unordered_map<std::string, std::unique_ptr<HostSeries>> hosts; ///< 主机名到序列
+        };
+
+        /**
+         * @brief 根据主机名选择分片
+         */
+        Shard& ShardFor(const std::string& host);
+        const Shard& ShardFor(const std::string& host) const;
+
+        /**
+         * @brief 为MonitorInfo的消息字段创建分组
+         * @param field MonitorInfo中的消息字段
+         * @return std::unique_ptr<Group> 空分组（尚无实例）
+         */
+        std::unique_ptr<Group> CreateGroup(const google::protobuf::FieldDescriptor* field) const;
+
+        /**
+         * @brief 查找实例，不存在时为其分配列
+         * @param group 分组
+         * @param instance 实例名
+         * @return size_t 实例序号
+         */
+        size_t InstanceIndex(Group* group, const std::string& instance) const;
+
+        /**
+         * @brief 删除一个实例并释放其列
+         * @param group 分组
+         * @param instance 实例序号
+         *
+         * 最后一个实例的列移动到被删除实例的位置，其余实例的序号不变。
+         */
+        void EvictInstance(Group* group, size_t instance) const;
+
+        /**
+         * @brief 把一个元素的数值字段写入当前位置
+         * @param group 分组
+         * @param element 分组中的一个元素（CpuStat、NetInfo等）
+         * @param instance 实例序号
+         */
+        void WriteElement(Group* group, const google::protobuf::Message& element, size_t instance) const;
+
+        /**
+         * @brief 把一个分组的元素追加为一个采样点
+         * @param group 分组
+         * @param sample 采样消息
+         * @param field MonitorInfo中该分组对应的字段
+         * @param timestamp_ms 采样时间
+         */
+        void AppendGroup(Group* group, const monitor::proto::MonitorInfo& sample,
+            const google::protobuf::FieldDescriptor* field, int64_t timestamp_ms) const;
+
+        /**
+         * @brief 落盘线程主循环
+         */
+        void FlushLoop();
+
+        size_t capacity_;                          ///< 每条序列保存的采样点数
+        std::array<Shard, kShardCount> shards_;    ///< 分片
+
+        // ==================== 持久化 ====================
+        std::unique_ptr<ChunkStore> chunks_;       ///< 磁盘块存储，未启用持久化时为空
+        int64_t flush_interval_ms_ = 0;            ///< 落盘周期
+        std::mutex flush_mutex_;                   ///< 保护stopping_
+        std::condition_variable flush_cv_;         ///< 唤醒落盘线程
+        bool stopping_ = false;                    ///< 是否正在停止
+        std::thread flusher_;                      ///< 落盘线程
+    };
+}  // namespace monitor
@@ -0,0 +1,71 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "server/aggregate_store.h"
+
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+namespace
+{
+    /**
+     * @brief 构造只包含内存使用率的采样
+     */
+    monitor::proto::MonitorInfo MemSample(const std::string& host, const std::string& group, float used_percent)
+    {
+        monitor::proto::MonitorInfo info;
+        info.set_name(host);
+        info.set_host_group(group);
+        info.set_timestamp_ms(1000);
+        info.mutable_mem_info()->set_used_percent(used_percent);
+        return info;
+    }
+
+    /**
+     * @brief 查询一个分组的内存使用率聚合
+     */
+    bool QueryMem(const AggregateStore& store, const std::string& group, monitor::proto::AggregateResponse* response)
+    {
+        monitor::proto::AggregateRequest request;
+        request.set_group(group);
+        request.set_metric("mem_used_percent");
+        response->Clear();
+        return store.Query(request, response);
+    }
+
+    TEST(AggregateStoreTest, StaleHostLeavesRollup)
+    {
+        AggregateStore store;
+        store.Update(MemSample("stale", "cluster-x", 90.0f), 1000);
+        store.Update(MemSample("live", "cluster-x", 30.0f), 1000);
+        store.Update(MemSample("live", "cluster-x", 40.0f), 5000);
+
+        EXPECT_EQ(store.Expire(3000), 1u);
+
+        monitor::proto::AggregateResponse response;
+        ASSERT_TRUE(QueryMem(store, "cluster-x", &response));
+        EXPECT_EQ(response.hosts(), 1u);
+        EXPECT_EQ(response.count(), 1u);
+        EXPECT_DOUBLE_EQ(response.sum(), 40.0);
+
+        ASSERT_TRUE(QueryMem(store, "", &response));
+        EXPECT_EQ(response.hosts(), 1u);
+        EXPECT_DOUBLE_EQ(response.sum(), 40.0);
+
+        // 最后一台主机过期后命名分组不再存在，全集群为空
+        EXPECT_EQ(store.Expire(6000), 1u);
+        EXPECT_FALSE(QueryMem(store, "cluster-x", &response));
+        ASSERT_TRUE(QueryMem(store, "", &response));
+        EXPECT_EQ(response.hosts(), 0u);
+        EXPECT_EQ(response.count(), 0u);
+
+        // 重新上报时按新主机加入
+        store.Update(MemSample("stale", "cluster-x", 50.0f), 7000);
+        ASSERT_TRUE(QueryMem(store, "cluster-x", &response));
+        EXPECT_EQ(response.hosts(), 1u);
+        EXPECT_DOUBLE_EQ(response.sum(), 50.0);
+    }
+}  // namespace
+}  // namespace monitor
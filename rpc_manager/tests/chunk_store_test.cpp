@@ -0,0 +1,182 @@
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/chunk_store.h"
+
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+namespace
+{
+    /// @brief 测试用的分区长度（1秒），方便构造跨分区的数据
+    constexpr int64_t kPartitionMs = 1000;
+
+    /**
+     * @brief 每个测试一个临时数据目录，结束时删除
+     */
+    class ChunkStoreTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            char pattern[] = "/tmp/chunk_store_test.XXXXXX";
+            ASSERT_NE(mkdtemp(pattern), nullptr);
+            dir_ = pattern;
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(dir_);
+        }
+
+        /**
+         * @brief 打开数据目录（合并线程的周期足够长，只由测试显式调用Compact）
+         */
+        std::unique_ptr<ChunkStore> Open()
+        {
+            ChunkStore::Options options;
+            options.dir = dir_;
+            options.partition_ms = kPartitionMs;
+            options.compaction_interval_ms = 3600 * 1000;
+            options.fan_in = 2;
+            options.sync = false;
+            auto store = std::make_unique<ChunkStore>();
+            std::string error;
+            EXPECT_TRUE(store->Open(options, &error)) << error;
+            return store;
+        }
+
+        std::string dir_;   ///< 临时数据目录
+    };
+
+    /**
+     * @brief 构造cpu_stat分组中cpu0的cpu_percent列
+     */
+    std::vector<ChunkGroup> CpuGroups(const std::vector<int64_t>& timestamps, const std::vector<float>& values)
+    {
+        ChunkGroup group;
+        group.name = "cpu_stat";
+        group.timestamps = timestamps;
+        group.columns.push_back(ChunkColumn{"cpu0", "cpu_percent", values});
+        return {group};
+    }
+
+    /**
+     * @brief 查询cpu0的cpu_percent在[t0_ms, t1_ms]内的点
+     */
+    monitor::proto::RangeResponse QueryCpu(const ChunkStore& store, int64_t t0_ms, int64_t t1_ms)
+    {
+        monitor::proto::RangeResponse response;
+        store.QueryRange("host", "cpu_stat", "cpu0", "cpu_percent", t0_ms, t1_ms, INT64_MAX, &response);
+        return response;
+    }
+
+    TEST_F(ChunkStoreTest, CompactedChunksSurviveReopen)
+    {
+        {
+            std::unique_ptr<ChunkStore> store = Open();
+            // 第一批跨两个分区（分区0一块序号1，分区1一块序号2），第二批只在分区0（序号3）
+            ASSERT_TRUE(store->Write("host", CpuGroups({100, 1100}, {1.0f, 2.0f})));
+            ASSERT_TRUE(store->Write("host", CpuGroups({200}, {3.0f})));
+            EXPECT_EQ(store->ChunkCount(), 3u);
+
+            monitor::proto::RangeResponse response = QueryCpu(*store, 0, 2000);
+            ASSERT_EQ(response.value_size(), 3);
+            EXPECT_EQ(response.timestamp_ms(0), 100);
+            EXPECT_EQ(response.timestamp_ms(1), 200);
+            EXPECT_EQ(response.timestamp_ms(2), 1100);
+
+            // 分区0的两块合并为序号范围1-3的块，分区1中序号2的块不参与
+            store->Compact(1500);
+            EXPECT_EQ(store->ChunkCount(), 2u);
+            response = QueryCpu(*store, 0, 2000);
+            ASSERT_EQ(response.value_size(), 3);
+            EXPECT_FLOAT_EQ(response.value(1), 3.0f);
+        }
+
+        // 重新打开：序号落在合并结果序号范围内的其他分区的块不能被当作已合并删除
+        std::unique_ptr<ChunkStore> store = Open();
+        EXPECT_EQ(store->ChunkCount(), 2u);
+        monitor::proto::RangeResponse response = QueryCpu(*store, 0, 2000);
+        ASSERT_EQ(response.value_size(), 3);
+        EXPECT_EQ(response.timestamp_ms(0), 100);
+        EXPECT_EQ(response.timestamp_ms(1), 200);
+        EXPECT_EQ(response.timestamp_ms(2), 1100);
+        EXPECT_FLOAT_EQ(response.value(2), 2.0f);
+        EXPECT_EQ(store->LastTimestamp("host", "cpu_stat"), 1100);
+
+        // 重启后新块的序号接着已有的最大序号
+        ASSERT_TRUE(store->Write("host", CpuGroups({300}, {4.0f})));
+        EXPECT_TRUE(std::filesystem::exists(dir_ + "/host/00000000000000000004-00000000000000000004.chunk"));
+        response = QueryCpu(*store, 0, 999);
+        ASSERT_EQ(response.value_size(), 3);
+        EXPECT_EQ(response.timestamp_ms(2), 300);
+    }
+
+    TEST_F(ChunkStoreTest, InterruptedMergeIsFinishedFromItsRecord)
+    {
+        std::vector<std::string> sources;
+        std::vector<std::string> contents;
+        {
+            std::unique_ptr<ChunkStore> store = Open();
+            ASSERT_TRUE(store->Write("host", CpuGroups({100}, {1.0f})));
+            ASSERT_TRUE(store->Write("host", CpuGroups({200}, {2.0f})));
+            for (const auto& entry : std::filesystem::directory_iterator(dir_ + "/host"))
+            {
+                sources.push_back(entry.path().string());
+                std::ifstream in(entry.path(), std::ios::binary);
+                contents.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+            ASSERT_EQ(sources.size(), 2u);
+            store->Compact(1500);
+            ASSERT_EQ(store->ChunkCount(), 1u);
+        }
+
+        // 模拟合并结果已发布、源块和合并记录还没删除时崩溃
+        std::ofstream record(dir_ + "/host/00000000000000000001-00000000000000000002.merge");
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            std::ofstream(sources[i], std::ios::binary) << contents[i];
+            record << std::filesystem::path(sources[i]).filename().string() << '\n';
+        }
+        record.close();
+
+        std::unique_ptr<ChunkStore> store = Open();
+        EXPECT_EQ(store->ChunkCount(), 1u);
+        EXPECT_EQ(QueryCpu(*store, 0, 999).value_size(), 2);   // 源块已删除，没有重复的点
+        for (const std::string& source : sources)
+        {
+            EXPECT_FALSE(std::filesystem::exists(source));
+        }
+        EXPECT_FALSE(std::filesystem::exists(dir_ + "/host/00000000000000000001-00000000000000000002.merge"));
+    }
+
+    TEST_F(ChunkStoreTest, RecordWithoutPublishedResultKeepsSources)
+    {
+        {
+            std::unique_ptr<ChunkStore> store = Open();
+            ASSERT_TRUE(store->Write("host", CpuGroups({100}, {1.0f})));
+            ASSERT_TRUE(store->Write("host", CpuGroups({200}, {2.0f})));
+        }
+
+        // 模拟合并记录已发布、合并结果还没发布时崩溃
+        std::ofstream(dir_ + "/host/00000000000000000001-00000000000000000002.merge")
+            << "00000000000000000001-00000000000000000001.chunk\n"
+            << "00000000000000000002-00000000000000000002.chunk\n";
+
+        std::unique_ptr<ChunkStore> store = Open();
+        EXPECT_EQ(store->ChunkCount(), 2u);
+        EXPECT_EQ(QueryCpu(*store, 0, 999).value_size(), 2);
+        EXPECT_FALSE(std::filesystem::exists(dir_ + "/host/00000000000000000001-00000000000000000002.merge"));
+    }
+}  // namespace
+}  // namespace monitor
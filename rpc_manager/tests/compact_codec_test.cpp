@@ -0,0 +1,178 @@
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "codec/compact_codec.h"
+
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+namespace
+{
+    /**
+     * @brief 构造一条只有一个CPU的采样
+     * @param cpu_percent cpu0的cpu_percent
+     * @param timestamp_ms 采样时间
+     */
+    monitor::proto::MonitorInfo MakeSample(float cpu_percent, int64_t timestamp_ms)
+    {
+        monitor::proto::MonitorInfo info;
+        info.set_name("host");
+        info.set_timestamp_ms(timestamp_ms);
+        auto* cpu = info.add_cpu_stat();
+        cpu->set_cpu_name("cpu0");
+        cpu->set_cpu_percent(cpu_percent);
+        cpu->set_usr_percent(12.5f);
+        return info;
+    }
+
+    /**
+     * @brief 编码后立即解码
+     */
+    monitor::proto::MonitorInfo RoundTrip(CompactEncoder* encoder, CompactDecoder* decoder,
+        const monitor::proto::MonitorInfo& info)
+    {
+        monitor::proto::CompactFrame frame;
+        encoder->Encode(info, &frame);
+        monitor::proto::MonitorInfo decoded;
+        EXPECT_TRUE(decoder->Decode(frame, &decoded));
+        return decoded;
+    }
+
+    TEST(CompactQuantizerTest, NonFiniteValuesMapToSentinels)
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double inf = std::numeric_limits<double>::infinity();
+        EXPECT_EQ(CompactQuantizer::Quantize(nan, 100), CompactQuantizer::kNaN);
+        EXPECT_EQ(CompactQuantizer::Quantize(inf, 100), CompactQuantizer::kPositiveInfinity);
+        EXPECT_EQ(CompactQuantizer::Quantize(-inf, 100), CompactQuantizer::kNegativeInfinity);
+        EXPECT_EQ(CompactQuantizer::Quantize(1e30, 100), CompactQuantizer::kLimit);
+        EXPECT_EQ(CompactQuantizer::Quantize(-1e30, 100), -CompactQuantizer::kLimit);
+        EXPECT_EQ(CompactQuantizer::Quantize(1.234, 100), 123);
+
+        EXPECT_TRUE(std::isnan(CompactQuantizer::Restore(CompactQuantizer::kNaN, 100)));
+        EXPECT_EQ(CompactQuantizer::Restore(CompactQuantizer::kPositiveInfinity, 100), inf);
+        EXPECT_EQ(CompactQuantizer::Restore(CompactQuantizer::kNegativeInfinity, 100), -inf);
+    }
+
+    TEST(CompactQuantizerTest, DeltaAcrossSentinelsIsReversible)
+    {
+        const int64_t values[] = {0, 5000, CompactQuantizer::kNaN, 4200, CompactQuantizer::kPositiveInfinity,
+                                  CompactQuantizer::kNegativeInfinity, -CompactQuantizer::kLimit, 7};
+        int64_t previous = 0;
+        int64_t decoded = 0;
+        for (int64_t value : values)
+        {
+            decoded = CompactQuantizer::Apply(decoded, CompactQuantizer::Delta(value, previous));
+            EXPECT_EQ(decoded, value);
+            previous = value;
+        }
+    }
+
+    TEST(CompactCodecTest, NaNFieldRoundTripsWithoutPoisoningDeltas)
+    {
+        CompactEncoder encoder;
+        CompactDecoder decoder;
+
+        // 关键帧：正常值
+        auto decoded = RoundTrip(&encoder, &decoder, MakeSample(42.0f, 1000));
+        ASSERT_EQ(decoded.cpu_stat_size(), 1);
+        EXPECT_FLOAT_EQ(decoded.cpu_stat(0).cpu_percent(), 42.0f);
+
+        // 差分帧：NaN原样还原，同一实例的其他字段不受影响
+        decoded = RoundTrip(&encoder, &decoder, MakeSample(std::numeric_limits<float>::quiet_NaN(), 2000));
+        ASSERT_EQ(decoded.cpu_stat_size(), 1);
+        EXPECT_TRUE(std::isnan(decoded.cpu_stat(0).cpu_percent()));
+        EXPECT_FLOAT_EQ(decoded.cpu_stat(0).usr_percent(), 12.5f);
+
+        // NaN之后的差分帧：还原出精确的值
+        decoded = RoundTrip(&encoder, &decoder, MakeSample(37.25f, 3000));
+        EXPECT_FLOAT_EQ(decoded.cpu_stat(0).cpu_percent(), 37.25f);
+
+        // 无穷和超出量化范围的值
+        decoded = RoundTrip(&encoder, &decoder, MakeSample(std::numeric_limits<float>::infinity(), 4000));
+        EXPECT_TRUE(std::isinf(decoded.cpu_stat(0).cpu_percent()));
+        EXPECT_GT(decoded.cpu_stat(0).cpu_percent(), 0);
+        decoded = RoundTrip(&encoder, &decoder, MakeSample(-3e38f, 5000));
+        EXPECT_FLOAT_EQ(decoded.cpu_stat(0).cpu_percent(),
+            static_cast<float>(static_cast<double>(-CompactQuantizer::kLimit) / CompactEncoder::kDefaultFloatScale));
+
+        decoded = RoundTrip(&encoder, &decoder, MakeSample(1.5f, 6000));
+        EXPECT_FLOAT_EQ(decoded.cpu_stat(0).cpu_percent(), 1.5f);
+    }
+
+    TEST(CompactCodecTest, SnapshotOnlyGroupBypassesDictionary)
+    {
+        CompactEncoder encoder;
+        CompactDecoder decoder;
+
+        for (uint32_t pid = 100; pid < 105; ++pid)
+        {
+            monitor::proto::MonitorInfo info = MakeSample(10.0f, pid * 1000);
+            auto* process = info.add_process_info();
+            process->set_name("worker[" + std::to_string(pid) + "]");
+            process->set_pid(pid);
+            process->set_cpu_percent(3.25f);
+
+            monitor::proto::CompactFrame frame;
+            encoder.Encode(info, &frame);
+            for (const std::string& name : frame.new_names())
+            {
+                EXPECT_EQ(name, "cpu0");   // 进程名不进入字典
+            }
+
+            monitor::proto::MonitorInfo decoded;
+            ASSERT_TRUE(decoder.Decode(frame, &decoded));
+            ASSERT_EQ(decoded.process_info_size(), 1);
+            EXPECT_EQ(decoded.process_info(0).name(), process->name());
+            EXPECT_EQ(decoded.process_info(0).pid(), pid);
+            EXPECT_FLOAT_EQ(decoded.process_info(0).cpu_percent(), 3.25f);   // 原样传输，不量化
+            ASSERT_EQ(decoded.cpu_stat_size(), 1);
+        }
+    }
+
+    TEST(CompactCodecTest, IdleNamesAreEvictedAndIdsReused)
+    {
+        CompactEncoder encoder;
+        CompactDecoder decoder;
+        auto cgroup_sample = [](const std::string& name, int64_t timestamp_ms) {
+            monitor::proto::MonitorInfo info;
+            info.set_name("host");
+            info.set_timestamp_ms(timestamp_ms);
+            auto* cgroup = info.add_cgroup_info();
+            cgroup->set_name(name);
+            cgroup->set_cpu_percent(20.0f);
+            return info;
+        };
+
+        RoundTrip(&encoder, &decoder, cgroup_sample("pod-old", 0));
+        bool removed = false;
+        for (uint32_t i = 1; i <= CompactEncoder::kNameIdleFrames; ++i)
+        {
+            monitor::proto::CompactFrame frame;
+            encoder.Encode(cgroup_sample("pod-new", i * 1000), &frame);
+            removed = removed || frame.removed_names_size() > 0;
+            monitor::proto::MonitorInfo decoded;
+            ASSERT_TRUE(decoder.Decode(frame, &decoded));
+            ASSERT_EQ(decoded.cgroup_info_size(), 1);
+            EXPECT_EQ(decoded.cgroup_info(0).name(), "pod-new");
+        }
+        EXPECT_TRUE(removed);   // pod-old在一个检查周期内没有出现
+
+        // 新实例复用被删除的id，解码器按相同顺序还原名称和值
+        monitor::proto::CompactFrame frame;
+        encoder.Encode(cgroup_sample("pod-next", 999000), &frame);
+        ASSERT_EQ(frame.new_names_size(), 1);
+        ASSERT_EQ(frame.group_size(), 1);
+        EXPECT_EQ(frame.group(0).instance(0), 0u);
+        monitor::proto::MonitorInfo decoded;
+        ASSERT_TRUE(decoder.Decode(frame, &decoded));
+        ASSERT_EQ(decoded.cgroup_info_size(), 1);
+        EXPECT_EQ(decoded.cgroup_info(0).name(), "pod-next");
+        EXPECT_FLOAT_EQ(decoded.cgroup_info(0).cpu_percent(), 20.0f);
+    }
+}  // namespace
+}  // namespace monitor
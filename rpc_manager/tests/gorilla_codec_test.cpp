@@ -0,0 +1,168 @@
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/gorilla_codec.h"
+
+namespace monitor
+{
+namespace
+{
+    /**
+     * @brief 编码一组时间戳再解码，返回解码结果
+     * @param timestamps 时间戳
+     * @param encoded 输出参数，编码数据
+     */
+    std::vector<int64_t> RoundTripTimestamps(const std::vector<int64_t>& timestamps, std::string* encoded)
+    {
+        TimestampEncoder encoder(encoded);
+        for (int64_t timestamp : timestamps)
+        {
+            encoder.Append(timestamp);
+        }
+        TimestampDecoder decoder(reinterpret_cast<const uint8_t*>(encoded->data()), encoded->size());
+        std::vector<int64_t> decoded;
+        int64_t timestamp = 0;
+        for (size_t i = 0; i < timestamps.size() && decoder.Next(&timestamp); ++i)
+        {
+            decoded.push_back(timestamp);
+        }
+        return decoded;
+    }
+
+    /**
+     * @brief 编码一组浮点数再解码，返回解码结果的位模式（NaN之间也能逐位比较）
+     * @param values 数值
+     * @param encoded 输出参数，编码数据
+     */
+    std::vector<uint32_t> RoundTripFloats(const std::vector<float>& values, std::string* encoded)
+    {
+        FloatEncoder encoder(encoded);
+        for (float value : values)
+        {
+            encoder.Append(value);
+        }
+        FloatDecoder decoder(reinterpret_cast<const uint8_t*>(encoded->data()), encoded->size());
+        std::vector<uint32_t> decoded;
+        float value = 0;
+        for (size_t i = 0; i < values.size() && decoder.Next(&value); ++i)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            decoded.push_back(bits);
+        }
+        return decoded;
+    }
+
+    /**
+     * @brief 取浮点数的位模式
+     */
+    std::vector<uint32_t> Bits(const std::vector<float>& values)
+    {
+        std::vector<uint32_t> bits(values.size());
+        std::memcpy(bits.data(), values.data(), values.size() * sizeof(float));
+        return bits;
+    }
+
+    TEST(GorillaCodecTest, TimestampsRoundTripThroughEveryWidth)
+    {
+        // 依次覆盖：二阶差分为0、7位、9位、12位和64位转义（正负两个方向的大跳变）
+        const std::vector<int64_t> timestamps = {
+            1700000000000, 1700000001000, 1700000002000, 1700000003005, 1700000004000,
+            1700000005300, 1700000006000, 1700000006900, 1700000007900, 1700000010000,
+            1700003610000, 1700003611000, 1600000000000, 1600000001000,
+            std::numeric_limits<int64_t>::min() / 4, 0};
+        std::string encoded;
+        EXPECT_EQ(RoundTripTimestamps(timestamps, &encoded), timestamps);
+    }
+
+    TEST(GorillaCodecTest, FixedIntervalTimestampsTakeOneBitEach)
+    {
+        std::vector<int64_t> timestamps;
+        for (int64_t i = 0; i < 1000; ++i)
+        {
+            timestamps.push_back(1700000000000 + i * 1000);
+        }
+        std::string encoded;
+        EXPECT_EQ(RoundTripTimestamps(timestamps, &encoded), timestamps);
+        // 首个64位，第二个的二阶差分为1000（'1110'+12位），其余每个1位
+        EXPECT_LE(encoded.size(), 8u + (16u + 998u + 7u) / 8u);
+    }
+
+    TEST(GorillaCodecTest, TruncatedTimestampsFailInsteadOfReadingPastEnd)
+    {
+        std::string encoded;
+        TimestampEncoder encoder(&encoded);
+        encoder.Append(1000);
+        encoder.Append(std::numeric_limits<int64_t>::max() / 2);   // 64位转义
+        encoded.resize(encoded.size() - 4);
+
+        TimestampDecoder decoder(reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size());
+        int64_t timestamp = 0;
+        ASSERT_TRUE(decoder.Next(&timestamp));
+        EXPECT_EQ(timestamp, 1000);
+        EXPECT_FALSE(decoder.Next(&timestamp));
+    }
+
+    TEST(GorillaCodecTest, NanRunsRoundTripAtOneBitEach)
+    {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<float> values = {12.5f};
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(nan);
+        }
+        values.push_back(12.5f);   // 缺失后恢复
+        values.push_back(nan);
+
+        std::string encoded;
+        EXPECT_EQ(RoundTripFloats(values, &encoded), Bits(values));
+
+        // 连续的NaN与上一个值相同，每个1位
+        std::string run;
+        RoundTripFloats(std::vector<float>(1001, nan), &run);
+        EXPECT_LE(run.size(), 4u + (1000u + 7u) / 8u);
+    }
+
+    TEST(GorillaCodecTest, XorWindowIsReusedAndReset)
+    {
+        // 1.0→1.5：尾数最高位变化，建立窗口；1.5→1.0再回到窗口内（复用）；
+        // 1.0→1.0000001：只有最低位变化，尾随零少于窗口，重建窗口；
+        // 再到-1.0000001：符号位变化，前导零少于窗口，再次重建；之后的值都在新窗口内
+        const std::vector<float> values = {
+            1.0f, 1.5f, 1.0f, 1.5f, 1.0f, 1.0000001f, -1.0000001f, 1.0000001f, -1.0000001f, 0.0f, -0.0f,
+            std::numeric_limits<float>::infinity(), std::numeric_limits<float>::denorm_min(), 3.25f};
+        std::string encoded;
+        EXPECT_EQ(RoundTripFloats(values, &encoded), Bits(values));
+
+        // 反复在两个值之间切换：第一次变化建立窗口（13位），之后每个点只写'10'+窗口内的1位
+        std::vector<float> toggling;
+        for (int i = 0; i < 100; ++i)
+        {
+            toggling.push_back(i % 2 == 0 ? 1.0f : 1.5f);
+        }
+        std::string compact;
+        EXPECT_EQ(RoundTripFloats(toggling, &compact), Bits(toggling));
+        EXPECT_LE(compact.size(), 4u + (13u + 98u * 3u + 7u) / 8u);
+    }
+
+    TEST(GorillaCodecTest, TruncatedFloatsFailInsteadOfReadingPastEnd)
+    {
+        std::string encoded;
+        FloatEncoder encoder(&encoded);
+        encoder.Append(1.0f);
+        encoder.Append(-3.0e20f);
+        encoded.resize(4);
+
+        FloatDecoder decoder(reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size());
+        float value = 0;
+        ASSERT_TRUE(decoder.Next(&value));
+        EXPECT_EQ(value, 1.0f);
+        EXPECT_FALSE(decoder.Next(&value));
+    }
+}  // namespace
+}  // namespace monitor
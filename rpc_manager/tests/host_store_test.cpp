@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "server/host_store.h"
+
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+namespace
+{
+    /**
+     * @brief 构造只包含CPU数据的局部批次
+     */
+    monitor::proto::MonitorInfo CpuBatch(float cpu_percent, int64_t timestamp_ms)
+    {
+        monitor::proto::MonitorInfo info;
+        info.set_name("host");
+        info.set_timestamp_ms(timestamp_ms);
+        auto* cpu = info.add_cpu_stat();
+        cpu->set_cpu_name("cpu");
+        cpu->set_cpu_percent(cpu_percent);
+        return info;
+    }
+
+    /**
+     * @brief 构造只包含内存数据的局部批次
+     */
+    monitor::proto::MonitorInfo MemBatch(float used_percent, int64_t timestamp_ms)
+    {
+        monitor::proto::MonitorInfo info;
+        info.set_name("host");
+        info.set_timestamp_ms(timestamp_ms);
+        info.mutable_mem_info()->set_used_percent(used_percent);
+        return info;
+    }
+
+    TEST(HostStoreTest, PartialBatchSharesUnchangedParts)
+    {
+        HostStore store;
+        monitor::proto::MonitorInfo mem = MemBatch(40.0f, 1000);
+        HostStore::Snapshot first = store.Update(&mem);
+        monitor::proto::MonitorInfo cpu = CpuBatch(12.5f, 2000);
+        HostStore::Snapshot second = store.Update(&cpu);
+
+        const int mem_index = monitor::proto::MonitorInfo::descriptor()
+            ->FindFieldByNumber(monitor::proto::MonitorInfo::kMemInfoFieldNumber)->index();
+        EXPECT_EQ(first->Parts()[mem_index], second->Parts()[mem_index]);   // 没有拷贝
+        EXPECT_FLOAT_EQ(second->Field(monitor::proto::MonitorInfo::kMemInfoFieldNumber).mem_info().used_percent(), 40.0f);
+        EXPECT_EQ(second->Field(monitor::proto::MonitorInfo::kTimestampMsFieldNumber).timestamp_ms(), 2000);
+        EXPECT_EQ(second->Name(), "host");
+    }
+
+    TEST(HostStoreTest, SerializedPartsParseAsMergedMessage)
+    {
+        HostStore store;
+        store.Update(MemBatch(40.0f, 1000));
+        HostStore::Snapshot snapshot = store.Update(CpuBatch(12.5f, 2000));
+
+        monitor::proto::MonitorInfo parsed;
+        ASSERT_TRUE(parsed.ParseFromString(snapshot->Serialized()));
+        EXPECT_EQ(parsed.name(), "host");
+        EXPECT_EQ(parsed.timestamp_ms(), 2000);
+        EXPECT_FLOAT_EQ(parsed.mem_info().used_percent(), 40.0f);
+        ASSERT_EQ(parsed.cpu_stat_size(), 1);
+        EXPECT_FLOAT_EQ(parsed.cpu_stat(0).cpu_percent(), 12.5f);
+    }
+
+    TEST(HostStoreTest, EmptyNameIsStoredAsUnknownHost)
+    {
+        HostStore store;
+        monitor::proto::MonitorInfo sample = CpuBatch(1.0f, 1000);
+        sample.clear_name();
+        HostStore::Snapshot snapshot = store.Update(sample);
+
+        EXPECT_EQ(snapshot->Name(), "unknown_host");
+        EXPECT_EQ(store.Get("unknown_host"), snapshot);
+        monitor::proto::MonitorInfo parsed;
+        ASSERT_TRUE(parsed.ParseFromString(snapshot->Serialized()));
+        EXPECT_EQ(parsed.name(), "unknown_host");
+    }
+}  // namespace
+}  // namespace monitor
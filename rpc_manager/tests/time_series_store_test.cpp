@@ -0,0 +1,88 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "server/time_series_store.h"
+
+#include "monitor_info.pb.h"
+
+namespace monitor
+{
+namespace
+{
+    /**
+     * @brief 构造只包含一个cgroup的采样
+     */
+    monitor::proto::MonitorInfo CgroupSample(const std::string& cgroup, float cpu_percent, int64_t timestamp_ms)
+    {
+        monitor::proto::MonitorInfo info;
+        info.set_name("host");
+        info.set_timestamp_ms(timestamp_ms);
+        auto* entry = info.add_cgroup_info();
+        entry->set_name(cgroup);
+        entry->set_cpu_percent(cpu_percent);
+        return info;
+    }
+
+    /**
+     * @brief 查询一个cgroup的cpu_percent
+     */
+    bool QueryCgroup(const TimeSeriesStore& store, const std::string& cgroup, monitor::proto::RangeResponse* response)
+    {
+        monitor::proto::RangeRequest request;
+        request.set_host("host");
+        request.set_metric("cgroup_info.cpu_percent");
+        request.set_instance(cgroup);
+        request.set_t0_ms(0);
+        request.set_t1_ms(1000000);
+        return store.QueryRange(request, response);
+    }
+
+    TEST(TimeSeriesStoreTest, InstanceAbsentForFullRingIsEvicted)
+    {
+        constexpr size_t kCapacity = 4;
+        TimeSeriesStore store(kCapacity);
+        store.Append(CgroupSample("pod-a", 10.0f, 1000), 0);
+        store.Append(CgroupSample("pod-b", 20.0f, 2000), 0);
+
+        monitor::proto::RangeResponse response;
+        ASSERT_TRUE(QueryCgroup(store, "pod-a", &response));
+        EXPECT_EQ(response.value_size(), 1);
+
+        // pod-a连续缺失一整圈后被删除，pod-b（移动到pod-a原来的位置）的数据不受影响
+        for (size_t i = 1; i < kCapacity; ++i)
+        {
+            store.Append(CgroupSample("pod-b", 20.0f + i, 2000 + i * 1000), 0);
+        }
+        EXPECT_FALSE(QueryCgroup(store, "pod-a", &response));
+        ASSERT_TRUE(QueryCgroup(store, "pod-b", &response));
+        ASSERT_EQ(response.value_size(), static_cast<int>(kCapacity));
+        EXPECT_FLOAT_EQ(response.value(0), 20.0f);
+        EXPECT_FLOAT_EQ(response.value(kCapacity - 1), 20.0f + kCapacity - 1);
+
+        // 同名实例重新出现时从空列开始
+        store.Append(CgroupSample("pod-a", 30.0f, 9000), 0);
+        ASSERT_TRUE(QueryCgroup(store, "pod-a", &response));
+        ASSERT_EQ(response.value_size(), 1);
+        EXPECT_FLOAT_EQ(response.value(0), 30.0f);
+    }
+
+    TEST(TimeSeriesStoreTest, SnapshotOnlyFieldsAreNotStored)
+    {
+        TimeSeriesStore store;
+        monitor::proto::MonitorInfo info;
+        info.set_name("host");
+        info.set_timestamp_ms(1000);
+        info.add_process_info()->set_name("worker[100]");
+        store.Append(info, 0);
+
+        monitor::proto::RangeRequest request;
+        request.set_host("host");
+        request.set_metric("process_info.cpu_percent");
+        request.set_instance("worker[100]");
+        request.set_t1_ms(2000);
+        monitor::proto::RangeResponse response;
+        EXPECT_FALSE(store.QueryRange(request, &response));
+    }
+}  // namespace
+}  // namespace monitor